@@ -28,9 +28,13 @@
 #include <mberror.hpp>
 #include <rr_buffer.hpp>
 #include <wdt.hpp>
+#include <rr_metrics.hpp>
+#include <rr_zone.hpp>
+#include <rr_memory.hpp>
 #include <mb_op_factory.hpp>
 #include "pb_encode.h"
 #include "pb_decode.h"
 #include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
 
 #endif // RR_BLE_MOUSEBOT_HPP
\ No newline at end of file
@@ -23,6 +23,31 @@
 
 #include <mb_operations.hpp>
 #include <rr_imu.hpp>
+#include <rr_pose_op.hpp>
+#include <rr_motor.hpp>
+#include <rr_speed.hpp>
+#include <rr_motion.hpp>
+#include <rr_range.hpp>
+#include <rr_walls_op.hpp>
+#include <rr_maze_op.hpp>
+#include <wdt_op.hpp>
+#include <rr_metrics_op.hpp>
+#include <rr_zone_op.hpp>
+#include <rr_memory_op.hpp>
+
+/**
+ * Maximum number of concurrent stream subscriptions.
+ */
+#ifndef MB_MAX_SUBSCRIPTIONS
+#define MB_MAX_SUBSCRIPTIONS 4
+#endif
+
+/**
+ * Shortest publication period (ms) a subscription may request.
+ */
+#ifndef MB_MIN_SUBSCRIPTION_MS
+#define MB_MIN_SUBSCRIPTION_MS 5
+#endif
 
 namespace mb_operations
 {
@@ -47,6 +72,26 @@ namespace mb_operations
          */
         ~MBOperationsFactory() = default;
 
+        /**
+         * @fn service_sensors
+         * @brief services the sensing handlers once per main loop iteration: bus transfers, IMU, pose, range, walls
+         * and maze.
+         */
+        void service_sensors();
+
+        /**
+         * @fn service_control
+         * @brief services the control handlers once per main loop iteration: motors and wheel speed control.
+         */
+        void service_control();
+
+        /**
+         * @fn control_alive
+         * @brief true if the wheel speed loop has run a period since the last call, or is not running at all. On
+         * target the loop runs in the timer interrupt, so its watchdog check in is taken from here.
+         */
+        bool control_alive();
+
         /**
          * @fn get_op_handler
          * @brief if supported, return MbOperationHandler.
@@ -65,8 +110,55 @@ namespace mb_operations
          */
         MbOperationHandler *get_op_handler(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Status &status);
 
+        /**
+         * @fn subscribe
+         * @brief publishes op every period_ms, as if a monitor request had been received.
+         *
+         * Subscribing to an op that is already subscribed changes its period, a period of 0 cancels it.
+         * Periods below MB_MIN_SUBSCRIPTION_MS are raised to it.
+         *
+         * @return false if op is not known, or all MB_MAX_SUBSCRIPTIONS slots are in use.
+         */
+        bool subscribe(std::int32_t op, std::uint32_t period_ms);
+
+        /**
+         * @fn next_publication
+         * @brief returns the handler of a subscription that is due, and the monitor request to perform on it.
+         *
+         * Motion segment completion events are returned first, as an MSP_MOTION monitor request, then maze cell
+         * wall events as MSP_WALLS.
+         *
+         * Only one publication is returned per call, so that a single main loop iteration does not write several
+         * frames. Subscriptions whose handler is not READY are skipped until their next period.
+         *
+         * @return null if nothing is due.
+         */
+        MbOperationHandler *next_publication(org_ryderrobots_ros2_serial_Request &req);
+
         private:
-            RRImuOpHandler imu_op_hdl_; 
+            struct Subscription
+            {
+                std::int32_t op;
+                std::uint32_t period_ms;
+                unsigned long due_ms;
+            };
+
+            RRImuOpHandler imu_op_hdl_;
+            RRPoseOpHandler pose_op_hdl_{imu_op_hdl_};
+            RRMotorOpHandler motor_op_hdl_;
+            RRSpeedOpHandler speed_op_hdl_{motor_op_hdl_};
+            RRMotionOpHandler motion_op_hdl_{speed_op_hdl_};
+            RRRangeOpHandler range_op_hdl_;
+            RRWallOpHandler walls_op_hdl_{pose_op_hdl_, range_op_hdl_};
+            RRMazeOpHandler maze_op_hdl_{walls_op_hdl_, pose_op_hdl_};
+            RRWdtOpHandler wdt_op_hdl_;
+            RRMetricsOpHandler metrics_op_hdl_;
+            RRProfileOpHandler profile_op_hdl_;
+            RRMemoryOpHandler memory_op_hdl_;
+
+            // op 0 marks a free slot
+            Subscription subscriptions_[MB_MAX_SUBSCRIPTIONS] = {};
+            size_t next_subscription_ = 0;
     };
 }
 
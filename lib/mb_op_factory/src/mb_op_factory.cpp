@@ -18,6 +18,7 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+
 #include <mb_op_factory.hpp>
 
 namespace mb_operations
@@ -25,11 +26,76 @@ namespace mb_operations
     void MBOperationsFactory::init()
     {
         imu_op_hdl_.init();
+
+        // the motor handler starts the encoders, which pose and speed control need at init.
+        motor_op_hdl_.init();
+        rr_encoder::Encoders &encoders = rr_encoder::Encoders::get_instance();
+        pose_op_hdl_.set_tick_source(&encoders);
+        speed_op_hdl_.set_tick_source(&encoders);
+        speed_op_hdl_.set_heading_source(&imu_op_hdl_);
+        pose_op_hdl_.init();
+        speed_op_hdl_.init();
+        motion_op_hdl_.init();
+        range_op_hdl_.init();
+        walls_op_hdl_.init();
+        maze_op_hdl_.init();
+        wdt_op_hdl_.init();
+        metrics_op_hdl_.init();
+        profile_op_hdl_.init();
+        memory_op_hdl_.init();
+    }
+
+    void MBOperationsFactory::service_sensors()
+    {
+        RR_ZONE(rr_zone::ZONE_SENSORS);
+
+        // complete bus transfers first, so handlers see their results in the same iteration.
+        {
+            RR_ZONE(rr_zone::ZONE_BUS);
+            rr_sensor_bus::SensorBus::get_instance().poll();
+        }
+        {
+            RR_ZONE(rr_zone::ZONE_IMU);
+            imu_op_hdl_.service();
+        }
+
+        // pose consumes the IMU sample, so it is serviced after it.
+        {
+            RR_ZONE(rr_zone::ZONE_POSE);
+            pose_op_hdl_.service();
+        }
+        {
+            RR_ZONE(rr_zone::ZONE_RANGE);
+            range_op_hdl_.service();
+        }
+
+        // walls consume both the pose and range readings, and the maze the cells walls has finished.
+        {
+            RR_ZONE(rr_zone::ZONE_WALLS);
+            walls_op_hdl_.service();
+        }
+        {
+            RR_ZONE(rr_zone::ZONE_MAZE);
+            maze_op_hdl_.service();
+        }
+    }
+
+    void MBOperationsFactory::service_control()
+    {
+        RR_ZONE(rr_zone::ZONE_CONTROL);
+        motor_op_hdl_.service();
+        speed_op_hdl_.service();
+    }
+
+    bool MBOperationsFactory::control_alive()
+    {
+        return speed_op_hdl_.status() != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY ||
+               speed_op_hdl_.take_tick();
     }
 
     MbOperationHandler *MBOperationsFactory::get_op_handler(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Status &status)
     {
-        RRImuOpHandler *hdl = nullptr;
+        MbOperationHandler *hdl = nullptr;
         status = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_UNKNOWN;
         switch (req.op)
         {
@@ -37,6 +103,59 @@ namespace mb_operations
             hdl = &imu_op_hdl_;
             break;
 
+        case rr_ble::MSP_MOTOR:
+        case rr_ble::MSP_SET_RAW_RC:
+            hdl = &motor_op_hdl_;
+            break;
+
+        case rr_ble::MSP_PID:
+        case rr_ble::MSP_SET_PID:
+        case rr_ble::MSP_SET_WHEEL_SPEED:
+            hdl = &speed_op_hdl_;
+            break;
+
+        case rr_ble::MSP_RAW_SENSORS:
+            hdl = &range_op_hdl_;
+            break;
+
+        case rr_ble::MSP_WALLS:
+            hdl = &walls_op_hdl_;
+            break;
+
+        case rr_ble::MSP_MAZE_MOVE:
+        case rr_ble::MSP_MAZE_DIST:
+        case rr_ble::MSP_MAZE_MAP:
+        case rr_ble::MSP_MAZE_PLAN:
+        case rr_ble::MSP_SET_MAZE:
+            hdl = &maze_op_hdl_;
+            break;
+
+        case rr_ble::MSP_POSE:
+            hdl = &pose_op_hdl_;
+            break;
+
+        case rr_ble::MSP_STATUS:
+        case rr_ble::MSP_TRACE:
+            hdl = &wdt_op_hdl_;
+            break;
+
+        case rr_ble::MSP_METRICS:
+            hdl = &metrics_op_hdl_;
+            break;
+
+        case rr_ble::MSP_PROFILE:
+            hdl = &profile_op_hdl_;
+            break;
+
+        case rr_ble::MSP_MEMORY:
+            hdl = &memory_op_hdl_;
+            break;
+
+        case rr_ble::MSP_MOTION:
+        case rr_ble::MSP_SET_MOTION:
+            hdl = &motion_op_hdl_;
+            break;
+
         default:
             status = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_UNKNOWN;
             return nullptr;
@@ -51,4 +170,109 @@ namespace mb_operations
         return hdl;
     }
 
-}
\ No newline at end of file
+    bool MBOperationsFactory::subscribe(std::int32_t op, std::uint32_t period_ms)
+    {
+        org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+        req.op = op;
+        org_ryderrobots_ros2_serial_Status status;
+        get_op_handler(req, status);
+        if (op == 0 || status == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_UNKNOWN)
+        {
+            return false;
+        }
+        if (period_ms != 0 && period_ms < MB_MIN_SUBSCRIPTION_MS)
+        {
+            period_ms = MB_MIN_SUBSCRIPTION_MS;
+        }
+
+        Subscription *free_slot = nullptr;
+        for (size_t i = 0; i < MB_MAX_SUBSCRIPTIONS; i++)
+        {
+            Subscription &sub = subscriptions_[i];
+            if (sub.op == op)
+            {
+                sub.period_ms = period_ms;
+                if (period_ms == 0)
+                {
+                    sub.op = 0;
+                }
+                return true;
+            }
+            if (sub.op == 0 && free_slot == nullptr)
+            {
+                free_slot = &sub;
+            }
+        }
+
+        if (period_ms == 0)
+        {
+            return true;
+        }
+        if (free_slot == nullptr)
+        {
+            return false;
+        }
+        free_slot->op = op;
+        free_slot->period_ms = period_ms;
+        free_slot->due_ms = millis() + period_ms;
+        return true;
+    }
+
+    MbOperationHandler *MBOperationsFactory::next_publication(org_ryderrobots_ros2_serial_Request &req)
+    {
+        unsigned long now = millis();
+
+        if (motion_op_hdl_.event_pending() &&
+            motion_op_hdl_.status() == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            req = org_ryderrobots_ros2_serial_Request_init_zero;
+            req.op = rr_ble::MSP_MOTION;
+            req.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+            req.data.monitor.is_request = true;
+            return &motion_op_hdl_;
+        }
+
+        if (walls_op_hdl_.event_pending() &&
+            walls_op_hdl_.status() == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            req = org_ryderrobots_ros2_serial_Request_init_zero;
+            req.op = rr_ble::MSP_WALLS;
+            req.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+            req.data.monitor.is_request = true;
+            return &walls_op_hdl_;
+        }
+
+        // start after the last publication, so one fast stream can not starve the others.
+        for (size_t n = 0; n < MB_MAX_SUBSCRIPTIONS; n++)
+        {
+            size_t i = (next_subscription_ + n) % MB_MAX_SUBSCRIPTIONS;
+            Subscription &sub = subscriptions_[i];
+            if (sub.op == 0 || static_cast<long>(now - sub.due_ms) < 0)
+            {
+                continue;
+            }
+
+            // keep the publication grid, unless a whole period has been missed.
+            sub.due_ms += sub.period_ms;
+            if (static_cast<long>(now - sub.due_ms) >= 0)
+            {
+                sub.due_ms = now + sub.period_ms;
+            }
+
+            req = org_ryderrobots_ros2_serial_Request_init_zero;
+            req.op = sub.op;
+            req.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+            req.data.monitor.is_request = true;
+
+            org_ryderrobots_ros2_serial_Status status;
+            MbOperationHandler *hdl = get_op_handler(req, status);
+            if (hdl == nullptr)
+            {
+                continue;
+            }
+            next_subscription_ = (i + 1) % MB_MAX_SUBSCRIPTIONS;
+            return hdl;
+        }
+        return nullptr;
+    }
+}
@@ -25,6 +25,7 @@
 #include "pb_encode.h"
 #include "pb_decode.h"
 #include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
 
 namespace mb_operations
 {
@@ -80,6 +81,34 @@ namespace mb_operations
          * For FAILUREs it is up to the calling system to intrepret how to handle this.
          */
         virtual org_ryderrobots_ros2_serial_Status status() = 0;
+
+        /**
+         * @fn service
+         * @brief background work, called once per main loop iteration before any request is read.
+         *
+         * Handlers that sample hardware independently of requests override this. Implementations MUST NOT
+         * block, as every handler shares the main loop.
+         */
+        virtual void service() {}
+
+        /**
+         * @fn perform_ext
+         * @brief handles the mousebot extension fields that arrived with the request.
+         *
+         * Called directly after perform_op(), unless perform_op() returned a bad request, or accept_ext() refused
+         * ereq. eres is encoded after
+         * res in the same frame, see proto/rr_mousebot.proto. Handlers without extensions leave eres untouched.
+         */
+        virtual void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) {}
+
+        /**
+         * @fn accept_ext
+         * @brief checks the extension fields before perform_ext() applies any of them.
+         *
+         * Returning false answers the request with an ET_INVALID_REQUEST bad request, and perform_ext() is not
+         * called. Handlers without checks accept every request.
+         */
+        virtual bool accept_ext(const org_ryderrobots_mousebot_ExtRequest &ereq) { return true; }
     };
 }
 
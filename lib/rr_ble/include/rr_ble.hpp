@@ -34,6 +34,9 @@
 #include <mb_operations.hpp>
 
 #define TERM_CHAR 0x1E
+// byte stuffing: TERM_CHAR and ESC_CHAR inside a frame are sent as ESC_CHAR, then the byte xor ESC_XOR.
+#define ESC_CHAR 0x1B
+#define ESC_XOR 0x20
 #define BAUD_RATE 115200
 
 namespace rr_ble
@@ -42,12 +45,33 @@ namespace rr_ble
     typedef enum _rr_op_code
     {
         // monitoring sits in 1xx range
+        MSP_STATUS = 101,
         MSP_RAW_IMU = 102,
         MSP_MOTOR = 104,
         MSP_RAW_SENSORS = 105,
+        MSP_PID = 112,
+
+        // mousebot specific monitoring, payloads are in proto/rr_mousebot.proto
+        MSP_POSE = 150,
+        MSP_MOTION = 151,
+        MSP_WALLS = 152,
+        MSP_MAZE_MOVE = 153,
+        MSP_MAZE_DIST = 154,
+        MSP_MAZE_MAP = 155,
+        MSP_MAZE_PLAN = 156,
+        MSP_TRACE = 157,
+        MSP_METRICS = 158,
+        MSP_PROFILE = 159,
+        MSP_MEMORY = 160,
 
         // Commands sit in the 2xx range.
         MSP_SET_RAW_RC = 200,
+        MSP_SET_PID = 202,
+
+        // mousebot specific commands, payloads are in proto/rr_mousebot.proto
+        MSP_SET_WHEEL_SPEED = 250,
+        MSP_SET_MOTION = 251,
+        MSP_SET_MAZE = 252,
 
         // Errors included under here
         BAD_REQUEST = 400,
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_GEOMETRY_HPP
+#define RR_GEOMETRY_HPP
+
+/**
+ * Drive and maze geometry, shared by odometry, wheel speed control, and wall detection.
+ */
+
+// distance between wheel contact points (m)
+#ifndef RR_WHEEL_BASE_M
+#define RR_WHEEL_BASE_M 0.074f
+#endif
+
+#ifndef RR_WHEEL_DIAMETER_M
+#define RR_WHEEL_DIAMETER_M 0.032f
+#endif
+
+// encoder ticks per wheel revolution, after gearing and quadrature.
+#ifndef RR_ENCODER_TICKS_PER_REV
+#define RR_ENCODER_TICKS_PER_REV 1440
+#endif
+
+// maze cell pitch, and wall thickness (m), and cells along each side, of a classic micromouse maze.
+#ifndef RR_MAZE_CELL_M
+#define RR_MAZE_CELL_M 0.18f
+#endif
+
+#ifndef RR_MAZE_WALL_M
+#define RR_MAZE_WALL_M 0.012f
+#endif
+
+#ifndef RR_MAZE_SIZE
+#define RR_MAZE_SIZE 16
+#endif
+
+namespace rr_ble
+{
+    // distance travelled by a wheel for one encoder tick (m)
+    constexpr float METRES_PER_TICK = 3.14159265358979f * RR_WHEEL_DIAMETER_M / static_cast<float>(RR_ENCODER_TICKS_PER_REV);
+}
+
+#endif // RR_GEOMETRY_HPP
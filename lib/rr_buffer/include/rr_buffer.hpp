@@ -82,6 +82,29 @@ namespace rr_buffer
          */
         static RRBuffer& get_instance();
     };
+
+    /**
+     * @fn escaped
+     * @brief true if b is sent as ESC_CHAR, then b ^ ESC_XOR, inside a frame.
+     */
+    inline bool escaped(std::uint8_t b)
+    {
+        return b == TERM_CHAR || b == ESC_CHAR;
+    }
+
+    /**
+     * @fn stuff
+     * @brief byte stuffs n bytes of in to out, which holds at least 2 * n bytes, and returns the bytes written.
+     * TERM_CHAR is not appended.
+     */
+    size_t stuff(const std::uint8_t *in, size_t n, std::uint8_t *out);
+
+    /**
+     * @fn unstuff
+     * @brief removes byte stuffing from the n bytes at buf in place, and sets n to the bytes left. Returns false,
+     * leaving buf undefined, if an ESC_CHAR is not followed by an escaped byte.
+     */
+    bool unstuff(std::uint8_t *buf, size_t &n);
 }
 
 #endif
\ No newline at end of file
@@ -51,4 +51,42 @@ namespace rr_buffer
         static RRBuffer instance;
         return instance;
     }
+
+    size_t stuff(const std::uint8_t *in, size_t n, std::uint8_t *out)
+    {
+        size_t w = 0;
+        for (size_t r = 0; r < n; r++)
+        {
+            if (escaped(in[r]))
+            {
+                out[w++] = ESC_CHAR;
+                out[w++] = static_cast<std::uint8_t>(in[r] ^ ESC_XOR);
+            }
+            else
+            {
+                out[w++] = in[r];
+            }
+        }
+        return w;
+    }
+
+    bool unstuff(std::uint8_t *buf, size_t &n)
+    {
+        size_t w = 0;
+        for (size_t r = 0; r < n; r++)
+        {
+            std::uint8_t b = buf[r];
+            if (b == ESC_CHAR)
+            {
+                if (++r == n || !escaped(static_cast<std::uint8_t>(buf[r] ^ ESC_XOR)))
+                {
+                    return false;
+                }
+                b = static_cast<std::uint8_t>(buf[r] ^ ESC_XOR);
+            }
+            buf[w++] = b;
+        }
+        n = w;
+        return true;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_LOOP_TIMER_HPP
+#define RR_LOOP_TIMER_HPP
+
+#include <cstdint>
+
+namespace rr_control
+{
+    /**
+     * Timing of a periodic task, microseconds.
+     */
+    struct LoopTiming
+    {
+        std::uint32_t count;
+
+        // time between successive starts
+        std::uint32_t period_min_us;
+        std::uint32_t period_max_us;
+        std::uint64_t period_sum_us;
+
+        // time from start to stop
+        std::uint32_t exec_min_us;
+        std::uint32_t exec_max_us;
+        std::uint64_t exec_sum_us;
+
+        // iterations that started more than half a period late, or ran longer than a period.
+        std::uint32_t overruns;
+    };
+
+    /**
+     * @class LoopTimer
+     * @brief records period, and execution time statistics of a fixed rate loop.
+     *
+     * Call start() on entry to each iteration, and stop() on exit, with a free running microsecond clock.
+     * Counters are allowed to wrap.
+     */
+    class LoopTimer
+    {
+    private:
+        std::uint32_t nominal_us_ = 0;
+        std::uint32_t last_start_us_ = 0;
+        std::uint32_t start_us_ = 0;
+        bool started_ = false;
+        LoopTiming stats_;
+
+    public:
+        LoopTimer()
+        {
+            reset();
+        }
+
+        /**
+         * @fn set_period
+         * @brief nominal period, used to detect overruns.
+         */
+        void set_period(std::uint32_t nominal_us)
+        {
+            nominal_us_ = nominal_us;
+        }
+
+        void reset()
+        {
+            stats_ = {0, UINT32_MAX, 0, 0, UINT32_MAX, 0, 0, 0};
+            started_ = false;
+        }
+
+        void start(std::uint32_t now_us)
+        {
+            if (started_)
+            {
+                std::uint32_t period = now_us - last_start_us_;
+                stats_.period_min_us = period < stats_.period_min_us ? period : stats_.period_min_us;
+                stats_.period_max_us = period > stats_.period_max_us ? period : stats_.period_max_us;
+                stats_.period_sum_us += period;
+                if (nominal_us_ != 0 && period > nominal_us_ + nominal_us_ / 2)
+                {
+                    stats_.overruns++;
+                }
+            }
+            last_start_us_ = now_us;
+            start_us_ = now_us;
+            started_ = true;
+        }
+
+        void stop(std::uint32_t now_us)
+        {
+            std::uint32_t exec = now_us - start_us_;
+            stats_.exec_min_us = exec < stats_.exec_min_us ? exec : stats_.exec_min_us;
+            stats_.exec_max_us = exec > stats_.exec_max_us ? exec : stats_.exec_max_us;
+            stats_.exec_sum_us += exec;
+            if (nominal_us_ != 0 && exec > nominal_us_)
+            {
+                stats_.overruns++;
+            }
+            stats_.count++;
+        }
+
+        const LoopTiming &stats() const
+        {
+            return stats_;
+        }
+    };
+}
+
+#endif // RR_LOOP_TIMER_HPP
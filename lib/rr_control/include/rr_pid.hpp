@@ -0,0 +1,102 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_PID_HPP
+#define RR_PID_HPP
+
+namespace rr_control
+{
+    /**
+     * Controller gains, output units per unit of setpoint / error.
+     */
+    struct Gains
+    {
+        float kp;
+        float ki;
+        float kd;
+
+        // feed-forward, output per unit of setpoint
+        float kff;
+
+        // feed-forward offset applied in the direction of the setpoint, overcomes static friction.
+        float kstatic;
+    };
+
+    /**
+     * @class Pid
+     * @brief PID controller with feed-forward, and anti-windup, for a fixed rate loop.
+     *
+     * output = kff * sp + kstatic * sign(sp) + kp * e + ki * integral(e) - kd * d(measured) / dt
+     *
+     * The derivative acts on the measurement, so setpoint steps do not kick the output. The integrator is
+     * frozen while the output is saturated in the direction the error would drive it (conditional
+     * integration), so it does not wind up while the actuator is at its limit.
+     */
+    class Pid
+    {
+    private:
+        Gains gains_ = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        float out_min_ = -1.0f;
+        float out_max_ = 1.0f;
+
+        float integral_ = 0.0f;
+        float prev_measured_ = 0.0f;
+        bool primed_ = false;
+        bool saturated_ = false;
+
+    public:
+        Pid() = default;
+
+        /**
+         * @fn set_gains
+         * @brief changes gains, the integrator is kept so the output does not step when ki changes.
+         */
+        void set_gains(const Gains &gains);
+
+        const Gains &gains() const;
+
+        /**
+         * @fn set_limits
+         * @brief output range, returns false (leaving limits untouched) if min is not below max.
+         */
+        bool set_limits(float out_min, float out_max);
+
+        /**
+         * @fn reset
+         * @brief clears integrator, and derivative history.
+         */
+        void reset();
+
+        /**
+         * @fn update
+         * @brief advances the controller by dt seconds, and returns the clamped output.
+         */
+        float update(float setpoint, float measured, float dt);
+
+        /**
+         * @fn saturated
+         * @brief true if the last output was clamped.
+         */
+        bool saturated() const;
+    };
+}
+
+#endif // RR_PID_HPP
@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_PROFILE_HPP
+#define RR_PROFILE_HPP
+
+#include <cstddef>
+
+namespace rr_control
+{
+    /**
+     * Motion limits, in units of the profiled axis (m or rad) per second, per second squared, and per second cubed.
+     */
+    struct Limits
+    {
+        float v_max;
+        float accel;
+
+        // 0 gives a trapezoidal profile, otherwise an S-curve with at most this jerk.
+        float jerk;
+    };
+
+    /**
+     * @class Profile
+     * @brief online velocity profile generator for a fixed rate loop.
+     *
+     * Each step first advances a trapezoidal profile, which accelerates to v_max, and leaves just enough distance
+     * to brake to the end velocity. S-curves pass the trapezoid through a moving average of accel / jerk seconds,
+     * which limits jerk to exactly that value, and preserves distance, so the segment still ends on target,
+     * one averaging window later.
+     *
+     * Segments start at the velocity the previous one ended at, so consecutive segments join without a step.
+     */
+    class Profile
+    {
+    public:
+        // longest moving average, in steps, lower jerk than accel / (MAX_SMOOTHING * dt) is not reached.
+        static constexpr size_t MAX_SMOOTHING = 64;
+
+    private:
+        float dt_ = 0.001f;
+        Limits limits_ = {0.0f, 0.0f, 0.0f};
+        float v_end_ = 0.0f;
+
+        // trapezoid
+        float trap_distance_ = 0.0f;
+        float trap_position_ = 0.0f;
+        float trap_velocity_ = 0.0f;
+        bool trap_done_ = true;
+
+        // moving average over the last smoothing_ trapezoid velocities.
+        float window_[MAX_SMOOTHING];
+        size_t smoothing_ = 1;
+        size_t next_ = 0;
+        float sum_ = 0.0f;
+        size_t flush_ = 0;
+
+        float distance_ = 0.0f;
+        float position_ = 0.0f;
+        float velocity_ = 0.0f;
+        bool done_ = true;
+
+        /*
+         * fills the moving average with the current velocity, and sets its length.
+         */
+        void fill(size_t smoothing);
+
+    public:
+        Profile();
+
+        /**
+         * @fn reset
+         * @brief idles the profile at rest.
+         */
+        void reset();
+
+        /**
+         * @fn start
+         * @brief starts a segment of distance (>= 0) from the current velocity, ending at v_end.
+         *
+         * Returns false, leaving the profile untouched, for non positive v_max, accel, or dt, negative jerk,
+         * or v_end outside 0 .. v_max.
+         */
+        bool start(float distance, float v_end, const Limits &limits, float dt);
+
+        /**
+         * @fn stop
+         * @brief brakes to rest as soon as the segment limits allow, abandoning the remaining distance.
+         */
+        void stop();
+
+        /**
+         * @fn step
+         * @brief advances one period, and returns the velocity for it.
+         */
+        float step();
+
+        bool done() const;
+
+        // distance covered since start().
+        float position() const;
+
+        float distance() const;
+
+        float velocity() const;
+    };
+}
+
+#endif // RR_PROFILE_HPP
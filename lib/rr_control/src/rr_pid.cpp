@@ -0,0 +1,115 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_pid.hpp>
+
+namespace rr_control
+{
+    void Pid::set_gains(const Gains &gains)
+    {
+        // the integrator accumulates ki * e * dt, so its contribution to the output already carries the old ki
+        // and is kept as is. Without integral action it would be a fixed offset, so it is dropped.
+        if (gains.ki == 0.0f)
+        {
+            integral_ = 0.0f;
+        }
+        gains_ = gains;
+    }
+
+    const Gains &Pid::gains() const
+    {
+        return gains_;
+    }
+
+    bool Pid::set_limits(float out_min, float out_max)
+    {
+        if (!(out_min < out_max))
+        {
+            return false;
+        }
+        out_min_ = out_min;
+        out_max_ = out_max;
+        return true;
+    }
+
+    void Pid::reset()
+    {
+        integral_ = 0.0f;
+        prev_measured_ = 0.0f;
+        primed_ = false;
+        saturated_ = false;
+    }
+
+    float Pid::update(float setpoint, float measured, float dt)
+    {
+        if (!(dt > 0.0f))
+        {
+            return 0.0f;
+        }
+
+        float error = setpoint - measured;
+
+        float ff = gains_.kff * setpoint;
+        if (setpoint > 0.0f)
+        {
+            ff += gains_.kstatic;
+        }
+        else if (setpoint < 0.0f)
+        {
+            ff -= gains_.kstatic;
+        }
+
+        float d = primed_ ? -gains_.kd * (measured - prev_measured_) / dt : 0.0f;
+        prev_measured_ = measured;
+        primed_ = true;
+
+        float base = ff + gains_.kp * error + d;
+        float integral = integral_ + gains_.ki * error * dt;
+        float out = base + integral;
+
+        // conditional integration, only accept the new integral if it does not push further into the limit.
+        if ((out > out_max_ && error > 0.0f) || (out < out_min_ && error < 0.0f))
+        {
+            out = base + integral_;
+        }
+        else
+        {
+            integral_ = integral;
+        }
+
+        saturated_ = true;
+        if (out > out_max_)
+        {
+            return out_max_;
+        }
+        if (out < out_min_)
+        {
+            return out_min_;
+        }
+        saturated_ = false;
+        return out;
+    }
+
+    bool Pid::saturated() const
+    {
+        return saturated_;
+    }
+}
@@ -0,0 +1,202 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_profile.hpp>
+
+#include <cmath>
+
+namespace rr_control
+{
+    Profile::Profile()
+    {
+        reset();
+    }
+
+    void Profile::fill(size_t smoothing)
+    {
+        smoothing_ = smoothing;
+        for (size_t i = 0; i < smoothing_; i++)
+        {
+            window_[i] = trap_velocity_;
+        }
+        sum_ = trap_velocity_ * static_cast<float>(smoothing_);
+        next_ = 0;
+    }
+
+    void Profile::reset()
+    {
+        trap_distance_ = 0.0f;
+        trap_position_ = 0.0f;
+        trap_velocity_ = 0.0f;
+        trap_done_ = true;
+        fill(1);
+        flush_ = 0;
+
+        v_end_ = 0.0f;
+        distance_ = 0.0f;
+        position_ = 0.0f;
+        velocity_ = 0.0f;
+        done_ = true;
+    }
+
+    bool Profile::start(float distance, float v_end, const Limits &limits, float dt)
+    {
+        if (!(distance >= 0.0f) || !(limits.v_max > 0.0f) || !(limits.accel > 0.0f) || !(limits.jerk >= 0.0f) ||
+            !(dt > 0.0f) || !(v_end >= 0.0f) || v_end > limits.v_max)
+        {
+            return false;
+        }
+
+        size_t smoothing = 1;
+        if (limits.jerk > 0.0f)
+        {
+            float steps = limits.accel / (limits.jerk * dt) + 0.5f;
+            smoothing = steps >= static_cast<float>(MAX_SMOOTHING) ? MAX_SMOOTHING : (steps < 1.0f ? 1 : static_cast<size_t>(steps));
+        }
+
+        limits_ = limits;
+        dt_ = dt;
+        v_end_ = v_end;
+
+        // continue from the velocity being output, the window restarts full of it.
+        float v_start = velocity_;
+        trap_velocity_ = v_start;
+        fill(smoothing);
+
+        // the average lags the trapezoid, running on at its start velocity for (n - 1) / 2 steps, and at the
+        // end velocity for (n + 1) / 2 steps while the window flushes, so the trapezoid is that much shorter.
+        float n = static_cast<float>(smoothing);
+        float lag = dt * (v_start * (n - 1.0f) + v_end * (n + 1.0f)) * 0.5f;
+        trap_distance_ = distance > lag ? distance - lag : 0.0f;
+        trap_position_ = 0.0f;
+        trap_done_ = false;
+        flush_ = smoothing;
+
+        distance_ = distance;
+        position_ = 0.0f;
+        done_ = false;
+        return true;
+    }
+
+    void Profile::stop()
+    {
+        if (limits_.accel <= 0.0f || (done_ && velocity_ == 0.0f))
+        {
+            return;
+        }
+
+        // brake the trapezoid at the segment deceleration, the average follows a window later.
+        float v = trap_velocity_;
+        float braking = v * v / (2.0f * limits_.accel);
+        trap_distance_ = trap_position_ + braking;
+        trap_done_ = false;
+        v_end_ = 0.0f;
+        flush_ = smoothing_;
+
+        distance_ = position_ + braking + velocity_ * dt_ * static_cast<float>(smoothing_) * 0.5f;
+        done_ = false;
+    }
+
+    float Profile::step()
+    {
+        if (done_)
+        {
+            return velocity_;
+        }
+
+        float x;
+        if (!trap_done_)
+        {
+            float remaining = trap_distance_ - trap_position_;
+            float v = trap_velocity_;
+            float next = v < limits_.v_max ? v + limits_.accel * dt_ : v - limits_.accel * dt_;
+            next = (v < limits_.v_max) == (next < limits_.v_max) ? next : limits_.v_max;
+
+            // fastest velocity from which the end velocity can still be reached in what remains after this
+            // step, v^2 = v_end^2 + 2 a (remaining - v dt).
+            float a_dt = limits_.accel * dt_;
+            float braking = std::sqrt(a_dt * a_dt + v_end_ * v_end_ + 2.0f * limits_.accel * (remaining > 0.0f ? remaining : 0.0f)) - a_dt;
+            next = next < braking ? next : braking;
+
+            if (next * dt_ >= remaining)
+            {
+                // the last step covers exactly the remaining distance.
+                x = remaining > 0.0f ? remaining / dt_ : 0.0f;
+                trap_velocity_ = v_end_;
+                trap_done_ = true;
+            }
+            else
+            {
+                x = next;
+                trap_velocity_ = next;
+            }
+            trap_position_ += x * dt_;
+        }
+        else
+        {
+            x = trap_velocity_;
+            flush_--;
+        }
+
+        sum_ += x - window_[next_];
+        window_[next_] = x;
+        next_ = (next_ + 1) % smoothing_;
+        if (next_ == 0)
+        {
+            // resum once per window, so rounding in the running sum does not accumulate.
+            sum_ = 0.0f;
+            for (size_t i = 0; i < smoothing_; i++)
+            {
+                sum_ += window_[i];
+            }
+        }
+
+        velocity_ = sum_ / static_cast<float>(smoothing_);
+        position_ += velocity_ * dt_;
+
+        if (trap_done_ && flush_ == 0)
+        {
+            velocity_ = v_end_;
+            done_ = true;
+        }
+        return velocity_;
+    }
+
+    bool Profile::done() const
+    {
+        return done_;
+    }
+
+    float Profile::position() const
+    {
+        return position_;
+    }
+
+    float Profile::distance() const
+    {
+        return distance_;
+    }
+
+    float Profile::velocity() const
+    {
+        return velocity_;
+    }
+}
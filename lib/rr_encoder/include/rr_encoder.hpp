@@ -0,0 +1,240 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_ENCODER_HPP
+#define RR_ENCODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_pose.hpp>
+
+/**
+ * On the nRF52840 every edge of both encoder channels is routed by GPIOTE and PPI into the COUNT task of a
+ * TIMER in counter mode, so edges are counted by hardware without any CPU involvement. Elsewhere the counters
+ * are plain variables, advanced by mock_edges() or SyntheticTicks.
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define RR_ENCODER_HW 1
+#else
+#define RR_ENCODER_HW 0
+#endif
+
+/**
+ * Encoder channels, nRF GPIO numbers. Defaults are D6 (P1.14), D7 (P0.23), D8 (P0.21), and D9 (P0.27).
+ */
+#ifndef RR_ENCODER_LEFT_A_PIN
+#define RR_ENCODER_LEFT_A_PIN 46
+#endif
+
+#ifndef RR_ENCODER_LEFT_B_PIN
+#define RR_ENCODER_LEFT_B_PIN 23
+#endif
+
+#ifndef RR_ENCODER_RIGHT_A_PIN
+#define RR_ENCODER_RIGHT_A_PIN 21
+#endif
+
+#ifndef RR_ENCODER_RIGHT_B_PIN
+#define RR_ENCODER_RIGHT_B_PIN 27
+#endif
+
+/**
+ * First of four GPIOTE, and four PPI channels used by the encoders.
+ */
+#ifndef RR_ENCODER_GPIOTE_BASE
+#define RR_ENCODER_GPIOTE_BASE 4
+#endif
+
+#ifndef RR_ENCODER_PPI_BASE
+#define RR_ENCODER_PPI_BASE 8
+#endif
+
+/**
+ * Velocity is estimated over the last RR_ENCODER_VELOCITY_WINDOW updates that are at least
+ * RR_ENCODER_VELOCITY_MIN_US apart.
+ */
+#ifndef RR_ENCODER_VELOCITY_WINDOW
+#define RR_ENCODER_VELOCITY_WINDOW 8
+#endif
+
+#ifndef RR_ENCODER_VELOCITY_MIN_US
+#define RR_ENCODER_VELOCITY_MIN_US 1000
+#endif
+
+/**
+ * A change of commanded direction is taken for the edge sign once the speed estimate is below
+ * RR_ENCODER_REVERSE_TICKS_PER_S, a braking wheel keeps turning the old way until it has nearly stopped.
+ */
+#ifndef RR_ENCODER_REVERSE_TICKS_PER_S
+#define RR_ENCODER_REVERSE_TICKS_PER_S 200
+#endif
+
+namespace rr_encoder
+{
+    static constexpr size_t LEFT = 0;
+    static constexpr size_t RIGHT = 1;
+    static constexpr size_t WHEELS = 2;
+
+    /**
+     * Wheel speed in ticks per second, and the micros() time it was estimated at.
+     */
+    struct Velocity
+    {
+        float ticks_per_s;
+        std::uint32_t timestamp_us;
+    };
+
+    /**
+     * @class Encoders
+     * @brief hardware counted wheel encoders.
+     *
+     * Both edges of both channels are counted, giving four ticks per encoder cycle, the same resolution as
+     * quadrature decoding. Edge counters do not know direction, so edges are signed with the direction of the
+     * motor command (set_direction()). A reversed command brakes the wheel before turning it the other way, so
+     * the new sign is only taken once the wheel has nearly stopped, edges until then are attributed to the old
+     * direction.
+     *
+     * update() folds new edges into the signed totals, and is safe to call from both the main loop, and the
+     * control interrupt. Totals are cumulative, and allowed to wrap.
+     */
+    class Encoders : public rr_pose::TickSource
+    {
+    public:
+        Encoders(const Encoders &) = delete;
+        Encoders &operator=(const Encoders &) = delete;
+
+        static Encoders &get_instance();
+
+        /**
+         * @fn begin
+         * @brief configures GPIOTE, PPI, and TIMER2 / TIMER3 counters, and clears totals.
+         */
+        bool begin();
+
+        bool ready() const;
+
+        /**
+         * @fn set_direction
+         * @brief commanded direction of wheel, dir > 0 is forwards, applied to edges once the wheel is below
+         * RR_ENCODER_REVERSE_TICKS_PER_S.
+         */
+        void set_direction(size_t wheel, int dir);
+
+        /**
+         * @fn update
+         * @brief folds edges counted since the last update into the totals, and the velocity estimate.
+         */
+        void update();
+
+        /**
+         * @fn read_ticks
+         * @brief update(), then returns the totals. false until begin() has been called.
+         */
+        bool read_ticks(std::int32_t &left, std::int32_t &right) override;
+
+        /**
+         * @fn ticks
+         * @brief total at the last update.
+         */
+        std::int32_t ticks(size_t wheel) const;
+
+        /**
+         * @fn velocity
+         * @brief latest velocity estimate, zero until two updates have been made.
+         */
+        Velocity velocity(size_t wheel) const;
+
+#if !RR_ENCODER_HW
+        /**
+         * @fn mock_edges
+         * @brief counts edges on wheel, as the hardware counter would.
+         */
+        void mock_edges(size_t wheel, std::uint32_t edges);
+#endif
+
+    private:
+        bool ready_ = false;
+
+        // hardware counter at the last update
+        std::uint32_t last_count_[WHEELS] = {0, 0};
+        std::int32_t total_[WHEELS] = {0, 0};
+        int dir_[WHEELS] = {1, 1};
+        // commanded direction, taken for dir_ when the wheel has nearly stopped
+        int command_[WHEELS] = {1, 1};
+
+        struct Sample
+        {
+            std::uint32_t us;
+            std::int32_t total[WHEELS];
+        };
+        Sample window_[RR_ENCODER_VELOCITY_WINDOW];
+        size_t head_ = 0;
+        size_t filled_ = 0;
+        Velocity velocity_[WHEELS] = {{0.0f, 0}, {0.0f, 0}};
+
+#if !RR_ENCODER_HW
+        std::uint32_t mock_count_[WHEELS] = {0, 0};
+#endif
+
+        Encoders() = default;
+
+        /*
+         * backend, free running edge count of wheel.
+         */
+        std::uint32_t count(size_t wheel);
+
+        /*
+         * update() with interrupts already masked.
+         */
+        void update_locked();
+
+        /*
+         * adds a velocity sample at now_us, unless the last one is closer than RR_ENCODER_VELOCITY_MIN_US.
+         */
+        void sample_velocity(std::uint32_t now_us);
+    };
+
+#if !RR_ENCODER_HW
+    /**
+     * @class SyntheticTicks
+     * @brief generates the edge stream of a wheel moving at a given speed, for native tests.
+     *
+     * Fractional edges are carried between calls, so long runs produce exactly speed * time edges.
+     */
+    class SyntheticTicks
+    {
+    private:
+        size_t wheel_;
+        double pending_ = 0.0;
+
+    public:
+        explicit SyntheticTicks(size_t wheel) : wheel_(wheel) {}
+
+        /**
+         * @fn advance
+         * @brief generates the edges of dt seconds at ticks_per_s, and sets direction from its sign.
+         */
+        void advance(float ticks_per_s, float dt);
+    };
+#endif
+}
+
+#endif // RR_ENCODER_HPP
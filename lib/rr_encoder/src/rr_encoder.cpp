@@ -0,0 +1,268 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_encoder.hpp>
+
+#include <Arduino.h>
+
+#if RR_ENCODER_HW
+#include <nrf.h>
+#endif
+
+namespace rr_encoder
+{
+    namespace
+    {
+        /*
+         * masks interrupts for the lifetime of the guard, restoring the previous state rather than unconditionally
+         * enabling, as update() is called from both interrupt and thread context.
+         */
+        class IrqGuard
+        {
+#if RR_ENCODER_HW
+            std::uint32_t primask_;
+
+        public:
+            IrqGuard() : primask_(__get_PRIMASK()) { __disable_irq(); }
+            ~IrqGuard() { __set_PRIMASK(primask_); }
+#else
+        public:
+            IrqGuard() {}
+#endif
+        };
+
+#if RR_ENCODER_HW
+        NRF_TIMER_Type *const TIMERS[WHEELS] = {NRF_TIMER2, NRF_TIMER3};
+        const std::uint8_t PINS[WHEELS][2] = {{RR_ENCODER_LEFT_A_PIN, RR_ENCODER_LEFT_B_PIN},
+                                              {RR_ENCODER_RIGHT_A_PIN, RR_ENCODER_RIGHT_B_PIN}};
+#endif
+    }
+
+    Encoders &Encoders::get_instance()
+    {
+        static Encoders instance;
+        return instance;
+    }
+
+    bool Encoders::begin()
+    {
+#if RR_ENCODER_HW
+        for (size_t w = 0; w < WHEELS; w++)
+        {
+            NRF_TIMER_Type *timer = TIMERS[w];
+            timer->TASKS_STOP = 1;
+            timer->MODE = TIMER_MODE_MODE_LowPowerCounter << TIMER_MODE_MODE_Pos;
+            timer->BITMODE = TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos;
+            timer->SHORTS = 0;
+            timer->INTENCLR = 0xFFFFFFFF;
+            timer->TASKS_CLEAR = 1;
+
+            for (size_t c = 0; c < 2; c++)
+            {
+                std::uint32_t pin = PINS[w][c];
+                std::uint32_t gpiote = RR_ENCODER_GPIOTE_BASE + w * 2 + c;
+                std::uint32_t ppi = RR_ENCODER_PPI_BASE + w * 2 + c;
+
+                NRF_GPIO_Type *port = (pin >> 5) ? NRF_P1 : NRF_P0;
+                port->PIN_CNF[pin & 0x1F] = (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos) |
+                                            (GPIO_PIN_CNF_INPUT_Connect << GPIO_PIN_CNF_INPUT_Pos) |
+                                            (GPIO_PIN_CNF_PULL_Pullup << GPIO_PIN_CNF_PULL_Pos);
+
+                NRF_GPIOTE->CONFIG[gpiote] = (GPIOTE_CONFIG_MODE_Event << GPIOTE_CONFIG_MODE_Pos) |
+                                             ((pin & 0x1F) << GPIOTE_CONFIG_PSEL_Pos) |
+                                             ((pin >> 5) << GPIOTE_CONFIG_PORT_Pos) |
+                                             (GPIOTE_CONFIG_POLARITY_Toggle << GPIOTE_CONFIG_POLARITY_Pos);
+                NRF_GPIOTE->EVENTS_IN[gpiote] = 0;
+
+                NRF_PPI->CH[ppi].EEP = reinterpret_cast<std::uint32_t>(&NRF_GPIOTE->EVENTS_IN[gpiote]);
+                NRF_PPI->CH[ppi].TEP = reinterpret_cast<std::uint32_t>(&timer->TASKS_COUNT);
+                NRF_PPI->CHENSET = 1UL << ppi;
+            }
+            timer->TASKS_START = 1;
+        }
+#endif
+
+        IrqGuard guard;
+        for (size_t w = 0; w < WHEELS; w++)
+        {
+            last_count_[w] = count(w);
+            total_[w] = 0;
+            dir_[w] = 1;
+            command_[w] = 1;
+            velocity_[w] = {0.0f, 0};
+        }
+        head_ = 0;
+        filled_ = 0;
+        ready_ = true;
+        return true;
+    }
+
+    bool Encoders::ready() const
+    {
+        return ready_;
+    }
+
+    std::uint32_t Encoders::count(size_t wheel)
+    {
+#if RR_ENCODER_HW
+        TIMERS[wheel]->TASKS_CAPTURE[0] = 1;
+        return TIMERS[wheel]->CC[0];
+#else
+        return mock_count_[wheel];
+#endif
+    }
+
+    void Encoders::set_direction(size_t wheel, int dir)
+    {
+        if (wheel >= WHEELS || dir == 0)
+        {
+            return;
+        }
+
+        IrqGuard guard;
+        command_[wheel] = dir > 0 ? 1 : -1;
+        if (command_[wheel] != dir_[wheel])
+        {
+            // edges up to now belong to the old direction, update() takes the new one if the wheel is at rest.
+            update_locked();
+        }
+    }
+
+    void Encoders::update()
+    {
+        IrqGuard guard;
+        update_locked();
+    }
+
+    void Encoders::update_locked()
+    {
+        if (!ready_)
+        {
+            return;
+        }
+
+        for (size_t w = 0; w < WHEELS; w++)
+        {
+            std::uint32_t now = count(w);
+            std::uint32_t edges = now - last_count_[w];
+            last_count_[w] = now;
+            total_[w] = static_cast<std::int32_t>(static_cast<std::uint32_t>(total_[w]) +
+                                                  static_cast<std::uint32_t>(dir_[w]) * edges);
+        }
+
+        sample_velocity(micros());
+        for (size_t w = 0; w < WHEELS; w++)
+        {
+            float speed = velocity_[w].ticks_per_s;
+            if (dir_[w] != command_[w] && speed < RR_ENCODER_REVERSE_TICKS_PER_S &&
+                speed > -RR_ENCODER_REVERSE_TICKS_PER_S)
+            {
+                dir_[w] = command_[w];
+            }
+        }
+    }
+
+    void Encoders::sample_velocity(std::uint32_t now_us)
+    {
+        if (filled_ > 0)
+        {
+            const Sample &last = window_[(head_ + RR_ENCODER_VELOCITY_WINDOW - 1) % RR_ENCODER_VELOCITY_WINDOW];
+            if (now_us - last.us < RR_ENCODER_VELOCITY_MIN_US)
+            {
+                return;
+            }
+        }
+
+        Sample &sample = window_[head_];
+        sample.us = now_us;
+        sample.total[LEFT] = total_[LEFT];
+        sample.total[RIGHT] = total_[RIGHT];
+        head_ = (head_ + 1) % RR_ENCODER_VELOCITY_WINDOW;
+        if (filled_ < RR_ENCODER_VELOCITY_WINDOW)
+        {
+            filled_++;
+        }
+        if (filled_ < 2)
+        {
+            return;
+        }
+
+        // oldest sample in the window.
+        const Sample &oldest = window_[(head_ + RR_ENCODER_VELOCITY_WINDOW - filled_) % RR_ENCODER_VELOCITY_WINDOW];
+        float dt = static_cast<float>(now_us - oldest.us) * 1e-6f;
+        for (size_t w = 0; w < WHEELS; w++)
+        {
+            std::int32_t delta = static_cast<std::int32_t>(static_cast<std::uint32_t>(sample.total[w]) -
+                                                           static_cast<std::uint32_t>(oldest.total[w]));
+            velocity_[w].ticks_per_s = static_cast<float>(delta) / dt;
+            velocity_[w].timestamp_us = now_us;
+        }
+    }
+
+    bool Encoders::read_ticks(std::int32_t &left, std::int32_t &right)
+    {
+        if (!ready_)
+        {
+            return false;
+        }
+
+        IrqGuard guard;
+        update_locked();
+        left = total_[LEFT];
+        right = total_[RIGHT];
+        return true;
+    }
+
+    std::int32_t Encoders::ticks(size_t wheel) const
+    {
+        return wheel < WHEELS ? total_[wheel] : 0;
+    }
+
+    Velocity Encoders::velocity(size_t wheel) const
+    {
+        IrqGuard guard;
+        return wheel < WHEELS ? velocity_[wheel] : Velocity{0.0f, 0};
+    }
+
+#if !RR_ENCODER_HW
+    void Encoders::mock_edges(size_t wheel, std::uint32_t edges)
+    {
+        if (wheel < WHEELS)
+        {
+            mock_count_[wheel] += edges;
+        }
+    }
+
+    void SyntheticTicks::advance(float ticks_per_s, float dt)
+    {
+        Encoders &encoders = Encoders::get_instance();
+        if (ticks_per_s != 0.0f)
+        {
+            encoders.set_direction(wheel_, ticks_per_s > 0.0f ? 1 : -1);
+        }
+
+        pending_ += static_cast<double>(ticks_per_s < 0.0f ? -ticks_per_s : ticks_per_s) * dt;
+        std::uint32_t edges = static_cast<std::uint32_t>(pending_);
+        pending_ -= edges;
+        encoders.mock_edges(wheel_, edges);
+    }
+#endif
+}
@@ -0,0 +1,164 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_FILTER_HPP
+#define RR_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_math.hpp>
+
+namespace rr_filter
+{
+    /**
+     * @fn design_lowpass
+     * @brief designs a Hamming windowed-sinc low pass filter with unity DC gain.
+     *
+     * @param taps number of coefficients to populate, should be odd.
+     * @param cutoff cutoff frequency as a fraction of the input sample rate (0 .. 0.5)
+     * @param coeffs output, at least taps long.
+     */
+    void design_lowpass(size_t taps, float cutoff, float *coeffs);
+
+    /**
+     * @class FirDecimator
+     * @brief anti-aliasing FIR filter and decimator for CHANNELS interleaved signals.
+     *
+     * Samples are pushed at the input (sensor) rate, and one filtered sample is produced every factor
+     * inputs. The filter is only evaluated when an output is due, so cost is taps * CHANNELS multiply
+     * accumulates per output sample.
+     *
+     * Memory is fixed at compile time by MAX_TAPS, nothing is allocated at runtime.
+     */
+    template <size_t CHANNELS, size_t MAX_TAPS>
+    class FirDecimator
+    {
+    private:
+        float coeffs_[MAX_TAPS];
+        float history_[MAX_TAPS][CHANNELS];
+        size_t taps_ = 1;
+        size_t head_ = 0;
+        std::uint16_t factor_ = 1;
+        std::uint16_t count_ = 0;
+
+    public:
+        FirDecimator()
+        {
+            configure(1);
+        }
+
+        /**
+         * @fn configure
+         * @brief sets decimation factor, and redesigns the filter. Clears history.
+         *
+         * Cutoff is placed at 80% of the output Nyquist frequency, a factor of 1 is a pass through.
+         *
+         * @return false if factor is zero.
+         */
+        bool configure(std::uint16_t factor)
+        {
+            if (factor == 0)
+            {
+                return false;
+            }
+            factor_ = factor;
+            if (factor == 1)
+            {
+                taps_ = 1;
+                coeffs_[0] = 1.0f;
+            }
+            else
+            {
+                size_t taps = 4 * static_cast<size_t>(factor) + 1;
+                size_t max_odd = (MAX_TAPS % 2) ? MAX_TAPS : MAX_TAPS - 1;
+                taps_ = taps < max_odd ? taps : max_odd;
+                design_lowpass(taps_, 0.4f / static_cast<float>(factor), coeffs_);
+            }
+            reset();
+            return true;
+        }
+
+        /**
+         * @fn reset
+         * @brief clears history, and decimation phase.
+         */
+        void reset()
+        {
+            for (size_t i = 0; i < MAX_TAPS; i++)
+            {
+                for (size_t c = 0; c < CHANNELS; c++)
+                {
+                    history_[i][c] = 0.0f;
+                }
+            }
+            head_ = 0;
+            count_ = 0;
+        }
+
+        /**
+         * @fn push
+         * @brief adds one input sample, and when an output is due populates out.
+         *
+         * @return true when out has been populated.
+         */
+        bool push(const float (&in)[CHANNELS], float (&out)[CHANNELS])
+        {
+            head_ = head_ + 1 < taps_ ? head_ + 1 : 0;
+            for (size_t c = 0; c < CHANNELS; c++)
+            {
+                history_[head_][c] = in[c];
+            }
+
+            if (++count_ < factor_)
+            {
+                return false;
+            }
+            count_ = 0;
+
+            for (size_t c = 0; c < CHANNELS; c++)
+            {
+                out[c] = 0.0f;
+            }
+            size_t idx = head_;
+            for (size_t k = 0; k < taps_; k++)
+            {
+                for (size_t c = 0; c < CHANNELS; c++)
+                {
+                    out[c] += coeffs_[k] * history_[idx][c];
+                }
+                idx = idx == 0 ? taps_ - 1 : idx - 1;
+            }
+            return true;
+        }
+
+        std::uint16_t factor() const
+        {
+            return factor_;
+        }
+
+        size_t taps() const
+        {
+            return taps_;
+        }
+    };
+}
+
+#endif // RR_FILTER_HPP
@@ -0,0 +1,340 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_MEDIAN_HPP
+#define RR_MEDIAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rr_filter
+{
+    /**
+     * @class SlidingMedian
+     * @brief median of the last N samples, O(log N) per sample.
+     *
+     * Samples are kept in a ring, and indexed by two heaps: a max heap of the lower half, and a min heap of the
+     * upper half, so the median sits on the heap tops. Once the window is full a new sample overwrites the
+     * oldest in place, so its heap entry is only sifted, and the heap sizes never change.
+     *
+     * Memory is fixed at compile time by N, nothing is allocated at runtime.
+     */
+    template <size_t N>
+    class SlidingMedian
+    {
+        static_assert(N >= 1, "window must hold a sample");
+
+    private:
+        static constexpr std::uint8_t LO = 0;
+        static constexpr std::uint8_t HI = 1;
+        static constexpr size_t HALF = N / 2 + 1;
+
+        float value_[N];
+        // heap, and position in it, of each ring slot.
+        std::uint8_t heap_of_[N];
+        size_t pos_[N];
+        // ring slots, lo_ holds one more than hi_ when the count is odd.
+        size_t heap_[2][HALF];
+        size_t size_[2] = {0, 0};
+        size_t head_ = 0;
+        size_t count_ = 0;
+
+        /*
+         * true if the sample at slot a belongs above slot b in heap h.
+         */
+        bool above(std::uint8_t h, size_t a, size_t b) const
+        {
+            return h == LO ? value_[a] > value_[b] : value_[a] < value_[b];
+        }
+
+        void place(std::uint8_t h, size_t i, size_t slot)
+        {
+            heap_[h][i] = slot;
+            heap_of_[slot] = h;
+            pos_[slot] = i;
+        }
+
+        void swap(std::uint8_t h, size_t i, size_t j)
+        {
+            size_t a = heap_[h][i];
+            place(h, i, heap_[h][j]);
+            place(h, j, a);
+        }
+
+        bool sift_up(std::uint8_t h, size_t i)
+        {
+            bool moved = false;
+            while (i > 0)
+            {
+                size_t parent = (i - 1) / 2;
+                if (!above(h, heap_[h][i], heap_[h][parent]))
+                {
+                    break;
+                }
+                swap(h, i, parent);
+                i = parent;
+                moved = true;
+            }
+            return moved;
+        }
+
+        void sift_down(std::uint8_t h, size_t i)
+        {
+            for (;;)
+            {
+                size_t best = i;
+                size_t l = 2 * i + 1;
+                size_t r = l + 1;
+                if (l < size_[h] && above(h, heap_[h][l], heap_[h][best]))
+                {
+                    best = l;
+                }
+                if (r < size_[h] && above(h, heap_[h][r], heap_[h][best]))
+                {
+                    best = r;
+                }
+                if (best == i)
+                {
+                    return;
+                }
+                swap(h, i, best);
+                i = best;
+            }
+        }
+
+    public:
+        SlidingMedian()
+        {
+            reset();
+        }
+
+        /**
+         * @fn reset
+         * @brief empties the window.
+         */
+        void reset()
+        {
+            size_[LO] = 0;
+            size_[HI] = 0;
+            head_ = 0;
+            count_ = 0;
+        }
+
+        /**
+         * @fn push
+         * @brief adds x to the window, dropping the oldest sample once it holds N.
+         */
+        void push(float x)
+        {
+            size_t slot = head_;
+            head_ = head_ + 1 < N ? head_ + 1 : 0;
+            value_[slot] = x;
+
+            if (count_ < N)
+            {
+                count_++;
+                std::uint8_t h = size_[LO] <= size_[HI] ? LO : HI;
+                place(h, size_[h]++, slot);
+                sift_up(h, pos_[slot]);
+            }
+            else
+            {
+                // the oldest sample's entry now holds x.
+                std::uint8_t h = heap_of_[slot];
+                if (!sift_up(h, pos_[slot]))
+                {
+                    sift_down(h, pos_[slot]);
+                }
+            }
+
+            // only the changed entry can have crossed the halves, one exchange of the tops restores the order.
+            if (size_[HI] > 0 && value_[heap_[LO][0]] > value_[heap_[HI][0]])
+            {
+                size_t lo = heap_[LO][0];
+                place(LO, 0, heap_[HI][0]);
+                place(HI, 0, lo);
+                sift_down(LO, 0);
+                sift_down(HI, 0);
+            }
+        }
+
+        /**
+         * @fn median
+         * @brief median of the window, the mean of the middle two for an even count. 0 when empty.
+         */
+        float median() const
+        {
+            if (count_ == 0)
+            {
+                return 0.0f;
+            }
+            if (size_[LO] > size_[HI])
+            {
+                return value_[heap_[LO][0]];
+            }
+            return 0.5f * (value_[heap_[LO][0]] + value_[heap_[HI][0]]);
+        }
+
+        size_t count() const
+        {
+            return count_;
+        }
+
+        bool full() const
+        {
+            return count_ == N;
+        }
+    };
+
+    /**
+     * @class Hampel
+     * @brief streaming Hampel outlier filter over the last N samples, O(log N) per sample.
+     *
+     * Each sample is compared with the median of the window, a sample further than k scaled median absolute
+     * deviations (MAD) from it is an outlier, and replaced by the median. Inliers pass unchanged, so a real
+     * step is followed as soon as it holds most of the window.
+     *
+     * The MAD is the median of each sample's deviation from the window median at the time it arrived, rather
+     * than from the current median, so that it can be kept by a second SlidingMedian instead of being
+     * recomputed over the window. min_scale keeps a window of identical samples from rejecting every change.
+     *
+     * Samples can be pushed as not valid (for instance a ping without an echo, pushed at the maximum range),
+     * they take part in the median, but never count towards confidence().
+     */
+    template <size_t N>
+    class Hampel
+    {
+    private:
+        // MAD to standard deviation, for normally distributed samples.
+        static constexpr float MAD_SCALE = 1.4826f;
+
+        SlidingMedian<N> values_;
+        SlidingMedian<N> deviations_;
+        // 1 for samples that were valid inliers, and their total.
+        std::uint8_t good_[N];
+        size_t good_count_ = 0;
+        size_t head_ = 0;
+
+        float k_;
+        float min_scale_;
+        float value_ = 0.0f;
+        bool outlier_ = false;
+
+    public:
+        /**
+         * @param k rejection threshold in scaled MADs, 3 is the usual choice.
+         * @param min_scale lower bound of the scaled MAD, in the units of the samples.
+         */
+        Hampel(float k = 3.0f, float min_scale = 0.0f)
+        {
+            configure(k, min_scale);
+        }
+
+        /**
+         * @fn configure
+         * @brief sets the rejection threshold and scale floor, see Hampel(). Empties the window.
+         */
+        void configure(float k, float min_scale)
+        {
+            k_ = k;
+            min_scale_ = min_scale;
+            reset();
+        }
+
+        /**
+         * @fn reset
+         * @brief empties the window.
+         */
+        void reset()
+        {
+            values_.reset();
+            deviations_.reset();
+            for (size_t i = 0; i < N; i++)
+            {
+                good_[i] = 0;
+            }
+            good_count_ = 0;
+            head_ = 0;
+            value_ = 0.0f;
+            outlier_ = false;
+        }
+
+        /**
+         * @fn push
+         * @brief filters x, and returns the filtered value. Nothing is rejected until the window holds three
+         * samples.
+         */
+        float push(float x, bool valid = true)
+        {
+            values_.push(x);
+            float median = values_.median();
+            float deviation = x > median ? x - median : median - x;
+            deviations_.push(deviation);
+
+            float scale = MAD_SCALE * deviations_.median();
+            scale = scale > min_scale_ ? scale : min_scale_;
+            outlier_ = values_.count() >= 3 && deviation > k_ * scale;
+            value_ = outlier_ ? median : x;
+
+            std::uint8_t good = valid && !outlier_ ? 1 : 0;
+            good_count_ = good_count_ - good_[head_] + good;
+            good_[head_] = good;
+            head_ = head_ + 1 < N ? head_ + 1 : 0;
+            return value_;
+        }
+
+        /**
+         * @fn value
+         * @brief last filtered value.
+         */
+        float value() const
+        {
+            return value_;
+        }
+
+        /**
+         * @fn outlier
+         * @brief true if the last sample was rejected.
+         */
+        bool outlier() const
+        {
+            return outlier_;
+        }
+
+        float median() const
+        {
+            return values_.median();
+        }
+
+        /**
+         * @fn confidence
+         * @brief fraction of the window (0 .. 1) taken by valid samples that were not rejected. A window still
+         * filling counts its empty slots as bad.
+         */
+        float confidence() const
+        {
+            return static_cast<float>(good_count_) / static_cast<float>(N);
+        }
+    };
+}
+
+#endif // RR_MEDIAN_HPP
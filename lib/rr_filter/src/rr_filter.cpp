@@ -0,0 +1,67 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_filter.hpp>
+
+namespace rr_filter
+{
+    void design_lowpass(size_t taps, float cutoff, float *coeffs)
+    {
+        if (taps == 0)
+        {
+            return;
+        }
+        if (taps == 1)
+        {
+            coeffs[0] = 1.0f;
+            return;
+        }
+
+        float centre = 0.5f * static_cast<float>(taps - 1);
+        float sum = 0.0f;
+        for (size_t i = 0; i < taps; i++)
+        {
+            float n = static_cast<float>(i) - centre;
+            float s, c;
+
+            // sinc(2 fc n)
+            float h = 2.0f * cutoff;
+            if (n != 0.0f)
+            {
+                rr_math::sin_cos(rr_math::TWO_PI * cutoff * n, &s, &c);
+                h = s / (rr_math::PI * n);
+            }
+
+            // Hamming window
+            rr_math::sin_cos(rr_math::TWO_PI * static_cast<float>(i) / static_cast<float>(taps - 1), &s, &c);
+            h *= 0.54f - 0.46f * c;
+
+            coeffs[i] = h;
+            sum += h;
+        }
+
+        // unity gain at DC
+        for (size_t i = 0; i < taps; i++)
+        {
+            coeffs[i] /= sum;
+        }
+    }
+}
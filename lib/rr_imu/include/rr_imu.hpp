@@ -30,19 +30,58 @@
 #include "pb_encode.h"
 #include "pb_decode.h"
 #include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
 #include "math.h"
 #include <mb_operations.hpp>
 #include <MadgwickAHRS.h>
 #include <rr_ble.hpp>
+#include <rr_math.hpp>
+#include <rr_filter.hpp>
+#include <rr_pose.hpp>
+#include <rr_sensor_bus.hpp>
+
+/**
+ * Sensor output data rate (Hz), one of 100, 200, 400, 800, or 1600.
+ */
+#ifndef RR_IMU_SENSOR_ODR_HZ
+#define RR_IMU_SENSOR_ODR_HZ 400
+#endif
+
+/**
+ * Fused output rate (Hz), must divide RR_IMU_SENSOR_ODR_HZ by at most RR_IMU_MAX_DECIMATION.
+ */
+#ifndef RR_IMU_OUTPUT_HZ
+#define RR_IMU_OUTPUT_HZ 100
+#endif
+
+#define RR_IMU_MAX_DECIMATION 16
+
+/**
+ * GPIO connected to BMI270 INT1, which is configured as a push-pull, active high, data ready pulse.
+ */
+#ifndef RR_IMU_INT_PIN
+#ifdef ARDUINO
+#define RR_IMU_INT_PIN P0_11
+#else
+#define RR_IMU_INT_PIN 0
+#endif
+#endif
+
+/**
+ * If no data ready interrupt arrives within this many milliseconds the IMU is reported as NOT_AVAILABLE.
+ */
+#ifndef RR_IMU_STALE_MS
+#define RR_IMU_STALE_MS 50
+#endif
 
 namespace mb_operations
 {
 
     /**
      * @class RRImu
-     * @brief responds to IMU op codes.
+     * @brief responds to IMU op codes, and is the heading reference for heading-hold.
      */
-    class RRImuOpHandler : public mb_operations::MbOperationHandler
+    class RRImuOpHandler : public mb_operations::MbOperationHandler, public rr_pose::HeadingSource
     {
 
     private:
@@ -50,8 +89,55 @@ namespace mb_operations
 
         org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
 
-        unsigned long last_update_ms_ = 0;
-        static constexpr unsigned long UPDATE_INTERVAL_MS = 10; // 100Hz to match Madgwick filter
+        // gyroscope x, y, z, then accelerometer x, y, z
+        static constexpr size_t IMU_CHANNELS = 6;
+
+        // 33 taps gives the full 4 * factor + 1 filter up to a decimation of 8, higher factors are capped.
+        rr_filter::FirDecimator<IMU_CHANNELS, 33> decimator_;
+
+        // latest decimated sample, this is what the filter and monitor requests see.
+        float sample_[IMU_CHANNELS] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+        // filter yaw (rad) after the latest update, a single word so the control interrupt can read it.
+        volatile float yaw_ = 0.0f;
+
+        std::uint16_t sensor_odr_hz_ = RR_IMU_SENSOR_ODR_HZ;
+        std::uint16_t output_hz_ = RR_IMU_OUTPUT_HZ;
+
+        // incremented by on_data_ready() in interrupt context, and only read elsewhere.
+        static volatile std::uint32_t drdy_count_;
+
+        // drdy_count_ value at the last sample that was read.
+        std::uint32_t drdy_seen_ = 0;
+
+        // samples that were signalled but overwritten before service() could read them.
+        std::uint32_t missed_samples_ = 0;
+
+        unsigned long last_sample_ms_ = 0;
+
+        // accelerometer x, y, z then gyroscope x, y, z as little endian int16, filled by EasyDMA.
+        std::uint8_t raw_[12];
+        bool read_in_flight_ = false;
+
+        /*
+         * data ready ISR, MUST do nothing more than count.
+         */
+        static void on_data_ready();
+
+        /*
+         * sensor bus completion for raw_.
+         */
+        static void on_sample(void *ctx, bool ok);
+
+        /*
+         * queues a write of val to BMI270 register reg.
+         */
+        bool write_reg(std::uint8_t reg, std::uint8_t val);
+
+        /*
+         * writes sensor ODR to BMI270 ACC_CONF, and GYR_CONF registers.
+         */
+        bool write_odr(std::uint16_t sensor_odr_hz);
 
         // private methods
         void euler_to_quaternion(float roll, float pitch, float yaw,
@@ -75,6 +161,53 @@ namespace mb_operations
          */
         void init() override;
 
+        /**
+         * @fn configure
+         * @brief sets sensor output data rate, and fused output rate.
+         *
+         * The sensor is sampled at sensor_odr_hz, passed through an anti-aliasing FIR decimator, and the
+         * Madgwick filter is updated at output_hz. Can be called at any time after init().
+         *
+         * @param sensor_odr_hz one of 100, 200, 400, 800, or 1600
+         * @param output_hz must divide sensor_odr_hz, with a decimation factor of at most RR_IMU_MAX_DECIMATION
+         * @return false, leaving the current configuration in place, if the rates are not supported.
+         */
+        bool configure(std::uint16_t sensor_odr_hz, std::uint16_t output_hz);
+
+        std::uint16_t sensor_odr_hz() const;
+        std::uint16_t output_hz() const;
+
+        /**
+         * @fn service
+         * @brief reads the sensor once for each data ready interrupt, and updates the filter at the output rate.
+         *
+         * The sensor status register is never polled, if no interrupt is pending this returns immediately.
+         * Reads are a single 12 byte burst queued on the shared SensorBus, and the sample is processed when
+         * the bus completes it, so the CPU is not held for the I2C transfer.
+         */
+        void service() override;
+
+        /**
+         * @fn missed_samples
+         * @brief number of data ready interrupts that were not serviced before the next one arrived.
+         */
+        std::uint32_t missed_samples() const;
+
+        /**
+         * @fn yaw_rate
+         * @brief latest decimated gyroscope z rate in rad/s, counter clockwise positive.
+         *
+         * @return false, leaving rad_s untouched, if the IMU is not sampling.
+         */
+        bool yaw_rate(float &rad_s) const;
+
+        /**
+         * @fn read_heading
+         * @brief Madgwick filter yaw (rad), and yaw_rate(). The filter has no magnetometer, so yaw is relative to
+         * the heading at start up, and drifts slowly with gyroscope bias.
+         */
+        bool read_heading(float &yaw, float &yaw_rate) override;
+
         /**
          * @fn perform_op
          * @brief set IMU data in accordance to org_ryderrobots_ros2_serial_MspRawImu
@@ -98,6 +231,12 @@ namespace mb_operations
          * solving a standard maze.
          */
         void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies imu_rate with configure(), if the request carries one, and reports the rates in use.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
     };
 }
 
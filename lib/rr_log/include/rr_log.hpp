@@ -0,0 +1,234 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_LOG_HPP
+#define RR_LOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A log is a 16 byte header followed by records, appended one after another, so a log is written with nothing but
+ * appends, and read straight out of memory, or a file mapped into it, without copying or parsing ahead. Every field
+ * is little endian.
+ *
+ *   header   0  "RRLG"
+ *            4  u16 version, VERSION
+ *            6  u16 header length, HEADER_LEN
+ *            8  u32 clock step of the recording (us), 0 for real time
+ *           12  u32 reserved, 0
+ *
+ *   record   0  u16 payload length
+ *            2  u8  type, RecordType
+ *            3  u8  channel
+ *            4  u64 time (us), micros() of the firmware that saw it
+ *           12  payload, then padding to a multiple of 4 bytes
+ *
+ * A record cut short, by a crash or a full disk, ends the log at the record before it.
+ */
+
+namespace rr_log
+{
+    static constexpr std::uint8_t MAGIC[4] = {'R', 'R', 'L', 'G'};
+    static constexpr std::uint16_t VERSION = 1;
+    static constexpr size_t HEADER_LEN = 16;
+    static constexpr size_t RECORD_HEADER_LEN = 12;
+    static constexpr size_t MAX_PAYLOAD = 0xFFFF;
+
+    /**
+     * What a record holds.
+     *
+     *   RT_RX     bytes the firmware received on its serial port, as they arrived.
+     *   RT_TX     bytes the firmware wrote to its serial port.
+     *   RT_IMU    the 12 byte BMI270 DATA_8 burst of one data ready pulse, acceleration then rates, int16 LSB.
+     *   RT_EDGES  u32 left, u32 right, encoder edges counted since the previous RT_EDGES.
+     *   RT_ECHO   u32 rise, u32 fall (us after the trigger) of the echo of the sensor on echo pin channel, fall 0
+     *             for none.
+     *   RT_NOTE   text, not used by replay.
+     */
+    enum RecordType : std::uint8_t
+    {
+        RT_RX = 1,
+        RT_TX = 2,
+        RT_IMU = 3,
+        RT_EDGES = 4,
+        RT_ECHO = 5,
+        RT_NOTE = 6,
+    };
+
+    /**
+     * A record as read, payload points into the log.
+     */
+    struct Record
+    {
+        std::uint64_t time_us;
+        std::uint8_t type;
+        std::uint8_t channel;
+        std::uint16_t length;
+        const std::uint8_t *payload;
+    };
+
+    /**
+     * @fn record_len
+     * @brief bytes a record of payload_len takes in the log, padding included.
+     */
+    size_t record_len(size_t payload_len);
+
+    void put_u32(std::uint8_t *out, std::uint32_t value);
+    std::uint32_t get_u32(const std::uint8_t *in);
+
+    /**
+     * @class Sink
+     * @brief where a Writer appends to. Records are built in place, in space the sink reserves at its end, so
+     * nothing is copied on the way.
+     */
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+
+        /**
+         * @fn reserve
+         * @brief len bytes at the end of the sink, nullptr if there is no room.
+         */
+        virtual std::uint8_t *reserve(size_t len) = 0;
+
+        /**
+         * @fn commit
+         * @brief appends the len bytes last reserved.
+         */
+        virtual void commit(size_t len) = 0;
+    };
+
+    /**
+     * @class BufferSink
+     * @brief appends to a buffer in memory, refusing what does not fit.
+     */
+    class BufferSink : public Sink
+    {
+    private:
+        std::uint8_t *buf_;
+        size_t capacity_;
+        size_t size_ = 0;
+
+    public:
+        BufferSink(std::uint8_t *buf, size_t capacity);
+
+        std::uint8_t *reserve(size_t len) override;
+        void commit(size_t len) override;
+
+        const std::uint8_t *data() const;
+        size_t size() const;
+        void clear();
+    };
+
+    /**
+     * @class Writer
+     * @brief appends records to a Sink, each whole or not at all.
+     *
+     * Records are not reordered, times are expected to be non decreasing but not checked. A record the sink has no
+     * room for is counted, and writing carries on.
+     */
+    class Writer
+    {
+    private:
+        Sink &sink_;
+        std::uint64_t records_ = 0;
+        std::uint64_t bytes_ = 0;
+        std::uint64_t failed_ = 0;
+
+    public:
+        explicit Writer(Sink &sink);
+
+        /**
+         * @fn begin
+         * @brief writes the header, step_us is the clock step of the recording, 0 for real time.
+         */
+        bool begin(std::uint32_t step_us);
+
+        /**
+         * @fn append
+         * @brief appends a record, false if length is over MAX_PAYLOAD, or the sink had no room for it.
+         */
+        bool append(RecordType type, std::uint8_t channel, std::uint64_t time_us, const void *payload, size_t length);
+
+        std::uint64_t records() const;
+        std::uint64_t bytes() const;
+        std::uint64_t failed() const;
+    };
+
+    /**
+     * @class Reader
+     * @brief reads the records of a log in memory, in order, without copying them.
+     */
+    class Reader
+    {
+    private:
+        const std::uint8_t *data_;
+        size_t size_;
+        size_t offset_ = 0;
+        std::uint32_t step_us_ = 0;
+        bool valid_ = false;
+
+    public:
+        /**
+         * The log must stay in place, and unchanged, while records read from it are in use.
+         */
+        Reader(const std::uint8_t *data, size_t size);
+
+        /**
+         * @fn valid
+         * @brief false if the header is not that of a log of this VERSION, there are no records then.
+         */
+        bool valid() const;
+
+        std::uint32_t step_us() const;
+
+        /**
+         * @fn peek
+         * @brief the next record, without moving past it. false at the end of the log.
+         */
+        bool peek(Record &record) const;
+
+        /**
+         * @fn next
+         * @brief the next record, and moves past it. false at the end of the log.
+         */
+        bool next(Record &record);
+
+        /**
+         * @fn rewind
+         * @brief back to the first record.
+         */
+        void rewind();
+
+        /**
+         * @fn truncated
+         * @brief true at the end of a log that ends in a record cut short.
+         */
+        bool truncated() const;
+
+        size_t offset() const;
+    };
+}
+
+#endif // RR_LOG_HPP
@@ -0,0 +1,116 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_LOG_FILE_HPP
+#define RR_LOG_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <rr_log.hpp>
+
+/**
+ * Logs are kept in files on the host, the simulator and native tests, where there is a file system to map them from.
+ */
+#if !defined(ARDUINO)
+#define RR_LOG_HOST 1
+#else
+#define RR_LOG_HOST 0
+#endif
+
+/**
+ * Bytes a FileSink collects before writing them out, at least MAX_PAYLOAD plus a record header.
+ */
+#ifndef RR_LOG_FILE_BUFFER
+#define RR_LOG_FILE_BUFFER (256 * 1024)
+#endif
+
+#if RR_LOG_HOST
+namespace rr_log
+{
+    /**
+     * @class FileSink
+     * @brief appends to a file, RR_LOG_FILE_BUFFER at a time, so a full rate stream costs a write call every few
+     * thousand records.
+     */
+    class FileSink : public Sink
+    {
+    private:
+        std::FILE *file_ = nullptr;
+        std::uint8_t *buf_ = nullptr;
+        size_t used_ = 0;
+        bool error_ = false;
+
+    public:
+        FileSink() = default;
+        FileSink(const FileSink &) = delete;
+        FileSink &operator=(const FileSink &) = delete;
+        ~FileSink() override;
+
+        /**
+         * @fn open
+         * @brief creates, or empties, the file at path.
+         */
+        bool open(const char *path);
+
+        /**
+         * @fn flush
+         * @brief writes out what has been collected, false once a write has failed.
+         */
+        bool flush();
+
+        /**
+         * @fn close
+         * @brief flushes, and closes the file.
+         */
+        bool close();
+
+        std::uint8_t *reserve(size_t len) override;
+        void commit(size_t len) override;
+    };
+
+    /**
+     * @class MappedFile
+     * @brief a log file mapped read only into memory, for a Reader.
+     */
+    class MappedFile
+    {
+    private:
+        const std::uint8_t *data_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        ~MappedFile();
+
+        bool open(const char *path);
+        void close();
+
+        const std::uint8_t *data() const;
+        size_t size() const;
+    };
+}
+#endif
+
+#endif // RR_LOG_FILE_HPP
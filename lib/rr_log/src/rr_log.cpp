@@ -0,0 +1,228 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_log.hpp>
+#include <cstring>
+
+namespace rr_log
+{
+    namespace
+    {
+        void put_u16(std::uint8_t *out, std::uint16_t value)
+        {
+            out[0] = static_cast<std::uint8_t>(value & 0xFF);
+            out[1] = static_cast<std::uint8_t>(value >> 8);
+        }
+
+        std::uint16_t get_u16(const std::uint8_t *in)
+        {
+            return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+        }
+
+        void put_u64(std::uint8_t *out, std::uint64_t value)
+        {
+            put_u32(out, static_cast<std::uint32_t>(value));
+            put_u32(out + 4, static_cast<std::uint32_t>(value >> 32));
+        }
+
+        std::uint64_t get_u64(const std::uint8_t *in)
+        {
+            return static_cast<std::uint64_t>(get_u32(in)) | (static_cast<std::uint64_t>(get_u32(in + 4)) << 32);
+        }
+    }
+
+    size_t record_len(size_t payload_len)
+    {
+        return (RECORD_HEADER_LEN + payload_len + 3) & ~static_cast<size_t>(3);
+    }
+
+    void put_u32(std::uint8_t *out, std::uint32_t value)
+    {
+        put_u16(out, static_cast<std::uint16_t>(value & 0xFFFF));
+        put_u16(out + 2, static_cast<std::uint16_t>(value >> 16));
+    }
+
+    std::uint32_t get_u32(const std::uint8_t *in)
+    {
+        return static_cast<std::uint32_t>(get_u16(in)) | (static_cast<std::uint32_t>(get_u16(in + 2)) << 16);
+    }
+
+    BufferSink::BufferSink(std::uint8_t *buf, size_t capacity) : buf_(buf), capacity_(capacity)
+    {
+    }
+
+    std::uint8_t *BufferSink::reserve(size_t len)
+    {
+        return buf_ != nullptr && len <= capacity_ - size_ ? buf_ + size_ : nullptr;
+    }
+
+    void BufferSink::commit(size_t len)
+    {
+        size_ += len;
+    }
+
+    const std::uint8_t *BufferSink::data() const
+    {
+        return buf_;
+    }
+
+    size_t BufferSink::size() const
+    {
+        return size_;
+    }
+
+    void BufferSink::clear()
+    {
+        size_ = 0;
+    }
+
+    Writer::Writer(Sink &sink) : sink_(sink)
+    {
+    }
+
+    bool Writer::begin(std::uint32_t step_us)
+    {
+        std::uint8_t *out = sink_.reserve(HEADER_LEN);
+        if (out == nullptr)
+        {
+            failed_++;
+            return false;
+        }
+        std::memcpy(out, MAGIC, sizeof(MAGIC));
+        put_u16(out + 4, VERSION);
+        put_u16(out + 6, static_cast<std::uint16_t>(HEADER_LEN));
+        put_u32(out + 8, step_us);
+        put_u32(out + 12, 0);
+        sink_.commit(HEADER_LEN);
+        bytes_ += HEADER_LEN;
+        return true;
+    }
+
+    bool Writer::append(RecordType type, std::uint8_t channel, std::uint64_t time_us, const void *payload,
+                        size_t length)
+    {
+        size_t len = record_len(length);
+        std::uint8_t *out = length <= MAX_PAYLOAD ? sink_.reserve(len) : nullptr;
+        if (out == nullptr)
+        {
+            failed_++;
+            return false;
+        }
+        put_u16(out, static_cast<std::uint16_t>(length));
+        out[2] = type;
+        out[3] = channel;
+        put_u64(out + 4, time_us);
+        if (length > 0)
+        {
+            std::memcpy(out + RECORD_HEADER_LEN, payload, length);
+        }
+        std::memset(out + RECORD_HEADER_LEN + length, 0, len - RECORD_HEADER_LEN - length);
+        sink_.commit(len);
+        records_++;
+        bytes_ += len;
+        return true;
+    }
+
+    std::uint64_t Writer::records() const
+    {
+        return records_;
+    }
+
+    std::uint64_t Writer::bytes() const
+    {
+        return bytes_;
+    }
+
+    std::uint64_t Writer::failed() const
+    {
+        return failed_;
+    }
+
+    Reader::Reader(const std::uint8_t *data, size_t size) : data_(data), size_(size)
+    {
+        valid_ = data_ != nullptr && size_ >= HEADER_LEN && std::memcmp(data_, MAGIC, sizeof(MAGIC)) == 0 &&
+                 get_u16(data_ + 4) == VERSION && get_u16(data_ + 6) == HEADER_LEN;
+        if (valid_)
+        {
+            step_us_ = get_u32(data_ + 8);
+        }
+        rewind();
+    }
+
+    bool Reader::valid() const
+    {
+        return valid_;
+    }
+
+    std::uint32_t Reader::step_us() const
+    {
+        return step_us_;
+    }
+
+    bool Reader::peek(Record &record) const
+    {
+        if (!valid_ || size_ - offset_ < RECORD_HEADER_LEN)
+        {
+            return false;
+        }
+        const std::uint8_t *p = data_ + offset_;
+        std::uint16_t length = get_u16(p);
+        if (size_ - offset_ < RECORD_HEADER_LEN + length)
+        {
+            return false;
+        }
+        record.length = length;
+        record.type = p[2];
+        record.channel = p[3];
+        record.time_us = get_u64(p + 4);
+        record.payload = p + RECORD_HEADER_LEN;
+        return true;
+    }
+
+    bool Reader::next(Record &record)
+    {
+        if (!peek(record))
+        {
+            return false;
+        }
+        // the padding of the last record may be missing, the log still ends there.
+        size_t len = record_len(record.length);
+        offset_ = len < size_ - offset_ ? offset_ + len : size_;
+        return true;
+    }
+
+    void Reader::rewind()
+    {
+        offset_ = valid_ ? HEADER_LEN : size_;
+    }
+
+    bool Reader::truncated() const
+    {
+        Record record;
+        return valid_ && offset_ < size_ && !peek(record);
+    }
+
+    size_t Reader::offset() const
+    {
+        return offset_;
+    }
+}
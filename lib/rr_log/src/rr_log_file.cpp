@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_log_file.hpp>
+
+#if RR_LOG_HOST
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace rr_log
+{
+    static_assert(RR_LOG_FILE_BUFFER >= RECORD_HEADER_LEN + MAX_PAYLOAD + 3, "RR_LOG_FILE_BUFFER can not hold a record");
+
+    FileSink::~FileSink()
+    {
+        close();
+    }
+
+    bool FileSink::open(const char *path)
+    {
+        close();
+        file_ = std::fopen(path, "wb");
+        if (file_ == nullptr)
+        {
+            return false;
+        }
+        buf_ = new std::uint8_t[RR_LOG_FILE_BUFFER];
+        used_ = 0;
+        error_ = false;
+        return true;
+    }
+
+    bool FileSink::flush()
+    {
+        if (file_ == nullptr)
+        {
+            return false;
+        }
+        if (used_ > 0 && std::fwrite(buf_, 1, used_, file_) != used_)
+        {
+            error_ = true;
+        }
+        used_ = 0;
+        if (std::fflush(file_) != 0)
+        {
+            error_ = true;
+        }
+        return !error_;
+    }
+
+    bool FileSink::close()
+    {
+        if (file_ == nullptr)
+        {
+            return false;
+        }
+        bool ok = flush();
+        ok = std::fclose(file_) == 0 && ok;
+        file_ = nullptr;
+        delete[] buf_;
+        buf_ = nullptr;
+        return ok;
+    }
+
+    std::uint8_t *FileSink::reserve(size_t len)
+    {
+        if (file_ == nullptr || error_ || len > RR_LOG_FILE_BUFFER)
+        {
+            return nullptr;
+        }
+        if (len > RR_LOG_FILE_BUFFER - used_ && !flush())
+        {
+            return nullptr;
+        }
+        return buf_ + used_;
+    }
+
+    void FileSink::commit(size_t len)
+    {
+        used_ += len;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    bool MappedFile::open(const char *path)
+    {
+        close();
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        // an empty file can not be mapped, it is an empty log.
+        void *data = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+        data_ = static_cast<const std::uint8_t *>(data);
+        size_ = size;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (data_ != nullptr)
+        {
+            munmap(const_cast<std::uint8_t *>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const std::uint8_t *MappedFile::data() const
+    {
+        return data_;
+    }
+
+    size_t MappedFile::size() const
+    {
+        return size_;
+    }
+}
+#endif
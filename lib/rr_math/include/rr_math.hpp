@@ -0,0 +1,147 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_MATH_HPP
+#define RR_MATH_HPP
+
+#include <cstdint>
+
+/**
+ * Math kernels shared by the IMU handler and filters.
+ *
+ * On the nRF52840 (Cortex-M4F) square roots are issued directly to the FPU with VSQRT.F32, on all other
+ * targets (native env) portable C++ implementations are used. Define RR_MATH_PORTABLE to force the portable
+ * kernels on target. Trigonometric kernels are polynomial approximations and do not call libm on either
+ * target.
+ *
+ * Measured error bounds are recorded in test/test_rr_math/README.md.
+ */
+#if defined(__ARM_FP) && (__ARM_FP & 0x4) && !defined(RR_MATH_PORTABLE)
+#define RR_MATH_ARM_FPU 1
+#else
+#define RR_MATH_ARM_FPU 0
+#endif
+
+namespace rr_math
+{
+    constexpr float PI = 3.14159265358979f;
+    constexpr float HALF_PI = 1.57079632679490f;
+    constexpr float TWO_PI = 6.28318530717959f;
+
+    struct Vec3
+    {
+        float x;
+        float y;
+        float z;
+    };
+
+    struct Quat
+    {
+        float w;
+        float x;
+        float y;
+        float z;
+    };
+
+    /**
+     * portable implementations, always compiled so that they can be compared against the dispatched
+     * kernels.
+     */
+    namespace portable
+    {
+        /**
+         * @fn inv_sqrt
+         * @brief bit level estimate refined by two Newton-Raphson iterations.
+         */
+        float inv_sqrt(float x);
+
+        /**
+         * @fn sqrt
+         * @brief x * inv_sqrt(x), returns 0 for x <= 0
+         */
+        float sqrt(float x);
+    }
+
+#if RR_MATH_ARM_FPU
+    namespace arm
+    {
+        float inv_sqrt(float x);
+
+        float sqrt(float x);
+    }
+#endif
+
+    /**
+     * @fn inv_sqrt
+     * @brief 1 / sqrt(x), dispatched to the FPU on target. Returns 0 for x <= 0.
+     */
+    float inv_sqrt(float x);
+
+    /**
+     * @fn sqrt
+     * @brief sqrt(x), dispatched to the FPU on target. Returns 0 for x <= 0.
+     */
+    float sqrt(float x);
+
+    /**
+     * @fn sin_cos
+     * @brief computes sine and cosine of angle (radians) in one pass.
+     */
+    void sin_cos(float angle, float *s, float *c);
+
+    /**
+     * @fn atan2
+     * @brief four quadrant arc tangent, result in [-PI, PI]
+     */
+    float atan2(float y, float x);
+
+    /**
+     * @fn wrap_pi
+     * @brief wraps angle (radians) into [-PI, PI]
+     */
+    float wrap_pi(float angle);
+
+    /**
+     * @fn normalise
+     * @brief scales v to unit length, returns false (leaving v untouched) when v has no length.
+     */
+    bool normalise(Vec3 &v);
+
+    /**
+     * @fn normalise
+     * @brief scales q to unit length, returns false (leaving q untouched) when q has no length.
+     */
+    bool normalise(Quat &q);
+
+    /**
+     * @fn multiply
+     * @brief Hamilton product a * b
+     */
+    Quat multiply(const Quat &a, const Quat &b);
+
+    /**
+     * @fn integrate
+     * @brief integrates body rate w (rad/s) over dt seconds into q, and renormalises q.
+     */
+    void integrate(Quat &q, const Vec3 &w, float dt);
+}
+
+#endif // RR_MATH_HPP
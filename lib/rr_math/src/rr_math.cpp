@@ -0,0 +1,233 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_math.hpp>
+#include <cstring>
+
+namespace rr_math
+{
+    namespace
+    {
+        // Hastings' coefficients for atan(z), z in [0, 1]
+        constexpr float ATAN_C1 = 0.9998660f;
+        constexpr float ATAN_C3 = -0.3302995f;
+        constexpr float ATAN_C5 = 0.1801410f;
+        constexpr float ATAN_C7 = -0.0851330f;
+        constexpr float ATAN_C9 = 0.0208351f;
+
+        /*
+         * sine for x in [-HALF_PI, HALF_PI], Taylor series to x^9 evaluated with Horner's method.
+         */
+        inline float sin_poly(float x)
+        {
+            float x2 = x * x;
+            return x * (1.0f + x2 * (-1.6666667e-1f + x2 * (8.3333333e-3f + x2 * (-1.9841270e-4f + x2 * 2.7557319e-6f))));
+        }
+
+        /*
+         * folds x in [-PI, PI] into [-HALF_PI, HALF_PI] preserving sin(x)
+         */
+        inline float fold(float x)
+        {
+            if (x > HALF_PI)
+            {
+                return PI - x;
+            }
+            if (x < -HALF_PI)
+            {
+                return -PI - x;
+            }
+            return x;
+        }
+    }
+
+    namespace portable
+    {
+        float inv_sqrt(float x)
+        {
+            if (!(x > 0.0f))
+            {
+                return 0.0f;
+            }
+            // memcpy rather than pointer casts, to keep strict aliasing rules intact.
+            std::uint32_t i;
+            float y;
+            std::memcpy(&i, &x, sizeof(i));
+            i = 0x5f375a86u - (i >> 1);
+            std::memcpy(&y, &i, sizeof(y));
+
+            float half_x = 0.5f * x;
+            y = y * (1.5f - half_x * y * y);
+            y = y * (1.5f - half_x * y * y);
+            return y;
+        }
+
+        float sqrt(float x)
+        {
+            return x * inv_sqrt(x);
+        }
+    }
+
+#if RR_MATH_ARM_FPU
+    namespace arm
+    {
+        float sqrt(float x)
+        {
+            if (!(x > 0.0f))
+            {
+                return 0.0f;
+            }
+            float r;
+            __asm__("vsqrt.f32 %0, %1" : "=t"(r) : "t"(x));
+            return r;
+        }
+
+        float inv_sqrt(float x)
+        {
+            if (!(x > 0.0f))
+            {
+                return 0.0f;
+            }
+            return 1.0f / sqrt(x);
+        }
+    }
+#endif
+
+    float inv_sqrt(float x)
+    {
+#if RR_MATH_ARM_FPU
+        return arm::inv_sqrt(x);
+#else
+        return portable::inv_sqrt(x);
+#endif
+    }
+
+    float sqrt(float x)
+    {
+#if RR_MATH_ARM_FPU
+        return arm::sqrt(x);
+#else
+        return portable::sqrt(x);
+#endif
+    }
+
+    float wrap_pi(float angle)
+    {
+        if (angle >= -PI && angle <= PI)
+        {
+            return angle;
+        }
+        float k = angle * (1.0f / TWO_PI);
+        std::int32_t n = static_cast<std::int32_t>(k >= 0.0f ? k + 0.5f : k - 0.5f);
+        return angle - static_cast<float>(n) * TWO_PI;
+    }
+
+    void sin_cos(float angle, float *s, float *c)
+    {
+        float a = wrap_pi(angle);
+        *s = sin_poly(fold(a));
+
+        // cos(a) = sin(a + PI/2), re-wrap as the shift may leave [-PI, PI]
+        float b = a + HALF_PI;
+        if (b > PI)
+        {
+            b -= TWO_PI;
+        }
+        *c = sin_poly(fold(b));
+    }
+
+    float atan2(float y, float x)
+    {
+        float ax = x < 0.0f ? -x : x;
+        float ay = y < 0.0f ? -y : y;
+        if (ax == 0.0f && ay == 0.0f)
+        {
+            return 0.0f;
+        }
+
+        // evaluate on [0, 1] and unfold by octant
+        bool swap = ay > ax;
+        float z = swap ? ax / ay : ay / ax;
+        float z2 = z * z;
+        float r = z * (ATAN_C1 + z2 * (ATAN_C3 + z2 * (ATAN_C5 + z2 * (ATAN_C7 + z2 * ATAN_C9))));
+
+        if (swap)
+        {
+            r = HALF_PI - r;
+        }
+        if (x < 0.0f)
+        {
+            r = PI - r;
+        }
+        return y < 0.0f ? -r : r;
+    }
+
+    bool normalise(Vec3 &v)
+    {
+        float n = v.x * v.x + v.y * v.y + v.z * v.z;
+        if (!(n > 0.0f))
+        {
+            return false;
+        }
+        float r = inv_sqrt(n);
+        v.x *= r;
+        v.y *= r;
+        v.z *= r;
+        return true;
+    }
+
+    bool normalise(Quat &q)
+    {
+        float n = q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z;
+        if (!(n > 0.0f))
+        {
+            return false;
+        }
+        float r = inv_sqrt(n);
+        q.w *= r;
+        q.x *= r;
+        q.y *= r;
+        q.z *= r;
+        return true;
+    }
+
+    Quat multiply(const Quat &a, const Quat &b)
+    {
+        Quat r;
+        r.w = a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z;
+        r.x = a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y;
+        r.y = a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x;
+        r.z = a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w;
+        return r;
+    }
+
+    void integrate(Quat &q, const Vec3 &w, float dt)
+    {
+        // q_dot = 0.5 * q * (0, w)
+        float h = 0.5f * dt;
+        float qw = q.w, qx = q.x, qy = q.y, qz = q.z;
+        q.w += h * (-qx * w.x - qy * w.y - qz * w.z);
+        q.x += h * (qw * w.x + qy * w.z - qz * w.y);
+        q.y += h * (qw * w.y - qx * w.z + qz * w.x);
+        q.z += h * (qw * w.z + qx * w.y - qy * w.x);
+        normalise(q);
+    }
+}
@@ -0,0 +1,241 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_MAZE_HPP
+#define RR_MAZE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_walls.hpp>
+
+namespace rr_maze
+{
+    /**
+     * Cells along each side, and in total. Rows of the map are 16 bit masks, so SIZE can not grow past 16.
+     */
+    static constexpr std::uint8_t SIZE = 16;
+    static constexpr std::uint16_t CELLS = static_cast<std::uint16_t>(SIZE) * SIZE;
+
+    /**
+     * Distance of a cell no path reaches.
+     */
+    static constexpr std::uint16_t UNREACHABLE = 0xffff;
+
+    /**
+     * Headings, in the order of the rr_walls side bits, so that the side ahead is 1 << heading.
+     */
+    enum Heading : std::uint8_t
+    {
+        H_NORTH = 0,
+        H_EAST = 1,
+        H_SOUTH = 2,
+        H_WEST = 3,
+    };
+
+    /**
+     * Moves relative to the heading, clockwise.
+     */
+    enum Move : std::uint8_t
+    {
+        M_NONE = 0,
+        M_FORWARD = 1,
+        M_RIGHT = 2,
+        M_BACK = 3,
+        M_LEFT = 4,
+    };
+
+    /**
+     * Next cell towards the goal. move is M_NONE at the goal, and when the goal can not be reached.
+     */
+    struct Step
+    {
+        Move move;
+        Heading heading;
+        std::uint8_t x;
+        std::uint8_t y;
+        std::uint16_t distance;
+    };
+
+    /**
+     * Goal rectangle, in cells.
+     */
+    struct Goal
+    {
+        std::uint8_t x;
+        std::uint8_t y;
+        std::uint8_t width;
+        std::uint8_t height;
+    };
+
+    /**
+     * @class MazeMap
+     * @brief bit packed walls of a SIZE x SIZE maze, 136 bytes.
+     *
+     * Each wall is stored once, as an edge between two cells, so the two cells sharing it always agree. Rows of
+     * horizontal edges and columns of vertical edges are 16 bit masks, with a second set of masks recording
+     * which edges have been seen. The outer walls are known from the start.
+     */
+    class MazeMap
+    {
+    private:
+        // h_*_[y] bit x is the edge on the south side of cell (x, y), h_*_[SIZE] the north boundary.
+        std::uint16_t h_wall_[SIZE + 1];
+        std::uint16_t h_seen_[SIZE + 1];
+
+        // v_*_[x] bit y is the edge on the west side of cell (x, y), v_*_[SIZE] the east boundary.
+        std::uint16_t v_wall_[SIZE + 1];
+        std::uint16_t v_seen_[SIZE + 1];
+
+        /*
+         * edge row and bit of side of cell (x, y), horizontal is false for east and west.
+         */
+        static void edge(std::uint8_t x, std::uint8_t y, Heading side, bool &horizontal, std::uint8_t &row, std::uint8_t &bit);
+
+    public:
+        MazeMap();
+
+        /**
+         * @fn clear
+         * @brief forgets every wall, apart from the outer walls.
+         */
+        void clear();
+
+        /**
+         * @fn wall
+         * @brief true if side of cell (x, y) is a known wall.
+         */
+        bool wall(std::uint8_t x, std::uint8_t y, Heading side) const;
+
+        /**
+         * @fn seen
+         * @brief true if side of cell (x, y) has been observed, or is an outer wall.
+         */
+        bool seen(std::uint8_t x, std::uint8_t y, Heading side) const;
+
+        /**
+         * @fn cell
+         * @brief walls and seen sides of cell (x, y), as rr_walls side masks.
+         */
+        rr_walls::CellWalls cell(std::uint8_t x, std::uint8_t y) const;
+
+        /**
+         * @fn set
+         * @brief records side of cell (x, y) as wall, or as open. Outer walls can not be opened.
+         *
+         * @return true if the map changed.
+         */
+        bool set(std::uint8_t x, std::uint8_t y, Heading side, bool wall);
+
+        /**
+         * @fn pack
+         * @brief copies the map, h_wall, h_seen, v_wall then v_seen, each as SIZE + 1 little endian 16 bit
+         * masks, to out, which holds PACKED bytes.
+         */
+        static constexpr size_t PACKED = 4 * (SIZE + 1) * 2;
+        void pack(std::uint8_t *out) const;
+    };
+
+    /**
+     * @class Solver
+     * @brief distances to the goal over a MazeMap, kept up to date as walls arrive.
+     *
+     * Sides that have not been seen are assumed open, so distances are the shortest path the robot could still
+     * hope for, and the robot explores by always moving to the neighbour closest to the goal. A new wall can only
+     * lengthen paths: update() finds the cells that lost every shortest path, from the cells behind the wall
+     * outwards, and only re-floods those from their intact neighbours, or floods the whole maze when that would be
+     * cheaper. A wall found to be open after all can only
+     * shorten paths, and is spread outwards from the wall. Nothing is allocated, the work queues are fixed
+     * arrays of CELLS cell indices.
+     */
+    class Solver
+    {
+    private:
+        MazeMap map_;
+        Goal goal_ = {7, 7, 2, 2};
+        std::uint16_t dist_[CELLS];
+
+        // cells whose distance is being rebuilt, and cells whose rebuilt distance is final.
+        std::uint32_t raised_[CELLS / 32];
+        std::uint32_t done_[CELLS / 32];
+        std::uint8_t queue_[CELLS];
+        std::uint8_t seeds_[CELLS];
+
+        std::uint16_t changed_ = 0;
+
+        bool is_goal(std::uint8_t c) const;
+        bool open(std::uint8_t c, Heading side, std::uint8_t &n) const;
+        /*
+         * re-floods the cells that depended on c being its distance. Returns false, leaving distances
+         * inconsistent, when so many cells depend on it that a flood() would be cheaper.
+         */
+        bool raise(std::uint8_t c);
+        void lower(std::uint8_t c);
+
+    public:
+        Solver();
+
+        /**
+         * @fn reset
+         * @brief clears the map, and floods it.
+         */
+        void reset();
+
+        /**
+         * @fn set_goal
+         * @brief returns false, leaving the goal in place, if it is empty or not inside the maze. Floods the map.
+         */
+        bool set_goal(const Goal &goal);
+        const Goal &goal() const;
+
+        /**
+         * @fn flood
+         * @brief recomputes every distance from scratch, breadth first from the goal.
+         */
+        void flood();
+
+        /**
+         * @fn update
+         * @brief merges the seen sides of cell into the map, and updates the distances the change affects.
+         *
+         * @return false if nothing changed.
+         */
+        bool update(const rr_walls::CellWalls &cell);
+
+        /**
+         * @fn changed
+         * @brief cells whose distance was recomputed by the last update(), or flood().
+         */
+        std::uint16_t changed() const;
+
+        std::uint16_t distance(std::uint8_t x, std::uint8_t y) const;
+
+        /**
+         * @fn next
+         * @brief next step from cell (x, y) facing heading. Ties prefer going straight, then right, left, and back.
+         */
+        Step next(std::uint8_t x, std::uint8_t y, Heading heading) const;
+
+        const MazeMap &map() const;
+    };
+}
+
+#endif // RR_MAZE_HPP
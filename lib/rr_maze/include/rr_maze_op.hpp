@@ -0,0 +1,143 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_MAZE_OP_HPP
+#define RR_MAZE_OP_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_geometry.hpp>
+#include <rr_maze.hpp>
+#include <rr_plan.hpp>
+#include <rr_pose_op.hpp>
+#include <rr_walls_op.hpp>
+
+/**
+ * Goal rectangle, cells, the centre four cells of a classic 16 x 16 maze.
+ */
+#ifndef RR_MAZE_GOAL_X
+#define RR_MAZE_GOAL_X 7
+#endif
+
+#ifndef RR_MAZE_GOAL_Y
+#define RR_MAZE_GOAL_Y 7
+#endif
+
+#ifndef RR_MAZE_GOAL_WIDTH
+#define RR_MAZE_GOAL_WIDTH 2
+#endif
+
+#ifndef RR_MAZE_GOAL_HEIGHT
+#define RR_MAZE_GOAL_HEIGHT 2
+#endif
+
+/**
+ * Map changes held for MSP_MAZE_MAP, a host further behind is sent the whole map.
+ */
+#ifndef RR_MAZE_DELTAS
+#define RR_MAZE_DELTAS 64
+#endif
+
+namespace mb_operations
+{
+    /**
+     * @class RRMazeOpHandler
+     * @brief keeps the maze map and flood fill on the device, responds to MSP_MAZE_MOVE, MSP_MAZE_DIST,
+     * MSP_MAZE_MAP, MSP_MAZE_PLAN and MSP_SET_MAZE.
+     *
+     * service() merges every cell the wall handler reports as left into a rr_maze::Solver, which updates only
+     * the distances the new walls affect, so the next move is ready on the device without a host round trip.
+     * Changed cells are also kept, by sequence number, so the host can follow the map a few bytes at a time.
+     *
+     * MSP_MAZE_PLAN plans the speed run over the explored map with a rr_maze::Planner, and returns it as motion
+     * segments for the host to queue, a page at a time from the cached plan.
+     */
+    class RRMazeOpHandler : public mb_operations::MbOperationHandler
+    {
+    private:
+        const RRWallOpHandler &walls_;
+        const RRPoseOpHandler &pose_;
+        rr_maze::Solver solver_;
+        rr_maze::Planner planner_;
+        std::uint32_t plan_us_ = 0;
+
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        // operation of the request being answered, perform_ext() fills in the part it asked for.
+        std::int32_t op_ = 0;
+
+        std::uint32_t used_left_ = 0;
+
+        // deltas_[(n - 1) % RR_MAZE_DELTAS] is change n, changes up to reset_seq_ predate the last reset.
+        rr_walls::CellWalls deltas_[RR_MAZE_DELTAS];
+        std::uint32_t seq_ = 0;
+        std::uint32_t reset_seq_ = 0;
+
+        std::uint32_t updates_ = 0;
+        std::uint32_t update_us_ = 0;
+        std::uint32_t max_update_us_ = 0;
+        std::uint16_t changed_ = 0;
+
+        void merge(const rr_walls::CellWalls &cell);
+        void reset();
+        void fill_step(org_ryderrobots_mousebot_MazeStep &step);
+        void fill_map(std::uint32_t since, org_ryderrobots_mousebot_MazeState &m);
+        void fill_plan(std::uint32_t from, org_ryderrobots_mousebot_PlanState &p);
+
+    public:
+        RRMazeOpHandler(const RRWallOpHandler &walls, const RRPoseOpHandler &pose);
+        ~RRMazeOpHandler() = default;
+
+        /**
+         * @fn init
+         * @brief clears the map, and sets the goal from RR_MAZE_GOAL_*.
+         */
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn service
+         * @brief merges the cell last left, if the wall handler has reported a new one.
+         */
+        void service() override;
+
+        const rr_maze::Solver &solver() const;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies maze_reset, maze_goal and plan_costs if present, then fills maze for the operation: the
+         * next step, which first merges what has been seen of the current cell, the distance grid, or the map
+         * changes since maze_since. MSP_MAZE_PLAN also fills plan, replanning when plan_from is 0.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_MAZE_OP_HPP
@@ -0,0 +1,152 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_PLAN_HPP
+#define RR_PLAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_maze.hpp>
+#include <rr_profile.hpp>
+
+namespace rr_maze
+{
+    /**
+     * Time cost model of a speed run. Straights, diagonals (straights at 45 degrees to the walls), and in place
+     * turns are each profiled with their own limits, m or rad. Every turn also costs turn_settle_s, for the
+     * robot to settle before it drives off.
+     */
+    struct Costs
+    {
+        rr_control::Limits straight;
+        rr_control::Limits diagonal;
+        rr_control::Limits turn;
+        float turn_settle_s;
+    };
+
+    enum SegmentKind : std::uint8_t
+    {
+        S_STRAIGHT = 0,
+        S_DIAGONAL = 1,
+        S_TURN = 2,
+    };
+
+    /**
+     * One motion segment of a plan, metres, or rad counter clockwise for turns. Segments start and end at rest.
+     */
+    struct Segment
+    {
+        SegmentKind kind;
+        float distance;
+    };
+
+    /**
+     * @fn segment_time
+     * @brief seconds to cover distance (m or rad, either sign) from rest to rest within limits, as rr_control::Profile
+     * runs it: a trapezoid, one jerk smoothing window longer when jerk is set.
+     */
+    float segment_time(float distance, const rr_control::Limits &limits);
+
+    /**
+     * @class Planner
+     * @brief fastest speed run over the explored part of a maze, as straights, diagonals and in place turns.
+     *
+     * The motion queue turns in place, from rest, so the search is over cells and headings, with macro moves
+     * that each start and end at rest in the middle of a cell: a straight run along open cells, a turn, or a
+     * diagonal through a staircase of cells, entered and left with half a cell and a 45 degree turn. Each move is
+     * costed in seconds by the Costs model, and the cheapest run is found by Dijkstra over SIZE * SIZE * 4
+     * states. Only sides seen open are used, so the run never relies on a guess.
+     *
+     * The plan then joins straights that meet in the same direction, and turns that meet, and the predicted run
+     * time is that of the joined plan, which can only be shorter than the search assumed. Memory is fixed,
+     * about 15KB, room for two segments a cell, and the work is bounded by the state count, whatever the maze.
+     */
+    class Planner
+    {
+    public:
+        static constexpr std::uint16_t STATES = CELLS * 4;
+        static constexpr size_t MAX_SEGMENTS = CELLS * 2;
+
+    private:
+        Costs costs_ = {{2.0f, 4.0f, 0.0f}, {1.5f, 4.0f, 0.0f}, {10.0f, 60.0f, 0.0f}, 0.02f};
+        float cell_m_ = 0.18f;
+
+        float cost_[STATES];
+        std::uint16_t prev_[STATES];
+        std::uint8_t move_[STATES];
+        std::uint16_t heap_[STATES];
+        std::uint16_t pos_[STATES];
+        std::uint16_t heap_size_ = 0;
+
+        Segment segments_[MAX_SEGMENTS];
+        size_t count_ = 0;
+        bool found_ = false;
+        float predicted_s_ = 0.0f;
+        std::uint16_t cells_ = 0;
+
+        void relax(std::uint16_t from, std::uint16_t to, float cost, std::uint8_t move);
+        std::uint16_t pop();
+        void sift_up(std::uint16_t i);
+        void sift_down(std::uint16_t i);
+
+        bool emit(SegmentKind kind, float distance);
+        bool emit_move(std::uint8_t move);
+
+    public:
+        Planner() = default;
+
+        /**
+         * @fn configure
+         * @brief returns false, leaving the model in place, unless every v_max and accel is positive, jerk
+         * and turn_settle_s are not negative, and cell_m is positive.
+         */
+        bool configure(const Costs &costs, float cell_m);
+
+        const Costs &costs() const;
+
+        /**
+         * @fn plan
+         * @brief plans the fastest run from cell (x, y) facing heading to any cell of goal.
+         *
+         * @return false if no run along seen open sides reaches the goal, or it needs more than MAX_SEGMENTS.
+         */
+        bool plan(const MazeMap &map, const Goal &goal, std::uint8_t x, std::uint8_t y, Heading heading);
+
+        bool found() const;
+        size_t count() const;
+        const Segment &segment(size_t i) const;
+
+        /**
+         * @fn predicted_s
+         * @brief run time of the plan, seconds, by the cost model.
+         */
+        float predicted_s() const;
+
+        /**
+         * @fn cells
+         * @brief cells entered along the run.
+         */
+        std::uint16_t cells() const;
+    };
+}
+
+#endif // RR_PLAN_HPP
@@ -0,0 +1,490 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_maze.hpp>
+#include <cstring>
+
+namespace rr_maze
+{
+    namespace
+    {
+        const std::uint8_t ROW_SHIFT = 4;
+        const std::uint8_t COL_MASK = SIZE - 1;
+
+        // past this many raised cells, repairing them costs more than flooding the whole maze.
+        const std::uint16_t RAISE_LIMIT = CELLS / 8;
+
+        inline std::uint8_t index(std::uint8_t x, std::uint8_t y)
+        {
+            return static_cast<std::uint8_t>((y << ROW_SHIFT) | x);
+        }
+
+        inline bool test(const std::uint32_t *bits, std::uint8_t c)
+        {
+            return (bits[c >> 5] >> (c & 31)) & 1u;
+        }
+
+        inline void mark(std::uint32_t *bits, std::uint8_t c)
+        {
+            bits[c >> 5] |= 1u << (c & 31);
+        }
+
+        // cell across side of c, only valid where there is no outer wall.
+        inline std::uint8_t across(std::uint8_t c, Heading side)
+        {
+            switch (side)
+            {
+            case H_NORTH:
+                return static_cast<std::uint8_t>(c + SIZE);
+            case H_EAST:
+                return static_cast<std::uint8_t>(c + 1);
+            case H_SOUTH:
+                return static_cast<std::uint8_t>(c - SIZE);
+            default:
+                return static_cast<std::uint8_t>(c - 1);
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // MazeMap
+    // ------------------------------------------------------------------------
+
+    MazeMap::MazeMap()
+    {
+        clear();
+    }
+
+    void MazeMap::clear()
+    {
+        std::memset(h_wall_, 0, sizeof(h_wall_));
+        std::memset(h_seen_, 0, sizeof(h_seen_));
+        std::memset(v_wall_, 0, sizeof(v_wall_));
+        std::memset(v_seen_, 0, sizeof(v_seen_));
+        h_wall_[0] = h_seen_[0] = h_wall_[SIZE] = h_seen_[SIZE] = 0xffff;
+        v_wall_[0] = v_seen_[0] = v_wall_[SIZE] = v_seen_[SIZE] = 0xffff;
+    }
+
+    void MazeMap::edge(std::uint8_t x, std::uint8_t y, Heading side, bool &horizontal, std::uint8_t &row, std::uint8_t &bit)
+    {
+        horizontal = side == H_NORTH || side == H_SOUTH;
+        if (horizontal)
+        {
+            row = side == H_NORTH ? y + 1 : y;
+            bit = x;
+        }
+        else
+        {
+            row = side == H_EAST ? x + 1 : x;
+            bit = y;
+        }
+    }
+
+    bool MazeMap::wall(std::uint8_t x, std::uint8_t y, Heading side) const
+    {
+        bool horizontal;
+        std::uint8_t row, bit;
+        edge(x, y, side, horizontal, row, bit);
+        return ((horizontal ? h_wall_[row] : v_wall_[row]) >> bit) & 1u;
+    }
+
+    bool MazeMap::seen(std::uint8_t x, std::uint8_t y, Heading side) const
+    {
+        bool horizontal;
+        std::uint8_t row, bit;
+        edge(x, y, side, horizontal, row, bit);
+        return ((horizontal ? h_seen_[row] : v_seen_[row]) >> bit) & 1u;
+    }
+
+    rr_walls::CellWalls MazeMap::cell(std::uint8_t x, std::uint8_t y) const
+    {
+        rr_walls::CellWalls c = {x, y, 0, 0};
+        for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+        {
+            std::uint8_t side_bit = static_cast<std::uint8_t>(1u << s);
+            if (wall(x, y, static_cast<Heading>(s)))
+            {
+                c.walls |= side_bit;
+            }
+            if (seen(x, y, static_cast<Heading>(s)))
+            {
+                c.seen |= side_bit;
+            }
+        }
+        return c;
+    }
+
+    bool MazeMap::set(std::uint8_t x, std::uint8_t y, Heading side, bool is_wall)
+    {
+        bool horizontal;
+        std::uint8_t row, bit;
+        edge(x, y, side, horizontal, row, bit);
+        if (row == 0 || row == SIZE)
+        {
+            return false;
+        }
+
+        std::uint16_t &walls = horizontal ? h_wall_[row] : v_wall_[row];
+        std::uint16_t &seen = horizontal ? h_seen_[row] : v_seen_[row];
+        std::uint16_t mask = static_cast<std::uint16_t>(1u << bit);
+        std::uint16_t before_walls = walls;
+        std::uint16_t before_seen = seen;
+        walls = is_wall ? (walls | mask) : (walls & ~mask);
+        seen |= mask;
+        return walls != before_walls || seen != before_seen;
+    }
+
+    void MazeMap::pack(std::uint8_t *out) const
+    {
+        const std::uint16_t *masks[] = {h_wall_, h_seen_, v_wall_, v_seen_};
+        for (const std::uint16_t *m : masks)
+        {
+            for (std::uint8_t i = 0; i <= SIZE; i++)
+            {
+                *out++ = static_cast<std::uint8_t>(m[i] & 0xff);
+                *out++ = static_cast<std::uint8_t>(m[i] >> 8);
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Solver
+    // ------------------------------------------------------------------------
+
+    Solver::Solver()
+    {
+        flood();
+    }
+
+    void Solver::reset()
+    {
+        map_.clear();
+        flood();
+    }
+
+    bool Solver::set_goal(const Goal &goal)
+    {
+        if (goal.width == 0 || goal.height == 0 || goal.x >= SIZE || goal.y >= SIZE ||
+            goal.width > SIZE - goal.x || goal.height > SIZE - goal.y)
+        {
+            return false;
+        }
+        goal_ = goal;
+        flood();
+        return true;
+    }
+
+    const Goal &Solver::goal() const
+    {
+        return goal_;
+    }
+
+    bool Solver::is_goal(std::uint8_t c) const
+    {
+        std::uint8_t x = c & COL_MASK;
+        std::uint8_t y = c >> ROW_SHIFT;
+        return x >= goal_.x && x < goal_.x + goal_.width && y >= goal_.y && y < goal_.y + goal_.height;
+    }
+
+    bool Solver::open(std::uint8_t c, Heading side, std::uint8_t &n) const
+    {
+        if (map_.wall(c & COL_MASK, c >> ROW_SHIFT, side))
+        {
+            return false;
+        }
+        n = across(c, side);
+        return true;
+    }
+
+    void Solver::flood()
+    {
+        for (std::uint16_t c = 0; c < CELLS; c++)
+        {
+            dist_[c] = UNREACHABLE;
+        }
+
+        std::uint16_t head = 0, tail = 0;
+        for (std::uint8_t y = goal_.y; y < goal_.y + goal_.height; y++)
+        {
+            for (std::uint8_t x = goal_.x; x < goal_.x + goal_.width; x++)
+            {
+                std::uint8_t c = index(x, y);
+                dist_[c] = 0;
+                queue_[tail++] = c;
+            }
+        }
+
+        while (head < tail)
+        {
+            std::uint8_t c = queue_[head++];
+            for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+            {
+                std::uint8_t n;
+                if (open(c, static_cast<Heading>(s), n) && dist_[n] == UNREACHABLE)
+                {
+                    dist_[n] = dist_[c] + 1;
+                    queue_[tail++] = n;
+                }
+            }
+        }
+        changed_ = tail;
+    }
+
+    bool Solver::raise(std::uint8_t r)
+    {
+        std::memset(raised_, 0, sizeof(raised_));
+        std::memset(done_, 0, sizeof(done_));
+
+        // find the cells left without a neighbour one step closer. The queue holds cells in order of
+        // distance, so every cell that could have supported a cell has been decided before it is checked.
+        // done_ marks queued cells here.
+        std::uint16_t head = 0, tail = 0, raised = 0;
+        queue_[tail++] = r;
+        mark(done_, r);
+        while (head < tail)
+        {
+            std::uint8_t c = queue_[head++];
+            if (is_goal(c))
+            {
+                continue;
+            }
+
+            bool supported = false;
+            for (std::uint8_t s = H_NORTH; s <= H_WEST && !supported; s++)
+            {
+                std::uint8_t n;
+                supported = open(c, static_cast<Heading>(s), n) && !test(raised_, n) && dist_[n] + 1 == dist_[c];
+            }
+            if (supported)
+            {
+                continue;
+            }
+
+            if (raised == RAISE_LIMIT)
+            {
+                return false;
+            }
+            mark(raised_, c);
+            seeds_[raised++] = c;
+            for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+            {
+                std::uint8_t n;
+                if (open(c, static_cast<Heading>(s), n) && !test(done_, n) && dist_[n] == dist_[c] + 1)
+                {
+                    mark(done_, n);
+                    queue_[tail++] = n;
+                }
+            }
+        }
+        changed_ += raised;
+
+        // each raised cell starts one step beyond its best intact neighbour.
+        std::uint16_t seeds = 0;
+        for (std::uint16_t i = 0; i < raised; i++)
+        {
+            std::uint8_t c = seeds_[i];
+            std::uint16_t best = UNREACHABLE;
+            for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+            {
+                std::uint8_t n;
+                if (open(c, static_cast<Heading>(s), n) && !test(raised_, n) && dist_[n] != UNREACHABLE &&
+                    dist_[n] + 1 < best)
+                {
+                    best = dist_[n] + 1;
+                }
+            }
+            dist_[c] = best;
+            if (best != UNREACHABLE)
+            {
+                seeds_[seeds++] = c;
+            }
+        }
+
+        // insertion sort, there are rarely more than a few seeds.
+        for (std::uint16_t i = 1; i < seeds; i++)
+        {
+            std::uint8_t c = seeds_[i];
+            std::uint16_t j = i;
+            for (; j > 0 && dist_[seeds_[j - 1]] > dist_[c]; j--)
+            {
+                seeds_[j] = seeds_[j - 1];
+            }
+            seeds_[j] = c;
+        }
+
+        // breadth first through the raised cells, merging the sorted seeds in as the front reaches their distance.
+        std::memset(done_, 0, sizeof(done_));
+        std::uint16_t next_seed = 0;
+        head = tail = 0;
+        while (next_seed < seeds || head < tail)
+        {
+            std::uint8_t c;
+            if (head < tail && (next_seed == seeds || dist_[queue_[head]] <= dist_[seeds_[next_seed]]))
+            {
+                c = queue_[head++];
+            }
+            else
+            {
+                c = seeds_[next_seed++];
+            }
+            if (test(done_, c))
+            {
+                continue;
+            }
+            mark(done_, c);
+
+            for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+            {
+                std::uint8_t n;
+                if (open(c, static_cast<Heading>(s), n) && test(raised_, n) && !test(done_, n) &&
+                    dist_[c] + 1 < dist_[n])
+                {
+                    dist_[n] = dist_[c] + 1;
+                    queue_[tail++] = n;
+                }
+            }
+        }
+        return true;
+    }
+
+    void Solver::lower(std::uint8_t r)
+    {
+        std::uint16_t head = 0, tail = 0;
+        queue_[tail++] = r;
+        while (head < tail)
+        {
+            std::uint8_t c = queue_[head++];
+            changed_++;
+            for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+            {
+                std::uint8_t n;
+                if (open(c, static_cast<Heading>(s), n) && dist_[c] + 1 < dist_[n])
+                {
+                    dist_[n] = dist_[c] + 1;
+                    queue_[tail++] = n;
+                }
+            }
+        }
+    }
+
+    bool Solver::update(const rr_walls::CellWalls &cell)
+    {
+        changed_ = 0;
+        if (cell.x >= SIZE || cell.y >= SIZE)
+        {
+            return false;
+        }
+
+        bool updated = false;
+        bool flood_needed = false;
+        std::uint8_t c = index(cell.x, cell.y);
+        for (std::uint8_t s = H_NORTH; s <= H_WEST; s++)
+        {
+            std::uint8_t side_bit = static_cast<std::uint8_t>(1u << s);
+            Heading side = static_cast<Heading>(s);
+            bool is_wall = (cell.walls & side_bit) != 0;
+            if (!(cell.seen & side_bit) || !map_.set(cell.x, cell.y, side, is_wall))
+            {
+                continue;
+            }
+            updated = true;
+
+            // once a flood is due, the remaining sides only need to be in the map.
+            if (flood_needed)
+            {
+                continue;
+            }
+
+            std::uint8_t n = across(c, side);
+            if (is_wall)
+            {
+                if (dist_[c] != UNREACHABLE && dist_[c] == dist_[n] + 1)
+                {
+                    flood_needed = !raise(c);
+                }
+                else if (dist_[n] != UNREACHABLE && dist_[n] == dist_[c] + 1)
+                {
+                    flood_needed = !raise(n);
+                }
+            }
+            else if (dist_[c] != UNREACHABLE && dist_[c] + 1 < dist_[n])
+            {
+                dist_[n] = dist_[c] + 1;
+                lower(n);
+            }
+            else if (dist_[n] != UNREACHABLE && dist_[n] + 1 < dist_[c])
+            {
+                dist_[c] = dist_[n] + 1;
+                lower(c);
+            }
+        }
+
+        if (flood_needed)
+        {
+            flood();
+        }
+        return updated;
+    }
+
+    std::uint16_t Solver::changed() const
+    {
+        return changed_;
+    }
+
+    std::uint16_t Solver::distance(std::uint8_t x, std::uint8_t y) const
+    {
+        return dist_[index(x, y)];
+    }
+
+    Step Solver::next(std::uint8_t x, std::uint8_t y, Heading heading) const
+    {
+        std::uint8_t c = index(x, y);
+        Step step = {M_NONE, heading, x, y, dist_[c]};
+        if (dist_[c] == UNREACHABLE || is_goal(c))
+        {
+            return step;
+        }
+
+        // clockwise turns from the heading, in order of preference.
+        static const std::uint8_t TURNS[] = {0, 1, 3, 2};
+        static const Move MOVES[] = {M_FORWARD, M_RIGHT, M_BACK, M_LEFT};
+        for (std::uint8_t t : TURNS)
+        {
+            Heading side = static_cast<Heading>((heading + t) & 3);
+            std::uint8_t n;
+            if (open(c, side, n) && dist_[n] < step.distance)
+            {
+                step.move = MOVES[t];
+                step.heading = side;
+                step.x = n & COL_MASK;
+                step.y = n >> ROW_SHIFT;
+                step.distance = dist_[n];
+            }
+        }
+        return step;
+    }
+
+    const MazeMap &Solver::map() const
+    {
+        return map_;
+    }
+}
@@ -0,0 +1,364 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_maze_op.hpp>
+#include <cmath>
+
+namespace mb_operations
+{
+    namespace
+    {
+        static_assert(RR_MAZE_SIZE == rr_maze::SIZE, "the maze map holds 16 x 16 cells");
+
+        // distances saturate below UNREACHED in the one byte grid.
+        const std::uint8_t UNREACHED = 0xff;
+
+        /*
+         * maze heading nearest to heading (rad, counter clockwise from +x).
+         */
+        rr_maze::Heading quantise(float heading)
+        {
+            static const rr_maze::Heading QUADRANTS[] = {rr_maze::H_EAST, rr_maze::H_NORTH, rr_maze::H_WEST, rr_maze::H_SOUTH};
+            long quadrant = std::lround(rr_math::wrap_pi(heading) / rr_math::HALF_PI);
+            return QUADRANTS[quadrant & 3];
+        }
+
+        void to_proto(const rr_walls::CellWalls &cell, org_ryderrobots_mousebot_CellWalls &out)
+        {
+            out.x = cell.x;
+            out.y = cell.y;
+            out.walls = cell.walls;
+            out.seen = cell.seen;
+        }
+
+        rr_control::Limits from_proto(const org_ryderrobots_mousebot_PlanLimits &in)
+        {
+            return {in.v_max, in.accel, in.jerk};
+        }
+
+        void to_proto(const rr_control::Limits &in, org_ryderrobots_mousebot_PlanLimits &out)
+        {
+            out.v_max = in.v_max;
+            out.accel = in.accel;
+            out.jerk = in.jerk;
+        }
+    }
+
+    RRMazeOpHandler::RRMazeOpHandler(const RRWallOpHandler &walls, const RRPoseOpHandler &pose)
+        : walls_(walls), pose_(pose)
+    {
+    }
+
+    void RRMazeOpHandler::init()
+    {
+        rr_maze::Goal goal = {RR_MAZE_GOAL_X, RR_MAZE_GOAL_Y, RR_MAZE_GOAL_WIDTH, RR_MAZE_GOAL_HEIGHT};
+        if (!solver_.set_goal(goal) || !planner_.configure(planner_.costs(), RR_MAZE_CELL_M))
+        {
+            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_FAILURE;
+            return;
+        }
+        reset();
+        used_left_ = walls_.cells_left();
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRMazeOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRMazeOpHandler::reset()
+    {
+        solver_.reset();
+        reset_seq_ = seq_;
+        updates_ = 0;
+        update_us_ = 0;
+        max_update_us_ = 0;
+        changed_ = 0;
+    }
+
+    void RRMazeOpHandler::merge(const rr_walls::CellWalls &cell)
+    {
+        unsigned long start = micros();
+        if (!solver_.update(cell))
+        {
+            return;
+        }
+        update_us_ = static_cast<std::uint32_t>(micros() - start);
+        if (update_us_ > max_update_us_)
+        {
+            max_update_us_ = update_us_;
+        }
+        changed_ = solver_.changed();
+        updates_++;
+
+        deltas_[seq_ % RR_MAZE_DELTAS] = solver_.map().cell(cell.x, cell.y);
+        seq_++;
+    }
+
+    void RRMazeOpHandler::service()
+    {
+        if (status_ != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            return;
+        }
+
+        // the wall handler reports at most one cell per iteration.
+        if (walls_.cells_left() != used_left_)
+        {
+            used_left_ = walls_.cells_left();
+            merge(walls_.last_left());
+        }
+    }
+
+    const rr_maze::Solver &RRMazeOpHandler::solver() const
+    {
+        return solver_;
+    }
+
+    void RRMazeOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+        op_ = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_MAZE_MOVE && req.op != rr_ble::rr_op_code_t::MSP_MAZE_DIST &&
+            req.op != rr_ble::rr_op_code_t::MSP_MAZE_MAP && req.op != rr_ble::rr_op_code_t::MSP_MAZE_PLAN &&
+            req.op != rr_ble::rr_op_code_t::MSP_SET_MAZE)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRMazeOpHandler::fill_step(org_ryderrobots_mousebot_MazeStep &s)
+    {
+        const rr_walls::WallDetector &detector = walls_.detector();
+        s.in_maze = detector.in_cell();
+        if (!s.in_maze)
+        {
+            return;
+        }
+
+        // decide with what has been seen of the current cell so far.
+        const rr_walls::CellWalls &cell = detector.current();
+        if (cell.seen != 0)
+        {
+            merge(cell);
+        }
+
+        rr_maze::Heading heading = quantise(pose_.pose().heading);
+        rr_maze::Step step = solver_.next(cell.x, cell.y, heading);
+        s.x = cell.x;
+        s.y = cell.y;
+        s.heading = heading;
+        s.move = static_cast<org_ryderrobots_mousebot_MazeMove>(step.move);
+        s.next_x = step.x;
+        s.next_y = step.y;
+        s.next_heading = step.heading;
+        s.distance = step.distance;
+    }
+
+    void RRMazeOpHandler::fill_map(std::uint32_t since, org_ryderrobots_mousebot_MazeState &m)
+    {
+        std::uint32_t oldest = seq_ > RR_MAZE_DELTAS ? seq_ - RR_MAZE_DELTAS : 0;
+        if (reset_seq_ > oldest)
+        {
+            oldest = reset_seq_;
+        }
+
+        if (since < oldest || since > seq_)
+        {
+            solver_.map().pack(m.map.bytes);
+            m.map.size = rr_maze::MazeMap::PACKED;
+            m.resync = true;
+            m.seq = seq_;
+            return;
+        }
+
+        const size_t max_deltas = sizeof(m.deltas) / sizeof(m.deltas[0]);
+        std::uint32_t n = since;
+        for (; n < seq_ && m.deltas_count < max_deltas; n++)
+        {
+            to_proto(deltas_[n % RR_MAZE_DELTAS], m.deltas[m.deltas_count++]);
+        }
+        m.seq = n;
+        m.more = n < seq_;
+    }
+
+    void RRMazeOpHandler::fill_plan(std::uint32_t from, org_ryderrobots_mousebot_PlanState &p)
+    {
+        if (from == 0)
+        {
+            // from the cell the robot is in, or the start cell facing north before it enters the maze.
+            const rr_walls::WallDetector &detector = walls_.detector();
+            std::uint8_t x = 0, y = 0;
+            rr_maze::Heading heading = rr_maze::H_NORTH;
+            if (detector.in_cell())
+            {
+                x = detector.current().x;
+                y = detector.current().y;
+                heading = quantise(pose_.pose().heading);
+            }
+            unsigned long start = micros();
+            planner_.plan(solver_.map(), solver_.goal(), x, y, heading);
+            plan_us_ = static_cast<std::uint32_t>(micros() - start);
+        }
+
+        const rr_maze::Costs &costs = planner_.costs();
+        const size_t max_segments = sizeof(p.segments) / sizeof(p.segments[0]);
+        size_t i = from > 0 ? from - 1 : 0;
+        p.first = static_cast<std::uint32_t>(i);
+        for (; i < planner_.count() && p.segments_count < max_segments; i++)
+        {
+            const rr_maze::Segment &seg = planner_.segment(i);
+            const rr_control::Limits &limits =
+                seg.kind == rr_maze::S_TURN ? costs.turn : (seg.kind == rr_maze::S_DIAGONAL ? costs.diagonal : costs.straight);
+            org_ryderrobots_mousebot_MotionSegment &out = p.segments[p.segments_count++];
+            out.id = static_cast<std::uint32_t>(i + 1);
+            out.kind = seg.kind == rr_maze::S_TURN ? org_ryderrobots_mousebot_MotionKind_MK_TURN
+                                                   : org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT;
+            out.distance = seg.distance;
+            out.v_max = limits.v_max;
+            out.accel = limits.accel;
+            out.jerk = limits.jerk;
+        }
+        p.more = i < planner_.count();
+
+        for (i = 0; i < planner_.count(); i++)
+        {
+            switch (planner_.segment(i).kind)
+            {
+            case rr_maze::S_STRAIGHT:
+                p.straights++;
+                break;
+            case rr_maze::S_DIAGONAL:
+                p.diagonals++;
+                break;
+            default:
+                p.turns++;
+                break;
+            }
+        }
+        p.found = planner_.found();
+        p.total = static_cast<std::uint32_t>(planner_.count());
+        p.predicted_s = planner_.predicted_s();
+        p.plan_us = plan_us_;
+        p.cells = planner_.cells();
+    }
+
+    void RRMazeOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        org_ryderrobots_mousebot_MazeState &m = eres.maze;
+        if (ereq.maze_reset)
+        {
+            reset();
+            m.accepted = true;
+        }
+        if (ereq.has_maze_goal)
+        {
+            rr_maze::Goal goal = {
+                static_cast<std::uint8_t>(ereq.maze_goal.x > rr_maze::SIZE ? rr_maze::SIZE : ereq.maze_goal.x),
+                static_cast<std::uint8_t>(ereq.maze_goal.y > rr_maze::SIZE ? rr_maze::SIZE : ereq.maze_goal.y),
+                static_cast<std::uint8_t>(ereq.maze_goal.width > rr_maze::SIZE ? 0 : ereq.maze_goal.width),
+                static_cast<std::uint8_t>(ereq.maze_goal.height > rr_maze::SIZE ? 0 : ereq.maze_goal.height),
+            };
+            m.accepted = solver_.set_goal(goal);
+        }
+        if (ereq.has_plan_costs)
+        {
+            const org_ryderrobots_mousebot_PlanCosts &pc = ereq.plan_costs;
+            rr_maze::Costs costs = {from_proto(pc.straight), from_proto(pc.diagonal), from_proto(pc.turn), pc.turn_settle_s};
+            eres.plan.accepted = planner_.configure(costs, RR_MAZE_CELL_M);
+            eres.has_plan = true;
+        }
+
+        switch (op_)
+        {
+        case rr_ble::rr_op_code_t::MSP_MAZE_MOVE:
+            fill_step(m.step);
+            m.has_step = true;
+            break;
+
+        case rr_ble::rr_op_code_t::MSP_MAZE_DIST:
+            for (std::uint8_t y = 0; y < rr_maze::SIZE; y++)
+            {
+                for (std::uint8_t x = 0; x < rr_maze::SIZE; x++)
+                {
+                    std::uint16_t d = solver_.distance(x, y);
+                    if (d == rr_maze::UNREACHABLE)
+                    {
+                        d = UNREACHED;
+                    }
+                    else if (d >= UNREACHED)
+                    {
+                        d = UNREACHED - 1;
+                    }
+                    m.distances.bytes[y * rr_maze::SIZE + x] = static_cast<std::uint8_t>(d);
+                }
+            }
+            m.distances.size = rr_maze::CELLS;
+            break;
+
+        case rr_ble::rr_op_code_t::MSP_MAZE_MAP:
+            fill_map(ereq.maze_since, m);
+            break;
+
+        case rr_ble::rr_op_code_t::MSP_MAZE_PLAN:
+            fill_plan(ereq.plan_from, eres.plan);
+            eres.has_plan = true;
+            m.seq = seq_;
+            break;
+
+        default:
+            m.seq = seq_;
+            break;
+        }
+
+        const rr_maze::Goal &goal = solver_.goal();
+        m.goal.x = goal.x;
+        m.goal.y = goal.y;
+        m.goal.width = goal.width;
+        m.goal.height = goal.height;
+        m.has_goal = true;
+        m.updates = updates_;
+        m.update_us = update_us_;
+        m.max_update_us = max_update_us_;
+        m.changed = changed_;
+        eres.has_maze = true;
+
+        if (eres.has_plan)
+        {
+            const rr_maze::Costs &costs = planner_.costs();
+            to_proto(costs.straight, eres.plan.costs.straight);
+            to_proto(costs.diagonal, eres.plan.costs.diagonal);
+            to_proto(costs.turn, eres.plan.costs.turn);
+            eres.plan.costs.has_straight = true;
+            eres.plan.costs.has_diagonal = true;
+            eres.plan.costs.has_turn = true;
+            eres.plan.costs.turn_settle_s = costs.turn_settle_s;
+            eres.plan.has_costs = true;
+        }
+    }
+}
@@ -0,0 +1,395 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_plan.hpp>
+#include <cmath>
+#include <rr_math.hpp>
+
+namespace rr_maze
+{
+    namespace
+    {
+        const float NEVER = 1e30f;
+        const std::uint16_t NOT_QUEUED = 0xffff;
+        const float HALF_SQRT2 = 0.70710678f;
+
+        // move_ codes, the kind in the top two bits, and cells, or the turn, below.
+        const std::uint8_t MV_STRAIGHT = 0x00;
+        const std::uint8_t MV_TURN = 0x40;
+        const std::uint8_t MV_DIAGONAL_LEFT = 0x80;
+        const std::uint8_t MV_DIAGONAL_RIGHT = 0xc0;
+        const std::uint8_t MV_KIND = 0xc0;
+        const std::uint8_t MV_COUNT = 0x3f;
+
+        const std::uint8_t TURN_LEFT = 1;
+        const std::uint8_t TURN_BACK = 2;
+        const std::uint8_t TURN_RIGHT = 3;
+
+        inline Heading left_of(std::uint8_t h)
+        {
+            return static_cast<Heading>((h + 3) & 3);
+        }
+
+        inline Heading right_of(std::uint8_t h)
+        {
+            return static_cast<Heading>((h + 1) & 3);
+        }
+
+        inline bool valid(const rr_control::Limits &l)
+        {
+            return l.v_max > 0.0f && l.accel > 0.0f && l.jerk >= 0.0f;
+        }
+
+        inline std::uint8_t cell_of(std::uint16_t s)
+        {
+            return static_cast<std::uint8_t>(s >> 2);
+        }
+
+        inline std::uint16_t state(std::uint8_t c, std::uint8_t h)
+        {
+            return static_cast<std::uint16_t>((c << 2) | h);
+        }
+
+        // known to be open, unseen sides are not used.
+        bool open(const MazeMap &map, std::uint8_t c, std::uint8_t side)
+        {
+            std::uint8_t x = c & (SIZE - 1), y = c / SIZE;
+            return map.seen(x, y, static_cast<Heading>(side)) && !map.wall(x, y, static_cast<Heading>(side));
+        }
+
+        std::uint8_t across(std::uint8_t c, std::uint8_t side)
+        {
+            static const int STEP[] = {SIZE, 1, -SIZE, -1};
+            return static_cast<std::uint8_t>(c + STEP[side]);
+        }
+    }
+
+    float segment_time(float distance, const rr_control::Limits &limits)
+    {
+        float d = std::fabs(distance);
+        if (d <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        // distance spent reaching v_max and braking from it.
+        float ramps = limits.v_max * limits.v_max / limits.accel;
+        float t = d >= ramps ? d / limits.v_max + limits.v_max / limits.accel : 2.0f * std::sqrt(d / limits.accel);
+        if (limits.jerk > 0.0f)
+        {
+            t += limits.accel / limits.jerk;
+        }
+        return t;
+    }
+
+    bool Planner::configure(const Costs &costs, float cell_m)
+    {
+        if (!valid(costs.straight) || !valid(costs.diagonal) || !valid(costs.turn) || costs.turn_settle_s < 0.0f ||
+            cell_m <= 0.0f)
+        {
+            return false;
+        }
+        costs_ = costs;
+        cell_m_ = cell_m;
+        return true;
+    }
+
+    const Costs &Planner::costs() const
+    {
+        return costs_;
+    }
+
+    void Planner::sift_up(std::uint16_t i)
+    {
+        std::uint16_t s = heap_[i];
+        while (i > 0)
+        {
+            std::uint16_t parent = (i - 1) / 2;
+            if (cost_[heap_[parent]] <= cost_[s])
+            {
+                break;
+            }
+            heap_[i] = heap_[parent];
+            pos_[heap_[i]] = i;
+            i = parent;
+        }
+        heap_[i] = s;
+        pos_[s] = i;
+    }
+
+    void Planner::sift_down(std::uint16_t i)
+    {
+        std::uint16_t s = heap_[i];
+        for (;;)
+        {
+            std::uint16_t child = 2 * i + 1;
+            if (child >= heap_size_)
+            {
+                break;
+            }
+            if (child + 1 < heap_size_ && cost_[heap_[child + 1]] < cost_[heap_[child]])
+            {
+                child++;
+            }
+            if (cost_[s] <= cost_[heap_[child]])
+            {
+                break;
+            }
+            heap_[i] = heap_[child];
+            pos_[heap_[i]] = i;
+            i = child;
+        }
+        heap_[i] = s;
+        pos_[s] = i;
+    }
+
+    std::uint16_t Planner::pop()
+    {
+        std::uint16_t s = heap_[0];
+        pos_[s] = NOT_QUEUED;
+        heap_size_--;
+        if (heap_size_ > 0)
+        {
+            heap_[0] = heap_[heap_size_];
+            sift_down(0);
+        }
+        return s;
+    }
+
+    void Planner::relax(std::uint16_t from, std::uint16_t to, float cost, std::uint8_t move)
+    {
+        if (cost >= cost_[to])
+        {
+            return;
+        }
+        cost_[to] = cost;
+        prev_[to] = from;
+        move_[to] = move;
+        if (pos_[to] == NOT_QUEUED)
+        {
+            heap_[heap_size_] = to;
+            pos_[to] = heap_size_;
+            heap_size_++;
+        }
+        sift_up(pos_[to]);
+    }
+
+    bool Planner::emit(SegmentKind kind, float distance)
+    {
+        // straights in the same direction, and turns, join.
+        if (count_ > 0 && kind != S_DIAGONAL && segments_[count_ - 1].kind == kind)
+        {
+            float joined = segments_[count_ - 1].distance + distance;
+            if (kind == S_TURN)
+            {
+                joined = rr_math::wrap_pi(joined);
+                if (std::fabs(joined) < 1e-4f)
+                {
+                    count_--;
+                    return true;
+                }
+            }
+            segments_[count_ - 1].distance = joined;
+            return true;
+        }
+
+        if (count_ == MAX_SEGMENTS)
+        {
+            return false;
+        }
+        segments_[count_].kind = kind;
+        segments_[count_].distance = distance;
+        count_++;
+        return true;
+    }
+
+    bool Planner::emit_move(std::uint8_t move)
+    {
+        std::uint8_t n = move & MV_COUNT;
+        switch (move & MV_KIND)
+        {
+        case MV_STRAIGHT:
+            cells_ += n;
+            return emit(S_STRAIGHT, n * cell_m_);
+
+        case MV_TURN:
+            return emit(S_TURN, n == TURN_LEFT ? rr_math::HALF_PI : (n == TURN_RIGHT ? -rr_math::HALF_PI : rr_math::PI));
+
+        default:
+        {
+            // half a cell to the first side crossed, 45 degrees towards the second, and along the diagonal, then
+            // back to the direction of the last cell entered.
+            float sign = (move & MV_KIND) == MV_DIAGONAL_LEFT ? 1.0f : -1.0f;
+            float eighth = rr_math::HALF_PI / 2.0f;
+            cells_ += n;
+            return emit(S_STRAIGHT, cell_m_ / 2.0f) && emit(S_TURN, sign * eighth) &&
+                   emit(S_DIAGONAL, (n - 1) * cell_m_ * HALF_SQRT2) &&
+                   emit(S_TURN, (n & 1) ? -sign * eighth : sign * eighth) && emit(S_STRAIGHT, cell_m_ / 2.0f);
+        }
+        }
+    }
+
+    bool Planner::plan(const MazeMap &map, const Goal &goal, std::uint8_t x, std::uint8_t y, Heading heading)
+    {
+        found_ = false;
+        count_ = 0;
+        predicted_s_ = 0.0f;
+        cells_ = 0;
+        if (x >= SIZE || y >= SIZE)
+        {
+            return false;
+        }
+
+        // every move starts and ends at rest, so costs only depend on its length.
+        float straight[SIZE];
+        float diagonal[SIZE];
+        for (std::uint8_t n = 0; n < SIZE; n++)
+        {
+            straight[n] = segment_time(n * cell_m_, costs_.straight);
+            diagonal[n] = segment_time(n * cell_m_ * HALF_SQRT2, costs_.diagonal);
+        }
+        float quarter = segment_time(rr_math::HALF_PI, costs_.turn) + costs_.turn_settle_s;
+        float half_turn = segment_time(rr_math::PI, costs_.turn) + costs_.turn_settle_s;
+        float eighth = segment_time(rr_math::HALF_PI / 2.0f, costs_.turn) + costs_.turn_settle_s;
+        float half_cell = segment_time(cell_m_ / 2.0f, costs_.straight);
+
+        for (std::uint16_t s = 0; s < STATES; s++)
+        {
+            cost_[s] = NEVER;
+            pos_[s] = NOT_QUEUED;
+        }
+        heap_size_ = 0;
+        std::uint16_t start = state(static_cast<std::uint8_t>(y * SIZE + x), heading);
+        relax(start, start, 0.0f, 0);
+
+        std::uint16_t end = NOT_QUEUED;
+        while (heap_size_ > 0)
+        {
+            std::uint16_t s = pop();
+            std::uint8_t c = cell_of(s);
+            std::uint8_t h = s & 3;
+            std::uint8_t cx = c & (SIZE - 1), cy = c / SIZE;
+            if (cx >= goal.x && cx < goal.x + goal.width && cy >= goal.y && cy < goal.y + goal.height)
+            {
+                end = s;
+                break;
+            }
+
+            float base = cost_[s];
+            relax(s, state(c, left_of(h)), base + quarter, MV_TURN | TURN_LEFT);
+            relax(s, state(c, right_of(h)), base + quarter, MV_TURN | TURN_RIGHT);
+            relax(s, state(c, (h + 2) & 3), base + half_turn, MV_TURN | TURN_BACK);
+
+            std::uint8_t to = c;
+            for (std::uint8_t n = 1; open(map, to, h); n++)
+            {
+                to = across(to, h);
+                relax(s, state(to, h), base + straight[n], MV_STRAIGHT | n);
+            }
+
+            // staircases alternate the heading with the side they lean to, from two cells on.
+            for (std::uint8_t lean = 0; lean < 2; lean++)
+            {
+                std::uint8_t side = lean == 0 ? left_of(h) : right_of(h);
+                std::uint8_t code = lean == 0 ? MV_DIAGONAL_LEFT : MV_DIAGONAL_RIGHT;
+                std::uint8_t dir = h;
+                to = c;
+                for (std::uint8_t k = 1; k < SIZE && open(map, to, dir); k++)
+                {
+                    to = across(to, dir);
+                    if (k >= 2)
+                    {
+                        float cost = base + 2.0f * (half_cell + eighth) + diagonal[k - 1];
+                        relax(s, state(to, dir), cost, code | k);
+                    }
+                    dir = dir == h ? side : h;
+                }
+            }
+        }
+
+        if (end == NOT_QUEUED)
+        {
+            return false;
+        }
+
+        // walk back to the start, the heap is free to hold the states along the way.
+        std::uint16_t steps = 0;
+        for (std::uint16_t s = end; s != start; s = prev_[s])
+        {
+            heap_[steps++] = s;
+        }
+        while (steps > 0)
+        {
+            std::uint16_t s = heap_[--steps];
+            if (!emit_move(move_[s]))
+            {
+                count_ = 0;
+                cells_ = 0;
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < count_; i++)
+        {
+            const Segment &seg = segments_[i];
+            switch (seg.kind)
+            {
+            case S_STRAIGHT:
+                predicted_s_ += segment_time(seg.distance, costs_.straight);
+                break;
+            case S_DIAGONAL:
+                predicted_s_ += segment_time(seg.distance, costs_.diagonal);
+                break;
+            default:
+                predicted_s_ += segment_time(seg.distance, costs_.turn) + costs_.turn_settle_s;
+                break;
+            }
+        }
+        found_ = true;
+        return true;
+    }
+
+    bool Planner::found() const
+    {
+        return found_;
+    }
+
+    size_t Planner::count() const
+    {
+        return count_;
+    }
+
+    const Segment &Planner::segment(size_t i) const
+    {
+        return segments_[i];
+    }
+
+    float Planner::predicted_s() const
+    {
+        return predicted_s_;
+    }
+
+    std::uint16_t Planner::cells() const
+    {
+        return cells_;
+    }
+}
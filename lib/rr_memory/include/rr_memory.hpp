@@ -0,0 +1,138 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_MEMORY_HPP
+#define RR_MEMORY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * On target the stack measured is that of the mbed main thread, which runs setup() and loop(), and static RAM is
+ * taken from the linker's data and bss symbols. Elsewhere there is no stack to paint safely, so a region is given
+ * with mock_stack(), and static RAM reads 0.
+ */
+#if defined(ARDUINO) && defined(ARDUINO_ARCH_MBED)
+#define RR_MEMORY_HW 1
+#else
+#define RR_MEMORY_HW 0
+#endif
+
+/**
+ * Bytes below the stack pointer, at the time the stack is painted, that are left alone: the painter's own frame,
+ * and anything an interrupt pushes while it runs.
+ */
+#ifndef RR_MEMORY_STACK_GUARD
+#define RR_MEMORY_STACK_GUARD 256
+#endif
+
+namespace rr_memory
+{
+    /**
+     * Word the unused stack is painted with, unlikely to be a pointer, a small integer, or a float.
+     */
+    static constexpr std::uint32_t PAINT = 0xA5C35A3Cu;
+
+    /**
+     * @fn paint
+     * @brief fills the words from lo up to hi with PAINT.
+     */
+    void paint(std::uint32_t *lo, std::uint32_t *hi);
+
+    /**
+     * @fn untouched
+     * @brief bytes from lo up that still hold PAINT, the stack grows down, so this is how close it has come to lo.
+     */
+    size_t untouched(const std::uint32_t *lo, const std::uint32_t *hi);
+
+    /**
+     * @class Stack
+     * @brief the stack setup() and loop() run on, painted once at boot, so that its high water mark, the most
+     * ever used, can be read at any time after by how much paint is left.
+     *
+     * Painting costs one pass over the free stack at boot, reading the high water mark one pass over the paint
+     * left, which stops at the first word overwritten. Neither is done from loop() unless asked for.
+     */
+    class Stack
+    {
+    public:
+        Stack(const Stack &) = delete;
+        Stack &operator=(const Stack &) = delete;
+
+        static Stack &get_instance();
+
+        /**
+         * @fn paint
+         * @brief paints the stack from its end up to RR_MEMORY_STACK_GUARD below the caller's frame, call first
+         * thing in setup().
+         */
+        void paint();
+
+        /**
+         * @fn painted
+         * @brief true once paint() has run on a known stack.
+         */
+        bool painted() const;
+
+        /**
+         * @fn size
+         * @brief size of the stack in bytes, 0 when it is not known.
+         */
+        size_t size() const;
+
+        /**
+         * @fn high_water
+         * @brief most bytes of the stack ever in use since paint(), 0 until painted.
+         */
+        size_t high_water() const;
+
+        /**
+         * @fn static_bytes
+         * @brief RAM taken by initialised and zeroed statics, data and bss, 0 off target.
+         */
+        static size_t static_bytes();
+
+#if !RR_MEMORY_HW
+        /**
+         * @fn mock_stack
+         * @brief makes the words from lo up to hi the stack, paint() paints all of it.
+         */
+        void mock_stack(std::uint32_t *lo, std::uint32_t *hi);
+#endif
+
+    private:
+        std::uint32_t *lo_ = nullptr;
+        std::uint32_t *hi_ = nullptr;
+        // lowest word painted
+        std::uint32_t *paint_lo_ = nullptr;
+        bool painted_ = false;
+
+        Stack() = default;
+
+        /*
+         * backend, sets lo_ and hi_ to the bounds of the running stack, false if they are not known.
+         */
+        bool bounds();
+    };
+}
+
+#endif // RR_MEMORY_HPP
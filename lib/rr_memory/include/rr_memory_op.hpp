@@ -0,0 +1,65 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_MEMORY_OP_HPP
+#define RR_MEMORY_OP_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_memory.hpp>
+
+namespace mb_operations
+{
+    /**
+     * @class RRMemoryOpHandler
+     * @brief reports the stack high water mark, static RAM, and the size of the request path's messages, responds
+     * to MSP_MEMORY.
+     */
+    class RRMemoryOpHandler : public mb_operations::MbOperationHandler
+    {
+    private:
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+    public:
+        RRMemoryOpHandler() = default;
+        ~RRMemoryOpHandler() = default;
+
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief fills memory, reading the stack's paint, which is a pass over the stack not yet used.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_MEMORY_OP_HPP
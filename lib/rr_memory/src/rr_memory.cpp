@@ -0,0 +1,148 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_memory.hpp>
+
+#if RR_MEMORY_HW
+#include <mbed.h>
+#include <rtx_os.h>
+
+// from the mbed GCC_ARM linker script.
+extern "C" std::uint32_t __data_start__;
+extern "C" std::uint32_t __data_end__;
+extern "C" std::uint32_t __bss_start__;
+extern "C" std::uint32_t __bss_end__;
+#endif
+
+namespace rr_memory
+{
+    void paint(std::uint32_t *lo, std::uint32_t *hi)
+    {
+        for (std::uint32_t *p = lo; p < hi; p++)
+        {
+            *p = PAINT;
+        }
+    }
+
+    size_t untouched(const std::uint32_t *lo, const std::uint32_t *hi)
+    {
+        const std::uint32_t *p = lo;
+        while (p < hi && *p == PAINT)
+        {
+            p++;
+        }
+        return static_cast<size_t>(p - lo) * sizeof(std::uint32_t);
+    }
+
+    Stack &Stack::get_instance()
+    {
+        static Stack instance;
+        return instance;
+    }
+
+#if RR_MEMORY_HW
+    bool Stack::bounds()
+    {
+        // the RTX control block of the running thread, osThreadId_t is a pointer to it.
+        const osRtxThread_t *thread = static_cast<const osRtxThread_t *>(osThreadGetId());
+        if (thread == nullptr || thread->stack_mem == nullptr)
+        {
+            return false;
+        }
+        lo_ = static_cast<std::uint32_t *>(thread->stack_mem);
+        hi_ = lo_ + thread->stack_size / sizeof(std::uint32_t);
+        return true;
+    }
+
+    void Stack::paint()
+    {
+        if (!bounds())
+        {
+            return;
+        }
+        // the first word holds RTX's own overflow marker, and is left to it.
+        std::uint8_t here;
+        std::uint32_t *limit = reinterpret_cast<std::uint32_t *>(
+            (reinterpret_cast<std::uintptr_t>(&here) - RR_MEMORY_STACK_GUARD) & ~static_cast<std::uintptr_t>(3));
+        if (limit > lo_ + 1 && limit < hi_)
+        {
+            paint_lo_ = lo_ + 1;
+            rr_memory::paint(paint_lo_, limit);
+            painted_ = true;
+        }
+    }
+
+    size_t Stack::static_bytes()
+    {
+        return static_cast<size_t>(reinterpret_cast<std::uintptr_t>(&__data_end__) -
+                                   reinterpret_cast<std::uintptr_t>(&__data_start__)) +
+               static_cast<size_t>(reinterpret_cast<std::uintptr_t>(&__bss_end__) -
+                                   reinterpret_cast<std::uintptr_t>(&__bss_start__));
+    }
+#else
+    bool Stack::bounds()
+    {
+        return lo_ != nullptr && hi_ > lo_;
+    }
+
+    void Stack::paint()
+    {
+        if (bounds())
+        {
+            paint_lo_ = lo_;
+            rr_memory::paint(paint_lo_, hi_);
+            painted_ = true;
+        }
+    }
+
+    size_t Stack::static_bytes()
+    {
+        return 0;
+    }
+
+    void Stack::mock_stack(std::uint32_t *lo, std::uint32_t *hi)
+    {
+        lo_ = lo;
+        hi_ = hi;
+        painted_ = false;
+    }
+#endif
+
+    bool Stack::painted() const
+    {
+        return painted_;
+    }
+
+    size_t Stack::size() const
+    {
+        return static_cast<size_t>(hi_ - lo_) * sizeof(std::uint32_t);
+    }
+
+    size_t Stack::high_water() const
+    {
+        if (!painted_)
+        {
+            return 0;
+        }
+        return static_cast<size_t>(hi_ - paint_lo_) * sizeof(std::uint32_t) - untouched(paint_lo_, hi_);
+    }
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_memory_op.hpp>
+#include <rr_buffer.hpp>
+
+/*
+ * sizeof each message, as an absolute symbol rr_sizeof_<name>, which takes no memory, so that
+ * utilities/memory_report.py can read them from the object file at build time.
+ */
+#define RR_MEMORY_SIZEOF(name, type) \
+    __asm__ volatile(".globl rr_sizeof_" name "\n\t.set rr_sizeof_" name ", %c0" : : "i"(sizeof(type)))
+
+namespace
+{
+    __attribute__((used)) void report_sizes()
+    {
+        RR_MEMORY_SIZEOF("Request", org_ryderrobots_ros2_serial_Request);
+        RR_MEMORY_SIZEOF("ExtRequest", org_ryderrobots_mousebot_ExtRequest);
+        RR_MEMORY_SIZEOF("Response", org_ryderrobots_ros2_serial_Response);
+        RR_MEMORY_SIZEOF("ExtResponse", org_ryderrobots_mousebot_ExtResponse);
+        RR_MEMORY_SIZEOF("RRBuffer", rr_buffer::RRBuffer);
+    }
+}
+
+namespace mb_operations
+{
+    void RRMemoryOpHandler::init()
+    {
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRMemoryOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRMemoryOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_MEMORY)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRMemoryOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        (void)ereq;
+        rr_memory::Stack &stack = rr_memory::Stack::get_instance();
+        org_ryderrobots_mousebot_MemoryState &m = eres.memory;
+        eres.has_memory = true;
+
+        m.painted = stack.painted();
+        if (m.painted)
+        {
+            m.stack_size = stack.size();
+            m.stack_used = stack.high_water();
+        }
+        m.static_bytes = rr_memory::Stack::static_bytes();
+        m.request_size = sizeof(org_ryderrobots_ros2_serial_Request);
+        m.ext_request_size = sizeof(org_ryderrobots_mousebot_ExtRequest);
+        m.response_size = sizeof(org_ryderrobots_ros2_serial_Response);
+        m.ext_response_size = sizeof(org_ryderrobots_mousebot_ExtResponse);
+        m.buffer_size = sizeof(rr_buffer::RRBuffer);
+    }
+}
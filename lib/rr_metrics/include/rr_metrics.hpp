@@ -0,0 +1,180 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_METRICS_HPP
+#define RR_METRICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Operation codes tracked, each has its own counters and histograms. Operations beyond these are only counted
+ * as dropped.
+ */
+#ifndef RR_METRICS_OPS
+#define RR_METRICS_OPS 24
+#endif
+
+/**
+ * Error types counted, at least org_ryderrobots_ros2_serial_ErrorType's count, larger values count as ET_UNKNOWN.
+ */
+#ifndef RR_METRICS_ERROR_TYPES
+#define RR_METRICS_ERROR_TYPES 8
+#endif
+
+namespace rr_metrics
+{
+    /**
+     * Stages of a request, each timed separately. Decode covers both Request and ExtRequest, dispatch finding the
+     * handler and subscribing, handler perform_op() and perform_ext(), and encode both responses.
+     */
+    enum Stage : std::uint8_t
+    {
+        ST_DECODE = 0,
+        ST_DISPATCH = 1,
+        ST_HANDLER = 2,
+        ST_ENCODE = 3,
+        STAGES = 4,
+    };
+
+    /**
+     * Time spent in one stage, bucket b of the histogram counting times of 2^b us up to 2^(b + 1), the last bucket
+     * everything longer.
+     */
+    struct StageLatency
+    {
+        static constexpr size_t BUCKETS = 12;
+
+        std::uint32_t histogram[BUCKETS];
+        std::uint32_t count;
+        std::uint32_t max_us;
+        std::uint64_t sum_us;
+    };
+
+    /**
+     * Counters of one operation code. requests are frames decoded for it, publications responses sent for a
+     * subscription, and errors the bad requests answered once op was known.
+     */
+    struct OpMetrics
+    {
+        std::int32_t op;
+        std::uint32_t requests;
+        std::uint32_t publications;
+        std::uint32_t errors;
+        StageLatency stages[STAGES];
+    };
+
+    /**
+     * @class Metrics
+     * @brief request counters, and latency histograms of each stage, kept per operation code.
+     *
+     * Operations get a slot the first time they are seen, in a fixed table, so nothing is allocated while
+     * running. Frames that could not be decoded are kept under op 0. All times are passed in, so it runs the same
+     * on the host.
+     */
+    class Metrics
+    {
+    private:
+        OpMetrics ops_[RR_METRICS_OPS];
+        size_t op_count_ = 0;
+        size_t last_ = 0;
+        std::uint32_t dropped_ = 0;
+        std::uint32_t errors_[RR_METRICS_ERROR_TYPES];
+
+        std::uint32_t rx_bytes_ = 0;
+        std::uint32_t rx_frames_ = 0;
+        std::uint32_t tx_bytes_ = 0;
+        std::uint32_t tx_frames_ = 0;
+
+        // returns op's slot, taking a free one if it has none, nullptr once the table is full.
+        OpMetrics *slot(std::int32_t op);
+
+    public:
+        Metrics();
+
+        void reset();
+
+        /**
+         * @fn count
+         * @brief counts a request for op, or a publication of it.
+         */
+        void count(std::int32_t op, bool publication = false);
+
+        /**
+         * @fn record
+         * @brief records that stage took elapsed_us while serving op.
+         */
+        void record(std::int32_t op, Stage stage, std::uint32_t elapsed_us);
+
+        /**
+         * @fn error
+         * @brief counts a bad request of etype, and against op when it is known (not 0).
+         */
+        void error(std::uint32_t etype, std::int32_t op = 0);
+
+        /**
+         * @fn received
+         * @brief counts a frame of bytes read from serial, including TERM_CHAR.
+         */
+        void received(size_t bytes);
+
+        /**
+         * @fn sent
+         * @brief counts a frame of bytes written to serial, including TERM_CHAR.
+         */
+        void sent(size_t bytes);
+
+        size_t ops() const;
+
+        /**
+         * @fn op
+         * @brief the i'th operation seen, in the order they were first seen.
+         */
+        const OpMetrics &op(size_t i) const;
+
+        /**
+         * @fn dropped
+         * @brief requests, and publications, of operations that found the table full.
+         */
+        std::uint32_t dropped() const;
+
+        std::uint32_t errors(std::uint32_t etype) const;
+        std::uint32_t rx_bytes() const;
+        std::uint32_t rx_frames() const;
+        std::uint32_t tx_bytes() const;
+        std::uint32_t tx_frames() const;
+
+        /**
+         * @fn bucket_of
+         * @brief histogram bucket of elapsed_us.
+         */
+        static size_t bucket_of(std::uint32_t elapsed_us);
+
+        /**
+         * @fn get_instance
+         * @brief the metrics of the serial service.
+         */
+        static Metrics &get_instance();
+    };
+}
+
+#endif // RR_METRICS_HPP
@@ -0,0 +1,196 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_metrics.hpp>
+#include <cstring>
+
+namespace rr_metrics
+{
+    Metrics::Metrics()
+    {
+        reset();
+    }
+
+    void Metrics::reset()
+    {
+        std::memset(ops_, 0, sizeof(ops_));
+        std::memset(errors_, 0, sizeof(errors_));
+        op_count_ = 0;
+        last_ = 0;
+        dropped_ = 0;
+        rx_bytes_ = 0;
+        rx_frames_ = 0;
+        tx_bytes_ = 0;
+        tx_frames_ = 0;
+    }
+
+    size_t Metrics::bucket_of(std::uint32_t elapsed_us)
+    {
+        size_t b = 0;
+        while (elapsed_us > 1 && b < StageLatency::BUCKETS - 1)
+        {
+            elapsed_us >>= 1;
+            b++;
+        }
+        return b;
+    }
+
+    OpMetrics *Metrics::slot(std::int32_t op)
+    {
+        // a request records each of its stages in turn, so the last slot is usually the one wanted. Otherwise a
+        // handful of operations are in use at a time, and a linear search is as quick as anything else.
+        if (last_ < op_count_ && ops_[last_].op == op)
+        {
+            return &ops_[last_];
+        }
+        for (size_t i = 0; i < op_count_; i++)
+        {
+            if (ops_[i].op == op)
+            {
+                last_ = i;
+                return &ops_[i];
+            }
+        }
+
+        if (op_count_ == RR_METRICS_OPS)
+        {
+            return nullptr;
+        }
+        last_ = op_count_++;
+        OpMetrics *m = &ops_[last_];
+        m->op = op;
+        return m;
+    }
+
+    void Metrics::count(std::int32_t op, bool publication)
+    {
+        OpMetrics *m = slot(op);
+        if (m == nullptr)
+        {
+            dropped_++;
+            return;
+        }
+
+        if (publication)
+        {
+            m->publications++;
+        }
+        else
+        {
+            m->requests++;
+        }
+    }
+
+    void Metrics::record(std::int32_t op, Stage stage, std::uint32_t elapsed_us)
+    {
+        OpMetrics *m = slot(op);
+        if (m == nullptr || stage >= STAGES)
+        {
+            return;
+        }
+
+        StageLatency &s = m->stages[stage];
+        s.histogram[bucket_of(elapsed_us)]++;
+        s.count++;
+        s.sum_us += elapsed_us;
+        if (elapsed_us > s.max_us)
+        {
+            s.max_us = elapsed_us;
+        }
+    }
+
+    void Metrics::error(std::uint32_t etype, std::int32_t op)
+    {
+        errors_[etype < RR_METRICS_ERROR_TYPES ? etype : 0]++;
+        if (op == 0)
+        {
+            return;
+        }
+
+        OpMetrics *m = slot(op);
+        if (m != nullptr)
+        {
+            m->errors++;
+        }
+    }
+
+    void Metrics::received(size_t bytes)
+    {
+        rx_bytes_ += static_cast<std::uint32_t>(bytes);
+        rx_frames_++;
+    }
+
+    void Metrics::sent(size_t bytes)
+    {
+        tx_bytes_ += static_cast<std::uint32_t>(bytes);
+        tx_frames_++;
+    }
+
+    size_t Metrics::ops() const
+    {
+        return op_count_;
+    }
+
+    const OpMetrics &Metrics::op(size_t i) const
+    {
+        return ops_[i < op_count_ ? i : 0];
+    }
+
+    std::uint32_t Metrics::dropped() const
+    {
+        return dropped_;
+    }
+
+    std::uint32_t Metrics::errors(std::uint32_t etype) const
+    {
+        return etype < RR_METRICS_ERROR_TYPES ? errors_[etype] : 0;
+    }
+
+    std::uint32_t Metrics::rx_bytes() const
+    {
+        return rx_bytes_;
+    }
+
+    std::uint32_t Metrics::rx_frames() const
+    {
+        return rx_frames_;
+    }
+
+    std::uint32_t Metrics::tx_bytes() const
+    {
+        return tx_bytes_;
+    }
+
+    std::uint32_t Metrics::tx_frames() const
+    {
+        return tx_frames_;
+    }
+
+    /**
+     * return static reference to metrics object.
+     */
+    Metrics &Metrics::get_instance()
+    {
+        static Metrics instance;
+        return instance;
+    }
+}
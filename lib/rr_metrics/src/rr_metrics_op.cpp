@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_metrics_op.hpp>
+
+static_assert(RR_METRICS_ERROR_TYPES >= _org_ryderrobots_ros2_serial_ErrorType_ARRAYSIZE,
+              "RR_METRICS_ERROR_TYPES must count every ErrorType");
+
+namespace mb_operations
+{
+    void RRMetricsOpHandler::init()
+    {
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRMetricsOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRMetricsOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_METRICS)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRMetricsOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        rr_metrics::Metrics &metrics = rr_metrics::Metrics::get_instance();
+        org_ryderrobots_mousebot_MetricsState &m = eres.metrics;
+        eres.has_metrics = true;
+
+        m.total = static_cast<std::uint32_t>(metrics.ops());
+        m.first = ereq.metrics_from;
+        m.dropped = metrics.dropped();
+
+        const size_t max_ops = sizeof(m.ops) / sizeof(m.ops[0]);
+        size_t i = ereq.metrics_from;
+        for (; i < metrics.ops() && m.ops_count < max_ops; i++)
+        {
+            const rr_metrics::OpMetrics &om = metrics.op(i);
+            org_ryderrobots_mousebot_OpMetrics &out = m.ops[m.ops_count++];
+            out.op = om.op;
+            out.requests = om.requests;
+            out.publications = om.publications;
+            out.errors = om.errors;
+            for (std::uint8_t stage = 0; stage < rr_metrics::STAGES; stage++)
+            {
+                const rr_metrics::StageLatency &s = om.stages[stage];
+                org_ryderrobots_mousebot_StageLatency &sl = out.stages[out.stages_count++];
+                sl.count = s.count;
+                sl.max_us = s.max_us;
+                sl.mean_us = s.count == 0 ? 0 : static_cast<std::uint32_t>(s.sum_us / s.count);
+                for (size_t b = 0; b < rr_metrics::StageLatency::BUCKETS; b++)
+                {
+                    sl.histogram[sl.histogram_count++] = s.histogram[b];
+                }
+            }
+        }
+        m.more = i < metrics.ops();
+
+        const std::uint32_t etypes = static_cast<std::uint32_t>(_org_ryderrobots_ros2_serial_ErrorType_ARRAYSIZE);
+        for (std::uint32_t etype = 0; etype < etypes; etype++)
+        {
+            m.errors[m.errors_count++] = metrics.errors(etype);
+        }
+        m.rx_bytes = metrics.rx_bytes();
+        m.rx_frames = metrics.rx_frames();
+        m.tx_bytes = metrics.tx_bytes();
+        m.tx_frames = metrics.tx_frames();
+
+        if (ereq.metrics_reset)
+        {
+            metrics.reset();
+            m.accepted = true;
+        }
+    }
+}
@@ -0,0 +1,149 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_MOTION_HPP
+#define RR_MOTION_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_geometry.hpp>
+#include <rr_profile.hpp>
+#include <rr_speed.hpp>
+
+/**
+ * Motion queue slots, one is kept free, so RR_MOTION_QUEUE_LEN - 1 segments can be queued.
+ */
+#ifndef RR_MOTION_QUEUE_LEN
+#define RR_MOTION_QUEUE_LEN 16
+#endif
+
+namespace mb_operations
+{
+    /**
+     * @class RRMotionOpHandler
+     * @brief on-device motion queue, responds to MSP_SET_MOTION and MSP_MOTION.
+     *
+     * MSP_SET_MOTION queues ExtRequest.motion_segment, or brakes to rest and drops the queue on motion_abort.
+     * Both ops return ExtResponse.motion, with queue length, progress through the active segment, and the last
+     * completed segment. The factory publishes an MSP_MOTION frame with event set whenever a segment completes.
+     *
+     * Segments are profiled by the wheel speed control loop, at its rate, so a move needs no link traffic once
+     * queued. Consecutive segments of the same kind join at their end velocity. A change of kind (straight to
+     * turn) must follow a segment that ends at rest. If the queue runs dry at speed the robot brakes to rest with
+     * the last segment's limits. Straights may hold a heading while they run, turns never do.
+     *
+     * The queue is single producer (main loop), single consumer (control loop), no locks are taken.
+     */
+    class RRMotionOpHandler : public mb_operations::MbOperationHandler, public rr_motor::SetpointSource
+    {
+    private:
+        RRSpeedOpHandler &speed_;
+
+        org_ryderrobots_mousebot_MotionSegment queue_[RR_MOTION_QUEUE_LEN];
+
+        // head_ is advanced by the control loop, tail_ by the main loop.
+        volatile size_t head_ = 0;
+        volatile size_t tail_ = 0;
+
+        // segments queued before an abort or cancel, up to drop_to_, are dropped by the control loop.
+        volatile bool abort_pending_ = false;
+        volatile bool cancel_pending_ = false;
+        volatile size_t drop_to_ = 0;
+
+        // control loop state
+        rr_control::Profile profile_;
+        org_ryderrobots_mousebot_MotionKind kind_ = org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT;
+        float sign_ = 1.0f;
+        bool stopping_ = false;
+        bool hold_heading_ = false;
+        float heading_ = 0.0f;
+
+        // written by the control loop, read by the main loop.
+        volatile bool active_ = false;
+        volatile std::uint32_t active_id_ = 0;
+        volatile float progress_ = 0.0f;
+        volatile float velocity_ = 0.0f;
+        volatile std::uint32_t completed_id_ = 0;
+        volatile std::uint32_t completed_ = 0;
+
+        // main loop state, the last queued segment constrains the next, and completions already published.
+        org_ryderrobots_mousebot_MotionKind last_kind_ = org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT;
+        float last_v_end_ = 0.0f;
+        std::uint32_t reported_ = 0;
+
+    public:
+        explicit RRMotionOpHandler(RRSpeedOpHandler &speed);
+        ~RRMotionOpHandler() = default;
+
+        /**
+         * @fn init
+         * @brief attaches the queue to the wheel speed control loop.
+         */
+        void init() override;
+
+        /**
+         * @fn status
+         * @brief follows the wheel speed controller.
+         */
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn enqueue
+         * @brief queues a segment, returns false if the queue is full, or the segment is invalid.
+         */
+        bool enqueue(const org_ryderrobots_mousebot_MotionSegment &segment);
+
+        /**
+         * @fn abort
+         * @brief drops queued segments, and brakes the active one to rest.
+         */
+        void abort();
+
+        size_t queued() const;
+
+        bool active() const;
+
+        /**
+         * @fn event_pending
+         * @brief true if a segment has completed since the last response.
+         */
+        bool event_pending() const;
+
+        bool next_setpoint(float dt, rr_motor::Setpoint &setpoint) override;
+
+        void cancel() override;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies motion_abort, then motion_segment if present, and sets motion.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_MOTION_HPP
@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_MOTOR_HPP
+#define RR_MOTOR_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_pwm.hpp>
+#include <rr_encoder.hpp>
+
+/**
+ * PWM counter top, the PWM frequency is 16MHz / RR_MOTOR_PWM_TOP (20kHz, above audible range).
+ */
+#ifndef RR_MOTOR_PWM_TOP
+#define RR_MOTOR_PWM_TOP 800
+#endif
+
+/**
+ * Motor driver inputs (DRV8833 style IN1 / IN2 per motor), nRF GPIO numbers.
+ * Defaults are D2 (P1.11), D3 (P1.12), D4 (P1.15), and D5 (P1.13) of the Nano 33 BLE.
+ */
+#ifndef RR_MOTOR_LEFT_IN1_PIN
+#define RR_MOTOR_LEFT_IN1_PIN 43
+#endif
+
+#ifndef RR_MOTOR_LEFT_IN2_PIN
+#define RR_MOTOR_LEFT_IN2_PIN 44
+#endif
+
+#ifndef RR_MOTOR_RIGHT_IN1_PIN
+#define RR_MOTOR_RIGHT_IN1_PIN 47
+#endif
+
+#ifndef RR_MOTOR_RIGHT_IN2_PIN
+#define RR_MOTOR_RIGHT_IN2_PIN 45
+#endif
+
+/**
+ * Motors are stopped if no command arrives for this many milliseconds, 0 disables the timeout.
+ */
+#ifndef RR_MOTOR_TIMEOUT_MS
+#define RR_MOTOR_TIMEOUT_MS 500
+#endif
+
+namespace mb_operations
+{
+    /**
+     * @class RRMotorOpHandler
+     * @brief drives both wheel motors, responds to MSP_SET_RAW_RC and MSP_MOTOR.
+     *
+     * Either op applies ExtRequest.motor_command if present, and returns ExtResponse.motor, so MSP_MOTOR
+     * without a command is a monitor request.
+     *
+     * Each motor uses two PWM channels, forward drives IN1 with IN2 low, reverse drives IN2 with IN1 low, and
+     * zero leaves both low (coast).
+     *
+     * The handler owns the wheel encoders, it starts them, signs their edges with the command direction, and
+     * reports their ticks and speeds in ExtResponse.motor.
+     */
+    class RRMotorOpHandler : public mb_operations::MbOperationHandler
+    {
+    public:
+        // full scale command, per mille.
+        static constexpr std::int16_t MAX_COMMAND = 1000;
+
+    private:
+        rr_motor::Pwm &pwm_ = rr_motor::Pwm::get_instance();
+        rr_encoder::Encoders &encoders_ = rr_encoder::Encoders::get_instance();
+
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        std::int16_t left_ = 0;
+        std::int16_t right_ = 0;
+        unsigned long command_ms_ = 0;
+
+        // set while a closed loop controller owns the motors, read from interrupt context.
+        volatile bool closed_loop_ = false;
+
+        /*
+         * per mille duty of the channel pair starting at channel, as loaded in the peripheral.
+         */
+        std::int32_t applied(size_t channel) const;
+
+    public:
+        RRMotorOpHandler() = default;
+        ~RRMotorOpHandler() = default;
+
+        /**
+         * @fn init
+         * @brief starts PWM with both motors stopped, and the encoders.
+         */
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn command
+         * @brief sets motor duty cycles, per mille, clamped to +/- MAX_COMMAND.
+         *
+         * Constant time, only the PWM sequence and its start task are written, and encoder direction updated.
+         */
+        void command(std::int16_t left, std::int16_t right);
+
+        /**
+         * @fn stop
+         * @brief coasts both motors.
+         */
+        void stop();
+
+        /**
+         * @fn set_closed_loop
+         * @brief hands the motors to (true), or takes them back from (false), a closed loop controller.
+         *
+         * A motor_command request always takes the motors back, so the host can override the controller.
+         */
+        void set_closed_loop(bool closed_loop);
+
+        bool closed_loop() const;
+
+        std::int16_t left() const;
+
+        std::int16_t right() const;
+
+        /**
+         * @fn service
+         * @brief stops the motors once RR_MOTOR_TIMEOUT_MS passes without a command.
+         *
+         * Does not apply in closed loop, where the controller enforces its own setpoint timeout.
+         */
+        void service() override;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies motor_command if present, and sets motor.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_MOTOR_HPP
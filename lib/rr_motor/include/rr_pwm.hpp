@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_PWM_HPP
+#define RR_PWM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * On the nRF52840 outputs are generated by the PWM0 peripheral, which reads its duty cycles from a four
+ * word sequence in RAM with EasyDMA. Elsewhere the same sequence is kept, and the start task is counted, so
+ * that tests can inspect exactly what would have been written to the peripheral.
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define RR_PWM_HW 1
+#else
+#define RR_PWM_HW 0
+#endif
+
+namespace rr_motor
+{
+    /**
+     * @class Pwm
+     * @brief four channel hardware PWM, one channel per motor driver input.
+     *
+     * Duty cycles are in counts of top(), the PWM frequency is 16MHz / top. Once started the peripheral
+     * generates the waveform on its own, set() only stores the new duty cycles and triggers the sequence
+     * start task, so the cost of an update is a handful of register writes regardless of the previous state.
+     */
+    class Pwm
+    {
+    public:
+        static constexpr size_t CHANNELS = 4;
+
+        // bit 15 of a sequence word selects polarity, set gives an active high pulse of the stored width.
+        static constexpr std::uint16_t ACTIVE_HIGH = 0x8000;
+
+        Pwm(const Pwm &) = delete;
+        Pwm &operator=(const Pwm &) = delete;
+
+        static Pwm &get_instance();
+
+        /**
+         * @fn begin
+         * @brief configures pins as outputs, and starts PWM0 with every channel at 0.
+         *
+         * @param pins nRF GPIO numbers (port * 32 + pin) for each channel.
+         * @param top counter top, between 3 and 32767.
+         * @return false if top is out of range.
+         */
+        bool begin(const std::uint8_t (&pins)[CHANNELS], std::uint16_t top);
+
+        /**
+         * @fn set
+         * @brief sets duty cycle of every channel, values above top() are clamped.
+         */
+        void set(const std::uint16_t (&duty)[CHANNELS]);
+
+        /**
+         * @fn duty
+         * @brief duty cycle that the peripheral is currently loaded with, read back from the sequence.
+         */
+        std::uint16_t duty(size_t channel) const;
+
+        std::uint16_t top() const;
+
+        /**
+         * @fn starts
+         * @brief number of times the sequence has been (re)started.
+         */
+        std::uint32_t starts() const;
+
+    private:
+        // read by EasyDMA, so it MUST stay in RAM, and MUST NOT move.
+        std::uint16_t seq_[CHANNELS] = {ACTIVE_HIGH, ACTIVE_HIGH, ACTIVE_HIGH, ACTIVE_HIGH};
+        std::uint16_t top_ = 0;
+        std::uint32_t starts_ = 0;
+
+        Pwm() = default;
+
+        /*
+         * backend, triggers the sequence start task.
+         */
+        void start();
+    };
+}
+
+#endif // RR_PWM_HPP
@@ -0,0 +1,365 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_SPEED_HPP
+#define RR_SPEED_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_geometry.hpp>
+#include <rr_motor.hpp>
+#include <rr_pid.hpp>
+#include <rr_loop_timer.hpp>
+#include <rr_pose.hpp>
+
+/**
+ * On the nRF52840 the control loop is run from the TIMER4 compare interrupt, so its rate does not depend on the
+ * main loop. Elsewhere service() runs it whenever a period has elapsed on micros().
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define RR_SPEED_TIMER_HW 1
+#else
+#define RR_SPEED_TIMER_HW 0
+#endif
+
+/**
+ * Control loop rate (Hz), 500 to 1000 is expected.
+ */
+#ifndef RR_SPEED_RATE_HZ
+#define RR_SPEED_RATE_HZ 1000
+#endif
+
+/**
+ * TIMER4 interrupt priority, 0 (highest) to 7.
+ */
+#ifndef RR_SPEED_IRQ_PRIORITY
+#define RR_SPEED_IRQ_PRIORITY 3
+#endif
+
+/**
+ * Wheel speed is measured over this many control periods, longer windows reduce tick quantisation noise,
+ * and add lag.
+ */
+#ifndef RR_SPEED_WINDOW
+#define RR_SPEED_WINDOW 8
+#endif
+
+/**
+ * Closed loop control is released, and the motors stopped, if no setpoint arrives for this many milliseconds.
+ */
+#ifndef RR_SPEED_TIMEOUT_MS
+#define RR_SPEED_TIMEOUT_MS 500
+#endif
+
+/**
+ * Default gains, per mille duty per m/s. Tune at runtime with MSP_SET_PID.
+ */
+#ifndef RR_SPEED_KP
+#define RR_SPEED_KP 300.0f
+#endif
+
+#ifndef RR_SPEED_KI
+#define RR_SPEED_KI 3000.0f
+#endif
+
+#ifndef RR_SPEED_KD
+#define RR_SPEED_KD 0.0f
+#endif
+
+#ifndef RR_SPEED_KFF
+#define RR_SPEED_KFF 800.0f
+#endif
+
+#ifndef RR_SPEED_KSTATIC
+#define RR_SPEED_KSTATIC 40.0f
+#endif
+
+/**
+ * Default heading-hold gains, turn rate (rad/s) per rad of heading error, and per rad/s of yaw rate, and the
+ * largest wheel speed correction (m/s). Tune at runtime with ExtRequest.heading_gains.
+ */
+#ifndef RR_HEADING_KP
+#define RR_HEADING_KP 8.0f
+#endif
+
+#ifndef RR_HEADING_KD
+#define RR_HEADING_KD 0.2f
+#endif
+
+#ifndef RR_HEADING_MAX_CORRECTION
+#define RR_HEADING_MAX_CORRECTION 0.1f
+#endif
+
+namespace rr_motor
+{
+    /**
+     * Wheel speeds (m/s), and the heading (rad) to hold while running them.
+     */
+    struct Setpoint
+    {
+        float left;
+        float right;
+        bool hold_heading;
+        float heading;
+    };
+
+    /**
+     * Heading-hold gains, see RR_HEADING_KP.
+     */
+    struct HeadingGains
+    {
+        float kp;
+        float kd;
+        float max_correction;
+    };
+
+    /**
+     * @class SetpointSource
+     * @brief generates wheel speed setpoints inside the control loop, such as a motion profile.
+     */
+    class SetpointSource
+    {
+    public:
+        /**
+         * @fn next_setpoint
+         * @brief called once per control period, from the loop context, returns false while idle.
+         */
+        virtual bool next_setpoint(float dt, Setpoint &setpoint) = 0;
+
+        /**
+         * @fn cancel
+         * @brief drops all motion at once, the host has taken the motors. Called from either context.
+         */
+        virtual void cancel() = 0;
+    };
+}
+
+namespace mb_operations
+{
+    /**
+     * @class RRSpeedOpHandler
+     * @brief closed loop wheel speed control, responds to MSP_SET_WHEEL_SPEED, MSP_SET_PID, and MSP_PID.
+     *
+     * Requests apply ExtRequest.wheel_speed (m/s), and ExtRequest.speed_gains if present, and return
+     * ExtResponse.speed with setpoints, measured speeds, outputs, gains, and loop timing statistics.
+     *
+     * A setpoint hands the motors to the controller, which then runs a PID per wheel at RR_SPEED_RATE_HZ from
+     * encoder feedback. A raw motor command, or RR_SPEED_TIMEOUT_MS without a setpoint, hands them back.
+     *
+     * An attached SetpointSource is asked for setpoints every period, and takes the motors while it is active.
+     * A host setpoint, or raw motor command, cancels it.
+     *
+     * Heading-hold steers the loop towards a target heading from the attached HeadingSource, adding a wheel
+     * speed difference from heading error and yaw rate inside the loop, so slip is corrected within a period.
+     * The active SetpointSource decides whether to hold heading, otherwise ExtRequest.heading_hold does.
+     *
+     * The loop runs in interrupt context on target. State shared with the main loop is either a single word,
+     * or handed over with a pending flag, so no locks are taken in the loop.
+     */
+    class RRSpeedOpHandler : public mb_operations::MbOperationHandler
+    {
+    public:
+        static constexpr std::uint32_t PERIOD_US = 1000000UL / RR_SPEED_RATE_HZ;
+
+    private:
+        RRMotorOpHandler &motor_;
+        rr_pose::TickSource *ticks_ = nullptr;
+        rr_motor::SetpointSource *source_ = nullptr;
+        rr_pose::HeadingSource *heading_ = nullptr;
+
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        rr_control::Pid pid_[2];
+        rr_control::LoopTimer timer_;
+
+        // setpoint the loop runs to, only written by tick() once running.
+        volatile float setpoint_[2] = {0.0f, 0.0f};
+        volatile bool enabled_ = false;
+        volatile unsigned long setpoint_ms_ = 0;
+
+        // latest requested gains, copied into the controllers by tick() while gains_pending_ is set.
+        rr_control::Gains gains_ = {RR_SPEED_KP, RR_SPEED_KI, RR_SPEED_KD, RR_SPEED_KFF, RR_SPEED_KSTATIC};
+        volatile bool gains_pending_ = false;
+
+        // latest host setpoint, copied into setpoint_ by tick() while setpoint_pending_ is set.
+        float requested_[2] = {0.0f, 0.0f};
+        volatile bool setpoint_pending_ = false;
+
+        rr_motor::HeadingGains heading_gains_ = {RR_HEADING_KP, RR_HEADING_KD, RR_HEADING_MAX_CORRECTION};
+        rr_motor::HeadingGains loop_heading_gains_ = heading_gains_;
+        volatile bool heading_gains_pending_ = false;
+
+        // host heading-hold, used while no setpoint source is active.
+        volatile bool host_hold_ = false;
+        volatile float host_heading_ = 0.0f;
+
+        // heading-hold as last applied by the loop.
+        bool hold_ = false;
+        float target_heading_ = 0.0f;
+        float yaw_ = 0.0f;
+        float correction_ = 0.0f;
+
+        float measured_[2] = {0.0f, 0.0f};
+        std::int16_t output_[2] = {0, 0};
+
+        // cumulative ticks of the last RR_SPEED_WINDOW + 1 periods.
+        std::int32_t history_[RR_SPEED_WINDOW + 1][2];
+        size_t head_ = 0;
+        size_t filled_ = 0;
+
+        unsigned long next_us_ = 0;
+
+        // set by tick(), cleared by take_tick().
+        volatile bool ticked_ = false;
+
+#if RR_SPEED_TIMER_HW
+        static RRSpeedOpHandler *instance_;
+
+        static void on_timer();
+#endif
+
+        /*
+         * updates measured_ from the encoders, returns false if they are not available.
+         */
+        bool measure();
+
+    public:
+        explicit RRSpeedOpHandler(RRMotorOpHandler &motor);
+        ~RRSpeedOpHandler() = default;
+
+        /**
+         * @fn set_tick_source
+         * @brief attaches wheel encoders, the handler is NOT_AVAILABLE without them. Call before init().
+         */
+        void set_tick_source(rr_pose::TickSource *ticks);
+
+        /**
+         * @fn set_setpoint_source
+         * @brief attaches a generator the control loop takes setpoints from while it is active.
+         */
+        void set_setpoint_source(rr_motor::SetpointSource *source);
+
+        /**
+         * @fn set_heading_source
+         * @brief attaches the heading reference for heading-hold, without one heading is not held.
+         */
+        void set_heading_source(rr_pose::HeadingSource *heading);
+
+        /**
+         * @fn hold_heading
+         * @brief holds heading (rad) while no setpoint source is active, or stops holding it.
+         */
+        void hold_heading(bool enable, float heading);
+
+        /**
+         * @fn set_heading_gains
+         * @brief gains are applied by the control loop at the start of its next period. Returns false, leaving
+         * the gains untouched, if any of them is negative or not finite.
+         */
+        bool set_heading_gains(const rr_motor::HeadingGains &gains);
+
+        const rr_motor::HeadingGains &heading_gains() const;
+
+        /**
+         * @fn heading_correction
+         * @brief wheel speed difference (m/s) heading-hold applied in the last period, added to the right wheel.
+         */
+        float heading_correction() const;
+
+        /**
+         * @fn init
+         * @brief loads default gains, and starts the control loop timer.
+         */
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn set_speed
+         * @brief sets wheel speed setpoints (m/s), and takes the motors into closed loop, cancelling the source.
+         * Both setpoints are applied together at the start of the loop's next period.
+         */
+        void set_speed(float left, float right);
+
+        /**
+         * @fn set_gains
+         * @brief gains are applied by the control loop at the start of its next period, keeping its integrators.
+         */
+        void set_gains(const rr_control::Gains &gains);
+
+        const rr_control::Gains &gains() const;
+
+        /**
+         * @fn release
+         * @brief leaves closed loop, and stops the motors.
+         */
+        void release();
+
+        bool enabled() const;
+
+        /**
+         * @fn tick
+         * @brief runs one control period, called by the timer interrupt, or by service() on native builds.
+         */
+        void tick();
+
+        /**
+         * @fn take_tick
+         * @brief true if tick() has run since the last call.
+         */
+        bool take_tick();
+
+        /**
+         * @fn timing
+         * @brief copy of the control loop timing statistics.
+         */
+        rr_control::LoopTiming timing() const;
+
+        float measured(size_t wheel) const;
+
+        /**
+         * @fn service
+         * @brief enforces the setpoint timeout, and on native builds runs tick() once per period.
+         */
+        void service() override;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn accept_ext
+         * @brief refuses heading_gains that set_heading_gains() would reject.
+         */
+        bool accept_ext(const org_ryderrobots_mousebot_ExtRequest &ereq) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies speed_gains, heading_gains, heading_hold, then wheel_speed if present, and sets speed.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_SPEED_HPP
@@ -0,0 +1,268 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_motion.hpp>
+
+#include <atomic>
+#include <cmath>
+
+namespace mb_operations
+{
+    namespace
+    {
+        inline size_t next_slot(size_t i)
+        {
+            return (i + 1) % RR_MOTION_QUEUE_LEN;
+        }
+    }
+
+    RRMotionOpHandler::RRMotionOpHandler(RRSpeedOpHandler &speed) : speed_(speed)
+    {
+    }
+
+    void RRMotionOpHandler::init()
+    {
+        speed_.set_setpoint_source(this);
+
+        // the control loop is not using the queue yet, so it is emptied directly.
+        head_ = 0;
+        tail_ = 0;
+        drop_to_ = 0;
+        abort_pending_ = false;
+        cancel_pending_ = false;
+        profile_.reset();
+        stopping_ = false;
+        active_ = false;
+        progress_ = 0.0f;
+        velocity_ = 0.0f;
+        last_v_end_ = 0.0f;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRMotionOpHandler::status()
+    {
+        return speed_.status();
+    }
+
+    bool RRMotionOpHandler::enqueue(const org_ryderrobots_mousebot_MotionSegment &segment)
+    {
+        if (!std::isfinite(segment.distance) || segment.distance == 0.0f || !(segment.v_max > 0.0f) ||
+            !(segment.accel > 0.0f) || !(segment.jerk >= 0.0f) || !(segment.v_end >= 0.0f) ||
+            segment.v_end > segment.v_max ||
+            (segment.kind != org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT &&
+             segment.kind != org_ryderrobots_mousebot_MotionKind_MK_TURN))
+        {
+            return false;
+        }
+
+        // once everything queued has run, the robot is at rest.
+        if (head_ == tail_ && !active_)
+        {
+            last_v_end_ = 0.0f;
+        }
+        if (segment.kind != last_kind_ && last_v_end_ != 0.0f)
+        {
+            return false;
+        }
+
+        size_t tail = tail_;
+        if (next_slot(tail) == head_)
+        {
+            return false;
+        }
+        queue_[tail] = segment;
+
+        // the segment must be in place before the control loop can see it.
+        std::atomic_signal_fence(std::memory_order_release);
+        tail_ = next_slot(tail);
+
+        last_kind_ = segment.kind;
+        last_v_end_ = segment.v_end;
+        return true;
+    }
+
+    void RRMotionOpHandler::abort()
+    {
+        drop_to_ = tail_;
+        std::atomic_signal_fence(std::memory_order_release);
+        abort_pending_ = true;
+        last_v_end_ = 0.0f;
+    }
+
+    void RRMotionOpHandler::cancel()
+    {
+        drop_to_ = tail_;
+        std::atomic_signal_fence(std::memory_order_release);
+        cancel_pending_ = true;
+        last_v_end_ = 0.0f;
+    }
+
+    size_t RRMotionOpHandler::queued() const
+    {
+        return (tail_ + RR_MOTION_QUEUE_LEN - head_) % RR_MOTION_QUEUE_LEN;
+    }
+
+    bool RRMotionOpHandler::active() const
+    {
+        return active_;
+    }
+
+    bool RRMotionOpHandler::event_pending() const
+    {
+        return completed_ != reported_;
+    }
+
+    bool RRMotionOpHandler::next_setpoint(float dt, rr_motor::Setpoint &setpoint)
+    {
+        if (cancel_pending_)
+        {
+            cancel_pending_ = false;
+            abort_pending_ = false;
+            head_ = drop_to_;
+            profile_.reset();
+            stopping_ = false;
+            active_ = false;
+            velocity_ = 0.0f;
+            return false;
+        }
+
+        if (abort_pending_)
+        {
+            abort_pending_ = false;
+            head_ = drop_to_;
+            if (active_)
+            {
+                profile_.stop();
+                stopping_ = true;
+            }
+        }
+
+        if (!active_)
+        {
+            if (head_ == tail_)
+            {
+                return false;
+            }
+
+            std::atomic_signal_fence(std::memory_order_acquire);
+            const org_ryderrobots_mousebot_MotionSegment &segment = queue_[head_];
+            rr_control::Limits limits = {segment.v_max, segment.accel, segment.jerk};
+            if (segment.kind != kind_)
+            {
+                // the other axis starts from rest.
+                profile_.reset();
+            }
+            bool started = profile_.start(std::fabs(segment.distance), segment.v_end, limits, dt);
+            kind_ = segment.kind;
+            sign_ = segment.distance < 0.0f ? -1.0f : 1.0f;
+            hold_heading_ = segment.heading_hold && segment.kind == org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT;
+            heading_ = segment.heading;
+            active_id_ = segment.id;
+            head_ = next_slot(head_);
+            if (!started)
+            {
+                return false;
+            }
+            stopping_ = false;
+            active_ = true;
+        }
+
+        float v = profile_.step();
+        progress_ = profile_.position();
+        velocity_ = v;
+
+        float speed = sign_ * v;
+        if (kind_ == org_ryderrobots_mousebot_MotionKind_MK_TURN)
+        {
+            // counter clockwise is positive, the wheels run in opposite directions.
+            speed *= RR_WHEEL_BASE_M * 0.5f;
+            setpoint.left = -speed;
+            setpoint.right = speed;
+        }
+        else
+        {
+            setpoint.left = speed;
+            setpoint.right = speed;
+        }
+        setpoint.hold_heading = hold_heading_;
+        setpoint.heading = heading_;
+
+        if (profile_.done())
+        {
+            if (!stopping_)
+            {
+                // id before count, the count is what the main loop polls.
+                completed_id_ = active_id_;
+                completed_ = completed_ + 1;
+            }
+            stopping_ = false;
+            active_ = false;
+
+            if (v > 0.0f && head_ == tail_)
+            {
+                // ran dry at speed, brake with the same limits.
+                profile_.stop();
+                stopping_ = true;
+                active_ = true;
+            }
+        }
+        return true;
+    }
+
+    void RRMotionOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_MOTION && req.op != rr_ble::rr_op_code_t::MSP_SET_MOTION)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRMotionOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        org_ryderrobots_mousebot_MotionState &m = eres.motion;
+        if (ereq.motion_abort)
+        {
+            abort();
+        }
+        if (ereq.has_motion_segment)
+        {
+            m.accepted = enqueue(ereq.motion_segment);
+        }
+
+        m.queued = static_cast<std::uint32_t>(queued());
+        m.active = active_;
+        m.active_id = active_id_;
+        m.progress = progress_;
+        m.velocity = velocity_;
+
+        std::uint32_t completed = completed_;
+        m.completed_id = completed_id_;
+        m.completed = completed;
+        m.event = completed != reported_;
+        reported_ = completed;
+        eres.has_motion = true;
+    }
+}
@@ -0,0 +1,182 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_motor.hpp>
+#include <rr_geometry.hpp>
+
+namespace mb_operations
+{
+    namespace
+    {
+        // PWM channel of each driver input.
+        constexpr size_t LEFT_IN1 = 0;
+        constexpr size_t RIGHT_IN1 = 2;
+
+        inline std::int16_t clamp(std::int32_t v)
+        {
+            if (v > RRMotorOpHandler::MAX_COMMAND)
+            {
+                return RRMotorOpHandler::MAX_COMMAND;
+            }
+            if (v < -RRMotorOpHandler::MAX_COMMAND)
+            {
+                return -RRMotorOpHandler::MAX_COMMAND;
+            }
+            return static_cast<std::int16_t>(v);
+        }
+
+        /*
+         * writes the IN1, IN2 duty pair for a signed per mille command.
+         */
+        inline void to_duty(std::int16_t cmd, std::uint16_t top, std::uint16_t *in1, std::uint16_t *in2)
+        {
+            std::uint32_t magnitude = static_cast<std::uint32_t>(cmd < 0 ? -cmd : cmd);
+            std::uint16_t duty = static_cast<std::uint16_t>(magnitude * top / RRMotorOpHandler::MAX_COMMAND);
+            *in1 = cmd > 0 ? duty : 0;
+            *in2 = cmd < 0 ? duty : 0;
+        }
+    }
+
+    void RRMotorOpHandler::init()
+    {
+        const std::uint8_t pins[rr_motor::Pwm::CHANNELS] = {
+            RR_MOTOR_LEFT_IN1_PIN,
+            RR_MOTOR_LEFT_IN2_PIN,
+            RR_MOTOR_RIGHT_IN1_PIN,
+            RR_MOTOR_RIGHT_IN2_PIN,
+        };
+        if (!pwm_.begin(pins, RR_MOTOR_PWM_TOP) || !encoders_.begin())
+        {
+            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_FAILURE;
+            return;
+        }
+        stop();
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRMotorOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRMotorOpHandler::command(std::int16_t left, std::int16_t right)
+    {
+        left_ = clamp(left);
+        right_ = clamp(right);
+
+        std::uint16_t duty[rr_motor::Pwm::CHANNELS];
+        to_duty(left_, pwm_.top(), &duty[LEFT_IN1], &duty[LEFT_IN1 + 1]);
+        to_duty(right_, pwm_.top(), &duty[RIGHT_IN1], &duty[RIGHT_IN1 + 1]);
+        pwm_.set(duty);
+        command_ms_ = millis();
+
+        // a coasting wheel keeps turning the way it was last driven, and a reversed one until it has braked.
+        encoders_.set_direction(rr_encoder::LEFT, left_);
+        encoders_.set_direction(rr_encoder::RIGHT, right_);
+    }
+
+    void RRMotorOpHandler::stop()
+    {
+        command(0, 0);
+    }
+
+    void RRMotorOpHandler::set_closed_loop(bool closed_loop)
+    {
+        closed_loop_ = closed_loop;
+    }
+
+    bool RRMotorOpHandler::closed_loop() const
+    {
+        return closed_loop_;
+    }
+
+    std::int16_t RRMotorOpHandler::left() const
+    {
+        return left_;
+    }
+
+    std::int16_t RRMotorOpHandler::right() const
+    {
+        return right_;
+    }
+
+    void RRMotorOpHandler::service()
+    {
+        if (RR_MOTOR_TIMEOUT_MS == 0 || closed_loop_ || (left_ == 0 && right_ == 0))
+        {
+            return;
+        }
+        if (millis() - command_ms_ > RR_MOTOR_TIMEOUT_MS)
+        {
+            stop();
+        }
+    }
+
+    std::int32_t RRMotorOpHandler::applied(size_t channel) const
+    {
+        if (pwm_.top() == 0)
+        {
+            return 0;
+        }
+        std::int32_t diff = static_cast<std::int32_t>(pwm_.duty(channel)) - static_cast<std::int32_t>(pwm_.duty(channel + 1));
+        return diff * MAX_COMMAND / pwm_.top();
+    }
+
+    void RRMotorOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_MOTOR && req.op != rr_ble::rr_op_code_t::MSP_SET_RAW_RC)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRMotorOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        if (ereq.has_motor_command)
+        {
+            // clamped before narrowing, the wire format is 32 bit.
+            closed_loop_ = false;
+            command(clamp(ereq.motor_command.left), clamp(ereq.motor_command.right));
+        }
+
+        eres.motor.left_command = left_;
+        eres.motor.right_command = right_;
+        eres.motor.left_applied = applied(LEFT_IN1);
+        eres.motor.right_applied = applied(RIGHT_IN1);
+        eres.motor.command_ms = static_cast<std::uint32_t>(command_ms_);
+
+        encoders_.update();
+        rr_encoder::Velocity left = encoders_.velocity(rr_encoder::LEFT);
+        rr_encoder::Velocity right = encoders_.velocity(rr_encoder::RIGHT);
+        eres.motor.left_ticks = encoders_.ticks(rr_encoder::LEFT);
+        eres.motor.right_ticks = encoders_.ticks(rr_encoder::RIGHT);
+        eres.motor.left_speed = left.ticks_per_s * rr_ble::METRES_PER_TICK;
+        eres.motor.right_speed = right.ticks_per_s * rr_ble::METRES_PER_TICK;
+        eres.motor.encoder_us = left.timestamp_us;
+        eres.has_motor = true;
+    }
+}
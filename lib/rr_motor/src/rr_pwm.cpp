@@ -0,0 +1,116 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_pwm.hpp>
+
+#if RR_PWM_HW
+#include <nrf.h>
+#endif
+
+namespace rr_motor
+{
+    Pwm &Pwm::get_instance()
+    {
+        static Pwm instance;
+        return instance;
+    }
+
+    bool Pwm::begin(const std::uint8_t (&pins)[CHANNELS], std::uint16_t top)
+    {
+        if (top < 3 || top > 0x7FFF)
+        {
+            return false;
+        }
+        top_ = top;
+        for (size_t i = 0; i < CHANNELS; i++)
+        {
+            seq_[i] = ACTIVE_HIGH;
+        }
+
+#if RR_PWM_HW
+        NRF_PWM0->ENABLE = PWM_ENABLE_ENABLE_Disabled << PWM_ENABLE_ENABLE_Pos;
+        for (size_t i = 0; i < CHANNELS; i++)
+        {
+            NRF_GPIO_Type *port = (pins[i] >> 5) ? NRF_P1 : NRF_P0;
+            std::uint32_t pin = pins[i] & 0x1F;
+            port->OUTCLR = 1UL << pin;
+            port->PIN_CNF[pin] = (GPIO_PIN_CNF_DIR_Output << GPIO_PIN_CNF_DIR_Pos) |
+                                 (GPIO_PIN_CNF_INPUT_Disconnect << GPIO_PIN_CNF_INPUT_Pos);
+            NRF_PWM0->PSEL.OUT[i] = pins[i];
+        }
+
+        NRF_PWM0->MODE = PWM_MODE_UPDOWN_Up << PWM_MODE_UPDOWN_Pos;
+        NRF_PWM0->PRESCALER = PWM_PRESCALER_PRESCALER_DIV_1 << PWM_PRESCALER_PRESCALER_Pos;
+        NRF_PWM0->COUNTERTOP = top_;
+        NRF_PWM0->LOOP = 0;
+        NRF_PWM0->DECODER = (PWM_DECODER_LOAD_Individual << PWM_DECODER_LOAD_Pos) |
+                            (PWM_DECODER_MODE_RefreshCount << PWM_DECODER_MODE_Pos);
+
+        // a single pass through the sequence, after which the last values are held until the next start.
+        NRF_PWM0->SEQ[0].PTR = reinterpret_cast<std::uint32_t>(seq_);
+        NRF_PWM0->SEQ[0].CNT = CHANNELS;
+        NRF_PWM0->SEQ[0].REFRESH = 0;
+        NRF_PWM0->SEQ[0].ENDDELAY = 0;
+        NRF_PWM0->SHORTS = 0;
+        NRF_PWM0->INTEN = 0;
+        NRF_PWM0->ENABLE = PWM_ENABLE_ENABLE_Enabled << PWM_ENABLE_ENABLE_Pos;
+#else
+        (void)pins;
+#endif
+        start();
+        return true;
+    }
+
+    void Pwm::set(const std::uint16_t (&duty)[CHANNELS])
+    {
+        for (size_t i = 0; i < CHANNELS; i++)
+        {
+            std::uint16_t d = duty[i] > top_ ? top_ : duty[i];
+            seq_[i] = static_cast<std::uint16_t>(ACTIVE_HIGH | d);
+        }
+        start();
+    }
+
+    std::uint16_t Pwm::duty(size_t channel) const
+    {
+        return channel < CHANNELS ? static_cast<std::uint16_t>(seq_[channel] & ~ACTIVE_HIGH) : 0;
+    }
+
+    std::uint16_t Pwm::top() const
+    {
+        return top_;
+    }
+
+    std::uint32_t Pwm::starts() const
+    {
+        return starts_;
+    }
+
+    void Pwm::start()
+    {
+#if RR_PWM_HW
+        // sequence stores must land in RAM before EasyDMA is told to read them.
+        __DSB();
+        NRF_PWM0->TASKS_SEQSTART[0] = 1;
+#endif
+        starts_++;
+    }
+}
@@ -0,0 +1,482 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_speed.hpp>
+
+#include <cmath>
+
+#if RR_SPEED_TIMER_HW
+#include <nrf.h>
+#endif
+
+namespace mb_operations
+{
+    namespace
+    {
+        constexpr float DT = 1.0f / static_cast<float>(RR_SPEED_RATE_HZ);
+
+        void set_bad_request(org_ryderrobots_ros2_serial_Response &response, org_ryderrobots_ros2_serial_ErrorType etype)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = etype;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+
+        bool valid(const rr_motor::HeadingGains &g)
+        {
+            return std::isfinite(g.kp) && std::isfinite(g.kd) && std::isfinite(g.max_correction) && g.kp >= 0.0f &&
+                   g.kd >= 0.0f && g.max_correction >= 0.0f;
+        }
+
+        inline std::uint32_t mean(std::uint64_t sum, std::uint32_t n)
+        {
+            return n == 0 ? 0 : static_cast<std::uint32_t>(sum / n);
+        }
+    }
+
+#if RR_SPEED_TIMER_HW
+    RRSpeedOpHandler *RRSpeedOpHandler::instance_ = nullptr;
+
+    void RRSpeedOpHandler::on_timer()
+    {
+        NRF_TIMER4->EVENTS_COMPARE[0] = 0;
+        // read back so the event is cleared before the interrupt returns.
+        (void)NRF_TIMER4->EVENTS_COMPARE[0];
+        if (instance_ != nullptr)
+        {
+            instance_->tick();
+        }
+    }
+#endif
+
+    RRSpeedOpHandler::RRSpeedOpHandler(RRMotorOpHandler &motor) : motor_(motor)
+    {
+    }
+
+    void RRSpeedOpHandler::set_tick_source(rr_pose::TickSource *ticks)
+    {
+        ticks_ = ticks;
+        filled_ = 0;
+    }
+
+    void RRSpeedOpHandler::set_setpoint_source(rr_motor::SetpointSource *source)
+    {
+        source_ = source;
+    }
+
+    void RRSpeedOpHandler::set_heading_source(rr_pose::HeadingSource *heading)
+    {
+        heading_ = heading;
+    }
+
+    void RRSpeedOpHandler::hold_heading(bool enable, float heading)
+    {
+        host_heading_ = heading;
+        host_hold_ = enable;
+    }
+
+    bool RRSpeedOpHandler::set_heading_gains(const rr_motor::HeadingGains &gains)
+    {
+        if (!valid(gains))
+        {
+            return false;
+        }
+        noInterrupts();
+        heading_gains_ = gains;
+        heading_gains_pending_ = true;
+        interrupts();
+        return true;
+    }
+
+    const rr_motor::HeadingGains &RRSpeedOpHandler::heading_gains() const
+    {
+        return heading_gains_;
+    }
+
+    float RRSpeedOpHandler::heading_correction() const
+    {
+        return correction_;
+    }
+
+    void RRSpeedOpHandler::init()
+    {
+        for (size_t i = 0; i < 2; i++)
+        {
+            pid_[i].set_limits(-RRMotorOpHandler::MAX_COMMAND, RRMotorOpHandler::MAX_COMMAND);
+            pid_[i].set_gains(gains_);
+            pid_[i].reset();
+        }
+        timer_.set_period(PERIOD_US);
+        timer_.reset();
+        next_us_ = micros() + PERIOD_US;
+
+        if (ticks_ == nullptr)
+        {
+            return;
+        }
+
+#if RR_SPEED_TIMER_HW
+        instance_ = this;
+        NRF_TIMER4->TASKS_STOP = 1;
+        NRF_TIMER4->MODE = TIMER_MODE_MODE_Timer << TIMER_MODE_MODE_Pos;
+        NRF_TIMER4->BITMODE = TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos;
+
+        // 16MHz / 2^4, one count per microsecond.
+        NRF_TIMER4->PRESCALER = 4;
+        NRF_TIMER4->CC[0] = PERIOD_US;
+        NRF_TIMER4->SHORTS = TIMER_SHORTS_COMPARE0_CLEAR_Enabled << TIMER_SHORTS_COMPARE0_CLEAR_Pos;
+        NRF_TIMER4->INTENSET = TIMER_INTENSET_COMPARE0_Enabled << TIMER_INTENSET_COMPARE0_Pos;
+        NRF_TIMER4->TASKS_CLEAR = 1;
+
+        NVIC_SetVector(TIMER4_IRQn, reinterpret_cast<std::uint32_t>(&on_timer));
+        NVIC_SetPriority(TIMER4_IRQn, RR_SPEED_IRQ_PRIORITY);
+        NVIC_ClearPendingIRQ(TIMER4_IRQn);
+        NVIC_EnableIRQ(TIMER4_IRQn);
+        NRF_TIMER4->TASKS_START = 1;
+#endif
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRSpeedOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRSpeedOpHandler::set_speed(float left, float right)
+    {
+        if (source_ != nullptr)
+        {
+            source_->cancel();
+        }
+        // both wheels are handed over together, the loop never sees one new and one old setpoint.
+        noInterrupts();
+        requested_[0] = left;
+        requested_[1] = right;
+        setpoint_pending_ = true;
+        interrupts();
+        setpoint_ms_ = millis();
+
+        // the controllers are held in reset while disabled, so each run starts from a clean integrator. closed
+        // loop is taken first: tick() drops enabled_ while the motor is not in closed loop.
+        motor_.set_closed_loop(true);
+        enabled_ = true;
+    }
+
+    void RRSpeedOpHandler::set_gains(const rr_control::Gains &gains)
+    {
+        // statistics restart with the new gains, so they describe one tuning.
+        noInterrupts();
+        gains_ = gains;
+        gains_pending_ = true;
+        timer_.reset();
+        interrupts();
+    }
+
+    const rr_control::Gains &RRSpeedOpHandler::gains() const
+    {
+        return gains_;
+    }
+
+    void RRSpeedOpHandler::release()
+    {
+        enabled_ = false;
+        noInterrupts();
+        requested_[0] = 0.0f;
+        requested_[1] = 0.0f;
+        setpoint_pending_ = true;
+        interrupts();
+        motor_.set_closed_loop(false);
+        motor_.stop();
+    }
+
+    bool RRSpeedOpHandler::enabled() const
+    {
+        return enabled_;
+    }
+
+    bool RRSpeedOpHandler::measure()
+    {
+        std::int32_t left, right;
+        if (ticks_ == nullptr || !ticks_->read_ticks(left, right))
+        {
+            filled_ = 0;
+            measured_[0] = 0.0f;
+            measured_[1] = 0.0f;
+            return false;
+        }
+
+        head_ = (head_ + 1) % (RR_SPEED_WINDOW + 1);
+        history_[head_][0] = left;
+        history_[head_][1] = right;
+        if (filled_ < RR_SPEED_WINDOW + 1)
+        {
+            filled_++;
+        }
+        if (filled_ < 2)
+        {
+            return false;
+        }
+
+        // oldest sample in the window, ticks are cumulative and may wrap.
+        size_t n = filled_ - 1;
+        size_t tail = (head_ + RR_SPEED_WINDOW + 1 - n) % (RR_SPEED_WINDOW + 1);
+        float scale = rr_ble::METRES_PER_TICK / (static_cast<float>(n) * DT);
+        for (size_t i = 0; i < 2; i++)
+        {
+            std::int32_t d = static_cast<std::int32_t>(static_cast<std::uint32_t>(history_[head_][i]) - static_cast<std::uint32_t>(history_[tail][i]));
+            measured_[i] = static_cast<float>(d) * scale;
+        }
+        return true;
+    }
+
+    bool RRSpeedOpHandler::take_tick()
+    {
+        noInterrupts();
+        bool ticked = ticked_;
+        ticked_ = false;
+        interrupts();
+        return ticked;
+    }
+
+    void RRSpeedOpHandler::tick()
+    {
+        timer_.start(micros());
+
+        // the integrators are kept, so retuning a running loop does not step its output.
+        if (gains_pending_)
+        {
+            pid_[0].set_gains(gains_);
+            pid_[1].set_gains(gains_);
+            gains_pending_ = false;
+        }
+        if (setpoint_pending_)
+        {
+            setpoint_[0] = requested_[0];
+            setpoint_[1] = requested_[1];
+            setpoint_pending_ = false;
+        }
+        if (heading_gains_pending_)
+        {
+            loop_heading_gains_ = heading_gains_;
+            heading_gains_pending_ = false;
+        }
+
+        bool measured = measure();
+
+        // the host may have taken the motors back with a raw command.
+        if (enabled_ && !motor_.closed_loop())
+        {
+            enabled_ = false;
+            if (source_ != nullptr)
+            {
+                source_->cancel();
+            }
+        }
+
+        rr_motor::Setpoint next = {0.0f, 0.0f, false, 0.0f};
+        if (source_ != nullptr && source_->next_setpoint(DT, next))
+        {
+            setpoint_[0] = next.left;
+            setpoint_[1] = next.right;
+            setpoint_ms_ = millis();
+            if (!enabled_)
+            {
+                motor_.set_closed_loop(true);
+                enabled_ = true;
+            }
+            hold_ = next.hold_heading;
+            target_heading_ = next.heading;
+        }
+        else
+        {
+            hold_ = host_hold_;
+            target_heading_ = host_heading_;
+        }
+
+        if (enabled_ && measured)
+        {
+            float sp[2] = {setpoint_[0], setpoint_[1]};
+            correction_ = 0.0f;
+
+            float rate;
+            if (hold_ && heading_ != nullptr && heading_->read_heading(yaw_, rate))
+            {
+                // turn towards the target, damped by the measured yaw rate, as a wheel speed difference.
+                const rr_motor::HeadingGains &g = loop_heading_gains_;
+                float turn = g.kp * rr_math::wrap_pi(target_heading_ - yaw_) - g.kd * rate;
+                float diff = turn * RR_WHEEL_BASE_M * 0.5f;
+                diff = diff > g.max_correction ? g.max_correction : (diff < -g.max_correction ? -g.max_correction : diff);
+                sp[0] -= diff;
+                sp[1] += diff;
+                correction_ = diff;
+            }
+
+            for (size_t i = 0; i < 2; i++)
+            {
+                output_[i] = static_cast<std::int16_t>(pid_[i].update(sp[i], measured_[i], DT));
+            }
+            motor_.command(output_[0], output_[1]);
+        }
+        else
+        {
+            correction_ = 0.0f;
+            pid_[0].reset();
+            pid_[1].reset();
+            output_[0] = 0;
+            output_[1] = 0;
+        }
+
+        timer_.stop(micros());
+        ticked_ = true;
+    }
+
+    rr_control::LoopTiming RRSpeedOpHandler::timing() const
+    {
+        noInterrupts();
+        rr_control::LoopTiming t = timer_.stats();
+        interrupts();
+        return t;
+    }
+
+    float RRSpeedOpHandler::measured(size_t wheel) const
+    {
+        return wheel < 2 ? measured_[wheel] : 0.0f;
+    }
+
+    void RRSpeedOpHandler::service()
+    {
+        if (status_ != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            return;
+        }
+
+        if (enabled_ && millis() - setpoint_ms_ > RR_SPEED_TIMEOUT_MS)
+        {
+            release();
+        }
+
+#if !RR_SPEED_TIMER_HW
+        // without a hardware timer, catch up one period per call.
+        if (static_cast<long>(micros() - next_us_) >= 0)
+        {
+            next_us_ += PERIOD_US;
+            tick();
+        }
+#endif
+    }
+
+    void RRSpeedOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_PID && req.op != rr_ble::rr_op_code_t::MSP_SET_PID &&
+            req.op != rr_ble::rr_op_code_t::MSP_SET_WHEEL_SPEED)
+        {
+            set_bad_request(response, org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION);
+        }
+    }
+
+    bool RRSpeedOpHandler::accept_ext(const org_ryderrobots_mousebot_ExtRequest &ereq)
+    {
+        if (!ereq.has_heading_gains)
+        {
+            return true;
+        }
+        rr_motor::HeadingGains g = {ereq.heading_gains.kp, ereq.heading_gains.kd, ereq.heading_gains.max_correction};
+        return valid(g);
+    }
+
+    void RRSpeedOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        if (ereq.has_speed_gains)
+        {
+            rr_control::Gains g = {
+                ereq.speed_gains.kp,
+                ereq.speed_gains.ki,
+                ereq.speed_gains.kd,
+                ereq.speed_gains.kff,
+                ereq.speed_gains.kstatic,
+            };
+            set_gains(g);
+        }
+        if (ereq.has_heading_gains)
+        {
+            rr_motor::HeadingGains g = {
+                ereq.heading_gains.kp,
+                ereq.heading_gains.kd,
+                ereq.heading_gains.max_correction,
+            };
+            set_heading_gains(g);
+        }
+        if (ereq.has_heading_hold)
+        {
+            hold_heading(ereq.heading_hold.enabled, ereq.heading_hold.target);
+        }
+        if (ereq.has_wheel_speed)
+        {
+            set_speed(ereq.wheel_speed.left, ereq.wheel_speed.right);
+        }
+
+        org_ryderrobots_mousebot_SpeedState &s = eres.speed;
+        s.enabled = enabled_;
+        noInterrupts();
+        s.setpoint.left = setpoint_[0];
+        s.setpoint.right = setpoint_[1];
+        interrupts();
+        s.has_setpoint = true;
+        s.measured.left = measured_[0];
+        s.measured.right = measured_[1];
+        s.has_measured = true;
+        s.left_output = output_[0];
+        s.right_output = output_[1];
+
+        s.gains.kp = gains_.kp;
+        s.gains.ki = gains_.ki;
+        s.gains.kd = gains_.kd;
+        s.gains.kff = gains_.kff;
+        s.gains.kstatic = gains_.kstatic;
+        s.has_gains = true;
+
+        rr_control::LoopTiming t = timing();
+        s.timing.count = t.count;
+        s.timing.period_min_us = t.count > 1 ? t.period_min_us : 0;
+        s.timing.period_max_us = t.period_max_us;
+        s.timing.period_mean_us = mean(t.period_sum_us, t.count > 1 ? t.count - 1 : 0);
+        s.timing.exec_min_us = t.count > 0 ? t.exec_min_us : 0;
+        s.timing.exec_max_us = t.exec_max_us;
+        s.timing.exec_mean_us = mean(t.exec_sum_us, t.count);
+        s.timing.overruns = t.overruns;
+        s.has_timing = true;
+
+        s.heading_hold.enabled = hold_;
+        s.heading_hold.target = target_heading_;
+        s.has_heading_hold = true;
+        s.heading_gains.kp = heading_gains_.kp;
+        s.heading_gains.kd = heading_gains_.kd;
+        s.heading_gains.max_correction = heading_gains_.max_correction;
+        s.has_heading_gains = true;
+        s.yaw = yaw_;
+        s.heading_correction = correction_;
+        eres.has_speed = true;
+    }
+}
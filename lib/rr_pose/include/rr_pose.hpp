@@ -0,0 +1,162 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_POSE_HPP
+#define RR_POSE_HPP
+
+#include <cstdint>
+#include <rr_math.hpp>
+
+namespace rr_pose
+{
+    /**
+     * Estimator geometry and tuning.
+     */
+    struct Config
+    {
+        // distance between wheel contact points (m)
+        float wheel_base_m;
+
+        // distance travelled by a wheel for one encoder tick (m)
+        float metres_per_tick;
+
+        // weight (0 .. 1) given to the gyroscope when propagating heading, the remainder pulls heading
+        // towards the encoder heading.
+        float gyro_weight;
+
+        // if gyroscope and encoder yaw rates disagree by more than this (rad/s) the wheels are assumed to be
+        // slipping, and encoder heading is not trusted for that step.
+        float slip_rad_s;
+    };
+
+    /**
+     * One control period of measurements. Either source may be absent.
+     */
+    struct Measurement
+    {
+        // seconds since the previous update
+        float dt;
+
+        bool has_ticks;
+        // ticks counted by each wheel during dt, positive is forwards.
+        std::int32_t left_ticks;
+        std::int32_t right_ticks;
+
+        bool has_yaw_rate;
+        // rad/s, counter clockwise positive
+        float yaw_rate;
+    };
+
+    /**
+     * Planar pose in the maze frame, metres, radians, and metres / radians per second.
+     */
+    struct Pose
+    {
+        float x;
+        float y;
+        float heading;
+
+        // forward speed, and yaw rate in the robot frame
+        float v;
+        float omega;
+
+        // velocity in the maze frame
+        float vx;
+        float vy;
+    };
+
+    /**
+     * @class TickSource
+     * @brief interface to wheel encoders, counts are cumulative and allowed to wrap.
+     */
+    class TickSource
+    {
+    public:
+        /**
+         * @fn read_ticks
+         * @brief returns false if the encoders are not available.
+         */
+        virtual bool read_ticks(std::int32_t &left, std::int32_t &right) = 0;
+    };
+
+    /**
+     * @class HeadingSource
+     * @brief interface to a heading reference, rad and rad/s, counter clockwise positive.
+     */
+    class HeadingSource
+    {
+    public:
+        /**
+         * @fn read_heading
+         * @brief returns false if no recent heading is available. May be called from interrupt context.
+         */
+        virtual bool read_heading(float &yaw, float &yaw_rate) = 0;
+    };
+
+    /**
+     * @class PoseEstimator
+     * @brief complementary fusion of wheel odometry and gyroscope yaw rate.
+     *
+     * Distance comes from the encoders. Heading is propagated with the gyroscope, which does not see wheel
+     * slip, and is pulled towards the heading integrated from the encoders with weight (1 - gyro_weight),
+     * which removes gyroscope bias drift. While the two yaw rates disagree by more than slip_rad_s the
+     * encoder heading is re-seated on the fused heading, so slip is not fed back into the estimate.
+     *
+     * With only one source present that source is used on its own. Position is integrated at the mid point
+     * heading of each step, so arcs are exact to first order.
+     */
+    class PoseEstimator
+    {
+    private:
+        Config config_ = {0.0f, 0.0f, 0.0f, 0.0f};
+        Pose pose_ = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+        // heading integrated from encoders alone
+        float encoder_heading_ = 0.0f;
+
+    public:
+        PoseEstimator() = default;
+
+        /**
+         * @fn configure
+         * @brief sets geometry and tuning, pose is not changed.
+         *
+         * @return false, leaving the current configuration in place, if config is not valid.
+         */
+        bool configure(const Config &config);
+
+        /**
+         * @fn reset
+         * @brief moves the estimate to x, y (m), and heading (rad), and clears velocities.
+         */
+        void reset(float x, float y, float heading);
+
+        /**
+         * @fn update
+         * @brief advances the estimate by one control period.
+         */
+        void update(const Measurement &m);
+
+        const Pose &pose() const;
+    };
+}
+
+#endif // RR_POSE_HPP
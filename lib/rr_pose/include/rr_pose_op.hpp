@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_POSE_OP_HPP
+#define RR_POSE_OP_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_geometry.hpp>
+#include <rr_imu.hpp>
+#include <rr_pose.hpp>
+
+/**
+ * Rate (Hz) at which the pose is propagated, this is the control rate.
+ */
+#ifndef RR_POSE_RATE_HZ
+#define RR_POSE_RATE_HZ 200
+#endif
+
+/**
+ * Complementary filter tuning, see rr_pose::Config.
+ */
+#ifndef RR_POSE_GYRO_WEIGHT
+#define RR_POSE_GYRO_WEIGHT 0.98f
+#endif
+
+#ifndef RR_POSE_SLIP_RAD_S
+#define RR_POSE_SLIP_RAD_S 1.0f
+#endif
+
+namespace mb_operations
+{
+    /**
+     * @class RRPoseOpHandler
+     * @brief estimates planar pose from wheel encoders and IMU yaw rate, and responds to MSP_POSE.
+     *
+     * The estimate is advanced by service() at RR_POSE_RATE_HZ. Requests, or a subscription, return the latest
+     * estimate in ExtResponse.pose, and ExtRequest.pose_reset moves the estimate before it is reported.
+     *
+     * Until a TickSource is attached heading is tracked from the gyroscope alone, and position does not move.
+     */
+    class RRPoseOpHandler : public mb_operations::MbOperationHandler
+    {
+    private:
+        const RRImuOpHandler &imu_;
+        rr_pose::TickSource *ticks_ = nullptr;
+        rr_pose::PoseEstimator estimator_;
+
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        std::int32_t last_left_ = 0;
+        std::int32_t last_right_ = 0;
+        bool have_ticks_ = false;
+
+        unsigned long last_us_ = 0;
+        unsigned long last_update_ms_ = 0;
+
+    public:
+        explicit RRPoseOpHandler(const RRImuOpHandler &imu);
+        ~RRPoseOpHandler() = default;
+
+        /**
+         * @fn set_tick_source
+         * @brief attaches wheel encoders, may be null.
+         */
+        void set_tick_source(rr_pose::TickSource *ticks);
+
+        /**
+         * @fn init
+         * @brief configures the estimator from RR_POSE_* and places the robot at the origin.
+         */
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn service
+         * @brief advances the estimate once per control period.
+         */
+        void service() override;
+
+        /**
+         * @fn pose
+         * @brief latest estimate.
+         */
+        const rr_pose::Pose &pose() const;
+
+        /**
+         * @fn perform_op
+         * @brief MSP_POSE, the pose itself is returned by perform_ext()
+         */
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies pose_reset if present, and sets pose.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_POSE_OP_HPP
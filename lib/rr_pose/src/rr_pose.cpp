@@ -0,0 +1,102 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_pose.hpp>
+#include <cmath>
+
+namespace rr_pose
+{
+    bool PoseEstimator::configure(const Config &config)
+    {
+        if (!(config.wheel_base_m > 0.0f) || !(config.metres_per_tick > 0.0f) ||
+            config.gyro_weight < 0.0f || config.gyro_weight > 1.0f || config.slip_rad_s < 0.0f)
+        {
+            return false;
+        }
+        config_ = config;
+        return true;
+    }
+
+    void PoseEstimator::reset(float x, float y, float heading)
+    {
+        pose_ = {x, y, rr_math::wrap_pi(heading), 0.0f, 0.0f, 0.0f, 0.0f};
+        encoder_heading_ = pose_.heading;
+    }
+
+    void PoseEstimator::update(const Measurement &m)
+    {
+        if (!(m.dt > 0.0f) || !(config_.wheel_base_m > 0.0f))
+        {
+            return;
+        }
+
+        float ds = 0.0f;
+        float d_encoder = 0.0f;
+        if (m.has_ticks)
+        {
+            float dl = static_cast<float>(m.left_ticks) * config_.metres_per_tick;
+            float dr = static_cast<float>(m.right_ticks) * config_.metres_per_tick;
+            ds = 0.5f * (dl + dr);
+            d_encoder = (dr - dl) / config_.wheel_base_m;
+        }
+
+        float dtheta = 0.0f;
+        bool fused = false;
+        if (m.has_yaw_rate)
+        {
+            float d_gyro = m.yaw_rate * m.dt;
+            dtheta = d_gyro;
+            if (m.has_ticks && std::fabs(d_gyro - d_encoder) <= config_.slip_rad_s * m.dt)
+            {
+                encoder_heading_ = rr_math::wrap_pi(encoder_heading_ + d_encoder);
+                float error = rr_math::wrap_pi(encoder_heading_ - (pose_.heading + d_gyro));
+                dtheta += (1.0f - config_.gyro_weight) * error;
+                fused = true;
+            }
+        }
+        else if (m.has_ticks)
+        {
+            dtheta = d_encoder;
+        }
+
+        float s, c;
+        rr_math::sin_cos(pose_.heading + 0.5f * dtheta, &s, &c);
+        pose_.x += ds * c;
+        pose_.y += ds * s;
+        pose_.heading = rr_math::wrap_pi(pose_.heading + dtheta);
+
+        pose_.v = ds / m.dt;
+        pose_.omega = dtheta / m.dt;
+        pose_.vx = pose_.v * c;
+        pose_.vy = pose_.v * s;
+
+        // a single source, or slip, leaves nothing to compare against so the encoder heading follows.
+        if (!fused)
+        {
+            encoder_heading_ = pose_.heading;
+        }
+    }
+
+    const Pose &PoseEstimator::pose() const
+    {
+        return pose_;
+    }
+}
@@ -0,0 +1,175 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_pose_op.hpp>
+
+namespace mb_operations
+{
+    namespace
+    {
+        constexpr unsigned long PERIOD_US = 1000000UL / RR_POSE_RATE_HZ;
+
+        // over steps longer than this the gyroscope rate is not integrated, one sample does not stand for the gap.
+        constexpr unsigned long MAX_STEP_US = 4 * PERIOD_US;
+
+        // the estimate is stale if service() has not run for this long.
+        constexpr unsigned long STALE_MS = 50;
+
+        void set_bad_request(org_ryderrobots_ros2_serial_Response &response, org_ryderrobots_ros2_serial_ErrorType etype)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = etype;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    RRPoseOpHandler::RRPoseOpHandler(const RRImuOpHandler &imu) : imu_(imu)
+    {
+    }
+
+    void RRPoseOpHandler::set_tick_source(rr_pose::TickSource *ticks)
+    {
+        ticks_ = ticks;
+        have_ticks_ = false;
+    }
+
+    void RRPoseOpHandler::init()
+    {
+        rr_pose::Config config = {
+            RR_WHEEL_BASE_M,
+            rr_ble::METRES_PER_TICK,
+            RR_POSE_GYRO_WEIGHT,
+            RR_POSE_SLIP_RAD_S,
+        };
+        if (!estimator_.configure(config))
+        {
+            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_FAILURE;
+            return;
+        }
+        estimator_.reset(0.0f, 0.0f, 0.0f);
+        last_us_ = micros();
+    }
+
+    org_ryderrobots_ros2_serial_Status RRPoseOpHandler::status()
+    {
+        if (status_ == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY &&
+            millis() - last_update_ms_ > STALE_MS)
+        {
+            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+        }
+        return status_;
+    }
+
+    void RRPoseOpHandler::service()
+    {
+        if (status_ == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_FAILURE)
+        {
+            return;
+        }
+        unsigned long now = micros();
+        unsigned long elapsed = now - last_us_;
+        if (elapsed < PERIOD_US)
+        {
+            return;
+        }
+        last_us_ = now;
+
+        rr_pose::Measurement m = {static_cast<float>(elapsed) * 1e-6f, false, 0, 0, false, 0.0f};
+
+        std::int32_t left, right;
+        if (ticks_ != nullptr && ticks_->read_ticks(left, right))
+        {
+            if (have_ticks_)
+            {
+                // counters may wrap, differences in unsigned arithmetic are still correct.
+                m.left_ticks = static_cast<std::int32_t>(static_cast<std::uint32_t>(left) - static_cast<std::uint32_t>(last_left_));
+                m.right_ticks = static_cast<std::int32_t>(static_cast<std::uint32_t>(right) - static_cast<std::uint32_t>(last_right_));
+                m.has_ticks = true;
+            }
+            last_left_ = left;
+            last_right_ = right;
+            have_ticks_ = true;
+        }
+        else
+        {
+            have_ticks_ = false;
+        }
+        m.has_yaw_rate = imu_.yaw_rate(m.yaw_rate);
+
+        if (!m.has_ticks && !m.has_yaw_rate)
+        {
+            return;
+        }
+        // the ticks were consumed and hold all the distance covered, whatever the gap.
+        if (elapsed > MAX_STEP_US)
+        {
+            m.has_yaw_rate = false;
+        }
+        if (m.has_ticks || m.has_yaw_rate)
+        {
+            estimator_.update(m);
+        }
+        last_update_ms_ = millis();
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    const rr_pose::Pose &RRPoseOpHandler::pose() const
+    {
+        return estimator_.pose();
+    }
+
+    void RRPoseOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = rr_ble::rr_op_code_t::MSP_POSE;
+
+        if (status() != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            set_bad_request(response, org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_SERVICE_UNAVAILABLE);
+            return;
+        }
+
+        if (req.which_data != org_ryderrobots_ros2_serial_Request_monitor_tag)
+        {
+            set_bad_request(response, org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION);
+        }
+    }
+
+    void RRPoseOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        if (ereq.has_pose_reset)
+        {
+            estimator_.reset(ereq.pose_reset.x, ereq.pose_reset.y, ereq.pose_reset.heading);
+        }
+
+        const rr_pose::Pose &p = estimator_.pose();
+        eres.pose.x = p.x;
+        eres.pose.y = p.y;
+        eres.pose.heading = p.heading;
+        eres.pose.v = p.v;
+        eres.pose.omega = p.omega;
+        eres.pose.vx = p.vx;
+        eres.pose.vy = p.vy;
+        eres.pose.timestamp_ms = static_cast<std::uint32_t>(last_update_ms_);
+        eres.has_pose = true;
+    }
+}
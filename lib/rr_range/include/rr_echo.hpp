@@ -0,0 +1,167 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_ECHO_HPP
+#define RR_ECHO_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * On the nRF52840 ultrasonic echoes are timed by TIMER0. Both edges of the active echo pin are routed by GPIOTE
+ * and PPI into its CAPTURE tasks, so pulse widths are exact to 1us whenever the main loop gets to read them, and
+ * the trigger pulse is ended by a TIMER0 compare. Elsewhere edges come from mock_echo().
+ *
+ * TIMER0 belongs to the BLE link layer, it is free because the host link is USB serial.
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define RR_RANGE_HW 1
+#else
+#define RR_RANGE_HW 0
+#endif
+
+/**
+ * First of two GPIOTE channels (trigger task, echo event), first of three PPI channels, and the PPI group used
+ * by the echo capture.
+ */
+#ifndef RR_RANGE_GPIOTE_BASE
+#define RR_RANGE_GPIOTE_BASE 2
+#endif
+
+#ifndef RR_RANGE_PPI_BASE
+#define RR_RANGE_PPI_BASE 12
+#endif
+
+#ifndef RR_RANGE_PPI_GROUP
+#define RR_RANGE_PPI_GROUP 5
+#endif
+
+/**
+ * Trigger pulse length, HC-SR04 style sensors need at least 10us.
+ */
+#ifndef RR_RANGE_TRIGGER_US
+#define RR_RANGE_TRIGGER_US 10
+#endif
+
+namespace rr_range
+{
+    /**
+     * Trigger and echo pin of one sensor, nRF GPIO numbers.
+     */
+    struct EchoPins
+    {
+        std::uint8_t trigger;
+        std::uint8_t echo;
+    };
+
+    /**
+     * @class EchoCapture
+     * @brief times one ultrasonic echo at a time, without blocking.
+     *
+     * trigger() starts a measurement on a sensor, and restarts the time base, echo() then reports the echo
+     * pulse once both of its edges have been captured. Only one sensor can be measured at a time, the capture
+     * is moved between sensors by the next trigger().
+     */
+    class EchoCapture
+    {
+    public:
+        EchoCapture(const EchoCapture &) = delete;
+        EchoCapture &operator=(const EchoCapture &) = delete;
+
+        static EchoCapture &get_instance();
+
+        /**
+         * @fn begin
+         * @brief configures the trigger pins as outputs (low), echo pins as inputs, and TIMER0.
+         */
+        bool begin(const EchoPins *pins, size_t count);
+
+        /**
+         * @fn idle
+         * @brief false while the sensor still drives its echo line, it ignores triggers until then.
+         */
+        bool idle(const EchoPins &pins) const;
+
+        /**
+         * @fn trigger
+         * @brief starts a measurement on pins. Returns without waiting for the trigger pulse to end.
+         */
+        void trigger(const EchoPins &pins);
+
+        /**
+         * @fn elapsed_us
+         * @brief microseconds since the last trigger().
+         */
+        std::uint32_t elapsed_us();
+
+        /**
+         * @fn echo
+         * @brief once the echo has ended, its width, and the time it ended, both in microseconds after the trigger.
+         */
+        bool echo(std::uint32_t &width_us, std::uint32_t &end_us);
+
+#if !RR_RANGE_HW
+        /**
+         * @fn mock_echo
+         * @brief echo raised rise_us, and dropped fall_us, after each trigger of the sensor on echo_pin.
+         * A fall_us of 0 removes the echo.
+         */
+        void mock_echo(std::uint8_t echo_pin, std::uint32_t rise_us, std::uint32_t fall_us);
+
+        /**
+         * @fn mock_busy
+         * @brief holds the echo line of echo_pin high, as a sensor still sending a previous echo does.
+         */
+        void mock_busy(std::uint8_t echo_pin, bool busy);
+
+        std::uint32_t mock_triggers() const;
+
+        /**
+         * @fn mock_triggered
+         * @brief echo pin of the last trigger().
+         */
+        std::uint8_t mock_triggered() const;
+#endif
+
+    private:
+        bool ready_ = false;
+
+#if !RR_RANGE_HW
+        static constexpr size_t MOCK_PINS = 48;
+
+        struct MockEcho
+        {
+            std::uint32_t rise_us;
+            std::uint32_t fall_us;
+            bool busy;
+        };
+        MockEcho mock_[MOCK_PINS] = {};
+        std::uint32_t trigger_us_ = 0;
+        std::uint8_t echo_pin_ = 0;
+        std::uint32_t triggers_ = 0;
+#endif
+
+        EchoCapture() = default;
+    };
+}
+
+#endif // RR_ECHO_HPP
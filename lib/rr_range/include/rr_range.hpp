@@ -0,0 +1,238 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_RANGE_HPP
+#define RR_RANGE_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_echo.hpp>
+#include <rr_median.hpp>
+
+/**
+ * Number of ultrasonic range sensors, at most RR_RANGE_MAX_SENSORS (the readings max_count in
+ * proto/rr_mousebot.options).
+ */
+#ifndef RR_RANGE_SENSORS
+#define RR_RANGE_SENSORS 3
+#endif
+
+#define RR_RANGE_MAX_SENSORS 4
+
+/**
+ * Sensor trigger and echo pins, nRF GPIO numbers. Defaults are D10 (P1.02) / D11 (P1.01) left,
+ * A0 (P0.04) / A1 (P0.05) front, A2 (P0.30) / A3 (P0.29) right, and D12 (P1.08) / D13 (P0.13).
+ */
+#ifndef RR_RANGE_0_TRIGGER_PIN
+#define RR_RANGE_0_TRIGGER_PIN 34
+#endif
+
+#ifndef RR_RANGE_0_ECHO_PIN
+#define RR_RANGE_0_ECHO_PIN 33
+#endif
+
+#ifndef RR_RANGE_1_TRIGGER_PIN
+#define RR_RANGE_1_TRIGGER_PIN 4
+#endif
+
+#ifndef RR_RANGE_1_ECHO_PIN
+#define RR_RANGE_1_ECHO_PIN 5
+#endif
+
+#ifndef RR_RANGE_2_TRIGGER_PIN
+#define RR_RANGE_2_TRIGGER_PIN 30
+#endif
+
+#ifndef RR_RANGE_2_ECHO_PIN
+#define RR_RANGE_2_ECHO_PIN 29
+#endif
+
+#ifndef RR_RANGE_3_TRIGGER_PIN
+#define RR_RANGE_3_TRIGGER_PIN 40
+#endif
+
+#ifndef RR_RANGE_3_ECHO_PIN
+#define RR_RANGE_3_ECHO_PIN 13
+#endif
+
+/**
+ * Each sensor is given a slot of RR_RANGE_SLOT_US to itself, long enough for the echoes of its ping to die
+ * away before the next sensor is triggered. An echo that has not ended RR_RANGE_TIMEOUT_US after the trigger
+ * is reported as no echo.
+ */
+#ifndef RR_RANGE_SLOT_US
+#define RR_RANGE_SLOT_US 30000
+#endif
+
+#ifndef RR_RANGE_TIMEOUT_US
+#define RR_RANGE_TIMEOUT_US 25000
+#endif
+
+/**
+ * Readings further than RR_RANGE_MAX_M are reported as no echo.
+ */
+#ifndef RR_RANGE_MAX_M
+#define RR_RANGE_MAX_M 2.0f
+#endif
+
+/**
+ * Every sensor's readings pass through a Hampel filter over its last RR_RANGE_FILTER_WINDOW readings. Readings
+ * more than RR_RANGE_HAMPEL_K scaled MADs (never less than RR_RANGE_HAMPEL_MIN_SCALE m) from the median are
+ * replaced by the median.
+ */
+#ifndef RR_RANGE_FILTER_WINDOW
+#define RR_RANGE_FILTER_WINDOW 7
+#endif
+
+#ifndef RR_RANGE_HAMPEL_K
+#define RR_RANGE_HAMPEL_K 3.0f
+#endif
+
+#ifndef RR_RANGE_HAMPEL_MIN_SCALE
+#define RR_RANGE_HAMPEL_MIN_SCALE 0.005f
+#endif
+
+/**
+ * Speed of sound, m/s, at 20C.
+ */
+#ifndef RR_RANGE_SPEED_OF_SOUND
+#define RR_RANGE_SPEED_OF_SOUND 343.0f
+#endif
+
+namespace rr_range
+{
+    /**
+     * Latest measurement of one sensor. valid is false until the first echo, and after a ping without one.
+     * timestamp_us is the micros() time the measurement finished, whether or not it found an echo.
+     *
+     * filtered is the Hampel filter output, filtered_valid is false while it sits at the maximum range (no
+     * echo), outlier is set when this measurement was rejected, and confidence is the fraction of the filter
+     * window that holds accepted echoes.
+     */
+    struct Reading
+    {
+        bool valid;
+        float distance;
+        std::uint32_t echo_us;
+        std::uint32_t timestamp_us;
+        bool filtered_valid;
+        float filtered;
+        float confidence;
+        bool outlier;
+    };
+}
+
+namespace mb_operations
+{
+    /**
+     * @class RRRangeOpHandler
+     * @brief ultrasonic range sensors, responds to MSP_RAW_SENSORS.
+     *
+     * Sensors are pinged one at a time in round robin, so that no sensor hears another's echo. service() moves
+     * the measurement along without waiting on the echo, which is timed by rr_range::EchoCapture, and keeps the
+     * latest reading of every sensor, with its outlier filtered value. MSP_RAW_SENSORS returns those readings
+     * in ExtResponse.range, it never triggers or waits on a sensor.
+     */
+    class RRRangeOpHandler : public mb_operations::MbOperationHandler
+    {
+    private:
+        rr_range::EchoCapture &capture_ = rr_range::EchoCapture::get_instance();
+
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        rr_range::Reading readings_[RR_RANGE_SENSORS] = {};
+        rr_filter::Hampel<RR_RANGE_FILTER_WINDOW> filters_[RR_RANGE_SENSORS];
+        size_t current_ = 0;
+        bool measuring_ = false;
+        bool done_ = false;
+        std::uint32_t trigger_us_ = 0;
+        std::uint32_t cycles_ = 0;
+        std::uint32_t timeouts_ = 0;
+
+        // a reading was stored since the round began.
+        bool stored_ = false;
+
+        /*
+         * pings current_, or the first sensor after it whose echo line is idle. Busy sensors that are skipped
+         * lose their readings, which keep their timestamp.
+         */
+        void start();
+
+        /*
+         * moves on to the next sensor, counting a cycle when the round wraps after storing a reading.
+         */
+        void advance();
+
+        void store(bool valid, std::uint32_t echo_us, std::uint32_t end_us);
+
+    public:
+        RRRangeOpHandler() = default;
+        ~RRRangeOpHandler() = default;
+
+        /**
+         * @fn init
+         * @brief configures the sensor pins and echo capture, clears the readings and filters, and pings the first
+         * sensor.
+         */
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn service
+         * @brief stores the current sensor's echo once it has ended or timed out, and pings the next sensor once
+         * the slot is over. Never waits.
+         */
+        void service() override;
+
+        size_t sensors() const;
+
+        /**
+         * @fn reading
+         * @brief latest reading of sensor, sensor must be below sensors().
+         */
+        const rr_range::Reading &reading(size_t sensor) const;
+
+        /**
+         * @fn cycles
+         * @brief number of completed rounds over all sensors, in which a reading was stored.
+         */
+        std::uint32_t cycles() const;
+
+        std::uint32_t timeouts() const;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief sets range from the cached readings.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_RANGE_HPP
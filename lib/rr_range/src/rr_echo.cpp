@@ -0,0 +1,219 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_echo.hpp>
+
+#include <Arduino.h>
+
+#if RR_RANGE_HW
+#include <nrf.h>
+#endif
+
+namespace rr_range
+{
+    namespace
+    {
+#if RR_RANGE_HW
+        constexpr std::uint32_t GPIOTE_TRIGGER = RR_RANGE_GPIOTE_BASE;
+        constexpr std::uint32_t GPIOTE_ECHO = RR_RANGE_GPIOTE_BASE + 1;
+
+        // first edge into CC[1], then removed from the group. every edge into CC[2], so it ends on the falling edge.
+        constexpr std::uint32_t PPI_RISE = RR_RANGE_PPI_BASE;
+        constexpr std::uint32_t PPI_EDGE = RR_RANGE_PPI_BASE + 1;
+        constexpr std::uint32_t PPI_TRIGGER_END = RR_RANGE_PPI_BASE + 2;
+
+        inline NRF_GPIO_Type *port(std::uint32_t pin)
+        {
+            return (pin >> 5) ? NRF_P1 : NRF_P0;
+        }
+
+        inline std::uint32_t psel(std::uint32_t pin)
+        {
+            return ((pin & 0x1F) << GPIOTE_CONFIG_PSEL_Pos) | ((pin >> 5) << GPIOTE_CONFIG_PORT_Pos);
+        }
+#endif
+    }
+
+    EchoCapture &EchoCapture::get_instance()
+    {
+        static EchoCapture instance;
+        return instance;
+    }
+
+    bool EchoCapture::begin(const EchoPins *pins, size_t count)
+    {
+        if (pins == nullptr || count == 0)
+        {
+            return false;
+        }
+
+#if RR_RANGE_HW
+        for (size_t i = 0; i < count; i++)
+        {
+            std::uint32_t trig = pins[i].trigger;
+            std::uint32_t echo = pins[i].echo;
+            port(trig)->OUTCLR = 1UL << (trig & 0x1F);
+            port(trig)->PIN_CNF[trig & 0x1F] = (GPIO_PIN_CNF_DIR_Output << GPIO_PIN_CNF_DIR_Pos) |
+                                               (GPIO_PIN_CNF_INPUT_Disconnect << GPIO_PIN_CNF_INPUT_Pos);
+            // pulled down, so a missing sensor reads as no echo rather than a floating line.
+            port(echo)->PIN_CNF[echo & 0x1F] = (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos) |
+                                               (GPIO_PIN_CNF_INPUT_Connect << GPIO_PIN_CNF_INPUT_Pos) |
+                                               (GPIO_PIN_CNF_PULL_Pulldown << GPIO_PIN_CNF_PULL_Pos);
+        }
+
+        NRF_TIMER0->TASKS_STOP = 1;
+        NRF_TIMER0->MODE = TIMER_MODE_MODE_Timer << TIMER_MODE_MODE_Pos;
+        NRF_TIMER0->BITMODE = TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos;
+        // 16MHz / 2^4, 1us per count.
+        NRF_TIMER0->PRESCALER = 4;
+        NRF_TIMER0->SHORTS = 0;
+        NRF_TIMER0->INTENCLR = 0xFFFFFFFF;
+        NRF_TIMER0->CC[3] = RR_RANGE_TRIGGER_US;
+        NRF_TIMER0->TASKS_CLEAR = 1;
+
+        NRF_PPI->CHENCLR = (1UL << PPI_RISE) | (1UL << PPI_EDGE) | (1UL << PPI_TRIGGER_END);
+        NRF_PPI->CHG[RR_RANGE_PPI_GROUP] = 1UL << PPI_RISE;
+
+        NRF_PPI->CH[PPI_RISE].EEP = reinterpret_cast<std::uint32_t>(&NRF_GPIOTE->EVENTS_IN[GPIOTE_ECHO]);
+        NRF_PPI->CH[PPI_RISE].TEP = reinterpret_cast<std::uint32_t>(&NRF_TIMER0->TASKS_CAPTURE[1]);
+        NRF_PPI->FORK[PPI_RISE].TEP = reinterpret_cast<std::uint32_t>(&NRF_PPI->TASKS_CHG[RR_RANGE_PPI_GROUP].DIS);
+
+        NRF_PPI->CH[PPI_EDGE].EEP = reinterpret_cast<std::uint32_t>(&NRF_GPIOTE->EVENTS_IN[GPIOTE_ECHO]);
+        NRF_PPI->CH[PPI_EDGE].TEP = reinterpret_cast<std::uint32_t>(&NRF_TIMER0->TASKS_CAPTURE[2]);
+
+        NRF_PPI->CH[PPI_TRIGGER_END].EEP = reinterpret_cast<std::uint32_t>(&NRF_TIMER0->EVENTS_COMPARE[3]);
+        NRF_PPI->CH[PPI_TRIGGER_END].TEP = reinterpret_cast<std::uint32_t>(&NRF_GPIOTE->TASKS_CLR[GPIOTE_TRIGGER]);
+#else
+        (void)pins;
+        triggers_ = 0;
+#endif
+        ready_ = true;
+        return true;
+    }
+
+    bool EchoCapture::idle(const EchoPins &pins) const
+    {
+#if RR_RANGE_HW
+        return ((port(pins.echo)->IN >> (pins.echo & 0x1F)) & 1UL) == 0;
+#else
+        return pins.echo >= MOCK_PINS || !mock_[pins.echo].busy;
+#endif
+    }
+
+    void EchoCapture::trigger(const EchoPins &pins)
+    {
+        if (!ready_)
+        {
+            return;
+        }
+
+#if RR_RANGE_HW
+        NRF_TIMER0->TASKS_STOP = 1;
+        NRF_TIMER0->TASKS_CLEAR = 1;
+        // 0 marks an edge not yet captured, no edge can arrive at 0 as the timer starts after the trigger.
+        NRF_TIMER0->CC[1] = 0;
+        NRF_TIMER0->CC[2] = 0;
+        NRF_TIMER0->EVENTS_COMPARE[3] = 0;
+
+        NRF_GPIOTE->CONFIG[GPIOTE_TRIGGER] = (GPIOTE_CONFIG_MODE_Task << GPIOTE_CONFIG_MODE_Pos) |
+                                             psel(pins.trigger) |
+                                             (GPIOTE_CONFIG_POLARITY_None << GPIOTE_CONFIG_POLARITY_Pos) |
+                                             (GPIOTE_CONFIG_OUTINIT_Low << GPIOTE_CONFIG_OUTINIT_Pos);
+        NRF_GPIOTE->CONFIG[GPIOTE_ECHO] = (GPIOTE_CONFIG_MODE_Event << GPIOTE_CONFIG_MODE_Pos) |
+                                          psel(pins.echo) |
+                                          (GPIOTE_CONFIG_POLARITY_Toggle << GPIOTE_CONFIG_POLARITY_Pos);
+        NRF_GPIOTE->EVENTS_IN[GPIOTE_ECHO] = 0;
+
+        NRF_PPI->CHENSET = (1UL << PPI_RISE) | (1UL << PPI_EDGE) | (1UL << PPI_TRIGGER_END);
+        NRF_GPIOTE->TASKS_SET[GPIOTE_TRIGGER] = 1;
+        NRF_TIMER0->TASKS_START = 1;
+#else
+        trigger_us_ = static_cast<std::uint32_t>(micros());
+        echo_pin_ = pins.echo;
+        triggers_++;
+#endif
+    }
+
+    std::uint32_t EchoCapture::elapsed_us()
+    {
+#if RR_RANGE_HW
+        NRF_TIMER0->TASKS_CAPTURE[0] = 1;
+        return NRF_TIMER0->CC[0];
+#else
+        return static_cast<std::uint32_t>(micros()) - trigger_us_;
+#endif
+    }
+
+    bool EchoCapture::echo(std::uint32_t &width_us, std::uint32_t &end_us)
+    {
+#if RR_RANGE_HW
+        // rising edge first, a falling edge between the two reads then still shows as complete.
+        std::uint32_t rise = NRF_TIMER0->CC[1];
+        std::uint32_t last = NRF_TIMER0->CC[2];
+#else
+        if (echo_pin_ >= MOCK_PINS || mock_[echo_pin_].fall_us == 0)
+        {
+            return false;
+        }
+        std::uint32_t now = elapsed_us();
+        const MockEcho &m = mock_[echo_pin_];
+        std::uint32_t rise = now >= m.rise_us ? m.rise_us : 0;
+        std::uint32_t last = now >= m.fall_us ? m.fall_us : rise;
+#endif
+        if (rise == 0 || last == rise)
+        {
+            return false;
+        }
+        width_us = last - rise;
+        end_us = last;
+        return true;
+    }
+
+#if !RR_RANGE_HW
+    void EchoCapture::mock_echo(std::uint8_t echo_pin, std::uint32_t rise_us, std::uint32_t fall_us)
+    {
+        if (echo_pin < MOCK_PINS)
+        {
+            mock_[echo_pin].rise_us = rise_us;
+            mock_[echo_pin].fall_us = fall_us;
+        }
+    }
+
+    void EchoCapture::mock_busy(std::uint8_t echo_pin, bool busy)
+    {
+        if (echo_pin < MOCK_PINS)
+        {
+            mock_[echo_pin].busy = busy;
+        }
+    }
+
+    std::uint32_t EchoCapture::mock_triggers() const
+    {
+        return triggers_;
+    }
+
+    std::uint8_t EchoCapture::mock_triggered() const
+    {
+        return echo_pin_;
+    }
+#endif
+}
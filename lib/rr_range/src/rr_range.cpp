@@ -0,0 +1,226 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_range.hpp>
+
+namespace mb_operations
+{
+    namespace
+    {
+        static_assert(RR_RANGE_SENSORS >= 1 && RR_RANGE_SENSORS <= RR_RANGE_MAX_SENSORS, "RR_RANGE_SENSORS out of range");
+        static_assert(RR_RANGE_SLOT_US >= RR_RANGE_TIMEOUT_US, "a slot must outlast the echo timeout");
+
+        const rr_range::EchoPins PINS[RR_RANGE_MAX_SENSORS] = {
+            {RR_RANGE_0_TRIGGER_PIN, RR_RANGE_0_ECHO_PIN},
+            {RR_RANGE_1_TRIGGER_PIN, RR_RANGE_1_ECHO_PIN},
+            {RR_RANGE_2_TRIGGER_PIN, RR_RANGE_2_ECHO_PIN},
+            {RR_RANGE_3_TRIGGER_PIN, RR_RANGE_3_ECHO_PIN},
+        };
+
+        // the echo covers the distance twice.
+        constexpr float METRES_PER_US = RR_RANGE_SPEED_OF_SOUND * 0.5e-6f;
+    }
+
+    void RRRangeOpHandler::init()
+    {
+        if (!capture_.begin(PINS, RR_RANGE_SENSORS))
+        {
+            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_FAILURE;
+            return;
+        }
+
+        for (size_t i = 0; i < RR_RANGE_SENSORS; i++)
+        {
+            readings_[i] = {false, 0.0f, 0, 0, false, 0.0f, 0.0f, false};
+            filters_[i].configure(RR_RANGE_HAMPEL_K, RR_RANGE_HAMPEL_MIN_SCALE);
+        }
+        current_ = 0;
+        measuring_ = false;
+        done_ = false;
+        cycles_ = 0;
+        timeouts_ = 0;
+        stored_ = false;
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+        start();
+    }
+
+    org_ryderrobots_ros2_serial_Status RRRangeOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRRangeOpHandler::start()
+    {
+        for (size_t n = 0; n < RR_RANGE_SENSORS; n++)
+        {
+            if (capture_.idle(PINS[current_]))
+            {
+                trigger_us_ = static_cast<std::uint32_t>(micros());
+                capture_.trigger(PINS[current_]);
+                measuring_ = true;
+                done_ = false;
+                return;
+            }
+            // still sending an echo from an earlier ping, it would ignore the trigger. retried next round, its
+            // last reading no longer stands.
+            rr_range::Reading &r = readings_[current_];
+            r.valid = false;
+            r.distance = 0.0f;
+            r.filtered_valid = false;
+            r.filtered = 0.0f;
+            advance();
+        }
+    }
+
+    void RRRangeOpHandler::advance()
+    {
+        measuring_ = false;
+        current_ = (current_ + 1) % RR_RANGE_SENSORS;
+        if (current_ == 0)
+        {
+            // every sensor busy makes no round.
+            if (stored_)
+            {
+                cycles_++;
+            }
+            stored_ = false;
+        }
+    }
+
+    void RRRangeOpHandler::store(bool valid, std::uint32_t echo_us, std::uint32_t end_us)
+    {
+        rr_range::Reading &r = readings_[current_];
+        float distance = static_cast<float>(echo_us) * METRES_PER_US;
+        r.valid = valid && distance <= RR_RANGE_MAX_M;
+        r.distance = r.valid ? distance : 0.0f;
+        r.echo_us = echo_us;
+        r.timestamp_us = trigger_us_ + end_us;
+
+        // no echo enters the filter at maximum range, so an isolated dropout is rejected like any spike.
+        rr_filter::Hampel<RR_RANGE_FILTER_WINDOW> &filter = filters_[current_];
+        float filtered = filter.push(r.valid ? distance : RR_RANGE_MAX_M, r.valid);
+        r.filtered_valid = filtered < RR_RANGE_MAX_M;
+        r.filtered = r.filtered_valid ? filtered : 0.0f;
+        r.confidence = filter.confidence();
+        r.outlier = filter.outlier();
+        stored_ = true;
+    }
+
+    void RRRangeOpHandler::service()
+    {
+        if (status_ != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            return;
+        }
+        if (!measuring_)
+        {
+            start();
+            return;
+        }
+
+        std::uint32_t elapsed = capture_.elapsed_us();
+        if (!done_)
+        {
+            std::uint32_t width;
+            std::uint32_t end;
+            // an echo that ended after the timeout is rejected, however late the main loop got here.
+            if (capture_.echo(width, end) && end <= RR_RANGE_TIMEOUT_US)
+            {
+                store(true, width, end);
+                done_ = true;
+            }
+            else if (elapsed >= RR_RANGE_TIMEOUT_US)
+            {
+                timeouts_++;
+                store(false, 0, RR_RANGE_TIMEOUT_US);
+                done_ = true;
+            }
+        }
+
+        if (done_ && elapsed >= RR_RANGE_SLOT_US)
+        {
+            advance();
+            start();
+        }
+    }
+
+    size_t RRRangeOpHandler::sensors() const
+    {
+        return RR_RANGE_SENSORS;
+    }
+
+    const rr_range::Reading &RRRangeOpHandler::reading(size_t sensor) const
+    {
+        return readings_[sensor < RR_RANGE_SENSORS ? sensor : 0];
+    }
+
+    std::uint32_t RRRangeOpHandler::cycles() const
+    {
+        return cycles_;
+    }
+
+    std::uint32_t RRRangeOpHandler::timeouts() const
+    {
+        return timeouts_;
+    }
+
+    void RRRangeOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_RAW_SENSORS)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRRangeOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        (void)ereq;
+        std::uint32_t now = static_cast<std::uint32_t>(micros());
+        org_ryderrobots_mousebot_RangeState &range = eres.range;
+        range.readings_count = RR_RANGE_SENSORS;
+        for (size_t i = 0; i < RR_RANGE_SENSORS; i++)
+        {
+            const rr_range::Reading &r = readings_[i];
+            org_ryderrobots_mousebot_RangeReading &out = range.readings[i];
+            out.sensor = static_cast<std::uint32_t>(i);
+            out.valid = r.valid;
+            out.distance = r.distance;
+            out.echo_us = r.echo_us;
+            out.timestamp_us = r.timestamp_us;
+            out.filtered_valid = r.filtered_valid;
+            out.filtered = r.filtered;
+            out.confidence = r.confidence;
+            out.outlier = r.outlier;
+            // a sensor that has not finished a measurement yet has no age.
+            out.age_ms = r.timestamp_us == 0 ? 0 : (now - r.timestamp_us) / 1000;
+        }
+        range.cycles = cycles_;
+        range.timeouts = timeouts_;
+        eres.has_range = true;
+    }
+}
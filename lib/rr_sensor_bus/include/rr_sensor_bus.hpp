@@ -0,0 +1,170 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RR_SENSOR_BUS_HPP
+#define RR_SENSOR_BUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * On the nRF52840 transfers are performed by TWIM1 EasyDMA directly from the internal I2C pins, and the CPU
+ * only starts, and polls for completion. Everywhere else a synchronous mock is used, that completes each transfer
+ * against an attached MockDevice within the poll() that starts it.
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define RR_SENSOR_BUS_TWIM 1
+#else
+#define RR_SENSOR_BUS_TWIM 0
+#endif
+
+// internal I2C bus (Wire1) of the Nano 33 BLE, nRF GPIO numbers.
+#ifndef RR_SENSOR_BUS_SDA_PIN
+#define RR_SENSOR_BUS_SDA_PIN 14
+#endif
+
+#ifndef RR_SENSOR_BUS_SCL_PIN
+#define RR_SENSOR_BUS_SCL_PIN 15
+#endif
+
+namespace rr_sensor_bus
+{
+    /**
+     * completion callback, ok is false if the transfer was not acknowledged, or the bus errored.
+     * Called from poll(), never from interrupt context.
+     */
+    typedef void (*complete_cb_t)(void *ctx, bool ok);
+
+#if !RR_SENSOR_BUS_TWIM
+    /**
+     * @class MockDevice
+     * @brief register level device model, used by the native sensor bus.
+     */
+    class MockDevice
+    {
+    public:
+        virtual bool read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len) = 0;
+
+        virtual bool write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *buf, size_t len) = 0;
+    };
+#endif
+
+    /**
+     * @class SensorBus
+     * @brief asynchronous register reads and writes, shared by all I2C sensors.
+     *
+     * Transfers are queued, and executed one at a time in the order that they were submitted. The buffer
+     * passed to read() MUST remain valid until its callback has been called.
+     *
+     * The main loop calls poll() once per iteration (MBOperationsFactory::service()), which completes the
+     * active transfer, calls its callback, and starts the next one.
+     */
+    class SensorBus
+    {
+    public:
+        static constexpr size_t QUEUE_LEN = 8;
+        static constexpr size_t MAX_WRITE = 4;
+
+        SensorBus(const SensorBus &) = delete;
+        SensorBus &operator=(const SensorBus &) = delete;
+
+        static SensorBus &get_instance();
+
+        /**
+         * @fn begin
+         * @brief takes ownership of the bus peripheral, Wire1 MUST NOT be used afterwards.
+         */
+        bool begin();
+
+        /**
+         * @fn read
+         * @brief queues a read of len bytes starting at register reg.
+         * @return false if the queue is full, or len is zero.
+         */
+        bool read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len, complete_cb_t cb, void *ctx);
+
+        /**
+         * @fn write
+         * @brief queues a write of up to MAX_WRITE bytes starting at register reg, data is copied.
+         * @return false if the queue is full, or len is out of range.
+         */
+        bool write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *data, size_t len, complete_cb_t cb, void *ctx);
+
+        /**
+         * @fn poll
+         * @brief completes the active transfer if it has finished, and starts the next.
+         */
+        void poll();
+
+        /**
+         * @fn flush
+         * @brief blocks, polling until every queued transfer is complete. Only for use during setup().
+         * @return false if timeout_ms elapsed first.
+         */
+        bool flush(unsigned long timeout_ms);
+
+        bool idle() const;
+
+        std::uint32_t errors() const;
+
+#if !RR_SENSOR_BUS_TWIM
+        void attach_mock(MockDevice *dev);
+#endif
+
+    private:
+        struct Transfer
+        {
+            std::uint8_t addr;
+            std::uint8_t tx[MAX_WRITE + 1];
+            std::uint8_t tx_len;
+            std::uint8_t *rx;
+            size_t rx_len;
+            complete_cb_t cb;
+            void *ctx;
+        };
+
+        Transfer queue_[QUEUE_LEN];
+        size_t head_ = 0;
+        size_t count_ = 0;
+        bool active_ = false;
+        std::uint32_t errors_ = 0;
+
+#if !RR_SENSOR_BUS_TWIM
+        MockDevice *mock_ = nullptr;
+#endif
+
+        SensorBus() = default;
+
+        Transfer *push();
+
+        /*
+         * backend, starts queue_[head_] on the peripheral.
+         */
+        void start(Transfer &t);
+
+        /*
+         * backend, returns true once the active transfer has finished, and sets ok.
+         */
+        bool finished(Transfer &t, bool &ok);
+    };
+}
+
+#endif // RR_SENSOR_BUS_HPP
@@ -0,0 +1,261 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <rr_sensor_bus.hpp>
+#include <cstring>
+#include <Arduino.h>
+
+#if RR_SENSOR_BUS_TWIM
+#include <nrf.h>
+#endif
+
+namespace rr_sensor_bus
+{
+    SensorBus &SensorBus::get_instance()
+    {
+        static SensorBus instance;
+        return instance;
+    }
+
+    SensorBus::Transfer *SensorBus::push()
+    {
+        if (count_ == QUEUE_LEN)
+        {
+            return nullptr;
+        }
+        Transfer *t = &queue_[(head_ + count_) % QUEUE_LEN];
+        count_++;
+        return t;
+    }
+
+    bool SensorBus::read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len, complete_cb_t cb, void *ctx)
+    {
+        if (len == 0 || buf == nullptr)
+        {
+            return false;
+        }
+        Transfer *t = push();
+        if (t == nullptr)
+        {
+            return false;
+        }
+        t->addr = addr;
+        t->tx[0] = reg;
+        t->tx_len = 1;
+        t->rx = buf;
+        t->rx_len = len;
+        t->cb = cb;
+        t->ctx = ctx;
+        return true;
+    }
+
+    bool SensorBus::write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *data, size_t len, complete_cb_t cb, void *ctx)
+    {
+        if (len == 0 || len > MAX_WRITE)
+        {
+            return false;
+        }
+        Transfer *t = push();
+        if (t == nullptr)
+        {
+            return false;
+        }
+        t->addr = addr;
+        t->tx[0] = reg;
+        std::memcpy(&t->tx[1], data, len);
+        t->tx_len = static_cast<std::uint8_t>(len + 1);
+        t->rx = nullptr;
+        t->rx_len = 0;
+        t->cb = cb;
+        t->ctx = ctx;
+        return true;
+    }
+
+    void SensorBus::poll()
+    {
+        // on hardware a freshly started transfer is never finished, so this completes at most one transfer and
+        // starts the next. The mock finishes immediately, and drains the queue.
+        for (;;)
+        {
+            if (!active_)
+            {
+                if (count_ == 0)
+                {
+                    return;
+                }
+                active_ = true;
+                start(queue_[head_]);
+            }
+
+            Transfer &t = queue_[head_];
+            bool ok = false;
+            if (!finished(t, ok))
+            {
+                return;
+            }
+            active_ = false;
+            if (!ok)
+            {
+                errors_++;
+            }
+
+            // pop before the callback, so that it can queue a follow up transfer.
+            complete_cb_t cb = t.cb;
+            void *ctx = t.ctx;
+            head_ = (head_ + 1) % QUEUE_LEN;
+            count_--;
+            if (cb != nullptr)
+            {
+                cb(ctx, ok);
+            }
+        }
+    }
+
+    bool SensorBus::flush(unsigned long timeout_ms)
+    {
+        unsigned long start_ms = millis();
+        while (!idle())
+        {
+            if (millis() - start_ms > timeout_ms)
+            {
+                return false;
+            }
+            poll();
+        }
+        return true;
+    }
+
+    bool SensorBus::idle() const
+    {
+        return count_ == 0;
+    }
+
+    std::uint32_t SensorBus::errors() const
+    {
+        return errors_;
+    }
+
+#if RR_SENSOR_BUS_TWIM
+    bool SensorBus::begin()
+    {
+        NRF_TWIM_Type *twim = NRF_TWIM1;
+
+        // completion is polled, so no interrupts from this instance.
+        NVIC_DisableIRQ(SPIM1_SPIS1_TWIM1_TWIS1_SPI1_TWI1_IRQn);
+        twim->ENABLE = TWIM_ENABLE_ENABLE_Disabled << TWIM_ENABLE_ENABLE_Pos;
+        twim->INTENCLR = 0xFFFFFFFF;
+
+        // open drain with the input connected, as TWIM expects, set before it takes the pins.
+        static_assert(RR_SENSOR_BUS_SCL_PIN < 32 && RR_SENSOR_BUS_SDA_PIN < 32, "sensor bus pins must be on P0");
+        const std::uint32_t pins[] = {RR_SENSOR_BUS_SCL_PIN, RR_SENSOR_BUS_SDA_PIN};
+        for (std::uint32_t pin : pins)
+        {
+            NRF_P0->PIN_CNF[pin] = (GPIO_PIN_CNF_DIR_Input << GPIO_PIN_CNF_DIR_Pos) |
+                                   (GPIO_PIN_CNF_INPUT_Connect << GPIO_PIN_CNF_INPUT_Pos) |
+                                   (GPIO_PIN_CNF_PULL_Pullup << GPIO_PIN_CNF_PULL_Pos) |
+                                   (GPIO_PIN_CNF_DRIVE_S0D1 << GPIO_PIN_CNF_DRIVE_Pos) |
+                                   (GPIO_PIN_CNF_SENSE_Disabled << GPIO_PIN_CNF_SENSE_Pos);
+        }
+        twim->PSEL.SCL = RR_SENSOR_BUS_SCL_PIN;
+        twim->PSEL.SDA = RR_SENSOR_BUS_SDA_PIN;
+        twim->FREQUENCY = TWIM_FREQUENCY_FREQUENCY_K400 << TWIM_FREQUENCY_FREQUENCY_Pos;
+        twim->SHORTS = 0;
+        twim->EVENTS_STOPPED = 0;
+        twim->EVENTS_ERROR = 0;
+        twim->ENABLE = TWIM_ENABLE_ENABLE_Enabled << TWIM_ENABLE_ENABLE_Pos;
+        return true;
+    }
+
+    void SensorBus::start(Transfer &t)
+    {
+        NRF_TWIM_Type *twim = NRF_TWIM1;
+        twim->ADDRESS = t.addr;
+        twim->EVENTS_STOPPED = 0;
+        twim->EVENTS_ERROR = 0;
+        twim->ERRORSRC = twim->ERRORSRC;
+        twim->TXD.PTR = reinterpret_cast<std::uint32_t>(t.tx);
+        twim->TXD.MAXCNT = t.tx_len;
+        if (t.rx_len > 0)
+        {
+            // repeated start into the read, then stop, without CPU involvement.
+            twim->RXD.PTR = reinterpret_cast<std::uint32_t>(t.rx);
+            twim->RXD.MAXCNT = t.rx_len;
+            twim->SHORTS = TWIM_SHORTS_LASTTX_STARTRX_Msk | TWIM_SHORTS_LASTRX_STOP_Msk;
+        }
+        else
+        {
+            twim->SHORTS = TWIM_SHORTS_LASTTX_STOP_Msk;
+        }
+        twim->TASKS_STARTTX = 1;
+    }
+
+    bool SensorBus::finished(Transfer &t, bool &ok)
+    {
+        NRF_TWIM_Type *twim = NRF_TWIM1;
+        if (twim->EVENTS_ERROR)
+        {
+            // a NACK does not stop the bus by itself.
+            twim->EVENTS_ERROR = 0;
+            twim->TASKS_STOP = 1;
+        }
+        if (!twim->EVENTS_STOPPED)
+        {
+            return false;
+        }
+        twim->EVENTS_STOPPED = 0;
+        ok = twim->ERRORSRC == 0 && twim->TXD.AMOUNT == t.tx_len && (t.rx_len == 0 || twim->RXD.AMOUNT == t.rx_len);
+        twim->ERRORSRC = twim->ERRORSRC;
+        return true;
+    }
+#else
+    bool SensorBus::begin()
+    {
+        return true;
+    }
+
+    void SensorBus::attach_mock(MockDevice *dev)
+    {
+        mock_ = dev;
+    }
+
+    void SensorBus::start(Transfer &t)
+    {
+        (void)t;
+    }
+
+    bool SensorBus::finished(Transfer &t, bool &ok)
+    {
+        if (mock_ == nullptr)
+        {
+            ok = false;
+        }
+        else if (t.rx_len > 0)
+        {
+            ok = mock_->read(t.addr, t.tx[0], t.rx, t.rx_len);
+        }
+        else
+        {
+            ok = mock_->write(t.addr, t.tx[0], &t.tx[1], t.tx_len - 1);
+        }
+        return true;
+    }
+#endif
+}
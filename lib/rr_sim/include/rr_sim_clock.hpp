@@ -0,0 +1,88 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_CLOCK_HPP
+#define RR_SIM_CLOCK_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace rr_sim
+{
+    /**
+     * @class Clock
+     * @brief the time the firmware sees in the simulator, read by micros() and millis(), and passed by delay().
+     *
+     * A real time clock follows the host's steady clock, so what a client measures over the serial port is what
+     * the firmware sees. A stepped clock only moves by step_us for each loop() iteration, and by delay(), so the
+     * same inputs always take the same path, as fast as the host can run it.
+     */
+    class Clock
+    {
+    public:
+        enum Mode : std::uint8_t
+        {
+            REALTIME = 0,
+            STEPPED = 1,
+        };
+
+    private:
+        Mode mode_ = REALTIME;
+        std::uint32_t step_us_ = 0;
+        std::uint64_t now_us_ = 0;
+        std::chrono::steady_clock::time_point origin_;
+
+    public:
+        Clock();
+
+        /**
+         * @fn start_realtime
+         * @brief restarts the clock at 0, following the host's clock.
+         */
+        void start_realtime();
+
+        /**
+         * @fn start_stepped
+         * @brief restarts the clock at 0, moving step_us for each step().
+         */
+        void start_stepped(std::uint32_t step_us);
+
+        std::uint64_t now_us() const;
+
+        /**
+         * @fn step
+         * @brief ends a loop() iteration, a stepped clock moves on by step_us.
+         */
+        void step();
+
+        /**
+         * @fn sleep
+         * @brief passes us, a real time clock by blocking the calling thread.
+         */
+        void sleep(std::uint64_t us);
+
+        Mode mode() const;
+        std::uint32_t step_us() const;
+    };
+}
+
+#endif // RR_SIM_CLOCK_HPP
@@ -0,0 +1,114 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_IMU_HPP
+#define RR_SIM_IMU_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_sensor_bus.hpp>
+
+namespace rr_sim
+{
+    /**
+     * @class Bmi270
+     * @brief BMI270 register model on the native sensor bus, serving the motion it is given.
+     *
+     * Registers written are kept, and read back, except the 12 byte data burst at DATA_8, which is the last
+     * motion set, at the +/- 4g and +/- 2000 deg/s ranges the firmware scales by. Data ready pulses follow the
+     * output data rate written to ACC_CONF, and none are raised until it has been.
+     */
+    class Bmi270 : public rr_sensor_bus::MockDevice
+    {
+    public:
+        static constexpr std::uint8_t ADDR = 0x68;
+        static constexpr std::uint8_t REG_DATA_8 = 0x0C;
+        static constexpr std::uint8_t REG_ACC_CONF = 0x40;
+        static constexpr size_t DATA_LEN = 12;
+        static constexpr size_t REGS = 128;
+
+        static constexpr float ACC_LSB_PER_G = 32768.0f / 4.0f;
+        static constexpr float GYR_LSB_PER_DPS = 32768.0f / 2000.0f;
+
+    private:
+        std::uint8_t regs_[REGS];
+        float gyro_dps_[3] = {0.0f, 0.0f, 0.0f};
+        float accel_g_[3] = {0.0f, 0.0f, 1.0f};
+
+        std::uint32_t period_us_ = 0;
+        std::uint64_t next_drdy_us_ = 0;
+        std::uint32_t bursts_ = 0;
+
+    public:
+        Bmi270();
+
+        bool read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len) override;
+
+        bool write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *buf, size_t len) override;
+
+        /**
+         * @fn set_motion
+         * @brief sets the rates, deg/s, and accelerations, g, served from now on. A level robot at rest reads
+         * 1g on z.
+         */
+        void set_motion(const float gyro_dps[3], const float accel_g[3]);
+
+        /**
+         * @fn data
+         * @brief the data burst the motion set reads as.
+         */
+        void data(std::uint8_t out[DATA_LEN]) const;
+
+        /**
+         * @fn set_data
+         * @brief sets the motion a data burst was read from, so that it reads the same again.
+         */
+        void set_data(const std::uint8_t in[DATA_LEN]);
+
+        /**
+         * @fn period_us
+         * @brief data ready period of the output data rate in ACC_CONF, 0 until one is written.
+         */
+        std::uint32_t period_us() const;
+
+        /**
+         * @fn data_ready
+         * @brief the data ready pulses since the last call, up to now_us. The first call after the output data
+         * rate is set, or changed, starts the pulses one period later.
+         */
+        std::uint32_t data_ready(std::uint64_t now_us);
+
+        /**
+         * @fn bursts
+         * @brief data bursts read so far.
+         */
+        std::uint32_t bursts() const;
+
+        /**
+         * @fn encode
+         * @brief value in LSB, as the sensor reports it, clamped to int16.
+         */
+        static std::int16_t encode(float value, float lsb_per_unit);
+    };
+}
+
+#endif // RR_SIM_IMU_HPP
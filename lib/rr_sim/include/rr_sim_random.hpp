@@ -0,0 +1,67 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_RANDOM_HPP
+#define RR_SIM_RANDOM_HPP
+
+#include <cstdint>
+
+namespace rr_sim
+{
+    /**
+     * @class Rng
+     * @brief xorshift64* generator, so a seed gives the same sequence on every host and standard library.
+     */
+    class Rng
+    {
+    private:
+        std::uint64_t state_;
+
+    public:
+        /**
+         * Any seed, 0 included, gives a usable sequence.
+         */
+        explicit Rng(std::uint64_t seed);
+
+        std::uint32_t next();
+
+        /**
+         * @fn below
+         * @brief uniform in 0 .. n - 1, n must not be 0.
+         */
+        std::uint32_t below(std::uint32_t n);
+
+        /**
+         * @fn uniform
+         * @brief uniform in [0, 1).
+         */
+        float uniform();
+
+        /**
+         * @fn gaussian
+         * @brief standard normal, by the Box-Muller transform.
+         */
+        float gaussian();
+    };
+}
+
+#endif // RR_SIM_RANDOM_HPP
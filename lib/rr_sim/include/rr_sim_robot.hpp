@@ -0,0 +1,135 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_ROBOT_HPP
+#define RR_SIM_ROBOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_geometry.hpp>
+#include <rr_sim_world.hpp>
+
+/**
+ * Physics timestep of the simulated robot (us). The motors, body, and encoders move in steps of this size, whatever
+ * the clock of the firmware does.
+ */
+#ifndef RR_SIM_PHYSICS_US
+#define RR_SIM_PHYSICS_US 1000
+#endif
+
+/**
+ * Wheel surface speed at full duty (m/s), and the time constant the wheels reach it with (s), a first order model
+ * of a small DC gear motor under the robot's load.
+ */
+#ifndef RR_SIM_WHEEL_MAX_MPS
+#define RR_SIM_WHEEL_MAX_MPS 0.8f
+#endif
+
+#ifndef RR_SIM_MOTOR_TAU_S
+#define RR_SIM_MOTOR_TAU_S 0.04f
+#endif
+
+/**
+ * Radius of the disc the body is taken to be, for collisions with walls and posts (m).
+ */
+#ifndef RR_SIM_BODY_RADIUS_M
+#define RR_SIM_BODY_RADIUS_M 0.045f
+#endif
+
+namespace rr_sim
+{
+    static constexpr size_t LEFT = 0;
+    static constexpr size_t RIGHT = 1;
+
+    /**
+     * Ground truth of the simulated robot. Pose is in the World frame, heading counter clockwise from east (rad).
+     * Accelerations are in the body frame, forward and to the left (m/s^2), centripetal included. odometer_m is
+     * the distance each wheel has turned through, whichever way it turned.
+     */
+    struct Truth
+    {
+        float x;
+        float y;
+        float heading;
+        float wheel_mps[2];
+        float v;
+        float omega;
+        float accel_mps2[2];
+        double odometer_m[2];
+        std::uint64_t time_us;
+    };
+
+    /**
+     * @class Robot
+     * @brief differential drive robot, moved a fixed timestep at a time, in a World.
+     *
+     * Each wheel follows its drive, -1 .. 1 of full duty, as a first order lag towards drive * max speed. The
+     * body moves on the arc the two wheel speeds give. A step that would bring the body into a wall or post leaves
+     * it where it was, still turning in place if the wheels turn opposite ways, and both wheels stalled against
+     * the wall otherwise. Wheels do not slip.
+     */
+    class Robot
+    {
+    private:
+        float wheel_base_m_ = RR_WHEEL_BASE_M;
+        float max_mps_ = RR_SIM_WHEEL_MAX_MPS;
+        float tau_s_ = RR_SIM_MOTOR_TAU_S;
+        float radius_m_ = RR_SIM_BODY_RADIUS_M;
+        Truth truth_;
+        bool contact_ = false;
+        std::uint32_t collisions_ = 0;
+
+    public:
+        /**
+         * At rest in the middle of cell (0, 0), facing north, the start of a micromouse run.
+         */
+        Robot();
+
+        /**
+         * @fn place
+         * @brief moves the robot to (x, y), heading, at rest, keeping its odometers and time.
+         */
+        void place(float x, float y, float heading);
+
+        /**
+         * @fn step
+         * @brief moves the robot on by dt_us, driven by drive[LEFT], drive[RIGHT].
+         */
+        void step(const float drive[2], std::uint32_t dt_us, const World &world);
+
+        const Truth &truth() const;
+
+        /**
+         * @fn collisions
+         * @brief times the body has run into a wall or post.
+         */
+        std::uint32_t collisions() const;
+
+        /**
+         * @fn contact
+         * @brief true while the body touches a wall or post.
+         */
+        bool contact() const;
+    };
+}
+
+#endif // RR_SIM_ROBOT_HPP
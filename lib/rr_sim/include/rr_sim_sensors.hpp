@@ -0,0 +1,133 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_SENSORS_HPP
+#define RR_SIM_SENSORS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_sim_random.hpp>
+#include <rr_sim_robot.hpp>
+#include <rr_sim_world.hpp>
+
+/**
+ * Sensor errors, one standard deviation: white noise on each gyroscope sample (deg/s), the bias each gyroscope
+ * axis powers up with (deg/s), white noise on each accelerometer sample (g), and on each range reading (m).
+ */
+#ifndef RR_SIM_GYRO_NOISE_DPS
+#define RR_SIM_GYRO_NOISE_DPS 0.15f
+#endif
+
+#ifndef RR_SIM_GYRO_BIAS_DPS
+#define RR_SIM_GYRO_BIAS_DPS 0.5f
+#endif
+
+#ifndef RR_SIM_ACCEL_NOISE_G
+#define RR_SIM_ACCEL_NOISE_G 0.004f
+#endif
+
+#ifndef RR_SIM_RANGE_NOISE_M
+#define RR_SIM_RANGE_NOISE_M 0.003f
+#endif
+
+/**
+ * Time from the trigger of an ultrasonic sensor to the start of its echo pulse (us), while it sends its burst.
+ */
+#ifndef RR_SIM_ECHO_DELAY_US
+#define RR_SIM_ECHO_DELAY_US 450
+#endif
+
+namespace rr_sim
+{
+    /**
+     * Standard deviations of the sensor errors, see RR_SIM_GYRO_NOISE_DPS. All zero is a perfect robot.
+     */
+    struct Noise
+    {
+        float gyro_dps;
+        float gyro_bias_dps;
+        float accel_g;
+        float range_m;
+    };
+
+    /**
+     * A range sensor on the robot, angle from the heading (rad, counter clockwise), and offset_m from the robot
+     * centre to its face, as rr_walls::Mount.
+     */
+    struct RangeMount
+    {
+        float angle;
+        float offset_m;
+    };
+
+    /**
+     * @class Sensors
+     * @brief what the robot's sensors read of its Truth, with noise drawn from a seed.
+     *
+     * The IMU and range sensors draw from separate streams, so how often one is sampled does not change what the
+     * other reads. The IMU is in the body frame, x forward, y left, z up, level on the floor.
+     */
+    class Sensors
+    {
+    private:
+        Noise noise_;
+        Rng imu_rng_;
+        Rng range_rng_;
+        float gyro_bias_dps_[3];
+        std::uint64_t edges_[2] = {0, 0};
+
+    public:
+        explicit Sensors(std::uint64_t seed);
+        Sensors(std::uint64_t seed, const Noise &noise);
+
+        const Noise &noise() const;
+        const float *gyro_bias_dps() const;
+
+        /**
+         * @fn imu
+         * @brief one IMU sample, rates (deg/s) and accelerations (g).
+         */
+        void imu(const Truth &truth, float gyro_dps[3], float accel_g[3]);
+
+        /**
+         * @fn edges
+         * @brief encoder edges of wheel since the last call, RR_ENCODER_TICKS_PER_REV per turn either way, as the
+         * edge counters see them.
+         */
+        std::uint32_t edges(const Truth &truth, size_t wheel);
+
+        /**
+         * @fn range
+         * @brief distance (m) the sensor at mount measures to the nearest wall face or post ahead of it. false, no
+         * echo, past max_m.
+         */
+        bool range(const World &world, const Truth &truth, const RangeMount &mount, float max_m, float &distance_m);
+
+        /**
+         * @fn echo
+         * @brief rise and fall of the echo pulse of distance_m, in us after the trigger, at speed_of_sound (m/s).
+         */
+        static void echo(float distance_m, float speed_of_sound, std::uint32_t &rise_us, std::uint32_t &fall_us);
+    };
+}
+
+#endif // RR_SIM_SENSORS_HPP
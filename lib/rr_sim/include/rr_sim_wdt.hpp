@@ -0,0 +1,71 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_WDT_HPP
+#define RR_SIM_WDT_HPP
+
+#include <cstdint>
+
+namespace rr_sim
+{
+    /**
+     * @class Watchdog
+     * @brief the nRF52 watchdog, as wdt::Wdt configures it.
+     *
+     * The counter is only reloaded once every task has written its reload register, which the firmware's
+     * Supervisor counts as a round, so the board resets timeout_ms after the last round completed.
+     */
+    class Watchdog
+    {
+    private:
+        std::uint32_t timeout_ms_ = 0;
+        bool running_ = false;
+        bool expired_ = false;
+        std::uint32_t rounds_ = 0;
+        std::uint64_t reload_us_ = 0;
+
+    public:
+        /**
+         * @fn start
+         * @brief starts counting down from now_us, rounds being the rounds completed so far.
+         */
+        void start(std::uint32_t timeout_ms, std::uint32_t rounds, std::uint64_t now_us);
+
+        /**
+         * @fn check
+         * @brief reloads the counter if rounds moved on since the last check.
+         * @return false once the watchdog has expired, it does not restart.
+         */
+        bool check(std::uint32_t rounds, std::uint64_t now_us);
+
+        bool running() const;
+        bool expired() const;
+
+        /**
+         * @fn since_reload_us
+         * @brief time from the last reload to now_us.
+         */
+        std::uint64_t since_reload_us(std::uint64_t now_us) const;
+    };
+}
+
+#endif // RR_SIM_WDT_HPP
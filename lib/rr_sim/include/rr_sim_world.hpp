@@ -0,0 +1,96 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_SIM_WORLD_HPP
+#define RR_SIM_WORLD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_geometry.hpp>
+#include <rr_maze.hpp>
+
+namespace rr_sim
+{
+    /**
+     * @class World
+     * @brief the maze the simulated robot drives in, walls of RR_MAZE_WALL_M on a grid of RR_MAZE_CELL_M cells.
+     *
+     * Walls are held in an rr_maze::MazeMap, cell (0, 0) is the south west corner, with its south west corner at
+     * the origin, +x east and +y north. Every grid corner carries a post, whether or not a wall meets it, as in a
+     * real maze. A new world has the outer walls only.
+     */
+    class World
+    {
+    private:
+        rr_maze::MazeMap walls_;
+        float cell_m_ = RR_MAZE_CELL_M;
+        float wall_m_ = RR_MAZE_WALL_M;
+
+    public:
+        World() = default;
+
+        rr_maze::MazeMap &walls();
+        const rr_maze::MazeMap &walls() const;
+        float cell_m() const;
+        float wall_m() const;
+
+        /**
+         * @fn generate
+         * @brief replaces the walls with a maze grown by a recursive backtracker from seed, with loops walls then
+         * knocked out at random, so there is more than one route.
+         */
+        void generate(std::uint32_t seed, int loops);
+
+        /**
+         * @fn load
+         * @brief replaces the walls with those of a maze drawn in text, the format micromouse maze files are
+         * shared in, north row first:
+         *
+         *   +---+---+
+         *   |       |
+         *   +   +---+
+         *   |       |
+         *   +---+---+
+         *
+         * Any character other than a space on a wall position is a wall. Mazes smaller than rr_maze::SIZE fill
+         * the south west corner, the rest of the world stays open.
+         *
+         * @return false, leaving the walls as they were, if the text is not a maze.
+         */
+        bool load(const char *text);
+
+        /**
+         * @fn cast
+         * @brief distance (m) from (x, y) along theta (rad, counter clockwise from east) to the first wall face
+         * or post, max_m if there is none closer. 0 from outside the maze.
+         */
+        float cast(float x, float y, float theta, float max_m) const;
+
+        /**
+         * @fn clear
+         * @brief true if a disc of radius (m) at (x, y) touches no wall or post.
+         */
+        bool clear(float x, float y, float radius) const;
+    };
+}
+
+#endif // RR_SIM_WORLD_HPP
@@ -0,0 +1,85 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_clock.hpp>
+#include <thread>
+
+namespace rr_sim
+{
+    Clock::Clock()
+    {
+        start_realtime();
+    }
+
+    void Clock::start_realtime()
+    {
+        mode_ = REALTIME;
+        step_us_ = 0;
+        now_us_ = 0;
+        origin_ = std::chrono::steady_clock::now();
+    }
+
+    void Clock::start_stepped(std::uint32_t step_us)
+    {
+        mode_ = STEPPED;
+        step_us_ = step_us;
+        now_us_ = 0;
+    }
+
+    std::uint64_t Clock::now_us() const
+    {
+        if (mode_ == STEPPED)
+        {
+            return now_us_;
+        }
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin_).count());
+    }
+
+    void Clock::step()
+    {
+        if (mode_ == STEPPED)
+        {
+            now_us_ += step_us_;
+        }
+    }
+
+    void Clock::sleep(std::uint64_t us)
+    {
+        if (mode_ == STEPPED)
+        {
+            now_us_ += us;
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+
+    Clock::Mode Clock::mode() const
+    {
+        return mode_;
+    }
+
+    std::uint32_t Clock::step_us() const
+    {
+        return step_us_;
+    }
+}
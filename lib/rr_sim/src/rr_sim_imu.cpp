@@ -0,0 +1,160 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_imu.hpp>
+#include <cmath>
+#include <cstring>
+
+namespace rr_sim
+{
+    namespace
+    {
+        // ODR codes of ACC_CONF bits 0..3, 0x08 is 100 Hz, and each code up or down doubles, or halves, it.
+        constexpr std::uint8_t ODR_MASK = 0x0F;
+        constexpr std::uint8_t ODR_100HZ = 0x08;
+        constexpr std::uint8_t ODR_MAX = 0x0C;
+        constexpr std::uint32_t PERIOD_100HZ_US = 10000;
+
+        void put(std::uint8_t *out, std::int16_t v)
+        {
+            std::uint16_t u = static_cast<std::uint16_t>(v);
+            out[0] = static_cast<std::uint8_t>(u & 0xFF);
+            out[1] = static_cast<std::uint8_t>(u >> 8);
+        }
+
+        std::int16_t get(const std::uint8_t *in)
+        {
+            return static_cast<std::int16_t>(static_cast<std::uint16_t>(in[0] | (in[1] << 8)));
+        }
+    }
+
+    Bmi270::Bmi270()
+    {
+        std::memset(regs_, 0, sizeof(regs_));
+    }
+
+    std::int16_t Bmi270::encode(float value, float lsb_per_unit)
+    {
+        float lsb = std::round(value * lsb_per_unit);
+        if (lsb > 32767.0f)
+        {
+            return 32767;
+        }
+        if (lsb < -32768.0f)
+        {
+            return -32768;
+        }
+        return static_cast<std::int16_t>(lsb);
+    }
+
+    bool Bmi270::read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len)
+    {
+        if (addr != ADDR || reg + len > REGS)
+        {
+            return false;
+        }
+
+        std::uint8_t burst[DATA_LEN];
+        data(burst);
+        for (size_t i = 0; i < len; i++)
+        {
+            size_t r = reg + i;
+            buf[i] = r >= REG_DATA_8 && r < REG_DATA_8 + DATA_LEN ? burst[r - REG_DATA_8] : regs_[r];
+        }
+        if (reg <= REG_DATA_8 && reg + len >= REG_DATA_8 + DATA_LEN)
+        {
+            bursts_++;
+        }
+        return true;
+    }
+
+    bool Bmi270::write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *buf, size_t len)
+    {
+        if (addr != ADDR || reg + len > REGS)
+        {
+            return false;
+        }
+        std::memcpy(&regs_[reg], buf, len);
+        return true;
+    }
+
+    void Bmi270::data(std::uint8_t out[DATA_LEN]) const
+    {
+        // acceleration x, y, z, then rates x, y, z, little endian.
+        for (size_t i = 0; i < 3; i++)
+        {
+            put(&out[i * 2], encode(accel_g_[i], ACC_LSB_PER_G));
+            put(&out[6 + i * 2], encode(gyro_dps_[i], GYR_LSB_PER_DPS));
+        }
+    }
+
+    void Bmi270::set_data(const std::uint8_t in[DATA_LEN])
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            accel_g_[i] = static_cast<float>(get(&in[i * 2])) / ACC_LSB_PER_G;
+            gyro_dps_[i] = static_cast<float>(get(&in[6 + i * 2])) / GYR_LSB_PER_DPS;
+        }
+    }
+
+    void Bmi270::set_motion(const float gyro_dps[3], const float accel_g[3])
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            gyro_dps_[i] = gyro_dps[i];
+            accel_g_[i] = accel_g[i];
+        }
+    }
+
+    std::uint32_t Bmi270::period_us() const
+    {
+        std::uint8_t code = regs_[REG_ACC_CONF] & ODR_MASK;
+        if (code == 0 || code > ODR_MAX)
+        {
+            return 0;
+        }
+        return code >= ODR_100HZ ? PERIOD_100HZ_US >> (code - ODR_100HZ) : PERIOD_100HZ_US << (ODR_100HZ - code);
+    }
+
+    std::uint32_t Bmi270::data_ready(std::uint64_t now_us)
+    {
+        std::uint32_t period = period_us();
+        if (period != period_us_)
+        {
+            period_us_ = period;
+            next_drdy_us_ = now_us + period;
+            return 0;
+        }
+        if (period == 0 || now_us < next_drdy_us_)
+        {
+            return 0;
+        }
+        std::uint64_t pulses = (now_us - next_drdy_us_) / period + 1;
+        next_drdy_us_ += pulses * period;
+        return static_cast<std::uint32_t>(pulses);
+    }
+
+    std::uint32_t Bmi270::bursts() const
+    {
+        return bursts_;
+    }
+}
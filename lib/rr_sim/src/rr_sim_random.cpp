@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_random.hpp>
+#include <cmath>
+#include <rr_math.hpp>
+
+namespace rr_sim
+{
+    namespace
+    {
+        // splitmix64 increment, scrambles the seed so that nearby seeds give unrelated sequences.
+        constexpr std::uint64_t GOLDEN = 0x9E3779B97F4A7C15ULL;
+        constexpr std::uint64_t MULTIPLIER = 0x2545F4914F6CDD1DULL;
+    }
+
+    Rng::Rng(std::uint64_t seed)
+    {
+        std::uint64_t z = seed + GOLDEN;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        // xorshift never leaves 0.
+        state_ = z != 0 ? z : GOLDEN;
+    }
+
+    std::uint32_t Rng::next()
+    {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return static_cast<std::uint32_t>((state_ * MULTIPLIER) >> 32);
+    }
+
+    std::uint32_t Rng::below(std::uint32_t n)
+    {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(next()) * n) >> 32);
+    }
+
+    float Rng::uniform()
+    {
+        // 24 bits, every value exactly representable, and never 1.
+        return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float Rng::gaussian()
+    {
+        // 1 - uniform() is in (0, 1], so the log is finite.
+        float u1 = 1.0f - uniform();
+        float u2 = uniform();
+        return std::sqrt(-2.0f * std::log(u1)) * std::cos(rr_math::TWO_PI * u2);
+    }
+}
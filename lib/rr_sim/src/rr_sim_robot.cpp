@@ -0,0 +1,133 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_robot.hpp>
+#include <cmath>
+#include <rr_math.hpp>
+
+namespace rr_sim
+{
+    namespace
+    {
+        // a body within this of a wall is still touching it, so creeping up to a wall counts as one collision.
+        constexpr float CONTACT_M = 0.001f;
+
+        inline float clamp_drive(float drive)
+        {
+            if (drive != drive)
+            {
+                return 0.0f;
+            }
+            return drive < -1.0f ? -1.0f : (drive > 1.0f ? 1.0f : drive);
+        }
+    }
+
+    Robot::Robot() : truth_()
+    {
+        place(0.5f * RR_MAZE_CELL_M, 0.5f * RR_MAZE_CELL_M, rr_math::HALF_PI);
+    }
+
+    void Robot::place(float x, float y, float heading)
+    {
+        truth_.x = x;
+        truth_.y = y;
+        truth_.heading = rr_math::wrap_pi(heading);
+        truth_.wheel_mps[LEFT] = 0.0f;
+        truth_.wheel_mps[RIGHT] = 0.0f;
+        truth_.v = 0.0f;
+        truth_.omega = 0.0f;
+        truth_.accel_mps2[0] = 0.0f;
+        truth_.accel_mps2[1] = 0.0f;
+        contact_ = false;
+    }
+
+    void Robot::step(const float drive[2], std::uint32_t dt_us, const World &world)
+    {
+        if (dt_us == 0)
+        {
+            return;
+        }
+        const float dt = static_cast<float>(dt_us) * 1e-6f;
+        const float alpha = 1.0f - std::exp(-dt / tau_s_);
+        const float v_before = truth_.v;
+
+        float wheel[2];
+        for (size_t w = LEFT; w <= RIGHT; w++)
+        {
+            wheel[w] = truth_.wheel_mps[w] + (clamp_drive(drive[w]) * max_mps_ - truth_.wheel_mps[w]) * alpha;
+        }
+        float v = 0.5f * (wheel[LEFT] + wheel[RIGHT]);
+        float omega = (wheel[RIGHT] - wheel[LEFT]) / wheel_base_m_;
+
+        // along the chord of the arc, at the heading half way through the step.
+        float mid = truth_.heading + 0.5f * omega * dt;
+        float x = truth_.x + v * std::cos(mid) * dt;
+        float y = truth_.y + v * std::sin(mid) * dt;
+
+        bool blocked = !world.clear(x, y, radius_m_);
+        if (blocked)
+        {
+            // a disc turns in place without touching anything new, only the common part of the wheels stalls.
+            x = truth_.x;
+            y = truth_.y;
+            float spin = 0.5f * (wheel[RIGHT] - wheel[LEFT]);
+            wheel[LEFT] = -spin;
+            wheel[RIGHT] = spin;
+            v = 0.0f;
+        }
+        bool contact = blocked || !world.clear(x, y, radius_m_ + CONTACT_M);
+        if (contact && !contact_)
+        {
+            collisions_++;
+        }
+        contact_ = contact;
+
+        truth_.x = x;
+        truth_.y = y;
+        truth_.heading = rr_math::wrap_pi(truth_.heading + omega * dt);
+        for (size_t w = LEFT; w <= RIGHT; w++)
+        {
+            truth_.wheel_mps[w] = wheel[w];
+            truth_.odometer_m[w] += std::fabs(static_cast<double>(wheel[w]) * dt);
+        }
+        truth_.v = v;
+        truth_.omega = omega;
+        truth_.accel_mps2[0] = (v - v_before) / dt;
+        truth_.accel_mps2[1] = v * omega;
+        truth_.time_us += dt_us;
+    }
+
+    const Truth &Robot::truth() const
+    {
+        return truth_;
+    }
+
+    std::uint32_t Robot::collisions() const
+    {
+        return collisions_;
+    }
+
+    bool Robot::contact() const
+    {
+        return contact_;
+    }
+}
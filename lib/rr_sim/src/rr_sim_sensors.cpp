@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_sensors.hpp>
+#include <cmath>
+#include <rr_geometry.hpp>
+
+namespace rr_sim
+{
+    namespace
+    {
+        constexpr float G = 9.80665f;
+        constexpr float DEG_PER_RAD = 57.2957795130823f;
+
+        // seeds of the separate streams, from the seed given.
+        constexpr std::uint64_t IMU_STREAM = 0x494D55;
+        constexpr std::uint64_t RANGE_STREAM = 0x524E47;
+
+        const Noise DEFAULT_NOISE = {
+            RR_SIM_GYRO_NOISE_DPS,
+            RR_SIM_GYRO_BIAS_DPS,
+            RR_SIM_ACCEL_NOISE_G,
+            RR_SIM_RANGE_NOISE_M,
+        };
+
+        // metres each wheel turns through per encoder edge, in double so long runs do not drift.
+        const double METRES_PER_EDGE = 3.14159265358979 * RR_WHEEL_DIAMETER_M / RR_ENCODER_TICKS_PER_REV;
+    }
+
+    Sensors::Sensors(std::uint64_t seed) : Sensors(seed, DEFAULT_NOISE)
+    {
+    }
+
+    Sensors::Sensors(std::uint64_t seed, const Noise &noise)
+        : noise_(noise), imu_rng_(seed ^ IMU_STREAM), range_rng_(seed ^ RANGE_STREAM)
+    {
+        for (size_t i = 0; i < 3; i++)
+        {
+            gyro_bias_dps_[i] = noise_.gyro_bias_dps * imu_rng_.gaussian();
+        }
+    }
+
+    const Noise &Sensors::noise() const
+    {
+        return noise_;
+    }
+
+    const float *Sensors::gyro_bias_dps() const
+    {
+        return gyro_bias_dps_;
+    }
+
+    void Sensors::imu(const Truth &truth, float gyro_dps[3], float accel_g[3])
+    {
+        const float rate[3] = {0.0f, 0.0f, truth.omega * DEG_PER_RAD};
+        const float accel[3] = {truth.accel_mps2[0] / G, truth.accel_mps2[1] / G, 1.0f};
+        for (size_t i = 0; i < 3; i++)
+        {
+            gyro_dps[i] = rate[i] + gyro_bias_dps_[i] + noise_.gyro_dps * imu_rng_.gaussian();
+            accel_g[i] = accel[i] + noise_.accel_g * imu_rng_.gaussian();
+        }
+    }
+
+    std::uint32_t Sensors::edges(const Truth &truth, size_t wheel)
+    {
+        if (wheel > RIGHT)
+        {
+            return 0;
+        }
+        std::uint64_t total = static_cast<std::uint64_t>(truth.odometer_m[wheel] / METRES_PER_EDGE);
+        std::uint32_t edges = total > edges_[wheel] ? static_cast<std::uint32_t>(total - edges_[wheel]) : 0;
+        edges_[wheel] += edges;
+        return edges;
+    }
+
+    bool Sensors::range(const World &world, const Truth &truth, const RangeMount &mount, float max_m,
+                        float &distance_m)
+    {
+        // the noise is drawn whether or not there is an echo, so every reading takes one draw.
+        float error = noise_.range_m * range_rng_.gaussian();
+
+        float theta = truth.heading + mount.angle;
+        float face_x = truth.x + mount.offset_m * std::cos(theta);
+        float face_y = truth.y + mount.offset_m * std::sin(theta);
+        float d = world.cast(face_x, face_y, theta, max_m) + error;
+        if (!(d < max_m))
+        {
+            return false;
+        }
+        distance_m = d > 0.0f ? d : 0.0f;
+        return true;
+    }
+
+    void Sensors::echo(float distance_m, float speed_of_sound, std::uint32_t &rise_us, std::uint32_t &fall_us)
+    {
+        rise_us = RR_SIM_ECHO_DELAY_US;
+        fall_us = rise_us + static_cast<std::uint32_t>(std::lround(2.0f * distance_m / speed_of_sound * 1e6f));
+    }
+}
@@ -0,0 +1,68 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_wdt.hpp>
+
+namespace rr_sim
+{
+    void Watchdog::start(std::uint32_t timeout_ms, std::uint32_t rounds, std::uint64_t now_us)
+    {
+        timeout_ms_ = timeout_ms;
+        running_ = true;
+        expired_ = false;
+        rounds_ = rounds;
+        reload_us_ = now_us;
+    }
+
+    bool Watchdog::check(std::uint32_t rounds, std::uint64_t now_us)
+    {
+        if (!running_ || expired_)
+        {
+            return !expired_;
+        }
+
+        // the loop statistics can be cleared, which restarts the count, so any change is a reload.
+        if (rounds != rounds_)
+        {
+            rounds_ = rounds;
+            reload_us_ = now_us;
+            return true;
+        }
+        expired_ = now_us - reload_us_ > static_cast<std::uint64_t>(timeout_ms_) * 1000;
+        return !expired_;
+    }
+
+    bool Watchdog::running() const
+    {
+        return running_;
+    }
+
+    bool Watchdog::expired() const
+    {
+        return expired_;
+    }
+
+    std::uint64_t Watchdog::since_reload_us(std::uint64_t now_us) const
+    {
+        return now_us - reload_us_;
+    }
+}
@@ -0,0 +1,369 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_sim_world.hpp>
+#include <rr_sim_random.hpp>
+#include <cmath>
+#include <cstring>
+
+namespace rr_sim
+{
+    namespace
+    {
+        using rr_maze::Heading;
+        using rr_maze::SIZE;
+
+        const int DX[] = {0, 1, 0, -1};
+        const int DY[] = {1, 0, -1, 0};
+
+        struct Box
+        {
+            float x0;
+            float y0;
+            float x1;
+            float y1;
+        };
+
+        /*
+         * distance along the unit ray (ox, oy) + t (dx, dy) at which it enters box, 0 from inside, false if it
+         * misses.
+         */
+        bool enter(const Box &box, float ox, float oy, float dx, float dy, float &t)
+        {
+            float t0 = 0.0f;
+            float t1 = INFINITY;
+            const float o[2] = {ox, oy};
+            const float d[2] = {dx, dy};
+            const float lo[2] = {box.x0, box.y0};
+            const float hi[2] = {box.x1, box.y1};
+            for (int i = 0; i < 2; i++)
+            {
+                if (d[i] == 0.0f)
+                {
+                    if (o[i] < lo[i] || o[i] > hi[i])
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                float a = (lo[i] - o[i]) / d[i];
+                float b = (hi[i] - o[i]) / d[i];
+                t0 = std::fmax(t0, std::fmin(a, b));
+                t1 = std::fmin(t1, std::fmax(a, b));
+            }
+            if (t0 > t1)
+            {
+                return false;
+            }
+            t = t0;
+            return true;
+        }
+
+        /*
+         * distance from (x, y) to box, 0 inside it.
+         */
+        float distance(const Box &box, float x, float y)
+        {
+            float dx = std::fmax(std::fmax(box.x0 - x, 0.0f), x - box.x1);
+            float dy = std::fmax(std::fmax(box.y0 - y, 0.0f), y - box.y1);
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+        /*
+         * posts at the corners of cell (cx, cy), and the walls on its sides, every obstacle within the cell.
+         */
+        size_t obstacles(const rr_maze::MazeMap &walls, int cx, int cy, float cell, float half, Box *out)
+        {
+            size_t n = 0;
+            float x0 = static_cast<float>(cx) * cell;
+            float y0 = static_cast<float>(cy) * cell;
+            float x1 = x0 + cell;
+            float y1 = y0 + cell;
+            const float px[] = {x0, x1};
+            const float py[] = {y0, y1};
+            for (float x : px)
+            {
+                for (float y : py)
+                {
+                    out[n++] = {x - half, y - half, x + half, y + half};
+                }
+            }
+            std::uint8_t ux = static_cast<std::uint8_t>(cx);
+            std::uint8_t uy = static_cast<std::uint8_t>(cy);
+            if (walls.wall(ux, uy, rr_maze::H_NORTH))
+            {
+                out[n++] = {x0, y1 - half, x1, y1 + half};
+            }
+            if (walls.wall(ux, uy, rr_maze::H_EAST))
+            {
+                out[n++] = {x1 - half, y0, x1 + half, y1};
+            }
+            if (walls.wall(ux, uy, rr_maze::H_SOUTH))
+            {
+                out[n++] = {x0, y0 - half, x1, y0 + half};
+            }
+            if (walls.wall(ux, uy, rr_maze::H_WEST))
+            {
+                out[n++] = {x0 - half, y0, x0 + half, y1};
+            }
+            return n;
+        }
+
+        void all_walls(rr_maze::MazeMap &walls)
+        {
+            walls.clear();
+            for (std::uint8_t y = 0; y < SIZE; y++)
+            {
+                for (std::uint8_t x = 0; x < SIZE; x++)
+                {
+                    walls.set(x, y, rr_maze::H_NORTH, true);
+                    walls.set(x, y, rr_maze::H_EAST, true);
+                }
+            }
+        }
+
+        /*
+         * character at column of line, a space past its end.
+         */
+        char at(const char *line, size_t length, size_t column)
+        {
+            return column < length ? line[column] : ' ';
+        }
+    }
+
+    rr_maze::MazeMap &World::walls()
+    {
+        return walls_;
+    }
+
+    const rr_maze::MazeMap &World::walls() const
+    {
+        return walls_;
+    }
+
+    float World::cell_m() const
+    {
+        return cell_m_;
+    }
+
+    float World::wall_m() const
+    {
+        return wall_m_;
+    }
+
+    void World::generate(std::uint32_t seed, int loops)
+    {
+        Rng rng(seed);
+        all_walls(walls_);
+
+        std::uint8_t stack[rr_maze::CELLS];
+        bool visited[rr_maze::CELLS] = {false};
+        size_t top = 0;
+        stack[top++] = 0;
+        visited[0] = true;
+        while (top > 0)
+        {
+            std::uint8_t c = stack[top - 1];
+            int x = c % SIZE;
+            int y = c / SIZE;
+            Heading options[4];
+            std::uint32_t n = 0;
+            for (std::uint8_t h = rr_maze::H_NORTH; h <= rr_maze::H_WEST; h++)
+            {
+                int nx = x + DX[h];
+                int ny = y + DY[h];
+                if (nx >= 0 && ny >= 0 && nx < SIZE && ny < SIZE && !visited[ny * SIZE + nx])
+                {
+                    options[n++] = static_cast<Heading>(h);
+                }
+            }
+            if (n == 0)
+            {
+                top--;
+                continue;
+            }
+            Heading h = options[rng.below(n)];
+            int nx = x + DX[h];
+            int ny = y + DY[h];
+            walls_.set(static_cast<std::uint8_t>(x), static_cast<std::uint8_t>(y), h, false);
+            visited[ny * SIZE + nx] = true;
+            stack[top++] = static_cast<std::uint8_t>(ny * SIZE + nx);
+        }
+
+        for (int i = 0; i < loops; i++)
+        {
+            walls_.set(static_cast<std::uint8_t>(rng.below(SIZE)), static_cast<std::uint8_t>(rng.below(SIZE - 1)),
+                       rr_maze::H_NORTH, false);
+        }
+    }
+
+    bool World::load(const char *text)
+    {
+        if (text == nullptr)
+        {
+            return false;
+        }
+
+        // lines, without line endings, and without blank lines before and after the maze.
+        const size_t MAX_LINES = 2 * SIZE + 1;
+        const char *lines[MAX_LINES];
+        size_t lengths[MAX_LINES];
+        size_t count = 0;
+        const char *p = text;
+        while (*p != '\0')
+        {
+            const char *end = std::strchr(p, '\n');
+            size_t length = end != nullptr ? static_cast<size_t>(end - p) : std::strlen(p);
+            size_t used = length;
+            while (used > 0 && (p[used - 1] == '\r' || p[used - 1] == ' ' || p[used - 1] == '\t'))
+            {
+                used--;
+            }
+            if (used > 0)
+            {
+                if (count == MAX_LINES)
+                {
+                    return false;
+                }
+                lines[count] = p;
+                lengths[count] = used;
+                count++;
+            }
+            else if (count > 0)
+            {
+                break;
+            }
+            p += end != nullptr ? length + 1 : length;
+        }
+
+        if (count < 3 || count % 2 == 0 || lengths[0] < 5 || (lengths[0] - 1) % 4 != 0)
+        {
+            return false;
+        }
+        size_t rows = (count - 1) / 2;
+        size_t cols = (lengths[0] - 1) / 4;
+        if (cols > SIZE)
+        {
+            return false;
+        }
+
+        rr_maze::MazeMap walls;
+        for (size_t r = 0; r < rows; r++)
+        {
+            // text row r is maze row rows - 1 - r, below its north line, and above its south line.
+            std::uint8_t y = static_cast<std::uint8_t>(rows - 1 - r);
+            const char *north = lines[2 * r];
+            const char *middle = lines[2 * r + 1];
+            const char *south = lines[2 * r + 2];
+            for (size_t c = 0; c < cols; c++)
+            {
+                std::uint8_t x = static_cast<std::uint8_t>(c);
+                walls.set(x, y, rr_maze::H_NORTH, at(north, lengths[2 * r], 4 * c + 2) != ' ');
+                walls.set(x, y, rr_maze::H_SOUTH, at(south, lengths[2 * r + 2], 4 * c + 2) != ' ');
+                walls.set(x, y, rr_maze::H_WEST, at(middle, lengths[2 * r + 1], 4 * c) != ' ');
+                walls.set(x, y, rr_maze::H_EAST, at(middle, lengths[2 * r + 1], 4 * c + 4) != ' ');
+            }
+        }
+        walls_ = walls;
+        return true;
+    }
+
+    float World::cast(float x, float y, float theta, float max_m) const
+    {
+        int cx = static_cast<int>(std::floor(x / cell_m_));
+        int cy = static_cast<int>(std::floor(y / cell_m_));
+        if (cx < 0 || cy < 0 || cx >= SIZE || cy >= SIZE)
+        {
+            return 0.0f;
+        }
+
+        const float half = 0.5f * wall_m_;
+        const float dx = std::cos(theta);
+        const float dy = std::sin(theta);
+        const int step_x = dx > 0.0f ? 1 : -1;
+        const int step_y = dy > 0.0f ? 1 : -1;
+
+        // walk the cells the ray passes through, between entering at t_in and leaving at t_out. The obstacles of a
+        // cell cover all of it, so the first hit inside the span of a cell is the nearest.
+        float t_in = 0.0f;
+        while (t_in <= max_m)
+        {
+            float tx = dx != 0.0f ? ((static_cast<float>(cx + (step_x > 0 ? 1 : 0)) * cell_m_) - x) / dx : INFINITY;
+            float ty = dy != 0.0f ? ((static_cast<float>(cy + (step_y > 0 ? 1 : 0)) * cell_m_) - y) / dy : INFINITY;
+            float t_out = std::fmin(tx, ty);
+
+            Box boxes[8];
+            size_t n = obstacles(walls_, cx, cy, cell_m_, half, boxes);
+            float nearest = INFINITY;
+            for (size_t i = 0; i < n; i++)
+            {
+                float t;
+                if (enter(boxes[i], x, y, dx, dy, t) && t <= t_out && t < nearest)
+                {
+                    nearest = t;
+                }
+            }
+            if (nearest <= max_m)
+            {
+                return nearest;
+            }
+
+            if (tx < ty)
+            {
+                cx += step_x;
+            }
+            else
+            {
+                cy += step_y;
+            }
+            if (cx < 0 || cy < 0 || cx >= SIZE || cy >= SIZE)
+            {
+                break;
+            }
+            t_in = t_out;
+        }
+        return max_m;
+    }
+
+    bool World::clear(float x, float y, float radius) const
+    {
+        int cx = static_cast<int>(std::floor(x / cell_m_));
+        int cy = static_cast<int>(std::floor(y / cell_m_));
+        if (cx < 0 || cy < 0 || cx >= SIZE || cy >= SIZE)
+        {
+            return false;
+        }
+
+        // anything of another cell within radius is also within one of this cell's posts, while radius is less
+        // than half a cell.
+        Box boxes[8];
+        size_t n = obstacles(walls_, cx, cy, cell_m_, 0.5f * wall_m_, boxes);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (distance(boxes[i], x, y) < radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,179 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_WALLS_HPP
+#define RR_WALLS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_pose.hpp>
+
+namespace rr_walls
+{
+    /**
+     * Side bits of a cell, in the maze frame (+y north, +x east).
+     */
+    static constexpr std::uint8_t NORTH = 1;
+    static constexpr std::uint8_t EAST = 2;
+    static constexpr std::uint8_t SOUTH = 4;
+    static constexpr std::uint8_t WEST = 8;
+
+    /**
+     * Maze geometry, metres, and cells along each side.
+     */
+    struct Maze
+    {
+        float cell_m;
+        float wall_m;
+        std::uint8_t size;
+    };
+
+    /**
+     * Hysteresis, in metres beyond the face a wall of the current cell would have. A reading within on_m of
+     * it is a wall, a reading further than off_m past it is open, readings in between leave the side as it
+     * was. Echoes with less than min_confidence (see rr_filter::Hampel) are ignored.
+     */
+    struct Thresholds
+    {
+        float on_m;
+        float off_m;
+        float min_confidence;
+    };
+
+    /**
+     * A range sensor as mounted on the robot. angle is its direction relative to the heading (rad, counter
+     * clockwise positive), offset_m the distance from the robot centre to its face. Lateral sensors only
+     * observe while the robot is within side_window_m of the middle of the cell, elsewhere they would see
+     * posts, and the walls of the neighbouring cells.
+     */
+    struct Mount
+    {
+        float angle;
+        float offset_m;
+        bool lateral;
+    };
+
+    /**
+     * One filtered range reading, valid is false when the filter reports no echo.
+     */
+    struct Observation
+    {
+        bool valid;
+        float distance;
+        float confidence;
+    };
+
+    /**
+     * Walls around a cell, walls and seen are masks of side bits. A side that has not been seen has no wall bit.
+     */
+    struct CellWalls
+    {
+        std::uint8_t x;
+        std::uint8_t y;
+        std::uint8_t walls;
+        std::uint8_t seen;
+    };
+
+    /**
+     * @class WallDetector
+     * @brief classifies the walls around the current maze cell from range readings and the pose estimate.
+     *
+     * Each reading is turned into the nearest side of the cell the robot is in, from the heading and the
+     * sensor mounting, and compared with where that side's wall face would be. Sides are classified with
+     * hysteresis, so a reading close to a threshold does not flip a side back and forth. When the robot crosses
+     * into another cell, by more than the cell margin so pose noise on a boundary does not emit cells back and
+     * forth, update() returns the cell that was left, and observation starts afresh.
+     */
+    class WallDetector
+    {
+    private:
+        Maze maze_ = {0.18f, 0.012f, 16};
+        Thresholds thresholds_ = {0.02f, 0.05f, 0.5f};
+        float max_skew_ = 0.35f;
+        float side_window_m_ = 0.05f;
+        float cell_margin_m_ = 0.005f;
+
+        bool in_cell_ = false;
+        CellWalls cell_ = {0, 0, 0, 0};
+
+        /*
+         * cell of pose, false outside the maze.
+         */
+        bool cell_of(const rr_pose::Pose &pose, std::uint8_t &x, std::uint8_t &y) const;
+
+    public:
+        WallDetector() = default;
+
+        /**
+         * @fn configure
+         * @brief sets maze geometry, the largest heading skew (rad) a reading is used at, the lateral sensor
+         * window, and how far past its boundary the robot must be to have left a cell. Forgets the current cell.
+         *
+         * @return false, leaving the configuration in place, if any value is out of range.
+         */
+        bool configure(const Maze &maze, float max_skew, float side_window_m, float cell_margin_m);
+
+        /**
+         * @fn set_thresholds
+         * @brief returns false, leaving thresholds in place, unless 0 <= on_m < off_m and min_confidence is
+         * within 0 .. 1.
+         */
+        bool set_thresholds(const Thresholds &thresholds);
+
+        const Thresholds &thresholds() const;
+
+        /**
+         * @fn reset
+         * @brief forgets the current cell, and what was seen of it.
+         */
+        void reset();
+
+        /**
+         * @fn observe
+         * @brief classifies the side of the current cell that mount sees from pose.
+         *
+         * Ignored outside the maze, before the first update(), or when the reading is too skewed to a side.
+         */
+        void observe(const rr_pose::Pose &pose, const Mount &mount, const Observation &obs);
+
+        /**
+         * @fn update
+         * @brief tracks the cell the robot is in. When it is further than the cell margin outside the current cell
+         * sets left to the cell it left, and returns true.
+         */
+        bool update(const rr_pose::Pose &pose, CellWalls &left);
+
+        /**
+         * @fn in_cell
+         * @brief false before the first update(), and while the robot is outside the maze.
+         */
+        bool in_cell() const;
+
+        /**
+         * @fn current
+         * @brief walls seen so far of the current cell.
+         */
+        const CellWalls &current() const;
+    };
+}
+
+#endif // RR_WALLS_HPP
@@ -0,0 +1,187 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_WALLS_OP_HPP
+#define RR_WALLS_OP_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <rr_geometry.hpp>
+#include <rr_pose_op.hpp>
+#include <rr_range.hpp>
+#include <rr_walls.hpp>
+
+/**
+ * Range sensors looking left, ahead, and right, indices of RRRangeOpHandler.
+ */
+#ifndef RR_WALL_LEFT_SENSOR
+#define RR_WALL_LEFT_SENSOR 0
+#endif
+
+#ifndef RR_WALL_FRONT_SENSOR
+#define RR_WALL_FRONT_SENSOR 1
+#endif
+
+#ifndef RR_WALL_RIGHT_SENSOR
+#define RR_WALL_RIGHT_SENSOR 2
+#endif
+
+/**
+ * Distance from the robot centre to the face of the side, and front, sensors (m).
+ */
+#ifndef RR_WALL_SIDE_OFFSET_M
+#define RR_WALL_SIDE_OFFSET_M 0.03f
+#endif
+
+#ifndef RR_WALL_FRONT_OFFSET_M
+#define RR_WALL_FRONT_OFFSET_M 0.04f
+#endif
+
+/**
+ * Hysteresis thresholds, see rr_walls::Thresholds. Can be changed at runtime with ExtRequest.wall_thresholds.
+ */
+#ifndef RR_WALL_ON_M
+#define RR_WALL_ON_M 0.02f
+#endif
+
+#ifndef RR_WALL_OFF_M
+#define RR_WALL_OFF_M 0.05f
+#endif
+
+#ifndef RR_WALL_MIN_CONFIDENCE
+#define RR_WALL_MIN_CONFIDENCE 0.5f
+#endif
+
+/**
+ * Largest angle between a beam and a maze axis that is still used (rad), and the distance from the middle of
+ * a cell within which the side sensors observe (m).
+ */
+#ifndef RR_WALL_MAX_SKEW
+#define RR_WALL_MAX_SKEW 0.35f
+#endif
+
+#ifndef RR_WALL_SIDE_WINDOW_M
+#define RR_WALL_SIDE_WINDOW_M 0.05f
+#endif
+
+/**
+ * How far past the boundary of the current cell the pose must be before it counts as having left it (m), so
+ * pose noise on a boundary does not emit cells back and forth.
+ */
+#ifndef RR_WALL_CELL_MARGIN_M
+#define RR_WALL_CELL_MARGIN_M 0.005f
+#endif
+
+/**
+ * Cell events kept until they are published, the oldest is dropped when full.
+ */
+#ifndef RR_WALL_EVENT_QUEUE
+#define RR_WALL_EVENT_QUEUE 8
+#endif
+
+namespace mb_operations
+{
+    /**
+     * @class RRWallOpHandler
+     * @brief detects the walls around each maze cell the robot passes through, responds to MSP_WALLS.
+     *
+     * service() feeds every new filtered range reading, with the pose estimate, to a rr_walls::WallDetector.
+     * Whenever the robot crosses into another cell the walls of the cell it left are queued, and the factory
+     * publishes them as MSP_WALLS frames with event set, so the host learns the maze a few bytes per cell
+     * without streaming range data. A request without a queued event returns the current cell so far.
+     */
+    class RRWallOpHandler : public mb_operations::MbOperationHandler
+    {
+    public:
+        static constexpr size_t MOUNTS = 3;
+
+    private:
+        const RRPoseOpHandler &pose_;
+        const RRRangeOpHandler &range_;
+        rr_walls::WallDetector detector_;
+
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        // timestamp of the last reading used from each mount.
+        std::uint32_t used_us_[MOUNTS] = {0, 0, 0};
+
+        rr_walls::CellWalls events_[RR_WALL_EVENT_QUEUE];
+        size_t head_ = 0;
+        size_t queued_ = 0;
+        std::uint32_t dropped_ = 0;
+
+        rr_walls::CellWalls last_left_ = {0, 0, 0, 0};
+        std::uint32_t cells_left_ = 0;
+
+        void push(const rr_walls::CellWalls &cell);
+
+    public:
+        RRWallOpHandler(const RRPoseOpHandler &pose, const RRRangeOpHandler &range);
+        ~RRWallOpHandler() = default;
+
+        /**
+         * @fn init
+         * @brief configures the detector from RR_MAZE_* and RR_WALL_*, and empties the event queue.
+         */
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        /**
+         * @fn service
+         * @brief tracks the current cell, and classifies its sides from readings that arrived since the last call.
+         */
+        void service() override;
+
+        /**
+         * @fn event_pending
+         * @brief true while cell events wait to be published.
+         */
+        bool event_pending() const;
+
+        const rr_walls::WallDetector &detector() const;
+
+        /**
+         * @fn cells_left
+         * @brief counts the cells left since init(), so on-device consumers can tell when last_left() is new.
+         */
+        std::uint32_t cells_left() const;
+
+        const rr_walls::CellWalls &last_left() const;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief applies wall_thresholds if present, and sets walls to the oldest queued event, or else the
+         * current cell.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // RR_WALLS_OP_HPP
@@ -0,0 +1,205 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_walls.hpp>
+
+#include <cmath>
+#include <rr_math.hpp>
+
+namespace rr_walls
+{
+    bool WallDetector::configure(const Maze &maze, float max_skew, float side_window_m, float cell_margin_m)
+    {
+        if (!(maze.cell_m > maze.wall_m) || !(maze.wall_m >= 0.0f) || maze.size == 0 ||
+            !(max_skew > 0.0f && max_skew < rr_math::PI / 4.0f) || !(side_window_m > 0.0f) ||
+            !(cell_margin_m >= 0.0f && cell_margin_m < 0.5f * maze.cell_m))
+        {
+            return false;
+        }
+        maze_ = maze;
+        max_skew_ = max_skew;
+        side_window_m_ = side_window_m;
+        cell_margin_m_ = cell_margin_m;
+        reset();
+        return true;
+    }
+
+    bool WallDetector::set_thresholds(const Thresholds &thresholds)
+    {
+        if (!(thresholds.on_m >= 0.0f && thresholds.on_m < thresholds.off_m) ||
+            !(thresholds.min_confidence >= 0.0f && thresholds.min_confidence <= 1.0f))
+        {
+            return false;
+        }
+        thresholds_ = thresholds;
+        return true;
+    }
+
+    const Thresholds &WallDetector::thresholds() const
+    {
+        return thresholds_;
+    }
+
+    void WallDetector::reset()
+    {
+        in_cell_ = false;
+        cell_ = {0, 0, 0, 0};
+    }
+
+    bool WallDetector::cell_of(const rr_pose::Pose &pose, std::uint8_t &x, std::uint8_t &y) const
+    {
+        if (!(pose.x >= 0.0f && pose.y >= 0.0f))
+        {
+            return false;
+        }
+        float cx = std::floor(pose.x / maze_.cell_m);
+        float cy = std::floor(pose.y / maze_.cell_m);
+        if (cx >= maze_.size || cy >= maze_.size)
+        {
+            return false;
+        }
+        x = static_cast<std::uint8_t>(cx);
+        y = static_cast<std::uint8_t>(cy);
+        return true;
+    }
+
+    void WallDetector::observe(const rr_pose::Pose &pose, const Mount &mount, const Observation &obs)
+    {
+        std::uint8_t x, y;
+        if (!in_cell_ || !cell_of(pose, x, y) || x != cell_.x || y != cell_.y)
+        {
+            return;
+        }
+
+        // nearest maze axis to the beam, 0 east, 1 north, 2 west, 3 south.
+        float theta = rr_math::wrap_pi(pose.heading + mount.angle);
+        long quadrant = std::lround(theta / rr_math::HALF_PI);
+        float skew = theta - static_cast<float>(quadrant) * rr_math::HALF_PI;
+        if (std::fabs(skew) > max_skew_)
+        {
+            return;
+        }
+
+        const float cell = maze_.cell_m;
+        const float face = 0.5f * maze_.wall_m;
+        // distance from the robot centre to the face of the wall on that side, and offset from the middle of the
+        // cell along the side.
+        float expected;
+        float along;
+        std::uint8_t side;
+        switch ((quadrant % 4 + 4) % 4)
+        {
+        case 0:
+            expected = (x + 1) * cell - face - pose.x;
+            along = pose.y - (y + 0.5f) * cell;
+            side = EAST;
+            break;
+        case 1:
+            expected = (y + 1) * cell - face - pose.y;
+            along = pose.x - (x + 0.5f) * cell;
+            side = NORTH;
+            break;
+        case 2:
+            expected = pose.x - (x * cell + face);
+            along = pose.y - (y + 0.5f) * cell;
+            side = WEST;
+            break;
+        default:
+            expected = pose.y - (y * cell + face);
+            along = pose.x - (x + 0.5f) * cell;
+            side = SOUTH;
+            break;
+        }
+
+        if (mount.lateral && std::fabs(along) > side_window_m_)
+        {
+            return;
+        }
+
+        bool wall;
+        if (!obs.valid)
+        {
+            // no echo within range, there is nothing on this side.
+            wall = false;
+        }
+        else
+        {
+            if (obs.confidence < thresholds_.min_confidence)
+            {
+                return;
+            }
+            float beyond = (obs.distance + mount.offset_m) * std::cos(skew) - expected;
+            if (beyond <= thresholds_.on_m)
+            {
+                wall = true;
+            }
+            else if (beyond >= thresholds_.off_m)
+            {
+                wall = false;
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        cell_.seen = static_cast<std::uint8_t>(cell_.seen | side);
+        cell_.walls = static_cast<std::uint8_t>(wall ? (cell_.walls | side) : (cell_.walls & ~side));
+    }
+
+    bool WallDetector::update(const rr_pose::Pose &pose, CellWalls &left)
+    {
+        // the current cell, grown by the margin on every side, is only left once the pose is outside it.
+        if (in_cell_)
+        {
+            const float cell = maze_.cell_m;
+            const float m = cell_margin_m_;
+            if (pose.x >= cell_.x * cell - m && pose.x < (cell_.x + 1) * cell + m && pose.y >= cell_.y * cell - m &&
+                pose.y < (cell_.y + 1) * cell + m)
+            {
+                return false;
+            }
+        }
+
+        std::uint8_t x, y;
+        bool inside = cell_of(pose, x, y);
+
+        bool crossed = in_cell_;
+        if (crossed)
+        {
+            left = cell_;
+        }
+        in_cell_ = inside;
+        cell_ = inside ? CellWalls{x, y, 0, 0} : CellWalls{0, 0, 0, 0};
+        return crossed;
+    }
+
+    bool WallDetector::in_cell() const
+    {
+        return in_cell_;
+    }
+
+    const CellWalls &WallDetector::current() const
+    {
+        return cell_;
+    }
+}
@@ -0,0 +1,190 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_walls_op.hpp>
+
+namespace mb_operations
+{
+    namespace
+    {
+        const size_t SENSORS[RRWallOpHandler::MOUNTS] = {RR_WALL_LEFT_SENSOR, RR_WALL_FRONT_SENSOR, RR_WALL_RIGHT_SENSOR};
+
+        const rr_walls::Mount MOUNTING[RRWallOpHandler::MOUNTS] = {
+            {rr_math::HALF_PI, RR_WALL_SIDE_OFFSET_M, true},
+            {0.0f, RR_WALL_FRONT_OFFSET_M, false},
+            {-rr_math::HALF_PI, RR_WALL_SIDE_OFFSET_M, true},
+        };
+
+        void to_proto(const rr_walls::CellWalls &cell, org_ryderrobots_mousebot_CellWalls &out)
+        {
+            out.x = cell.x;
+            out.y = cell.y;
+            out.walls = cell.walls;
+            out.seen = cell.seen;
+        }
+    }
+
+    RRWallOpHandler::RRWallOpHandler(const RRPoseOpHandler &pose, const RRRangeOpHandler &range)
+        : pose_(pose), range_(range)
+    {
+    }
+
+    void RRWallOpHandler::init()
+    {
+        rr_walls::Maze maze = {RR_MAZE_CELL_M, RR_MAZE_WALL_M, RR_MAZE_SIZE};
+        rr_walls::Thresholds thresholds = {RR_WALL_ON_M, RR_WALL_OFF_M, RR_WALL_MIN_CONFIDENCE};
+        if (!detector_.configure(maze, RR_WALL_MAX_SKEW, RR_WALL_SIDE_WINDOW_M, RR_WALL_CELL_MARGIN_M) || !detector_.set_thresholds(thresholds))
+        {
+            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_FAILURE;
+            return;
+        }
+
+        for (size_t m = 0; m < MOUNTS; m++)
+        {
+            used_us_[m] = range_.reading(SENSORS[m]).timestamp_us;
+        }
+        head_ = 0;
+        queued_ = 0;
+        dropped_ = 0;
+        cells_left_ = 0;
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRWallOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRWallOpHandler::push(const rr_walls::CellWalls &cell)
+    {
+        last_left_ = cell;
+        cells_left_++;
+
+        if (queued_ == RR_WALL_EVENT_QUEUE)
+        {
+            head_ = (head_ + 1) % RR_WALL_EVENT_QUEUE;
+            queued_--;
+            dropped_++;
+        }
+        events_[(head_ + queued_) % RR_WALL_EVENT_QUEUE] = cell;
+        queued_++;
+    }
+
+    void RRWallOpHandler::service()
+    {
+        if (status_ != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+        {
+            return;
+        }
+
+        // track the cell first, so readings are attributed to the cell the robot is in now.
+        const rr_pose::Pose &pose = pose_.pose();
+        rr_walls::CellWalls left;
+        if (detector_.update(pose, left))
+        {
+            push(left);
+        }
+
+        for (size_t m = 0; m < MOUNTS; m++)
+        {
+            const rr_range::Reading &r = range_.reading(SENSORS[m]);
+            if (r.timestamp_us == used_us_[m])
+            {
+                continue;
+            }
+            used_us_[m] = r.timestamp_us;
+            detector_.observe(pose, MOUNTING[m], {r.filtered_valid, r.filtered, r.confidence});
+        }
+    }
+
+    bool RRWallOpHandler::event_pending() const
+    {
+        return queued_ > 0;
+    }
+
+    const rr_walls::WallDetector &RRWallOpHandler::detector() const
+    {
+        return detector_;
+    }
+
+    std::uint32_t RRWallOpHandler::cells_left() const
+    {
+        return cells_left_;
+    }
+
+    const rr_walls::CellWalls &RRWallOpHandler::last_left() const
+    {
+        return last_left_;
+    }
+
+    void RRWallOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_WALLS)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRWallOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        org_ryderrobots_mousebot_WallState &w = eres.walls;
+        if (ereq.has_wall_thresholds)
+        {
+            rr_walls::Thresholds t = {
+                ereq.wall_thresholds.on_m,
+                ereq.wall_thresholds.off_m,
+                ereq.wall_thresholds.min_confidence,
+            };
+            w.accepted = detector_.set_thresholds(t);
+        }
+
+        if (queued_ > 0)
+        {
+            to_proto(events_[head_], w.cell);
+            head_ = (head_ + 1) % RR_WALL_EVENT_QUEUE;
+            queued_--;
+            w.event = true;
+            w.in_maze = true;
+        }
+        else
+        {
+            to_proto(detector_.current(), w.cell);
+            w.in_maze = detector_.in_cell();
+        }
+        w.has_cell = true;
+        w.queued = static_cast<std::uint32_t>(queued_);
+        w.dropped = dropped_;
+
+        const rr_walls::Thresholds &t = detector_.thresholds();
+        w.thresholds.on_m = t.on_m;
+        w.thresholds.off_m = t.off_m;
+        w.thresholds.min_confidence = t.min_confidence;
+        w.has_thresholds = true;
+        eres.has_walls = true;
+    }
+}
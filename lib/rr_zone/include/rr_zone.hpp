@@ -0,0 +1,235 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef RR_ZONE_HPP
+#define RR_ZONE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Profiling zones are compiled in when RR_ZONE_PROFILE is 1, otherwise RR_ZONE() expands to nothing.
+ */
+#ifndef RR_ZONE_PROFILE
+#define RR_ZONE_PROFILE 0
+#endif
+
+/**
+ * Zones are timed with the Cortex-M4 DWT cycle counter on target. Elsewhere std::chrono::steady_clock is used,
+ * with ticks of 1ns, and the first RR_ZONE_EVENTS zones left are also kept as events for a Chrome trace.
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define RR_ZONE_HW 1
+#include <nrf.h>
+#else
+#define RR_ZONE_HW 0
+#include <chrono>
+#include <cstdio>
+#endif
+
+/**
+ * Zone events kept off target, for write_chrome_trace().
+ */
+#ifndef RR_ZONE_EVENTS
+#define RR_ZONE_EVENTS 65536
+#endif
+
+namespace rr_zone
+{
+    /**
+     * Profiled zones, each has its own slot. A new zone is added here, and its name to Profiler::zone_name().
+     */
+    enum Zone : std::uint8_t
+    {
+        ZONE_LOOP = 0,
+        ZONE_SENSORS = 1,
+        ZONE_CONTROL = 2,
+        ZONE_SERIAL = 3,
+        ZONE_DECODE = 4,
+        ZONE_ENCODE = 5,
+        ZONE_BUS = 6,
+        ZONE_IMU = 7,
+        ZONE_POSE = 8,
+        ZONE_RANGE = 9,
+        ZONE_WALLS = 10,
+        ZONE_MAZE = 11,
+        ZONE_IMU_MONITOR = 12,
+        ZONE_EULER_TO_QUATERNION = 13,
+        ZONE_READ = 14,
+        ZONE_DISPATCH = 15,
+        ZONE_HANDLER = 16,
+        ZONE_WRITE = 17,
+        // ProfileState.zones max_count in proto/rr_mousebot.options.
+        ZONES = 18,
+    };
+
+#if RR_ZONE_HW
+    typedef std::uint32_t ticks_t;
+#else
+    typedef std::uint64_t ticks_t;
+#endif
+
+    /**
+     * Time spent in a zone, in ticks, nested zones included.
+     */
+    struct ZoneStats
+    {
+        std::uint32_t count;
+        std::uint32_t min_ticks;
+        std::uint32_t max_ticks;
+        std::uint64_t sum_ticks;
+    };
+
+#if !RR_ZONE_HW
+    struct ZoneEvent
+    {
+        ticks_t start;
+        std::uint32_t ticks;
+        Zone zone;
+    };
+#endif
+
+    /**
+     * @class Profiler
+     * @brief aggregates the time spent in each profiling zone.
+     *
+     * Zones are entered and left through RR_ZONE(), which reads the clock at the start and end of the
+     * enclosing scope, reading DWT->CYCCNT is a single load. Every zone has a fixed slot, so nothing is allocated,
+     * and durations are taken modulo 2^32 ticks, so the cycle counter wrapping does not matter for zones shorter
+     * than a minute.
+     */
+    class Profiler
+    {
+    private:
+        ZoneStats zones_[ZONES];
+
+#if !RR_ZONE_HW
+        ZoneEvent events_[RR_ZONE_EVENTS];
+        size_t event_count_ = 0;
+        std::uint32_t events_dropped_ = 0;
+#endif
+
+        Profiler();
+
+    public:
+        Profiler(const Profiler &) = delete;
+        Profiler &operator=(const Profiler &) = delete;
+
+        /**
+         * @fn init
+         * @brief starts the DWT cycle counter on target.
+         */
+        void init();
+
+        void reset();
+
+        /**
+         * @fn now
+         * @brief the current time in ticks.
+         */
+        static inline ticks_t now()
+        {
+#if RR_ZONE_HW
+            return DWT->CYCCNT;
+#else
+            return static_cast<ticks_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            std::chrono::steady_clock::now().time_since_epoch())
+                                            .count());
+#endif
+        }
+
+        /**
+         * @fn record
+         * @brief records that zone ran from start until end.
+         */
+        void record(Zone zone, ticks_t start, ticks_t end);
+
+        const ZoneStats &zone(Zone zone) const;
+
+        /**
+         * @fn ticks_per_us
+         * @brief clock ticks a microsecond, the core clock on target.
+         */
+        static std::uint32_t ticks_per_us();
+
+        static std::uint32_t to_ns(std::uint64_t ticks);
+
+        static const char *zone_name(Zone zone);
+
+#if !RR_ZONE_HW
+        size_t events() const;
+        const ZoneEvent &event(size_t i) const;
+
+        /**
+         * @fn events_dropped
+         * @brief zones left after RR_ZONE_EVENTS events were kept.
+         */
+        std::uint32_t events_dropped() const;
+
+        /**
+         * @fn write_chrome_trace
+         * @brief writes the events kept as Chrome trace JSON, to be opened in chrome://tracing or Perfetto.
+         *
+         * @return false when out could not be written.
+         */
+        bool write_chrome_trace(std::FILE *out) const;
+#endif
+
+        static Profiler &get_instance();
+    };
+
+    /**
+     * @class Scope
+     * @brief records zone from construction until it goes out of scope.
+     */
+    class Scope
+    {
+    private:
+        Zone zone_;
+        ticks_t start_;
+
+    public:
+        explicit Scope(Zone zone) : zone_(zone), start_(Profiler::now()) {}
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope()
+        {
+            Profiler::get_instance().record(zone_, start_, Profiler::now());
+        }
+    };
+}
+
+#define RR_ZONE_CONCAT_(a, b) a##b
+#define RR_ZONE_CONCAT(a, b) RR_ZONE_CONCAT_(a, b)
+
+#if RR_ZONE_PROFILE
+#define RR_ZONE(zone) rr_zone::Scope RR_ZONE_CONCAT(rr_zone_scope_, __LINE__)(zone)
+#else
+#define RR_ZONE(zone) \
+    do                        \
+    {                         \
+    } while (0)
+#endif
+
+#endif // RR_ZONE_HPP
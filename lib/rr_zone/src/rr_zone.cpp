@@ -0,0 +1,191 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_zone.hpp>
+#include <cstring>
+
+namespace rr_zone
+{
+    namespace
+    {
+        const char *const ZONE_NAMES[ZONES] = {
+            "loop",
+            "sensors",
+            "control",
+            "serial",
+            "decode",
+            "encode",
+            "bus",
+            "imu",
+            "pose",
+            "range",
+            "walls",
+            "maze",
+            "imu_monitor",
+            "euler_to_quaternion",
+            "read",
+            "dispatch",
+            "handler",
+            "write",
+        };
+    }
+
+    Profiler::Profiler()
+    {
+        reset();
+    }
+
+    void Profiler::init()
+    {
+#if RR_ZONE_HW
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    }
+
+    void Profiler::reset()
+    {
+        std::memset(zones_, 0, sizeof(zones_));
+        for (size_t z = 0; z < ZONES; z++)
+        {
+            zones_[z].min_ticks = UINT32_MAX;
+        }
+#if !RR_ZONE_HW
+        event_count_ = 0;
+        events_dropped_ = 0;
+#endif
+    }
+
+    void Profiler::record(Zone zone, ticks_t start, ticks_t end)
+    {
+        if (zone >= ZONES)
+        {
+            return;
+        }
+
+        // unsigned arithmetic, correct across one wrap of the cycle counter.
+        std::uint32_t ticks = static_cast<std::uint32_t>(end - start);
+        ZoneStats &z = zones_[zone];
+        z.count++;
+        z.sum_ticks += ticks;
+        if (ticks < z.min_ticks)
+        {
+            z.min_ticks = ticks;
+        }
+        if (ticks > z.max_ticks)
+        {
+            z.max_ticks = ticks;
+        }
+
+#if !RR_ZONE_HW
+        if (event_count_ < RR_ZONE_EVENTS)
+        {
+            events_[event_count_++] = {start, ticks, zone};
+        }
+        else
+        {
+            events_dropped_++;
+        }
+#endif
+    }
+
+    const ZoneStats &Profiler::zone(Zone zone) const
+    {
+        return zones_[zone < ZONES ? zone : 0];
+    }
+
+    std::uint32_t Profiler::ticks_per_us()
+    {
+#if RR_ZONE_HW
+        return SystemCoreClock / 1000000;
+#else
+        return 1000;
+#endif
+    }
+
+    std::uint32_t Profiler::to_ns(std::uint64_t ticks)
+    {
+        std::uint64_t ns = ticks * 1000 / ticks_per_us();
+        return ns > UINT32_MAX ? UINT32_MAX : static_cast<std::uint32_t>(ns);
+    }
+
+    const char *Profiler::zone_name(Zone zone)
+    {
+        return zone < ZONES ? ZONE_NAMES[zone] : "unknown";
+    }
+
+#if !RR_ZONE_HW
+    size_t Profiler::events() const
+    {
+        return event_count_;
+    }
+
+    const ZoneEvent &Profiler::event(size_t i) const
+    {
+        return events_[i < event_count_ ? i : 0];
+    }
+
+    std::uint32_t Profiler::events_dropped() const
+    {
+        return events_dropped_;
+    }
+
+    bool Profiler::write_chrome_trace(std::FILE *out) const
+    {
+        if (out == nullptr)
+        {
+            return false;
+        }
+
+        // complete ("X") events in us, relative to the first zone entered, on a single thread.
+        ticks_t origin = 0;
+        for (size_t i = 0; i < event_count_; i++)
+        {
+            if (i == 0 || events_[i].start < origin)
+            {
+                origin = events_[i].start;
+            }
+        }
+
+        std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+        for (size_t i = 0; i < event_count_; i++)
+        {
+            const ZoneEvent &e = events_[i];
+            std::fprintf(out, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                         i == 0 ? "" : ",", zone_name(e.zone), static_cast<double>(e.start - origin) / 1000.0,
+                         static_cast<double>(e.ticks) / 1000.0);
+        }
+        std::fprintf(out, "\n]}\n");
+        return std::ferror(out) == 0;
+    }
+#endif
+
+    /**
+     * return static reference to profiler object.
+     */
+    Profiler &Profiler::get_instance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+}
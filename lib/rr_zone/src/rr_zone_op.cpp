@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <rr_zone_op.hpp>
+#include <cstdio>
+
+namespace mb_operations
+{
+    namespace
+    {
+        // the Response and the ExtResponse, which for MSP_PROFILE holds only profile behind a two byte tag and a
+        // length of at most two bytes, are encoded together into the BUFSIZ output buffer. nanopb only defines
+        // a message size when every field of it is bounded.
+#if defined(org_ryderrobots_ros2_serial_Response_size) && defined(org_ryderrobots_mousebot_ProfileState_size)
+        static_assert(org_ryderrobots_ros2_serial_Response_size + 4 + org_ryderrobots_mousebot_ProfileState_size <= BUFSIZ,
+                      "an MSP_PROFILE response with every zone must fit the output buffer");
+#endif
+    }
+
+    void RRProfileOpHandler::init()
+    {
+        rr_zone::Profiler::get_instance().init();
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRProfileOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRProfileOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_PROFILE)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRProfileOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        rr_zone::Profiler &profiler = rr_zone::Profiler::get_instance();
+        org_ryderrobots_mousebot_ProfileState &p = eres.profile;
+        eres.has_profile = true;
+
+        p.enabled = RR_ZONE_PROFILE;
+        p.ticks_per_us = rr_zone::Profiler::ticks_per_us();
+
+        const size_t max_zones = sizeof(p.zones) / sizeof(p.zones[0]);
+        static_assert(sizeof(p.zones) / sizeof(p.zones[0]) == rr_zone::ZONES, "ProfileState.zones max_count is rr_zone::ZONES");
+        for (std::uint8_t zone = 0; zone < rr_zone::ZONES && p.zones_count < max_zones; zone++)
+        {
+            const rr_zone::ZoneStats &z = profiler.zone(static_cast<rr_zone::Zone>(zone));
+            if (z.count == 0)
+            {
+                continue;
+            }
+
+            org_ryderrobots_mousebot_ProfileZone &out = p.zones[p.zones_count++];
+            out.zone = zone;
+            out.count = z.count;
+            out.min_ns = rr_zone::Profiler::to_ns(z.min_ticks);
+            out.max_ns = rr_zone::Profiler::to_ns(z.max_ticks);
+            out.mean_ns = rr_zone::Profiler::to_ns(z.sum_ticks / z.count);
+            out.total_us = z.sum_ticks / rr_zone::Profiler::ticks_per_us();
+        }
+
+        if (ereq.profile_reset)
+        {
+            profiler.reset();
+            p.accepted = true;
+        }
+    }
+}
@@ -21,8 +21,19 @@
 #ifndef WDT_HPP
 #define WDT_HPP
 
-#include <nrf.h>
 #include <Arduino.h>
+#include <wdt_supervisor.hpp>
+#include <wdt_trace.hpp>
+
+/**
+ * The nRF52840 watchdog is only driven on target. Elsewhere check ins are recorded, and nothing resets.
+ */
+#if defined(ARDUINO) && defined(NRF52840_XXAA)
+#define WDT_HW 1
+#include <nrf.h>
+#else
+#define WDT_HW 0
+#endif
 
 namespace wdt
 {
@@ -32,17 +43,22 @@ namespace wdt
      * @brief watchdog functionality
      *
      * Connects to BLE internal watchdog, which is nRF52840.
+     *
+     * Each Task has its own reload register, and the nRF52 only reloads the counter once every enabled register
+     * has been written, so the board resets if any one task stops checking in, not only when the whole loop
+     * stalls. The Supervisor keeps the loop timing that shows where the time went before it comes to that, and
+     * the Trace, in retained RAM, what the loop was doing when it did.
      */
     class Wdt
     {
 
     private:
         size_t timeout_secs_ = 5;
+        Supervisor supervisor_;
+        Trace trace_;
+        std::uint32_t loop_start_us_ = 0;
 
-        Wdt()
-        {
-            init();
-        }
+        Wdt();
 
     public:
         Wdt(const Wdt &) = delete;
@@ -53,15 +69,49 @@ namespace wdt
 
         /**
          * @fn init
-         * @brief initlize RR
+         * @brief enables RR[0] to RR[TASKS - 1], and starts the watchdog. The configuration can not change once
+         * it runs, so later calls do nothing.
          */
         void init();
 
         /**
          * @fn reset
-         * @brief Feed RR[0]
+         * @brief Feed every task's reload register
          */
         void reset();
+
+        /**
+         * @fn begin_loop
+         * @brief starts timing a main loop iteration.
+         */
+        void begin_loop();
+
+        /**
+         * @fn check_in
+         * @brief Feed RR[task], and record the check in.
+         */
+        void check_in(Task task);
+
+        /**
+         * @fn note
+         * @brief records the operation requested in this iteration, for the slowest iterations kept, and traces
+         * its handler being entered.
+         */
+        void note(std::int32_t op);
+
+        /**
+         * @fn note_publication
+         * @brief traces the handler of a publication being entered.
+         */
+        void note_publication(std::int32_t op);
+
+        void end_loop();
+
+        Supervisor &supervisor();
+
+        const Trace &trace() const;
+
+        std::uint32_t timeout_ms() const;
     };
 }
 
@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef WDT_OP_HPP
+#define WDT_OP_HPP
+
+#include "Arduino.h"
+#include "pb_encode.h"
+#include "pb_decode.h"
+#include "rr_serial.pb.h"
+#include "rr_mousebot.pb.h"
+#include <mb_operations.hpp>
+#include <rr_ble.hpp>
+#include <wdt.hpp>
+
+namespace mb_operations
+{
+    /**
+     * @class RRWdtOpHandler
+     * @brief reports main loop timing and watchdog check ins from wdt::Wdt, responds to MSP_STATUS, and
+     * MSP_TRACE with the trace left by the previous boot.
+     */
+    class RRWdtOpHandler : public mb_operations::MbOperationHandler
+    {
+    private:
+        org_ryderrobots_ros2_serial_Status status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
+
+        // operation of the request being answered, perform_ext() fills in the part it asked for.
+        std::int32_t op_ = 0;
+
+        void fill_loop(bool reset, org_ryderrobots_mousebot_LoopState &l);
+        void fill_trace(std::uint32_t from, org_ryderrobots_mousebot_TraceState &t);
+
+    public:
+        RRWdtOpHandler() = default;
+        ~RRWdtOpHandler() = default;
+
+        void init() override;
+
+        org_ryderrobots_ros2_serial_Status status() override;
+
+        void perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &res) override;
+
+        /**
+         * @fn perform_ext
+         * @brief MSP_STATUS fills loop, then clears the statistics if loop_reset is set. MSP_TRACE fills trace
+         * from event trace_from.
+         */
+        void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) override;
+    };
+}
+
+#endif // WDT_OP_HPP
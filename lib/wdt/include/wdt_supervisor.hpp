@@ -0,0 +1,184 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef WDT_SUPERVISOR_HPP
+#define WDT_SUPERVISOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <rr_loop_timer.hpp>
+
+/**
+ * Slowest main loop iterations kept, with the task and operation that took longest in each.
+ */
+#ifndef WDT_OFFENDERS
+#define WDT_OFFENDERS 4
+#endif
+
+/**
+ * Main loop budget (us), iterations that start more than half of it late, or run longer, count as overruns.
+ */
+#ifndef WDT_LOOP_BUDGET_US
+#define WDT_LOOP_BUDGET_US 2000
+#endif
+
+namespace wdt
+{
+    /**
+     * Tasks that check in with the watchdog, each has its own nRF52 reload register RR[task].
+     */
+    enum Task : std::uint8_t
+    {
+        TASK_SERIAL = 0,
+        TASK_SENSORS = 1,
+        TASK_CONTROL = 2,
+        TASKS = 3,
+    };
+
+    struct TaskTiming
+    {
+        std::uint32_t check_ins;
+
+        // longest time from the previous check in of any task, or the start of the iteration, to this task's.
+        std::uint32_t max_span_us;
+
+        // longest time between two check ins of this task.
+        std::uint32_t max_gap_us;
+    };
+
+    /**
+     * One of the slowest iterations, when it finished (ms), the operation requested in it (0 if none), and the
+     * task that took longest.
+     */
+    struct Offender
+    {
+        std::uint32_t exec_us;
+        std::uint32_t at_ms;
+        std::int32_t op;
+        Task task;
+        std::uint32_t task_us;
+    };
+
+    /**
+     * @class Supervisor
+     * @brief main loop timing, and task check in bookkeeping for the watchdog.
+     *
+     * begin() and end() bracket each main loop iteration, and each task calls check_in() when it has done its
+     * part. Iteration periods go into a rr_control::LoopTimer, and a log2 histogram, bucket b counting periods
+     * of 2^b us up to 2^(b + 1), the last bucket everything longer. The WDT_OFFENDERS slowest iterations are kept
+     * with the task whose span was longest, so a spike can be traced to the stage that caused it.
+     *
+     * The supervisor does not touch the hardware, and all times are passed in, so it runs the same on the host.
+     */
+    class Supervisor
+    {
+    public:
+        static constexpr size_t BUCKETS = 24;
+        static constexpr std::uint8_t ALL_TASKS = (1 << TASKS) - 1;
+
+    private:
+        rr_control::LoopTimer timer_;
+        std::uint32_t histogram_[BUCKETS];
+        TaskTiming tasks_[TASKS];
+        std::uint32_t last_check_in_us_[TASKS];
+        Offender offenders_[WDT_OFFENDERS];
+        size_t offender_count_ = 0;
+        Offender last_ = {0, 0, 0, TASK_SERIAL, 0};
+
+        bool started_ = false;
+        std::uint32_t last_begin_us_ = 0;
+        std::uint32_t mark_us_ = 0;
+        std::uint8_t pending_ = ALL_TASKS;
+        std::uint32_t rounds_ = 0;
+
+        // the iteration in progress.
+        std::int32_t op_ = 0;
+        Task slowest_ = TASK_SERIAL;
+        std::uint32_t slowest_us_ = 0;
+
+    public:
+        Supervisor();
+
+        void reset();
+
+        /**
+         * @fn begin
+         * @brief starts an iteration, and records the period since the last.
+         */
+        void begin(std::uint32_t now_us);
+
+        /**
+         * @fn check_in
+         * @brief records that task has done its part of this iteration.
+         *
+         * @return true when this completes a round, every task having checked in since the last one did.
+         */
+        bool check_in(Task task, std::uint32_t now_us);
+
+        /**
+         * @fn note
+         * @brief records the operation requested in this iteration.
+         */
+        void note(std::int32_t op);
+
+        /**
+         * @fn end
+         * @brief ends an iteration, and keeps it if it is among the slowest.
+         */
+        void end(std::uint32_t now_us, std::uint32_t now_ms);
+
+        const rr_control::LoopTiming &timing() const;
+        std::uint32_t bucket(size_t b) const;
+        const TaskTiming &task(Task task) const;
+
+        size_t offenders() const;
+
+        /**
+         * @fn offender
+         * @brief the i'th slowest iteration kept, slowest first.
+         */
+        const Offender &offender(size_t i) const;
+
+        /**
+         * @fn last
+         * @brief the iteration that ended last, whether or not it is among the slowest.
+         */
+        const Offender &last() const;
+
+        /**
+         * @fn pending
+         * @brief bit mask of the tasks that have not checked in since the last round completed, the tasks the
+         * hardware is waiting for.
+         */
+        std::uint8_t pending() const;
+
+        std::uint32_t rounds() const;
+
+        /**
+         * @fn bucket_of
+         * @brief histogram bucket of period_us.
+         */
+        static size_t bucket_of(std::uint32_t period_us);
+    };
+}
+
+#endif // WDT_SUPERVISOR_HPP
@@ -0,0 +1,162 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef WDT_TRACE_HPP
+#define WDT_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Events kept in retained RAM, a power of two.
+ */
+#ifndef WDT_TRACE_EVENTS
+#define WDT_TRACE_EVENTS 64
+#endif
+
+namespace wdt
+{
+    static_assert((WDT_TRACE_EVENTS & (WDT_TRACE_EVENTS - 1)) == 0, "WDT_TRACE_EVENTS must be a power of two");
+
+    enum TraceKind : std::uint8_t
+    {
+        TE_NONE = 0,
+
+        // a main loop iteration finished, loop_us is its run time, task the task that took longest.
+        TE_LOOP = 1,
+
+        // a request, or publication, is about to be handled, loop_us is the time into the iteration.
+        TE_REQUEST = 2,
+        TE_PUBLISH = 3,
+    };
+
+    struct TraceEvent
+    {
+        std::uint32_t at_us;
+        std::uint32_t loop_us;
+        std::int16_t op;
+        std::uint8_t task;
+        TraceKind kind;
+    };
+
+    /**
+     * Trace state kept in retained RAM. Nothing here is initialised by the C runtime, Trace::boot() checks the
+     * magic and sanity of what it finds before trusting it.
+     */
+    struct Retained
+    {
+        std::uint32_t magic;
+        std::uint32_t boots;
+
+        // events written since boot, the next is written at head % WDT_TRACE_EVENTS.
+        std::uint32_t head;
+
+        // tasks that have not checked in during the iteration in progress.
+        std::uint32_t pending;
+
+        TraceEvent events[WDT_TRACE_EVENTS];
+    };
+
+    /**
+     * @class Trace
+     * @brief post-mortem trace ring, in RAM that survives a watchdog reset.
+     *
+     * record() is a handful of stores, without formatting or locking, so it stays enabled in production. At
+     * boot the ring left by the previous boot is copied aside, with the reset reason, for the host to read, and a
+     * new ring is started. The last events, and the tasks still pending, show what the loop was doing when the
+     * watchdog fired.
+     */
+    class Trace
+    {
+    public:
+        static constexpr std::uint32_t MAGIC = 0x52525452;
+
+    private:
+        Retained &ram_;
+
+        TraceEvent previous_[WDT_TRACE_EVENTS];
+        size_t previous_count_ = 0;
+        std::uint32_t previous_recorded_ = 0;
+        std::uint32_t previous_pending_ = 0;
+        bool previous_valid_ = false;
+        std::uint32_t reset_reason_ = 0;
+
+    public:
+        explicit Trace(Retained &ram);
+
+        /**
+         * @fn boot
+         * @brief keeps the previous boot's ring, if retained RAM holds a valid one, and starts a new one.
+         */
+        void boot(std::uint32_t reset_reason);
+
+        inline void record(TraceKind kind, std::int32_t op, std::uint8_t task, std::uint32_t at_us, std::uint32_t loop_us)
+        {
+            TraceEvent &e = ram_.events[ram_.head & (WDT_TRACE_EVENTS - 1)];
+            e.at_us = at_us;
+            e.loop_us = loop_us;
+            e.op = static_cast<std::int16_t>(op);
+            e.task = task;
+            e.kind = kind;
+            ram_.head++;
+        }
+
+        inline void set_pending(std::uint32_t pending)
+        {
+            ram_.pending = pending;
+        }
+
+        /**
+         * @fn reset_reason
+         * @brief RESETREAS as read at boot, 0 after a power on reset.
+         */
+        std::uint32_t reset_reason() const;
+
+        std::uint32_t boots() const;
+
+        /**
+         * @fn previous_valid
+         * @brief true if the previous boot's ring was retained.
+         */
+        bool previous_valid() const;
+
+        size_t previous_count() const;
+
+        /**
+         * @fn previous
+         * @brief the i'th event kept from the previous boot, oldest first.
+         */
+        const TraceEvent &previous(size_t i) const;
+
+        /**
+         * @fn previous_recorded
+         * @brief events the previous boot recorded, including those overwritten.
+         */
+        std::uint32_t previous_recorded() const;
+
+        std::uint32_t previous_pending() const;
+
+        std::uint32_t recorded() const;
+    };
+}
+
+#endif // WDT_TRACE_HPP
@@ -22,21 +22,119 @@
 
 namespace wdt
 {
+    static_assert(TASKS == 3, "RREN enables one reload register per task");
+
+    namespace
+    {
+        // left alone by the C runtime, so it still holds the trace after a watchdog, pin, or soft reset.
+#if WDT_HW
+        __attribute__((section(".noinit"))) Retained retained;
+#else
+        Retained retained;
+#endif
+
+        /*
+         * reset reason, cleared once read so the next boot sees only its own.
+         */
+        std::uint32_t read_reset_reason()
+        {
+#if WDT_HW
+            std::uint32_t reason = NRF_POWER->RESETREAS;
+            NRF_POWER->RESETREAS = reason;
+            return reason;
+#else
+            return 0;
+#endif
+        }
+    }
+
+    Wdt::Wdt() : trace_(retained)
+    {
+        trace_.boot(read_reset_reason());
+        init();
+    }
+
     /**
      * These functions are pretty spectic chipsets that support them, such as Arduino Nano BLE 33.
      */
     void Wdt::init()
     {
+#if WDT_HW
+        if (NRF_WDT->RUNSTATUS)
+        {
+            return;
+        }
+
         // 5 second timeout
         NRF_WDT->CRV = 32768 * timeout_secs_; // 32768 * 5
-        NRF_WDT->RREN = WDT_RREN_RR0_Msk;     // Enable RR[0]
+        NRF_WDT->RREN = WDT_RREN_RR0_Msk | WDT_RREN_RR1_Msk | WDT_RREN_RR2_Msk; // Enable RR[0] .. RR[TASKS - 1]
         NRF_WDT->CONFIG = ((WDT_CONFIG_SLEEP_Run << WDT_CONFIG_SLEEP_Pos) | (WDT_CONFIG_HALT_Pause << WDT_CONFIG_HALT_Pos));
         NRF_WDT->TASKS_START = 1;
+#endif
     }
 
     void Wdt::reset()
     {
-        NRF_WDT->RR[0] = WDT_RR_RR_Reload;
+#if WDT_HW
+        for (size_t t = 0; t < TASKS; t++)
+        {
+            NRF_WDT->RR[t] = WDT_RR_RR_Reload;
+        }
+#endif
+    }
+
+    void Wdt::begin_loop()
+    {
+        loop_start_us_ = micros();
+        supervisor_.begin(loop_start_us_);
+    }
+
+    void Wdt::check_in(Task task)
+    {
+#if WDT_HW
+        if (task < TASKS)
+        {
+            NRF_WDT->RR[task] = WDT_RR_RR_Reload;
+        }
+#endif
+        supervisor_.check_in(task, micros());
+        trace_.set_pending(supervisor_.pending());
+    }
+
+    void Wdt::note(std::int32_t op)
+    {
+        supervisor_.note(op);
+        std::uint32_t now = micros();
+        trace_.record(TE_REQUEST, op, TASK_SERIAL, now, now - loop_start_us_);
+    }
+
+    void Wdt::note_publication(std::int32_t op)
+    {
+        std::uint32_t now = micros();
+        trace_.record(TE_PUBLISH, op, TASK_SERIAL, now, now - loop_start_us_);
+    }
+
+    void Wdt::end_loop()
+    {
+        std::uint32_t now = micros();
+        supervisor_.end(now, millis());
+        const Offender &o = supervisor_.last();
+        trace_.record(TE_LOOP, o.op, o.task, now, o.exec_us);
+    }
+
+    Supervisor &Wdt::supervisor()
+    {
+        return supervisor_;
+    }
+
+    const Trace &Wdt::trace() const
+    {
+        return trace_;
+    }
+
+    std::uint32_t Wdt::timeout_ms() const
+    {
+        return static_cast<std::uint32_t>(timeout_secs_ * 1000);
     }
 
     Wdt &Wdt::get_instance()
@@ -0,0 +1,151 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <wdt_op.hpp>
+
+namespace mb_operations
+{
+    namespace
+    {
+        inline std::uint32_t mean(std::uint64_t sum, std::uint32_t n)
+        {
+            return n == 0 ? 0 : static_cast<std::uint32_t>(sum / n);
+        }
+    }
+
+    void RRWdtOpHandler::init()
+    {
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    org_ryderrobots_ros2_serial_Status RRWdtOpHandler::status()
+    {
+        return status_;
+    }
+
+    void RRWdtOpHandler::perform_op(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
+    {
+        response = org_ryderrobots_ros2_serial_Response_init_zero;
+        response.op = req.op;
+        op_ = req.op;
+
+        if (req.op != rr_ble::rr_op_code_t::MSP_STATUS && req.op != rr_ble::rr_op_code_t::MSP_TRACE)
+        {
+            org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+            bad_request.etype = org_ryderrobots_ros2_serial_ErrorType::org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION;
+            response.data.bad_request = bad_request;
+            response.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+        }
+    }
+
+    void RRWdtOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        if (op_ == rr_ble::rr_op_code_t::MSP_TRACE)
+        {
+            fill_trace(ereq.trace_from, eres.trace);
+            eres.has_trace = true;
+            return;
+        }
+        fill_loop(ereq.loop_reset, eres.loop);
+        eres.has_loop = true;
+    }
+
+    void RRWdtOpHandler::fill_trace(std::uint32_t from, org_ryderrobots_mousebot_TraceState &t)
+    {
+        const wdt::Trace &trace = wdt::Wdt::get_instance().trace();
+        t.reset_reason = trace.reset_reason();
+        t.boots = trace.boots();
+        t.valid = trace.previous_valid();
+        t.pending = trace.previous_pending();
+        t.recorded = trace.previous_recorded();
+        t.total = static_cast<std::uint32_t>(trace.previous_count());
+        t.first = from;
+
+        const size_t max_events = sizeof(t.events) / sizeof(t.events[0]);
+        size_t i = from;
+        for (; i < trace.previous_count() && t.events_count < max_events; i++)
+        {
+            const wdt::TraceEvent &e = trace.previous(i);
+            org_ryderrobots_mousebot_TraceEvent &out = t.events[t.events_count++];
+            out.at_us = e.at_us;
+            out.loop_us = e.loop_us;
+            out.op = e.op;
+            out.task = e.task;
+            out.kind = static_cast<org_ryderrobots_mousebot_TraceKind>(e.kind);
+        }
+        t.more = i < trace.previous_count();
+    }
+
+    void RRWdtOpHandler::fill_loop(bool reset, org_ryderrobots_mousebot_LoopState &l)
+    {
+        wdt::Wdt &watchdog = wdt::Wdt::get_instance();
+        wdt::Supervisor &sv = watchdog.supervisor();
+
+        const rr_control::LoopTiming &t = sv.timing();
+        l.timing.count = t.count;
+        l.timing.period_min_us = t.count > 1 ? t.period_min_us : 0;
+        l.timing.period_max_us = t.period_max_us;
+        l.timing.period_mean_us = mean(t.period_sum_us, t.count > 1 ? t.count - 1 : 0);
+        l.timing.exec_min_us = t.count > 0 ? t.exec_min_us : 0;
+        l.timing.exec_max_us = t.exec_max_us;
+        l.timing.exec_mean_us = mean(t.exec_sum_us, t.count);
+        l.timing.overruns = t.overruns;
+        l.has_timing = true;
+
+        const size_t max_buckets = sizeof(l.histogram) / sizeof(l.histogram[0]);
+        for (size_t b = 0; b < wdt::Supervisor::BUCKETS && b < max_buckets; b++)
+        {
+            l.histogram[l.histogram_count++] = sv.bucket(b);
+        }
+
+        for (std::uint8_t task = 0; task < wdt::TASKS; task++)
+        {
+            const wdt::TaskTiming &tt = sv.task(static_cast<wdt::Task>(task));
+            org_ryderrobots_mousebot_TaskTiming &out = l.tasks[l.tasks_count++];
+            out.check_ins = tt.check_ins;
+            out.max_span_us = tt.max_span_us;
+            out.max_gap_us = tt.max_gap_us;
+        }
+
+        const size_t max_offenders = sizeof(l.offenders) / sizeof(l.offenders[0]);
+        for (size_t i = 0; i < sv.offenders() && i < max_offenders; i++)
+        {
+            const wdt::Offender &o = sv.offender(i);
+            org_ryderrobots_mousebot_LoopOffender &out = l.offenders[l.offenders_count++];
+            out.exec_us = o.exec_us;
+            out.at_ms = o.at_ms;
+            out.op = o.op;
+            out.task = o.task;
+            out.task_us = o.task_us;
+        }
+
+        l.pending = sv.pending();
+        l.rounds = sv.rounds();
+        l.timeout_ms = watchdog.timeout_ms();
+
+        if (reset)
+        {
+            sv.reset();
+            l.accepted = true;
+        }
+    }
+}
@@ -0,0 +1,185 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <wdt_supervisor.hpp>
+
+namespace wdt
+{
+    Supervisor::Supervisor()
+    {
+        timer_.set_period(WDT_LOOP_BUDGET_US);
+        reset();
+    }
+
+    void Supervisor::reset()
+    {
+        timer_.reset();
+        for (size_t b = 0; b < BUCKETS; b++)
+        {
+            histogram_[b] = 0;
+        }
+        for (size_t t = 0; t < TASKS; t++)
+        {
+            tasks_[t] = {0, 0, 0};
+            last_check_in_us_[t] = 0;
+        }
+        offender_count_ = 0;
+        started_ = false;
+        pending_ = ALL_TASKS;
+        rounds_ = 0;
+    }
+
+    size_t Supervisor::bucket_of(std::uint32_t period_us)
+    {
+        size_t b = 0;
+        while (period_us > 1 && b < BUCKETS - 1)
+        {
+            period_us >>= 1;
+            b++;
+        }
+        return b;
+    }
+
+    void Supervisor::begin(std::uint32_t now_us)
+    {
+        if (started_)
+        {
+            histogram_[bucket_of(now_us - last_begin_us_)]++;
+        }
+        timer_.start(now_us);
+        started_ = true;
+        last_begin_us_ = now_us;
+        mark_us_ = now_us;
+        op_ = 0;
+        slowest_ = TASK_SERIAL;
+        slowest_us_ = 0;
+    }
+
+    bool Supervisor::check_in(Task task, std::uint32_t now_us)
+    {
+        if (task >= TASKS)
+        {
+            return false;
+        }
+
+        TaskTiming &t = tasks_[task];
+        std::uint32_t span = now_us - mark_us_;
+        mark_us_ = now_us;
+        if (span > t.max_span_us)
+        {
+            t.max_span_us = span;
+        }
+        if (span >= slowest_us_)
+        {
+            slowest_ = task;
+            slowest_us_ = span;
+        }
+
+        if (t.check_ins > 0)
+        {
+            std::uint32_t gap = now_us - last_check_in_us_[task];
+            if (gap > t.max_gap_us)
+            {
+                t.max_gap_us = gap;
+            }
+        }
+        last_check_in_us_[task] = now_us;
+        t.check_ins++;
+
+        pending_ &= static_cast<std::uint8_t>(~(1 << task));
+        if (pending_ != 0)
+        {
+            return false;
+        }
+        pending_ = ALL_TASKS;
+        rounds_++;
+        return true;
+    }
+
+    void Supervisor::note(std::int32_t op)
+    {
+        op_ = op;
+    }
+
+    void Supervisor::end(std::uint32_t now_us, std::uint32_t now_ms)
+    {
+        timer_.stop(now_us);
+        Offender o = {now_us - last_begin_us_, now_ms, op_, slowest_, slowest_us_};
+        last_ = o;
+
+        // sorted slowest first, the fastest kept drops out when full.
+        size_t i = offender_count_ < WDT_OFFENDERS ? offender_count_++ : WDT_OFFENDERS;
+        if (i == WDT_OFFENDERS)
+        {
+            if (o.exec_us <= offenders_[WDT_OFFENDERS - 1].exec_us)
+            {
+                return;
+            }
+            i = WDT_OFFENDERS - 1;
+        }
+        for (; i > 0 && offenders_[i - 1].exec_us < o.exec_us; i--)
+        {
+            offenders_[i] = offenders_[i - 1];
+        }
+        offenders_[i] = o;
+    }
+
+    const rr_control::LoopTiming &Supervisor::timing() const
+    {
+        return timer_.stats();
+    }
+
+    std::uint32_t Supervisor::bucket(size_t b) const
+    {
+        return b < BUCKETS ? histogram_[b] : 0;
+    }
+
+    const TaskTiming &Supervisor::task(Task task) const
+    {
+        return tasks_[task < TASKS ? task : TASK_SERIAL];
+    }
+
+    size_t Supervisor::offenders() const
+    {
+        return offender_count_;
+    }
+
+    const Offender &Supervisor::offender(size_t i) const
+    {
+        return offenders_[i];
+    }
+
+    const Offender &Supervisor::last() const
+    {
+        return last_;
+    }
+
+    std::uint8_t Supervisor::pending() const
+    {
+        return pending_;
+    }
+
+    std::uint32_t Supervisor::rounds() const
+    {
+        return rounds_;
+    }
+}
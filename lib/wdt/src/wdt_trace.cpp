@@ -0,0 +1,99 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <wdt_trace.hpp>
+
+namespace wdt
+{
+    Trace::Trace(Retained &ram) : ram_(ram)
+    {
+    }
+
+    void Trace::boot(std::uint32_t reset_reason)
+    {
+        reset_reason_ = reset_reason;
+        previous_valid_ = ram_.magic == MAGIC;
+        previous_count_ = 0;
+        previous_recorded_ = 0;
+        previous_pending_ = 0;
+
+        if (previous_valid_)
+        {
+            std::uint32_t head = ram_.head;
+            previous_count_ = head < WDT_TRACE_EVENTS ? head : WDT_TRACE_EVENTS;
+            for (size_t i = 0; i < previous_count_; i++)
+            {
+                previous_[i] = ram_.events[(head - previous_count_ + i) & (WDT_TRACE_EVENTS - 1)];
+            }
+            previous_recorded_ = head;
+            previous_pending_ = ram_.pending;
+            ram_.boots++;
+        }
+        else
+        {
+            ram_.magic = MAGIC;
+            ram_.boots = 1;
+        }
+        ram_.head = 0;
+        ram_.pending = 0;
+    }
+
+    std::uint32_t Trace::reset_reason() const
+    {
+        return reset_reason_;
+    }
+
+    std::uint32_t Trace::boots() const
+    {
+        return ram_.boots;
+    }
+
+    bool Trace::previous_valid() const
+    {
+        return previous_valid_;
+    }
+
+    size_t Trace::previous_count() const
+    {
+        return previous_count_;
+    }
+
+    const TraceEvent &Trace::previous(size_t i) const
+    {
+        return previous_[i < previous_count_ ? i : 0];
+    }
+
+    std::uint32_t Trace::previous_recorded() const
+    {
+        return previous_recorded_;
+    }
+
+    std::uint32_t Trace::previous_pending() const
+    {
+        return previous_pending_;
+    }
+
+    std::uint32_t Trace::recorded() const
+    {
+        return ram_.head;
+    }
+}
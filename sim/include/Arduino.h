@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/**
+ * The part of the Arduino core the firmware uses off the nRF52840 hardware paths, which is its hardware
+ * abstraction: the USB serial port, time, and GPIO interrupts. On the board it is the mbed Arduino core, in the
+ * simulator this header, with the serial port on a pseudo terminal and time from rr_sim::Clock
+ * (see sim/README.md).
+ */
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <rr_log.hpp>
+
+typedef void (*voidFuncPtr)(void);
+
+enum PinStatus
+{
+    LOW = 0,
+    HIGH = 1,
+    CHANGE,
+    FALLING,
+    RISING
+};
+
+enum PinMode
+{
+    INPUT = 0,
+    OUTPUT,
+    INPUT_PULLUP,
+    INPUT_PULLDOWN
+};
+
+/**
+ * @class SimSerial
+ * @brief the USB serial port, on the master side of a pseudo terminal that clients open as if it were the board.
+ *
+ * Bytes written are sent straight away, and kept while the terminal is full, up to TX_LEN, after which they are
+ * dropped and counted. Bytes received are read from the terminal when none are left. Without a terminal, when a
+ * log is replayed, bytes received are those injected, and bytes written go nowhere but the log.
+ */
+class SimSerial
+{
+public:
+    static constexpr size_t RX_LEN = 4096;
+    static constexpr size_t TX_LEN = 65536;
+    static constexpr size_t LOG_TX_LEN = 512;
+
+    /**
+     * @fn open
+     * @brief creates the pseudo terminal, in raw mode, and when link is not nullptr a symbolic link to it.
+     */
+    bool open(const char *link);
+
+    void close();
+
+    /**
+     * @fn port
+     * @brief the terminal clients open, such as /dev/pts/3.
+     */
+    const char *port() const;
+
+    void begin(long baud);
+    void print(const char *str);
+    void println(const char *str);
+    operator bool();
+
+    int available();
+    int read();
+    size_t write(std::uint8_t c);
+    size_t write(const std::uint8_t *buf, size_t len);
+
+    /**
+     * @fn service
+     * @brief sends the bytes kept while the terminal was full, and reads those received.
+     */
+    void service();
+
+    /**
+     * @fn wait
+     * @brief blocks until bytes are received, or timeout_us passes.
+     */
+    void wait(std::uint32_t timeout_us);
+
+    /**
+     * @fn inject
+     * @brief receives len bytes, as if they had been read from the terminal. false, receiving none, if they do not
+     * fit.
+     */
+    bool inject(const std::uint8_t *buf, size_t len);
+
+    /**
+     * @fn record
+     * @brief appends bytes received, as RT_RX, and written, as RT_TX, to log from now on, nullptr stops. Bytes
+     * written in the same microsecond go in one record, up to LOG_TX_LEN.
+     */
+    void record(rr_log::Writer *log);
+
+    /**
+     * @fn flush_log
+     * @brief appends the bytes written that are still held for the log.
+     */
+    void flush_log();
+
+    std::uint64_t rx_bytes() const;
+    std::uint64_t tx_bytes() const;
+    std::uint64_t tx_dropped() const;
+
+private:
+    int fd_ = -1;
+    int slave_fd_ = -1;
+    char port_[64] = {0};
+    char link_[256] = {0};
+
+    std::uint8_t rx_[RX_LEN];
+    size_t rx_head_ = 0;
+    size_t rx_count_ = 0;
+    std::uint8_t tx_[TX_LEN];
+    size_t tx_head_ = 0;
+    size_t tx_count_ = 0;
+
+    std::uint64_t rx_bytes_ = 0;
+    std::uint64_t tx_bytes_ = 0;
+    std::uint64_t tx_dropped_ = 0;
+    rr_log::Writer *log_ = nullptr;
+    std::uint8_t log_tx_[LOG_TX_LEN];
+    size_t log_tx_len_ = 0;
+    std::uint64_t log_tx_us_ = 0;
+
+    void receive();
+    void log_rx(const std::uint8_t *buf, size_t len);
+    void log_tx(const std::uint8_t *buf, size_t len);
+    void send();
+};
+
+extern SimSerial Serial;
+
+void pinMode(unsigned pin, PinMode mode);
+void attachInterrupt(unsigned pin, voidFuncPtr isr, PinStatus mode);
+void detachInterrupt(unsigned pin);
+
+// the firmware runs on one thread, interrupts are raised between loop() iterations.
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,39 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/**
+ * The simulator's IMU library, it only loads the sensor configuration on the board, after which the firmware
+ * talks to the BMI270 through rr_sensor_bus, so begin() is all there is. The registers are modelled by
+ * rr_sim::Bmi270.
+ */
+#ifndef SIM_ARDUINO_BMI270_BMM150_H
+#define SIM_ARDUINO_BMI270_BMM150_H
+
+class BoschSensorClass
+{
+public:
+    bool begin() { return true; }
+};
+
+extern BoschSensorClass IMU;
+
+#endif // SIM_ARDUINO_BMI270_BMM150_H
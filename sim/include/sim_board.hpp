@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef SIM_BOARD_HPP
+#define SIM_BOARD_HPP
+
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <rr_log.hpp>
+#include <rr_sim_clock.hpp>
+#include <rr_sim_imu.hpp>
+#include <rr_sim_robot.hpp>
+#include <rr_sim_sensors.hpp>
+#include <rr_sim_wdt.hpp>
+#include <rr_sim_world.hpp>
+
+/**
+ * Longest a real time simulator waits between loop() iterations with nothing received, 0 spins as the board does.
+ */
+#ifndef SIM_IDLE_US
+#define SIM_IDLE_US 500
+#endif
+
+/**
+ * Seed of the sensor noise, walls knocked out of a generated maze to give it loops, and the period of the ground
+ * truth record (us).
+ */
+#ifndef SIM_SEED
+#define SIM_SEED 1
+#endif
+
+#ifndef SIM_MAZE_LOOPS
+#define SIM_MAZE_LOOPS 12
+#endif
+
+#ifndef SIM_TRUTH_US
+#define SIM_TRUTH_US 10000
+#endif
+
+namespace rr_sim
+{
+    /**
+     * @class Board
+     * @brief the simulated Nano 33 BLE around setup() and loop(): its clock, interrupt lines, BMI270 and watchdog,
+     * on a robot in a maze.
+     *
+     * Everything that happens outside the firmware on the board happens in service(), before each loop()
+     * iteration: the robot is moved on to the present, RR_SIM_PHYSICS_US at a time, driven by the motor PWM duty
+     * cycles, and the edges its wheels turned through are counted by the encoders. A range sensor the firmware
+     * triggered gets the echo of the wall it faces, each data ready pulse that fell due loads the BMI270 with a
+     * new sample of the motion, and is raised on the IMU interrupt line. Then the serial port is serviced, and
+     * the watchdog checked.
+     *
+     * What the firmware is fed can be recorded to a log, and a log replayed in place of the robot: each record is
+     * fed to the firmware at the first service() at or after its time, so a log recorded with a stepped clock
+     * replays exactly, when replayed with the same step. The robot still stands in for any sensor the log has no
+     * records of, as for a log of the serial link alone.
+     */
+    class Board
+    {
+    public:
+        static constexpr size_t LINES = 8;
+
+    private:
+        struct Line
+        {
+            unsigned pin;
+            voidFuncPtr isr;
+        };
+
+        Line lines_[LINES];
+        size_t line_count_ = 0;
+
+        Clock clock_;
+        Bmi270 imu_;
+        Watchdog watchdog_;
+        World world_;
+        Robot robot_;
+        Sensors sensors_ = Sensors(SIM_SEED);
+        std::uint32_t triggers_ = 0;
+        std::FILE *truth_ = nullptr;
+        std::uint64_t next_truth_us_ = 0;
+        rr_log::Writer *log_ = nullptr;
+        rr_log::Reader *replay_ = nullptr;
+        std::uint32_t fed_ = 0;
+        std::uint32_t idle_us_ = SIM_IDLE_US;
+        std::uint64_t iterations_ = 0;
+
+        Board() = default;
+
+        /*
+         * moves the robot on to now_us, counting encoder edges, and recording ground truth.
+         */
+        void move(std::uint64_t now_us);
+
+        /*
+         * echo of the sensor last triggered, if there has been a trigger since the last call.
+         */
+        void ping();
+
+        /*
+         * feeds the records of the replayed log up to now_us.
+         */
+        void feed(std::uint64_t now_us);
+
+        /*
+         * true when the replayed log has records of type, which are fed in place of the robot's.
+         */
+        bool fed(std::uint8_t type) const;
+
+        /*
+         * loads the BMI270 with a data burst, and raises its data ready pulse.
+         */
+        void sample(const std::uint8_t *burst);
+
+    public:
+        Board(const Board &) = delete;
+        Board &operator=(const Board &) = delete;
+
+        static Board &get_instance();
+
+        Clock &clock();
+        Bmi270 &imu();
+        Watchdog &watchdog();
+        World &world();
+        Robot &robot();
+
+        /**
+         * @fn set_noise
+         * @brief draws sensor noise from seed from now on, noise of zero is a perfect robot.
+         */
+        void set_noise(std::uint64_t seed, const Noise &noise);
+
+        /**
+         * @fn record_truth
+         * @brief writes the ground truth to out, a CSV line every SIM_TRUTH_US, nullptr stops.
+         */
+        void record_truth(std::FILE *out);
+
+        /**
+         * @fn record_log
+         * @brief appends the IMU bursts, encoder edges and echoes fed to the firmware to log, nullptr stops. The
+         * serial port records its own bytes, SimSerial::record().
+         */
+        void record_log(rr_log::Writer *log);
+
+        /**
+         * @fn replay
+         * @brief feeds the firmware from log instead of the robot, for the sensors it has records of, nullptr goes
+         * back to the robot.
+         */
+        void replay(rr_log::Reader *log);
+
+        /**
+         * @fn attach
+         * @brief calls isr for each edge raised on pin, replacing any it had.
+         */
+        bool attach(unsigned pin, voidFuncPtr isr);
+
+        void detach(unsigned pin);
+
+        /**
+         * @fn raise
+         * @brief raises an edge on pin, false if no interrupt is attached to it.
+         */
+        bool raise(unsigned pin);
+
+        /**
+         * @fn power_on
+         * @brief connects the BMI270 to the sensor bus, before setup().
+         */
+        void power_on();
+
+        /**
+         * @fn booted
+         * @brief starts the watchdog as wdt::Wdt configured it, after setup().
+         */
+        void booted();
+
+        /**
+         * @fn service
+         * @brief raises what fell due since the last iteration, and services the serial port, before loop().
+         * @return false once the watchdog has expired.
+         */
+        bool service();
+
+        /**
+         * @fn idle
+         * @brief ends a loop() iteration, stepping the clock, or in real time waiting up to idle_us for the next
+         * byte when none is waiting.
+         */
+        void idle();
+
+        void set_idle_us(std::uint32_t idle_us);
+
+        std::uint64_t iterations() const;
+    };
+}
+
+#endif // SIM_BOARD_HPP
@@ -0,0 +1,431 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <sim_board.hpp>
+#include <rr_echo.hpp>
+#include <rr_encoder.hpp>
+#include <rr_imu.hpp>
+#include <rr_math.hpp>
+#include <rr_pwm.hpp>
+#include <rr_range.hpp>
+#include <rr_sensor_bus.hpp>
+#include <rr_walls_op.hpp>
+#include <wdt.hpp>
+
+SimSerial Serial;
+BoschSensorClass IMU;
+
+void pinMode(unsigned pin, PinMode mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void attachInterrupt(unsigned pin, voidFuncPtr isr, PinStatus mode)
+{
+    // every line of the simulator raises single edges, so the mode does not change anything.
+    (void)mode;
+    rr_sim::Board::get_instance().attach(pin, isr);
+}
+
+void detachInterrupt(unsigned pin)
+{
+    rr_sim::Board::get_instance().detach(pin);
+}
+
+unsigned long millis()
+{
+    return static_cast<unsigned long>(rr_sim::Board::get_instance().clock().now_us() / 1000);
+}
+
+unsigned long micros()
+{
+    return static_cast<unsigned long>(rr_sim::Board::get_instance().clock().now_us());
+}
+
+void delay(unsigned long ms)
+{
+    rr_sim::Board::get_instance().clock().sleep(static_cast<std::uint64_t>(ms) * 1000);
+}
+
+namespace rr_sim
+{
+    namespace
+    {
+        // PWM channel of IN1 of each driver, IN2 is the next, as RRMotorOpHandler wires them.
+        constexpr size_t IN1[2] = {0, 2};
+
+        const std::uint8_t ECHO_PINS[RR_RANGE_MAX_SENSORS] = {
+            RR_RANGE_0_ECHO_PIN,
+            RR_RANGE_1_ECHO_PIN,
+            RR_RANGE_2_ECHO_PIN,
+            RR_RANGE_3_ECHO_PIN,
+        };
+
+        /*
+         * where the range sensor on echo_pin is mounted, as RRWallOpHandler takes it to be. false for a sensor that
+         * is not used for walls, it never sees an echo.
+         */
+        bool mount_of(std::uint8_t echo_pin, RangeMount &mount)
+        {
+            for (size_t i = 0; i < RR_RANGE_SENSORS; i++)
+            {
+                if (ECHO_PINS[i] != echo_pin)
+                {
+                    continue;
+                }
+                if (i == RR_WALL_LEFT_SENSOR)
+                {
+                    mount = {rr_math::HALF_PI, RR_WALL_SIDE_OFFSET_M};
+                    return true;
+                }
+                if (i == RR_WALL_FRONT_SENSOR)
+                {
+                    mount = {0.0f, RR_WALL_FRONT_OFFSET_M};
+                    return true;
+                }
+                if (i == RR_WALL_RIGHT_SENSOR)
+                {
+                    mount = {-rr_math::HALF_PI, RR_WALL_SIDE_OFFSET_M};
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    Board &Board::get_instance()
+    {
+        static Board instance;
+        return instance;
+    }
+
+    Clock &Board::clock()
+    {
+        return clock_;
+    }
+
+    Bmi270 &Board::imu()
+    {
+        return imu_;
+    }
+
+    Watchdog &Board::watchdog()
+    {
+        return watchdog_;
+    }
+
+    World &Board::world()
+    {
+        return world_;
+    }
+
+    Robot &Board::robot()
+    {
+        return robot_;
+    }
+
+    void Board::set_noise(std::uint64_t seed, const Noise &noise)
+    {
+        sensors_ = Sensors(seed, noise);
+    }
+
+    void Board::record_truth(std::FILE *out)
+    {
+        truth_ = out;
+        std::uint64_t now_us = robot_.truth().time_us;
+        next_truth_us_ = now_us - now_us % SIM_TRUTH_US + SIM_TRUTH_US;
+        if (truth_ != nullptr)
+        {
+            std::fprintf(truth_, "time_us,x,y,heading,v,omega,left_m,right_m,collisions\n");
+        }
+    }
+
+    void Board::move(std::uint64_t now_us)
+    {
+        rr_motor::Pwm &pwm = rr_motor::Pwm::get_instance();
+        rr_encoder::Encoders &encoders = rr_encoder::Encoders::get_instance();
+        std::uint32_t edges[2] = {0, 0};
+        while (robot_.truth().time_us + RR_SIM_PHYSICS_US <= now_us)
+        {
+            float drive[2] = {0.0f, 0.0f};
+            if (pwm.top() > 0)
+            {
+                for (size_t w = LEFT; w <= RIGHT; w++)
+                {
+                    drive[w] = (static_cast<float>(pwm.duty(IN1[w])) - static_cast<float>(pwm.duty(IN1[w] + 1))) /
+                               static_cast<float>(pwm.top());
+                }
+            }
+            robot_.step(drive, RR_SIM_PHYSICS_US, world_);
+
+            const Truth &truth = robot_.truth();
+            std::uint32_t left = sensors_.edges(truth, LEFT);
+            std::uint32_t right = sensors_.edges(truth, RIGHT);
+            encoders.mock_edges(rr_encoder::LEFT, left);
+            encoders.mock_edges(rr_encoder::RIGHT, right);
+            edges[LEFT] += left;
+            edges[RIGHT] += right;
+
+            if (truth_ != nullptr && truth.time_us >= next_truth_us_)
+            {
+                std::fprintf(truth_, "%llu,%.5f,%.5f,%.5f,%.4f,%.4f,%.5f,%.5f,%u\n",
+                             static_cast<unsigned long long>(truth.time_us), truth.x, truth.y, truth.heading, truth.v,
+                             truth.omega, truth.odometer_m[LEFT], truth.odometer_m[RIGHT],
+                             static_cast<unsigned>(robot_.collisions()));
+                next_truth_us_ = truth.time_us - truth.time_us % SIM_TRUTH_US + SIM_TRUTH_US;
+            }
+        }
+
+        if (log_ != nullptr && (edges[LEFT] > 0 || edges[RIGHT] > 0))
+        {
+            std::uint8_t payload[8];
+            rr_log::put_u32(payload, edges[LEFT]);
+            rr_log::put_u32(payload + 4, edges[RIGHT]);
+            log_->append(rr_log::RT_EDGES, 0, now_us, payload, sizeof(payload));
+        }
+    }
+
+    void Board::ping()
+    {
+        rr_range::EchoCapture &capture = rr_range::EchoCapture::get_instance();
+        if (capture.mock_triggers() == triggers_)
+        {
+            return;
+        }
+        triggers_ = capture.mock_triggers();
+
+        std::uint8_t pin = capture.mock_triggered();
+        RangeMount mount;
+        float distance;
+        std::uint32_t rise = 0;
+        std::uint32_t fall = 0;
+        if (mount_of(pin, mount) && sensors_.range(world_, robot_.truth(), mount, RR_RANGE_MAX_M, distance))
+        {
+            Sensors::echo(distance, RR_RANGE_SPEED_OF_SOUND, rise, fall);
+        }
+        capture.mock_echo(pin, rise, fall);
+
+        if (log_ != nullptr)
+        {
+            std::uint8_t payload[8];
+            rr_log::put_u32(payload, rise);
+            rr_log::put_u32(payload + 4, fall);
+            log_->append(rr_log::RT_ECHO, pin, clock_.now_us(), payload, sizeof(payload));
+        }
+    }
+
+    void Board::sample(const std::uint8_t *burst)
+    {
+        if (burst != nullptr)
+        {
+            imu_.set_data(burst);
+        }
+        if (log_ != nullptr)
+        {
+            std::uint8_t data[Bmi270::DATA_LEN];
+            imu_.data(data);
+            log_->append(rr_log::RT_IMU, 0, clock_.now_us(), data, sizeof(data));
+        }
+        raise(RR_IMU_INT_PIN);
+    }
+
+    void Board::feed(std::uint64_t now_us)
+    {
+        rr_log::Record record;
+        while (replay_->peek(record) && record.time_us <= now_us)
+        {
+            replay_->next(record);
+            switch (record.type)
+            {
+            case rr_log::RT_RX:
+                Serial.inject(record.payload, record.length);
+                break;
+            case rr_log::RT_IMU:
+                if (record.length == Bmi270::DATA_LEN)
+                {
+                    sample(record.payload);
+                }
+                break;
+            case rr_log::RT_EDGES:
+                if (record.length == 8)
+                {
+                    rr_encoder::Encoders &encoders = rr_encoder::Encoders::get_instance();
+                    encoders.mock_edges(rr_encoder::LEFT, rr_log::get_u32(record.payload));
+                    encoders.mock_edges(rr_encoder::RIGHT, rr_log::get_u32(record.payload + 4));
+                    if (log_ != nullptr)
+                    {
+                        log_->append(rr_log::RT_EDGES, 0, now_us, record.payload, record.length);
+                    }
+                }
+                break;
+            case rr_log::RT_ECHO:
+                if (record.length == 8)
+                {
+                    rr_range::EchoCapture::get_instance().mock_echo(record.channel, rr_log::get_u32(record.payload),
+                                                                    rr_log::get_u32(record.payload + 4));
+                    if (log_ != nullptr)
+                    {
+                        log_->append(rr_log::RT_ECHO, record.channel, now_us, record.payload, record.length);
+                    }
+                }
+                break;
+            default:
+                // the firmware's own output, and notes, are there to compare with, not to feed.
+                break;
+            }
+        }
+    }
+
+    void Board::record_log(rr_log::Writer *log)
+    {
+        log_ = log;
+    }
+
+    void Board::replay(rr_log::Reader *log)
+    {
+        replay_ = log;
+        fed_ = 0;
+        if (replay_ != nullptr)
+        {
+            rr_log::Record record;
+            while (replay_->next(record))
+            {
+                fed_ |= 1u << record.type;
+            }
+            replay_->rewind();
+        }
+    }
+
+    bool Board::fed(std::uint8_t type) const
+    {
+        return (fed_ & (1u << type)) != 0;
+    }
+
+    bool Board::attach(unsigned pin, voidFuncPtr isr)
+    {
+        for (size_t i = 0; i < line_count_; i++)
+        {
+            if (lines_[i].pin == pin)
+            {
+                lines_[i].isr = isr;
+                return true;
+            }
+        }
+        if (line_count_ == LINES)
+        {
+            return false;
+        }
+        lines_[line_count_].pin = pin;
+        lines_[line_count_].isr = isr;
+        line_count_++;
+        return true;
+    }
+
+    void Board::detach(unsigned pin)
+    {
+        for (size_t i = 0; i < line_count_; i++)
+        {
+            if (lines_[i].pin == pin)
+            {
+                lines_[i] = lines_[--line_count_];
+                return;
+            }
+        }
+    }
+
+    bool Board::raise(unsigned pin)
+    {
+        for (size_t i = 0; i < line_count_; i++)
+        {
+            if (lines_[i].pin == pin && lines_[i].isr != nullptr)
+            {
+                lines_[i].isr();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Board::power_on()
+    {
+        rr_sensor_bus::SensorBus::get_instance().attach_mock(&imu_);
+    }
+
+    void Board::booted()
+    {
+        wdt::Wdt &wdt = wdt::Wdt::get_instance();
+        watchdog_.start(wdt.timeout_ms(), wdt.supervisor().rounds(), clock_.now_us());
+    }
+
+    bool Board::service()
+    {
+        std::uint64_t now_us = clock_.now_us();
+        // what the firmware wrote last iteration goes in the log before anything fed to it now.
+        Serial.flush_log();
+        if (replay_ != nullptr)
+        {
+            feed(now_us);
+        }
+        if (!fed(rr_log::RT_EDGES))
+        {
+            move(now_us);
+        }
+        if (!fed(rr_log::RT_ECHO))
+        {
+            ping();
+        }
+        if (!fed(rr_log::RT_IMU))
+        {
+            for (std::uint32_t pulses = imu_.data_ready(now_us); pulses > 0; pulses--)
+            {
+                float gyro_dps[3];
+                float accel_g[3];
+                sensors_.imu(robot_.truth(), gyro_dps, accel_g);
+                imu_.set_motion(gyro_dps, accel_g);
+                sample(nullptr);
+            }
+        }
+        Serial.service();
+        return watchdog_.check(wdt::Wdt::get_instance().supervisor().rounds(), now_us);
+    }
+
+    void Board::idle()
+    {
+        iterations_++;
+        clock_.step();
+        if (clock_.mode() == Clock::REALTIME && idle_us_ > 0 && Serial.available() == 0)
+        {
+            Serial.wait(idle_us_);
+        }
+    }
+
+    void Board::set_idle_us(std::uint32_t idle_us)
+    {
+        idle_us_ = idle_us;
+    }
+
+    std::uint64_t Board::iterations() const
+    {
+        return iterations_;
+    }
+}
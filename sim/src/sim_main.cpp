@@ -0,0 +1,329 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/**
+ * Runs the firmware, setup() then loop(), as a Linux process, with its serial port on a pseudo terminal, see
+ * sim/README.md.
+ *
+ *   mousebot_sim [--link PATH] [--step-us US] [--seconds S] [--idle-us US]
+ *                [--maze FILE | --maze-seed N] [--seed N] [--perfect] [--truth PATH]
+ *                [--record PATH] [--replay PATH]
+ *
+ * Exits 0 once --seconds of simulated time have passed, a replayed log has run out, or on SIGINT or SIGTERM, 1 if
+ * the terminal, or a file, could not be opened, and 3 when the watchdog resets the board.
+ */
+#include <sim_board.hpp>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <rr_log_file.hpp>
+#include <wdt.hpp>
+
+#ifndef SIM_REPLAY_STEP_US
+#define SIM_REPLAY_STEP_US 100
+#endif
+
+// a replay runs on past its last record, for the firmware to answer what is still queued.
+#ifndef SIM_REPLAY_TAIL_US
+#define SIM_REPLAY_TAIL_US 1000000
+#endif
+
+void setup();
+void loop();
+
+namespace
+{
+    constexpr int EXIT_WATCHDOG = 3;
+
+    volatile std::sig_atomic_t stopping = 0;
+
+    void stop(int signum)
+    {
+        (void)signum;
+        stopping = 1;
+    }
+
+    // largest maze file, a 16 x 16 maze drawn with +---+ is 33 lines of 66 characters.
+    constexpr size_t MAZE_FILE_MAX = 4096;
+
+    void usage(const char *prog)
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--link PATH] [--step-us US] [--seconds S] [--idle-us US]\n"
+                     "       [--maze FILE | --maze-seed N] [--seed N] [--perfect] [--truth PATH]\n"
+                     "       [--record PATH] [--replay PATH]\n"
+                     "  --link PATH     symbolic link to the serial port, such as /tmp/mousebot\n"
+                     "  --step-us US    stepped clock, US per loop() iteration, instead of real time\n"
+                     "  --seconds S     stop after S seconds of simulated time\n"
+                     "  --idle-us US    real time wait between idle iterations, 0 spins (default %u)\n"
+                     "  --maze FILE     maze drawn in text, +---+ walls, instead of an open maze\n"
+                     "  --maze-seed N   maze generated from N instead\n"
+                     "  --seed N        seed of the sensor noise (default %u)\n"
+                     "  --perfect       sensors without noise or bias\n"
+                     "  --truth PATH    write the robot's ground truth to PATH as CSV\n"
+                     "  --record PATH   log what the firmware is fed, and writes, to PATH\n"
+                     "  --replay PATH   feed the firmware from the log at PATH instead of the robot, and stop at\n"
+                     "                  a second past its end, on the log's stepped clock (default %u us)\n",
+                     prog, static_cast<unsigned>(SIM_IDLE_US), static_cast<unsigned>(SIM_SEED),
+                     static_cast<unsigned>(SIM_REPLAY_STEP_US));
+    }
+
+    bool load_maze(rr_sim::World &world, const char *path)
+    {
+        std::FILE *f = std::fopen(path, "r");
+        if (f == nullptr)
+        {
+            return false;
+        }
+        static char text[MAZE_FILE_MAX + 1];
+        size_t length = std::fread(text, 1, MAZE_FILE_MAX, f);
+        std::fclose(f);
+        text[length] = '\0';
+        return world.load(text);
+    }
+
+    std::uint64_t last_record_us(rr_log::Reader &reader)
+    {
+        std::uint64_t last_us = 0;
+        rr_log::Record record;
+        while (reader.next(record))
+        {
+            last_us = record.time_us;
+        }
+        reader.rewind();
+        return last_us;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *link = nullptr;
+    unsigned long step_us = 0;
+    double seconds = 0.0;
+    const char *maze = nullptr;
+    long maze_seed = -1;
+    unsigned long seed = SIM_SEED;
+    bool perfect = false;
+    const char *truth = nullptr;
+    const char *record = nullptr;
+    const char *replay = nullptr;
+    rr_sim::Board &board = rr_sim::Board::get_instance();
+
+    static const struct option options[] = {
+        {"link", required_argument, nullptr, 'l'},
+        {"step-us", required_argument, nullptr, 's'},
+        {"seconds", required_argument, nullptr, 't'},
+        {"idle-us", required_argument, nullptr, 'i'},
+        {"maze", required_argument, nullptr, 'm'},
+        {"maze-seed", required_argument, nullptr, 'g'},
+        {"seed", required_argument, nullptr, 'r'},
+        {"perfect", no_argument, nullptr, 'p'},
+        {"truth", required_argument, nullptr, 'o'},
+        {"record", required_argument, nullptr, 'w'},
+        {"replay", required_argument, nullptr, 'y'},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "l:s:t:i:m:g:r:po:w:y:h", options, nullptr)) != -1)
+    {
+        switch (opt)
+        {
+        case 'l':
+            link = optarg;
+            break;
+        case 's':
+            step_us = std::strtoul(optarg, nullptr, 10);
+            break;
+        case 't':
+            seconds = std::strtod(optarg, nullptr);
+            break;
+        case 'i':
+            board.set_idle_us(static_cast<std::uint32_t>(std::strtoul(optarg, nullptr, 10)));
+            break;
+        case 'm':
+            maze = optarg;
+            break;
+        case 'g':
+            maze_seed = std::strtol(optarg, nullptr, 10);
+            break;
+        case 'r':
+            seed = std::strtoul(optarg, nullptr, 10);
+            break;
+        case 'p':
+            perfect = true;
+            break;
+        case 'o':
+            truth = optarg;
+            break;
+        case 'w':
+            record = optarg;
+            break;
+        case 'y':
+            replay = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    // a replay runs on the clock it was recorded on, unless told otherwise, and as fast as it can.
+    static rr_log::MappedFile replay_file;
+    static rr_log::Reader reader(nullptr, 0);
+    std::uint64_t replay_end_us = 0;
+    if (replay != nullptr)
+    {
+        if (!replay_file.open(replay))
+        {
+            std::perror("mousebot_sim: replay");
+            return 1;
+        }
+        reader = rr_log::Reader(replay_file.data(), replay_file.size());
+        if (!reader.valid())
+        {
+            std::fprintf(stderr, "mousebot_sim: %s is not a log\n", replay);
+            return 1;
+        }
+        if (step_us == 0)
+        {
+            step_us = reader.step_us() > 0 ? reader.step_us() : SIM_REPLAY_STEP_US;
+        }
+        replay_end_us = last_record_us(reader) + SIM_REPLAY_TAIL_US;
+        board.set_idle_us(0);
+        board.replay(&reader);
+    }
+    if (step_us > 0)
+    {
+        board.clock().start_stepped(static_cast<std::uint32_t>(step_us));
+    }
+    if (maze != nullptr && !load_maze(board.world(), maze))
+    {
+        std::fprintf(stderr, "mousebot_sim: %s is not a maze\n", maze);
+        return 1;
+    }
+    if (maze == nullptr && maze_seed >= 0)
+    {
+        board.world().generate(static_cast<std::uint32_t>(maze_seed), SIM_MAZE_LOOPS);
+    }
+    const rr_sim::Noise noise = {RR_SIM_GYRO_NOISE_DPS, RR_SIM_GYRO_BIAS_DPS, RR_SIM_ACCEL_NOISE_G,
+                                 RR_SIM_RANGE_NOISE_M};
+    const rr_sim::Noise none = {0.0f, 0.0f, 0.0f, 0.0f};
+    board.set_noise(seed, perfect ? none : noise);
+    std::FILE *truth_file = nullptr;
+    if (truth != nullptr)
+    {
+        truth_file = std::fopen(truth, "w");
+        if (truth_file == nullptr)
+        {
+            std::perror("mousebot_sim: truth");
+            return 1;
+        }
+        board.record_truth(truth_file);
+    }
+    static rr_log::FileSink record_file;
+    static rr_log::Writer writer(record_file);
+    if (record != nullptr)
+    {
+        if (!record_file.open(record) || !writer.begin(static_cast<std::uint32_t>(step_us)))
+        {
+            std::perror("mousebot_sim: record");
+            return 1;
+        }
+        Serial.record(&writer);
+        board.record_log(&writer);
+    }
+    // a replay needs no terminal, its input comes from the log, but can still be watched on one.
+    if ((replay == nullptr || link != nullptr) && !Serial.open(link))
+    {
+        std::perror("mousebot_sim: pseudo terminal");
+        return 1;
+    }
+    std::signal(SIGINT, stop);
+    std::signal(SIGTERM, stop);
+    if (replay != nullptr)
+    {
+        std::fprintf(stderr, "mousebot_sim: replaying %s, %lu us steps\n", replay, step_us);
+    }
+    else
+    {
+        std::fprintf(stderr, "mousebot_sim: serial port %s%s%s, %s clock\n", Serial.port(), link ? " at " : "",
+                     link ? link : "", step_us > 0 ? "stepped" : "real time");
+    }
+
+    board.power_on();
+    setup();
+    board.booted();
+
+    int status = 0;
+    std::uint64_t end_us = static_cast<std::uint64_t>(seconds * 1e6);
+    if (replay_end_us > 0 && (end_us == 0 || replay_end_us < end_us))
+    {
+        end_us = replay_end_us;
+    }
+    while (!stopping && (end_us == 0 || board.clock().now_us() < end_us))
+    {
+        if (!board.service())
+        {
+            wdt::Wdt &wdt = wdt::Wdt::get_instance();
+            std::fprintf(stderr, "mousebot_sim: watchdog reset at %lu ms, tasks 0x%x had not checked in for %lu ms\n",
+                         millis(), wdt.supervisor().pending(),
+                         static_cast<unsigned long>(board.watchdog().since_reload_us(board.clock().now_us()) / 1000));
+            status = EXIT_WATCHDOG;
+            break;
+        }
+        loop();
+        board.idle();
+    }
+
+    std::fprintf(stderr, "mousebot_sim: %llu iterations in %.3f s, rx %llu bytes, tx %llu bytes, %llu dropped\n",
+                 static_cast<unsigned long long>(board.iterations()), board.clock().now_us() / 1e6,
+                 static_cast<unsigned long long>(Serial.rx_bytes()), static_cast<unsigned long long>(Serial.tx_bytes()),
+                 static_cast<unsigned long long>(Serial.tx_dropped()));
+    const rr_sim::Truth &t = board.robot().truth();
+    std::fprintf(stderr, "mousebot_sim: robot at %.3f, %.3f m, heading %.3f rad, %.3f / %.3f m turned, %u collisions\n",
+                 t.x, t.y, t.heading, t.odometer_m[rr_sim::LEFT], t.odometer_m[rr_sim::RIGHT],
+                 static_cast<unsigned>(board.robot().collisions()));
+    if (truth_file != nullptr)
+    {
+        board.record_truth(nullptr);
+        std::fclose(truth_file);
+    }
+    if (record != nullptr)
+    {
+        Serial.record(nullptr);
+        board.record_log(nullptr);
+        record_file.close();
+        std::fprintf(stderr, "mousebot_sim: %llu records, %llu bytes logged to %s, %llu lost\n",
+                     static_cast<unsigned long long>(writer.records()), static_cast<unsigned long long>(writer.bytes()),
+                     record, static_cast<unsigned long long>(writer.failed()));
+    }
+    if (replay != nullptr)
+    {
+        board.replay(nullptr);
+        replay_file.close();
+    }
+    Serial.close();
+    return status;
+}
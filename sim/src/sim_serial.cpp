@@ -0,0 +1,303 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <Arduino.h>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+bool SimSerial::open(const char *link)
+{
+    fd_ = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd_ < 0 || grantpt(fd_) != 0 || unlockpt(fd_) != 0 || ptsname_r(fd_, port_, sizeof(port_)) != 0)
+    {
+        close();
+        return false;
+    }
+
+    // the simulator keeps the terminal open itself, so that clients can come and go without the master seeing a
+    // hang up, and so that it stays raw in between.
+    slave_fd_ = ::open(port_, O_RDWR | O_NOCTTY);
+    struct termios tio;
+    if (slave_fd_ < 0 || tcgetattr(slave_fd_, &tio) != 0)
+    {
+        close();
+        return false;
+    }
+    cfmakeraw(&tio);
+    if (tcsetattr(slave_fd_, TCSANOW, &tio) != 0 || fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) | O_NONBLOCK) != 0)
+    {
+        close();
+        return false;
+    }
+
+    if (link != nullptr)
+    {
+        unlink(link);
+        if (symlink(port_, link) != 0)
+        {
+            close();
+            return false;
+        }
+        std::strncpy(link_, link, sizeof(link_) - 1);
+    }
+    return true;
+}
+
+void SimSerial::close()
+{
+    if (link_[0] != '\0')
+    {
+        unlink(link_);
+        link_[0] = '\0';
+    }
+    if (slave_fd_ >= 0)
+    {
+        ::close(slave_fd_);
+        slave_fd_ = -1;
+    }
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+const char *SimSerial::port() const
+{
+    return port_;
+}
+
+void SimSerial::begin(long baud)
+{
+    // USB CDC, the baud rate a client asks for makes no difference.
+    (void)baud;
+}
+
+void SimSerial::print(const char *str)
+{
+    write(reinterpret_cast<const std::uint8_t *>(str), std::strlen(str));
+}
+
+void SimSerial::println(const char *str)
+{
+    print(str);
+    print("\r\n");
+}
+
+SimSerial::operator bool()
+{
+    return fd_ >= 0;
+}
+
+int SimSerial::available()
+{
+    if (rx_count_ == 0)
+    {
+        receive();
+    }
+    return static_cast<int>(rx_count_);
+}
+
+int SimSerial::read()
+{
+    if (rx_count_ == 0)
+    {
+        return -1;
+    }
+    std::uint8_t c = rx_[rx_head_];
+    rx_head_ = (rx_head_ + 1) % RX_LEN;
+    rx_count_--;
+    return c;
+}
+
+size_t SimSerial::write(std::uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t SimSerial::write(const std::uint8_t *buf, size_t len)
+{
+    log_tx(buf, len);
+    if (fd_ < 0)
+    {
+        tx_bytes_ += len;
+        return len;
+    }
+
+    size_t sent = 0;
+    if (tx_count_ == 0)
+    {
+        ssize_t n = ::write(fd_, buf, len);
+        sent = n > 0 ? static_cast<size_t>(n) : 0;
+    }
+
+    // the rest waits for the client to read, in order.
+    for (size_t i = sent; i < len; i++)
+    {
+        if (tx_count_ == TX_LEN)
+        {
+            tx_dropped_ += len - i;
+            len = i;
+            break;
+        }
+        tx_[(tx_head_ + tx_count_) % TX_LEN] = buf[i];
+        tx_count_++;
+    }
+    tx_bytes_ += len;
+    return len;
+}
+
+void SimSerial::service()
+{
+    send();
+    receive();
+}
+
+void SimSerial::wait(std::uint32_t timeout_us)
+{
+    struct timespec timeout;
+    timeout.tv_sec = timeout_us / 1000000;
+    timeout.tv_nsec = static_cast<long>(timeout_us % 1000000) * 1000;
+    if (fd_ < 0)
+    {
+        nanosleep(&timeout, nullptr);
+        return;
+    }
+    struct pollfd pfd;
+    pfd.fd = fd_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    ppoll(&pfd, 1, &timeout, nullptr);
+}
+
+bool SimSerial::inject(const std::uint8_t *buf, size_t len)
+{
+    if (len > RX_LEN - rx_count_)
+    {
+        return false;
+    }
+    log_rx(buf, len);
+    for (size_t i = 0; i < len; i++)
+    {
+        rx_[(rx_head_ + rx_count_) % RX_LEN] = buf[i];
+        rx_count_++;
+    }
+    rx_bytes_ += len;
+    return true;
+}
+
+void SimSerial::record(rr_log::Writer *log)
+{
+    flush_log();
+    log_ = log;
+}
+
+void SimSerial::log_rx(const std::uint8_t *buf, size_t len)
+{
+    if (log_ != nullptr)
+    {
+        flush_log();
+        log_->append(rr_log::RT_RX, 0, micros(), buf, len);
+    }
+}
+
+void SimSerial::log_tx(const std::uint8_t *buf, size_t len)
+{
+    if (log_ == nullptr)
+    {
+        return;
+    }
+    std::uint64_t now_us = micros();
+    if (log_tx_len_ > 0 && (now_us != log_tx_us_ || len > LOG_TX_LEN - log_tx_len_))
+    {
+        flush_log();
+    }
+    if (len > LOG_TX_LEN)
+    {
+        log_->append(rr_log::RT_TX, 0, now_us, buf, len);
+        return;
+    }
+    std::memcpy(&log_tx_[log_tx_len_], buf, len);
+    log_tx_len_ += len;
+    log_tx_us_ = now_us;
+}
+
+void SimSerial::flush_log()
+{
+    if (log_ != nullptr && log_tx_len_ > 0)
+    {
+        log_->append(rr_log::RT_TX, 0, log_tx_us_, log_tx_, log_tx_len_);
+    }
+    log_tx_len_ = 0;
+}
+
+void SimSerial::receive()
+{
+    while (fd_ >= 0 && rx_count_ < RX_LEN)
+    {
+        size_t tail = (rx_head_ + rx_count_) % RX_LEN;
+        size_t room = tail >= rx_head_ ? RX_LEN - tail : rx_head_ - tail;
+        ssize_t n = ::read(fd_, &rx_[tail], room);
+        if (n <= 0)
+        {
+            return;
+        }
+        log_rx(&rx_[tail], static_cast<size_t>(n));
+        rx_count_ += static_cast<size_t>(n);
+        rx_bytes_ += static_cast<std::uint64_t>(n);
+    }
+}
+
+void SimSerial::send()
+{
+    while (fd_ >= 0 && tx_count_ > 0)
+    {
+        size_t chunk = tx_head_ + tx_count_ > TX_LEN ? TX_LEN - tx_head_ : tx_count_;
+        ssize_t n = ::write(fd_, &tx_[tx_head_], chunk);
+        if (n <= 0)
+        {
+            return;
+        }
+        tx_head_ = (tx_head_ + static_cast<size_t>(n)) % TX_LEN;
+        tx_count_ -= static_cast<size_t>(n);
+    }
+}
+
+std::uint64_t SimSerial::rx_bytes() const
+{
+    return rx_bytes_;
+}
+
+std::uint64_t SimSerial::tx_bytes() const
+{
+    return tx_bytes_;
+}
+
+std::uint64_t SimSerial::tx_dropped() const
+{
+    return tx_dropped_;
+}
@@ -23,15 +23,40 @@
  * | ID      | CONSTANT        |  SENSOR   | DESCRIPTION              |
  * | ------  | --------------  | --------- | ------------------------ |
  * | 200     | MSP_SET_RAW_RC. | Motors.   | Sets motors              |
+ * | 202     | MSP_SET_PID     | Motors    | Sets wheel speed gains   |
+ * | 250     | MSP_SET_WHEEL_SPEED | Motors | Sets wheel speeds (m/s) |
+ * | 251     | MSP_SET_MOTION  | Motors    | Queues a motion segment  |
+ * | 252     | MSP_SET_MAZE    | Maze      | Sets maze goal, or reset |
  *
  *
  * ### Monitor Commands
  *
  * | ID.     | CONSTANT        |  SENSOR   | DESCRIPTION              |
  * | ------  | --------------  | --------- | ------------------------ |
+ * | 101     | MSP_STATUS      | Loop      | Loop timing, watchdog    |
  * | 102     | MSP_RAW_IMU.    | IMU       | Monitor IMU details      |
  * | 104     | MSP_MOTOR       | MOTORS    | Set, or monitor motors.  |
  * | 105     | MSP_RAW_SENSORS | Range     | Range sensors            |
+ * | 112     | MSP_PID         | Motors    | Wheel speed controller   |
+ * | 150     | MSP_POSE        | IMU, ENC  | Pose estimate            |
+ * | 151     | MSP_MOTION      | Motors    | Motion queue progress    |
+ * | 152     | MSP_WALLS       | Range     | Maze cell walls          |
+ * | 153     | MSP_MAZE_MOVE   | Maze      | Next move to the goal    |
+ * | 154     | MSP_MAZE_DIST   | Maze      | Flood fill distances     |
+ * | 155     | MSP_MAZE_MAP    | Maze      | Maze map changes         |
+ * | 156     | MSP_MAZE_PLAN   | Maze      | Speed run plan           |
+ * | 157     | MSP_TRACE       | Loop      | Previous boot's trace    |
+ * | 158     | MSP_METRICS     | Serial    | Request counts, latency  |
+ * | 159     | MSP_PROFILE     | Loop      | Profiling zone timings   |
+ * | 160     | MSP_MEMORY      | Memory    | Stack high water, sizes  |
+ *
+ * Mousebot specific fields (proto/rr_mousebot.proto) are encoded in the same frame, directly after the
+ * rr_serial message. A request carrying ExtRequest.subscribe is answered, and then published every period.
+ * MSP_MOTION is also published, unrequested, whenever a queued motion segment completes, and MSP_WALLS whenever
+ * the robot leaves a maze cell.
+ *
+ * Frames end at TERM_CHAR, and are byte stuffed both ways: TERM_CHAR and ESC_CHAR inside a frame are sent as
+ * ESC_CHAR, then the byte xor ESC_XOR.
  */
 
 #include "rr_ble_mousebot.h"
@@ -76,8 +101,125 @@ size_t read_serial()
   return r;
 }
 
+/**
+ * writes n bytes of buf as one frame, byte stuffed and followed by TERM_CHAR, and returns the bytes sent.
+ */
+size_t write_frame(const std::uint8_t *buf, size_t n)
+{
+  size_t sent = 0;
+  while (n > 0)
+  {
+    // bytes that need no escape go out in runs.
+    size_t run = 0;
+    while (run < n && !rr_buffer::escaped(buf[run]))
+    {
+      run++;
+    }
+    if (run > 0)
+    {
+      Serial.write(buf, run);
+      sent += run;
+      buf += run;
+      n -= run;
+    }
+    if (n > 0)
+    {
+      Serial.write(static_cast<std::uint8_t>(ESC_CHAR));
+      Serial.write(static_cast<std::uint8_t>(*buf ^ ESC_XOR));
+      sent += 2;
+      buf++;
+      n--;
+    }
+  }
+  Serial.write(static_cast<std::uint8_t>(TERM_CHAR));
+  return sent + 1;
+}
+
+/**
+ * writes a bad request frame with etype, and counts it against op when that is known.
+ */
+void write_bad_request(org_ryderrobots_ros2_serial_ErrorType etype, std::int32_t op = 0)
+{
+  auto &buf = rr_buffer::RRBuffer::get_instance();
+  rr_metrics::Metrics::get_instance().error(etype, op);
+  mberror::RRBadRequest rr_bad_request(pb_ostream_from_buffer(buf.obuf_ptr(), BUFSIZ));
+  size_t result = rr_bad_request.serialize(etype);
+  if (result > 0)
+  {
+    size_t sent;
+    {
+      RR_ZONE(rr_zone::ZONE_WRITE);
+      sent = write_frame(buf.obuf_ptr(), result);
+    }
+    rr_metrics::Metrics::get_instance().sent(sent);
+  }
+}
+
+/**
+ * performs req on handler, and writes the response frame. The extension response is encoded directly
+ * after the response.
+ */
+void respond(mb_operations::MbOperationHandler *handler, const org_ryderrobots_ros2_serial_Request &req,
+             const org_ryderrobots_mousebot_ExtRequest &ereq)
+{
+  auto &buf = rr_buffer::RRBuffer::get_instance();
+  auto &metrics = rr_metrics::Metrics::get_instance();
+  auto ostream = pb_ostream_from_buffer(buf.obuf_ptr(), BUFSIZ);
+
+  org_ryderrobots_ros2_serial_Response res = org_ryderrobots_ros2_serial_Response_init_zero;
+  org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+  unsigned long start_us = micros();
+  {
+    RR_ZONE(rr_zone::ZONE_HANDLER);
+    handler->perform_op(req, res);
+    if (res.which_data != org_ryderrobots_ros2_serial_Response_bad_request_tag)
+    {
+      if (handler->accept_ext(ereq))
+      {
+        handler->perform_ext(ereq, eres);
+      }
+      else
+      {
+        org_ryderrobots_ros2_serial_BadRequest bad_request = org_ryderrobots_ros2_serial_BadRequest_init_zero;
+        bad_request.etype = org_ryderrobots_ros2_serial_ErrorType_ET_INVALID_REQUEST;
+        res.data.bad_request = bad_request;
+        res.which_data = org_ryderrobots_ros2_serial_Response_bad_request_tag;
+      }
+    }
+  }
+  if (res.which_data == org_ryderrobots_ros2_serial_Response_bad_request_tag)
+  {
+    metrics.error(res.data.bad_request.etype, req.op);
+  }
+  unsigned long handled_us = micros();
+  metrics.record(req.op, rr_metrics::ST_HANDLER, handled_us - start_us);
+
+  bool encoded;
+  {
+    RR_ZONE(rr_zone::ZONE_ENCODE);
+    encoded = pb_encode(&ostream, org_ryderrobots_ros2_serial_Response_fields, &res) &&
+              pb_encode(&ostream, org_ryderrobots_mousebot_ExtResponse_fields, &eres);
+  }
+  metrics.record(req.op, rr_metrics::ST_ENCODE, micros() - handled_us);
+  if (!encoded)
+  {
+    // operation can not be serialized.
+    write_bad_request(org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN, req.op);
+    return;
+  }
+  size_t sent;
+  {
+    RR_ZONE(rr_zone::ZONE_WRITE);
+    sent = write_frame(buf.obuf_ptr(), ostream.bytes_written);
+  }
+  metrics.sent(sent);
+}
+
 void setup()
 {
+  // before anything else runs on it, so that the deepest the stack ever goes shows in MSP_MEMORY.
+  rr_memory::Stack::get_instance().paint();
+
   // reserve memory early to stop potential issues later
   rr_buffer::RRBuffer &buf = rr_buffer::RRBuffer::get_instance();
   (void)buf;
@@ -91,11 +233,26 @@ void setup()
   wdt::Wdt::get_instance().init();
 }
 
-// Called from within a loop, it will block while data is not available.
-// but does not consider processing time.
-void loop()
+/**
+ * publishes at most one subscribed stream, then reads, and answers, at most one request.
+ */
+void service_serial(wdt::Wdt &watchdog)
 {
-  wdt::Wdt::get_instance().reset();
+  RR_ZONE(rr_zone::ZONE_SERIAL);
+  auto &buf = rr_buffer::RRBuffer::get_instance();
+  auto &metrics = rr_metrics::Metrics::get_instance();
+
+  // at most one subscribed stream is published per iteration.
+  org_ryderrobots_ros2_serial_Request pub_req;
+  mb_operations::MbOperationHandler *publisher = fact.next_publication(pub_req);
+  if (publisher != nullptr)
+  {
+    org_ryderrobots_mousebot_ExtRequest no_ext = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    watchdog.note_publication(pub_req.op);
+    metrics.count(pub_req.op, true);
+    respond(publisher, pub_req, no_ext);
+    buf.clear();
+  }
 
   static unsigned long last_serial = 0;
   if (millis() - last_serial < 5)
@@ -106,87 +263,111 @@ void loop()
   {
     return;
   }
-  // read input
-  auto &buf = rr_buffer::RRBuffer::get_instance();
-  auto ostream = pb_ostream_from_buffer(buf.obuf_ptr(), BUFSIZ);
 
-  size_t bytes_read = read_serial();
+  // read input
+  size_t bytes_read;
+  {
+    RR_ZONE(rr_zone::ZONE_READ);
+    bytes_read = read_serial();
+  }
   if (bytes_read == 0)
   {
     buf.clear();
     return;
   }
+  // the byte that ended the read, TERM_CHAR, is not counted in bytes_read.
+  metrics.received(bytes_read < BUFSIZ ? bytes_read + 1 : bytes_read);
 
-  org_ryderrobots_ros2_serial_ErrorType etype;
   if (bytes_read == BUFSIZ && buf.ibuf_ptr()[BUFSIZ - 1] != TERM_CHAR)
   {
     // return back error code too big
-    mberror::RRBadRequest rr_bad_request(ostream);
-    etype = org_ryderrobots_ros2_serial_ErrorType_ET_MAX_LEN_EXCEED;
-    size_t result = rr_bad_request.serialize(etype);
-    if (result > 0)
-    {
-      Serial.write(buf.obuf_ptr(), result);
-      Serial.write(TERM_CHAR);
-    }
+    write_bad_request(org_ryderrobots_ros2_serial_ErrorType_ET_MAX_LEN_EXCEED);
     buf.clear();
     return;
   }
 
+  // the frame is decoded as sent, before byte stuffing.
+  if (!rr_buffer::unstuff(buf.ibuf_ptr(), bytes_read))
+  {
+    write_bad_request(org_ryderrobots_ros2_serial_ErrorType_ET_INVALID_REQUEST);
+    buf.clear();
+    return;
+  }
+
+  // the same bytes are decoded twice, each message skips the fields of the other.
   auto istream = pb_istream_from_buffer(buf.ibuf_ptr(), bytes_read);
+  auto ext_istream = pb_istream_from_buffer(buf.ibuf_ptr(), bytes_read);
   org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
-  if (!pb_decode(&istream, org_ryderrobots_ros2_serial_Request_fields, &req))
+  org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+  unsigned long start_us = micros();
+  bool decoded;
   {
-    // operation can not be deserialized.
-    mberror::RRBadRequest rr_bad_request(ostream);
-    etype = org_ryderrobots_ros2_serial_ErrorType_ET_INVALID_REQUEST;
-    size_t result = rr_bad_request.serialize(etype);
-    if (result > 0)
-    {
-      Serial.write(buf.obuf_ptr(), result);
-      Serial.write(TERM_CHAR);
-    }
+    RR_ZONE(rr_zone::ZONE_DECODE);
+    decoded = pb_decode(&istream, org_ryderrobots_ros2_serial_Request_fields, &req) &&
+              pb_decode(&ext_istream, org_ryderrobots_mousebot_ExtRequest_fields, &ereq);
+  }
+  unsigned long decoded_us = micros();
+  if (!decoded)
+  {
+    // operation can not be deserialized, the frame is kept under op 0.
+    metrics.record(0, rr_metrics::ST_DECODE, decoded_us - start_us);
+    write_bad_request(org_ryderrobots_ros2_serial_ErrorType_ET_INVALID_REQUEST);
     buf.clear();
     return;
   }
+  metrics.count(req.op);
+  metrics.record(req.op, rr_metrics::ST_DECODE, decoded_us - start_us);
 
+  watchdog.note(req.op);
   auto status = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_UNKNOWN;
-  mb_operations::MbOperationHandler *handler = fact.get_op_handler(req, status);
-
-  if (status == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+  mb_operations::MbOperationHandler *handler;
+  bool subscribed;
   {
+    RR_ZONE(rr_zone::ZONE_DISPATCH);
+    handler = fact.get_op_handler(req, status);
+    subscribed = status == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY &&
+                 (!ereq.has_subscribe || fact.subscribe(req.op, ereq.subscribe.period_ms));
+  }
+  metrics.record(req.op, rr_metrics::ST_DISPATCH, micros() - decoded_us);
 
-    org_ryderrobots_ros2_serial_Response res = org_ryderrobots_ros2_serial_Response_init_zero;
-    handler->perform_op(req, res);
-    if (!pb_encode(&ostream, org_ryderrobots_ros2_serial_Response_fields, &res))
-    {
-      // operation can not be deserialized.
-      mberror::RRBadRequest rr_bad_request(ostream);
-      etype = org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN;
-      size_t result = rr_bad_request.serialize(etype);
-      if (result > 0)
-      {
-        Serial.write(buf.obuf_ptr(), result);
-        Serial.write(TERM_CHAR);
-      }
-      buf.clear();
-      return;
-    }
-    Serial.write(buf.obuf_ptr(), ostream.bytes_written);
-    Serial.write(TERM_CHAR);
+  if (status != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY)
+  {
+    write_bad_request(org_ryderrobots_ros2_serial_ErrorType_ET_SERIAL_FAILURE, req.op);
+  }
+  else if (!subscribed)
+  {
+    // every subscription slot is in use.
+    write_bad_request(org_ryderrobots_ros2_serial_ErrorType_ET_SERVICE_UNAVAILABLE, req.op);
   }
   else
   {
-    mberror::RRBadRequest rr_bad_request(ostream);
-    etype = org_ryderrobots_ros2_serial_ErrorType_ET_SERIAL_FAILURE;
-    size_t result = rr_bad_request.serialize(etype);
-    if (result > 0)
-    {
-      Serial.write(buf.obuf_ptr(), result);
-      Serial.write(TERM_CHAR);
-    }
+    respond(handler, req, ereq);
   }
 
-  // This must be the last line of the loop.
+  // This must be the last line of the serial service.
   buf.clear();
 }
+
+// Called from within a loop, it will block while data is not available.
+// but does not consider processing time.
+void loop()
+{
+  // each task feeds its own reload register, the watchdog resets the board if any one of them stalls.
+  wdt::Wdt &watchdog = wdt::Wdt::get_instance();
+  watchdog.begin_loop();
+  RR_ZONE(rr_zone::ZONE_LOOP);
+
+  // background sampling runs every iteration, independently of serial requests.
+  fact.service_sensors();
+  watchdog.check_in(wdt::TASK_SENSORS);
+  fact.service_control();
+  // the wheel speed loop runs in the TIMER4 interrupt, control checks in only once it has run a period since.
+  if (fact.control_alive())
+  {
+    watchdog.check_in(wdt::TASK_CONTROL);
+  }
+
+  service_serial(watchdog);
+  watchdog.check_in(wdt::TASK_SERIAL);
+  watchdog.end_loop();
+}
@@ -0,0 +1,338 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+// the request path in main.cpp is timed by its profiling zones, one for each stage. the libraries must have them
+// too, so the flag comes from the build, env:native_profile.
+#if !defined(RR_ZONE_PROFILE) || !RR_ZONE_PROFILE
+#error "test_bench_pipeline needs -D RR_ZONE_PROFILE=1, run it with pio test -e native_profile"
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "Arduino.h"
+#include "Arduino_BMI270_BMM150.h"
+
+MockSerial Serial;
+MockBMI270_BMM150 IMU;
+MockInterrupt mock_interrupt;
+
+unsigned long mock_micros = 0;
+unsigned long micros() { return mock_micros; }
+unsigned long millis() { return mock_micros / 1000; }
+void delay(unsigned long ms) { mock_micros += ms * 1000; }
+
+// the firmware itself, setup() and loop() run unchanged against the mocks.
+#include "../../src/main.cpp"
+
+// Register level BMI270 on the native sensor bus, it serves a level, still robot, so the IMU, and the pose
+// estimate it feeds, are ready.
+class MockBmi270Registers : public rr_sensor_bus::MockDevice {
+public:
+    bool read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len) override {
+        if (addr != 0x68 || reg != 0x0C || len != 12) {
+            return false;
+        }
+        std::memset(buf, 0, len);
+
+        // 1g on z, at +/- 4g full scale.
+        buf[4] = 0x00;
+        buf[5] = 0x20;
+        return true;
+    }
+
+    bool write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *buf, size_t len) override {
+        return addr == 0x68;
+    }
+};
+
+MockBmi270Registers mock_bmi270;
+
+namespace
+{
+    const std::uint32_t FRAMES = 20000;
+    const std::uint32_t WARMUP = 500;
+    const size_t MAX_OPS = 8;
+    const size_t MAX_FRAME = 1024;
+
+    // unknown to both Request and ExtRequest, so both decoders skip it, it pads requests to a given size.
+    const std::uint32_t PAD_FIELD = 99;
+
+    struct Scenario
+    {
+        const char *name;
+        std::int32_t ops[MAX_OPS];
+        size_t op_count;
+
+        // bytes of padding in every request.
+        size_t pad;
+
+        // frames that can not be decoded, ops are ignored.
+        bool invalid;
+    };
+
+    const Scenario SCENARIOS[] = {
+        {"pose", {rr_ble::MSP_POSE}, 1, 0, false},
+        {"imu", {rr_ble::MSP_RAW_IMU}, 1, 0, false},
+        {"status", {rr_ble::MSP_STATUS}, 1, 0, false},
+        {"maze-dist", {rr_ble::MSP_MAZE_DIST}, 1, 0, false},
+        {"metrics", {rr_ble::MSP_METRICS}, 1, 0, false},
+        {"pose-pad-64", {rr_ble::MSP_POSE}, 1, 64, false},
+        {"pose-pad-256", {rr_ble::MSP_POSE}, 1, 256, false},
+        {"pose-pad-900", {rr_ble::MSP_POSE}, 1, 900, false},
+        {"mixed",
+         {rr_ble::MSP_POSE, rr_ble::MSP_RAW_IMU, rr_ble::MSP_STATUS, rr_ble::MSP_MOTION, rr_ble::MSP_WALLS,
+          rr_ble::MSP_MAZE_MOVE, rr_ble::MSP_MAZE_DIST, rr_ble::MSP_TRACE},
+         8, 64, false},
+        {"invalid", {0}, 1, 0, true},
+    };
+
+    const rr_zone::Zone STAGES[] = {
+        rr_zone::ZONE_READ,
+        rr_zone::ZONE_DECODE,
+        rr_zone::ZONE_DISPATCH,
+        rr_zone::ZONE_HANDLER,
+        rr_zone::ZONE_ENCODE,
+        rr_zone::ZONE_WRITE,
+        rr_zone::ZONE_SERIAL,
+    };
+
+    std::uint8_t frames[MAX_OPS][MAX_FRAME];
+    size_t frame_len[MAX_OPS];
+    size_t kinds = 0;
+
+    std::FILE *results = nullptr;
+    bool first_result = true;
+
+    /*
+     * encodes a monitor request for op, padded by pad bytes, byte stuffed and followed by TERM_CHAR, as frame k.
+     */
+    void encode_frame(size_t k, std::int32_t op, size_t pad)
+    {
+        std::uint8_t plain[MAX_FRAME];
+        pb_ostream_t os = pb_ostream_from_buffer(plain, sizeof(plain));
+        org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+        org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+        req.op = op;
+        req.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+        req.data.monitor.is_request = true;
+
+        static const std::uint8_t zeros[MAX_FRAME] = {0};
+        TEST_ASSERT_TRUE(pb_encode(&os, org_ryderrobots_ros2_serial_Request_fields, &req));
+        TEST_ASSERT_TRUE(pb_encode(&os, org_ryderrobots_mousebot_ExtRequest_fields, &ereq));
+        if (pad > 0)
+        {
+            TEST_ASSERT_TRUE(pb_encode_tag(&os, PB_WT_STRING, PAD_FIELD));
+            TEST_ASSERT_TRUE(pb_encode_string(&os, zeros, pad));
+        }
+
+        // stuffing at most doubles the frame, the padding is left as it is.
+        static std::uint8_t stuffed[2 * MAX_FRAME];
+        size_t n = rr_buffer::stuff(plain, os.bytes_written, stuffed);
+        TEST_ASSERT_LESS_THAN(MAX_FRAME, n);
+        std::memcpy(frames[k], stuffed, n);
+        frames[k][n] = TERM_CHAR;
+        frame_len[k] = n + 1;
+    }
+
+    void build_frames(const Scenario &s)
+    {
+        if (s.invalid)
+        {
+            // wire type 7 does not exist.
+            const std::uint8_t garbage[] = {0xFF, 0xFF, 0xFF, 0xFF, TERM_CHAR};
+            std::memcpy(frames[0], garbage, sizeof(garbage));
+            frame_len[0] = sizeof(garbage);
+            kinds = 1;
+            return;
+        }
+
+        for (size_t k = 0; k < s.op_count; k++)
+        {
+            encode_frame(k, s.ops[k], s.pad);
+        }
+        kinds = s.op_count;
+    }
+
+    /*
+     * feeds n frames, round robin, one to each main loop iteration, with an IMU sample ready in each.
+     */
+    void serve(std::uint32_t n)
+    {
+        for (std::uint32_t i = 0; i < n; i++)
+        {
+            size_t k = i % kinds;
+            Serial.mock_receive(frames[k], frame_len[k]);
+
+            // past the serial rate limit.
+            mock_micros += 5000;
+            mock_interrupt.fire();
+            loop();
+
+            if (Serial.mock_sent_len() > MockSerial::MOCK_TX / 2)
+            {
+                Serial.mock_clear();
+            }
+        }
+    }
+
+    void report(const Scenario &s, double elapsed_s)
+    {
+        rr_zone::Profiler &profiler = rr_zone::Profiler::get_instance();
+        rr_metrics::Metrics &metrics = rr_metrics::Metrics::get_instance();
+
+        std::uint32_t errors = 0;
+        for (std::uint32_t etype = 0; etype < RR_METRICS_ERROR_TYPES; etype++)
+        {
+            errors += metrics.errors(etype);
+        }
+
+        size_t rx = 0;
+        for (size_t k = 0; k < kinds; k++)
+        {
+            rx += frame_len[k];
+        }
+
+        // one JSON object a scenario, on a line of its own prefixed by BENCH, and in RR_BENCH_OUT if it is set.
+        char line[2048];
+        int n = std::snprintf(line, sizeof(line),
+                              "{\"scenario\":\"%s\",\"frames\":%u,\"frames_per_s\":%.0f,\"request_bytes\":%.1f,"
+                              "\"response_bytes\":%.1f,\"errors\":%u,\"stages_ns\":{",
+                              s.name, FRAMES, FRAMES / elapsed_s, static_cast<double>(rx) / kinds,
+                              static_cast<double>(metrics.tx_bytes()) / metrics.tx_frames(), errors);
+        for (size_t i = 0; i < sizeof(STAGES) / sizeof(STAGES[0]); i++)
+        {
+            const rr_zone::ZoneStats &z = profiler.zone(STAGES[i]);
+            std::uint32_t mean = z.count == 0 ? 0 : rr_zone::Profiler::to_ns(z.sum_ticks / z.count);
+            std::uint32_t max = z.count == 0 ? 0 : rr_zone::Profiler::to_ns(z.max_ticks);
+            n += std::snprintf(line + n, sizeof(line) - n, "%s\"%s\":{\"count\":%u,\"mean\":%u,\"max\":%u}",
+                               i == 0 ? "" : ",", rr_zone::Profiler::zone_name(STAGES[i]), z.count, mean, max);
+        }
+        std::snprintf(line + n, sizeof(line) - n, "}}");
+
+        printf("BENCH %s\n", line);
+        if (results != nullptr)
+        {
+            std::fprintf(results, "%s\n  %s", first_result ? "" : ",", line);
+            first_result = false;
+        }
+    }
+
+    void run(const Scenario &s)
+    {
+        build_frames(s);
+        serve(WARMUP);
+
+        rr_zone::Profiler::get_instance().reset();
+        rr_metrics::Metrics::get_instance().reset();
+        Serial.mock_clear();
+
+        auto start = std::chrono::steady_clock::now();
+        serve(FRAMES);
+        double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        rr_metrics::Metrics &metrics = rr_metrics::Metrics::get_instance();
+        TEST_ASSERT_EQUAL_UINT32(FRAMES, metrics.rx_frames());
+
+        // every request is answered by exactly one frame.
+        TEST_ASSERT_EQUAL_UINT32(FRAMES, metrics.tx_frames());
+        if (s.invalid)
+        {
+            TEST_ASSERT_EQUAL_UINT32(FRAMES, metrics.errors(org_ryderrobots_ros2_serial_ErrorType_ET_INVALID_REQUEST));
+        }
+        else
+        {
+            for (std::uint32_t etype = 0; etype < RR_METRICS_ERROR_TYPES; etype++)
+            {
+                TEST_ASSERT_EQUAL_UINT32(0, metrics.errors(etype));
+            }
+        }
+
+        report(s, elapsed_s);
+
+        const char *trace = std::getenv("RR_BENCH_TRACE");
+        if (trace != nullptr && std::strcmp(s.name, "mixed") == 0)
+        {
+            std::FILE *f = std::fopen(trace, "w");
+            TEST_ASSERT_TRUE(rr_zone::Profiler::get_instance().write_chrome_trace(f));
+            std::fclose(f);
+        }
+    }
+}
+
+void test_bench_pose(void) { run(SCENARIOS[0]); }
+void test_bench_imu(void) { run(SCENARIOS[1]); }
+void test_bench_status(void) { run(SCENARIOS[2]); }
+void test_bench_maze_dist(void) { run(SCENARIOS[3]); }
+void test_bench_metrics(void) { run(SCENARIOS[4]); }
+void test_bench_pose_pad_64(void) { run(SCENARIOS[5]); }
+void test_bench_pose_pad_256(void) { run(SCENARIOS[6]); }
+void test_bench_pose_pad_900(void) { run(SCENARIOS[7]); }
+void test_bench_mixed(void) { run(SCENARIOS[8]); }
+void test_bench_invalid(void) { run(SCENARIOS[9]); }
+
+void setUp(void) {
+    Serial.mock_clear();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    rr_sensor_bus::SensorBus::get_instance().attach_mock(&mock_bmi270);
+    setup();
+
+    const char *out = std::getenv("RR_BENCH_OUT");
+    if (out != nullptr)
+    {
+        results = std::fopen(out, "w");
+        if (results != nullptr)
+        {
+            std::fprintf(results, "{\"benchmark\":\"pipeline\",\"results\":[");
+        }
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_pose);
+    RUN_TEST(test_bench_imu);
+    RUN_TEST(test_bench_status);
+    RUN_TEST(test_bench_maze_dist);
+    RUN_TEST(test_bench_metrics);
+    RUN_TEST(test_bench_pose_pad_64);
+    RUN_TEST(test_bench_pose_pad_256);
+    RUN_TEST(test_bench_pose_pad_900);
+    RUN_TEST(test_bench_mixed);
+    RUN_TEST(test_bench_invalid);
+    int failures = UNITY_END();
+
+    if (results != nullptr)
+    {
+        std::fprintf(results, "\n]}\n");
+        std::fclose(results);
+    }
+    return failures;
+}
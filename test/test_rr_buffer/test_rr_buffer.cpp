@@ -51,6 +51,46 @@ void test_bad_request_buf(void)
     TEST_ASSERT_EQUAL(test_etype, decoded_response.data.bad_request.etype); // Verify etype
 }
 
+void test_stuffed_frame_has_no_terminator(void)
+{
+    // a maze distance of 30, a map byte of 0x1E, and an escape, as they appear in an encoded response.
+    std::uint8_t frame[256];
+    for (size_t i = 0; i < sizeof(frame); i++)
+    {
+        frame[i] = static_cast<std::uint8_t>(i);
+    }
+
+    std::uint8_t wire[2 * sizeof(frame)];
+    size_t n = stuff(frame, sizeof(frame), wire);
+    TEST_ASSERT_EQUAL(sizeof(frame) + 2, n);
+    for (size_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(TERM_CHAR, wire[i]);
+    }
+
+    TEST_ASSERT_TRUE(unstuff(wire, n));
+    TEST_ASSERT_EQUAL(sizeof(frame), n);
+    TEST_ASSERT_EQUAL_MEMORY(frame, wire, sizeof(frame));
+}
+
+void test_unstuff_rejects_bad_escapes(void)
+{
+    std::uint8_t trailing[] = {0x08, ESC_CHAR};
+    size_t n = sizeof(trailing);
+    TEST_ASSERT_FALSE(unstuff(trailing, n));
+
+    std::uint8_t unknown[] = {ESC_CHAR, 0x08};
+    n = sizeof(unknown);
+    TEST_ASSERT_FALSE(unstuff(unknown, n));
+
+    std::uint8_t escapes[] = {ESC_CHAR, TERM_CHAR ^ ESC_XOR, ESC_CHAR, ESC_CHAR ^ ESC_XOR};
+    n = sizeof(escapes);
+    TEST_ASSERT_TRUE(unstuff(escapes, n));
+    TEST_ASSERT_EQUAL(2, n);
+    TEST_ASSERT_EQUAL_UINT8(TERM_CHAR, escapes[0]);
+    TEST_ASSERT_EQUAL_UINT8(ESC_CHAR, escapes[1]);
+}
+
 void setUp(void) {
     // Set up code if needed
 }
@@ -62,5 +102,7 @@ void tearDown(void) {
 int main(void) {
     UNITY_BEGIN();
     RUN_TEST(test_bad_request_buf);
+    RUN_TEST(test_stuffed_frame_has_no_terminator);
+    RUN_TEST(test_unstuff_rejects_bad_escapes);
     return UNITY_END();
 }
@@ -0,0 +1,311 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <cmath>
+
+#include <rr_pid.hpp>
+#include <rr_loop_timer.hpp>
+#include <rr_profile.hpp>
+
+using namespace rr_control;
+
+static const float DT = 0.001f;
+
+static Pid pid;
+
+/*
+ * first order wheel, speed approaches gain * output with time constant tau.
+ */
+struct Plant
+{
+    float gain;
+    float tau;
+    float speed;
+
+    void step(float output, float dt)
+    {
+        speed += (gain * output - speed) * dt / tau;
+    }
+};
+
+void test_set_limits_rejects_empty_range(void)
+{
+    TEST_ASSERT_FALSE(pid.set_limits(1.0f, 1.0f));
+    TEST_ASSERT_FALSE(pid.set_limits(2.0f, -2.0f));
+    TEST_ASSERT_TRUE(pid.set_limits(-2.0f, 2.0f));
+}
+
+void test_feed_forward_only(void)
+{
+    Gains g = {0.0f, 0.0f, 0.0f, 800.0f, 40.0f};
+    pid.set_gains(g);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 440.0f, pid.update(0.5f, 0.0f, DT));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, -440.0f, pid.update(-0.5f, 0.0f, DT));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.update(0.0f, 0.3f, DT));
+}
+
+void test_derivative_acts_on_measurement(void)
+{
+    Gains g = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    pid.set_gains(g);
+
+    // first update has no history, a setpoint step does not kick the output.
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.update(1.0f, 0.0f, DT));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid.update(2.0f, 0.0f, DT));
+
+    // measurement rising at 0.1 / ms opposes the change.
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, -100.0f, pid.update(2.0f, 0.1f, DT));
+}
+
+void test_tracks_setpoint_without_error(void)
+{
+    // feed-forward deliberately 20% low, the integrator has to make up the difference.
+    Gains g = {300.0f, 3000.0f, 0.0f, 800.0f, 0.0f};
+    pid.set_gains(g);
+    Plant wheel = {1.0f / 1000.0f, 0.05f, 0.0f};
+
+    for (int i = 0; i < 2000; i++)
+    {
+        wheel.step(pid.update(0.5f, wheel.speed, DT), DT);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.5f, wheel.speed);
+    TEST_ASSERT_FALSE(pid.saturated());
+}
+
+void test_integrator_does_not_wind_up(void)
+{
+    Gains g = {300.0f, 3000.0f, 0.0f, 0.0f, 0.0f};
+    pid.set_gains(g);
+    Plant wheel = {1.0f / 1000.0f, 0.05f, 0.0f};
+
+    // unreachable setpoint for a second, output sits at the limit.
+    for (int i = 0; i < 1000; i++)
+    {
+        float out = pid.update(5.0f, wheel.speed, DT);
+        TEST_ASSERT_TRUE(out <= 1000.0f);
+        wheel.step(out, DT);
+    }
+    TEST_ASSERT_TRUE(pid.saturated());
+
+    // on a reachable setpoint the output leaves the limit within a few periods, instead of unwinding a
+    // second of accumulated error.
+    int i = 0;
+    for (; i < 1000 && pid.update(0.5f, wheel.speed, DT) >= 1000.0f; i++)
+    {
+    }
+    TEST_ASSERT_TRUE(i < 10);
+}
+
+void test_gain_change_is_bumpless(void)
+{
+    Gains g = {0.0f, 1000.0f, 0.0f, 0.0f, 0.0f};
+    pid.set_gains(g);
+    float out = 0.0f;
+    for (int i = 0; i < 100; i++)
+    {
+        out = pid.update(1.0f, 0.5f, DT);
+    }
+
+    g.ki = 2000.0f;
+    pid.set_gains(g);
+    // zero error, output holds at the integrator value.
+    TEST_ASSERT_FLOAT_WITHIN(1e-2f, out, pid.update(0.5f, 0.5f, DT));
+}
+
+void test_loop_timer_statistics(void)
+{
+    LoopTimer timer;
+    timer.set_period(1000);
+
+    std::uint32_t t = 0xFFFFF000u; // wraps during the run
+    for (int i = 0; i < 10; i++)
+    {
+        timer.start(t);
+        timer.stop(t + 20 + i);
+        t += (i == 5) ? 1600 : 1000;
+    }
+
+    const LoopTiming &s = timer.stats();
+    TEST_ASSERT_EQUAL_UINT32(10, s.count);
+    TEST_ASSERT_EQUAL_UINT32(1000, s.period_min_us);
+    TEST_ASSERT_EQUAL_UINT32(1600, s.period_max_us);
+    TEST_ASSERT_EQUAL_UINT32(9600, (std::uint32_t)s.period_sum_us);
+    TEST_ASSERT_EQUAL_UINT32(20, s.exec_min_us);
+    TEST_ASSERT_EQUAL_UINT32(29, s.exec_max_us);
+    TEST_ASSERT_EQUAL_UINT32(1, s.overruns);
+
+    timer.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, timer.stats().count);
+}
+
+/*
+ * runs a profile to completion, checking velocity, acceleration, and jerk limits on the way.
+ */
+struct ProfileRun
+{
+    int steps;
+    float peak_velocity;
+    float peak_accel;
+    float peak_jerk;
+};
+
+static ProfileRun run_profile(Profile &profile)
+{
+    ProfileRun run = {0, 0.0f, 0.0f, 0.0f};
+    float v = profile.velocity();
+    float a = 0.0f;
+    while (!profile.done() && run.steps < 100000)
+    {
+        float next = profile.step();
+        float accel = (next - v) / DT;
+        run.peak_velocity = fmaxf(run.peak_velocity, next);
+        run.peak_accel = fmaxf(run.peak_accel, fabsf(accel));
+        run.peak_jerk = fmaxf(run.peak_jerk, fabsf(accel - a) / DT);
+        v = next;
+        a = accel;
+        run.steps++;
+    }
+    return run;
+}
+
+void test_profile_rejects_bad_limits(void)
+{
+    Profile profile;
+    Limits ok = {1.0f, 2.0f, 0.0f};
+    TEST_ASSERT_FALSE(profile.start(-0.1f, 0.0f, ok, DT));
+    TEST_ASSERT_FALSE(profile.start(0.1f, 1.5f, ok, DT));
+    Limits no_accel = {1.0f, 0.0f, 0.0f};
+    TEST_ASSERT_FALSE(profile.start(0.1f, 0.0f, no_accel, DT));
+    TEST_ASSERT_TRUE(profile.done());
+    TEST_ASSERT_TRUE(profile.start(0.1f, 0.0f, ok, DT));
+}
+
+void test_trapezoid_reaches_target(void)
+{
+    Profile profile;
+    Limits limits = {0.5f, 2.0f, 0.0f};
+    TEST_ASSERT_TRUE(profile.start(0.18f, 0.0f, limits, DT));
+    ProfileRun run = run_profile(profile);
+
+    TEST_ASSERT_TRUE(profile.done());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.18f, profile.position());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, profile.velocity());
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, run.peak_velocity);
+    TEST_ASSERT_TRUE(run.peak_accel <= 2.0f * 1.01f);
+
+    // 0.25s each way, and 0.11s at 0.5 m/s.
+    TEST_ASSERT_INT_WITHIN(8, 610, run.steps);
+}
+
+void test_short_move_is_triangular(void)
+{
+    Profile profile;
+    Limits limits = {2.0f, 2.0f, 0.0f};
+    TEST_ASSERT_TRUE(profile.start(0.02f, 0.0f, limits, DT));
+    ProfileRun run = run_profile(profile);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.02f, profile.position());
+    // half the distance each way, v^2 = 2 a d / 2.
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, sqrtf(2.0f * 0.02f), run.peak_velocity);
+}
+
+void test_s_curve_limits_jerk(void)
+{
+    Profile profile;
+    Limits limits = {0.5f, 2.0f, 100.0f};
+    TEST_ASSERT_TRUE(profile.start(0.18f, 0.0f, limits, DT));
+    ProfileRun run = run_profile(profile);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.18f, profile.position());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, profile.velocity());
+    TEST_ASSERT_TRUE(run.peak_accel <= 2.0f * 1.01f);
+    TEST_ASSERT_TRUE(run.peak_jerk <= 100.0f * 1.05f);
+
+    // one 20ms averaging window longer than the trapezoid.
+    TEST_ASSERT_INT_WITHIN(8, 630, run.steps);
+}
+
+void test_segments_join_at_end_velocity(void)
+{
+    Profile profile;
+    Limits limits = {0.5f, 2.0f, 100.0f};
+    TEST_ASSERT_TRUE(profile.start(0.09f, 0.3f, limits, DT));
+    run_profile(profile);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.09f, profile.position());
+    TEST_ASSERT_EQUAL_FLOAT(0.3f, profile.velocity());
+
+    // the next segment starts without a velocity step.
+    TEST_ASSERT_TRUE(profile.start(0.09f, 0.0f, limits, DT));
+    float first = profile.step();
+    TEST_ASSERT_FLOAT_WITHIN(2.0f * DT + 1e-4f, 0.3f, first);
+    run_profile(profile);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.09f, profile.position());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, profile.velocity());
+}
+
+void test_stop_brakes_at_segment_limit(void)
+{
+    Profile profile;
+    Limits limits = {0.5f, 2.0f, 0.0f};
+    TEST_ASSERT_TRUE(profile.start(1.0f, 0.0f, limits, DT));
+    for (int i = 0; i < 400; i++)
+    {
+        profile.step();
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.5f, profile.velocity());
+
+    profile.stop();
+    ProfileRun run = run_profile(profile);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, profile.velocity());
+    TEST_ASSERT_TRUE(run.peak_accel <= 2.0f * 1.01f);
+    TEST_ASSERT_INT_WITHIN(8, 250, run.steps);
+    TEST_ASSERT_TRUE(profile.position() < 1.0f);
+}
+
+void setUp(void) {
+    pid = Pid();
+    pid.set_limits(-1000.0f, 1000.0f);
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_set_limits_rejects_empty_range);
+    RUN_TEST(test_feed_forward_only);
+    RUN_TEST(test_derivative_acts_on_measurement);
+    RUN_TEST(test_tracks_setpoint_without_error);
+    RUN_TEST(test_integrator_does_not_wind_up);
+    RUN_TEST(test_gain_change_is_bumpless);
+    RUN_TEST(test_loop_timer_statistics);
+    RUN_TEST(test_profile_rejects_bad_limits);
+    RUN_TEST(test_trapezoid_reaches_target);
+    RUN_TEST(test_short_move_is_triangular);
+    RUN_TEST(test_s_curve_limits_jerk);
+    RUN_TEST(test_segments_join_at_end_velocity);
+    RUN_TEST(test_stop_brakes_at_segment_limit);
+    return UNITY_END();
+}
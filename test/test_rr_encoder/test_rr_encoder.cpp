@@ -0,0 +1,202 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <rr_encoder.hpp>
+
+using namespace rr_encoder;
+
+static unsigned long mock_micros = 0;
+unsigned long micros() { return mock_micros; }
+unsigned long millis() { return mock_micros / 1000; }
+
+static Encoders &encoders = Encoders::get_instance();
+
+/*
+ * runs both wheels at constant tick rates for us microseconds, updating every step_us.
+ */
+static void run(SyntheticTicks &left, float left_rate, SyntheticTicks &right, float right_rate,
+                unsigned long us, unsigned long step_us)
+{
+    for (unsigned long t = 0; t < us; t += step_us)
+    {
+        mock_micros += step_us;
+        left.advance(left_rate, step_us * 1e-6f);
+        right.advance(right_rate, step_us * 1e-6f);
+        encoders.update();
+    }
+}
+
+void test_begin_clears_totals(void)
+{
+    encoders.mock_edges(LEFT, 7);
+    encoders.mock_edges(RIGHT, 9);
+    encoders.begin();
+
+    std::int32_t l = 1, r = 1;
+    TEST_ASSERT_TRUE(encoders.ready());
+    TEST_ASSERT_TRUE(encoders.read_ticks(l, r));
+    TEST_ASSERT_EQUAL_INT32(0, l);
+    TEST_ASSERT_EQUAL_INT32(0, r);
+}
+
+void test_synthetic_stream_counts_exactly(void)
+{
+    SyntheticTicks left(LEFT), right(RIGHT);
+    // 1234.5 ticks/s for one second, fractional edges are carried between steps.
+    run(left, 1234.5f, right, 100.0f, 1000000, 1000);
+
+    std::int32_t l, r;
+    TEST_ASSERT_TRUE(encoders.read_ticks(l, r));
+    TEST_ASSERT_INT32_WITHIN(1, 1234, l);
+    TEST_ASSERT_INT32_WITHIN(1, 100, r);
+}
+
+void test_reverse_edges_are_negative(void)
+{
+    SyntheticTicks left(LEFT), right(RIGHT);
+    run(left, 1000.0f, right, -1000.0f, 100000, 1000);
+    TEST_ASSERT_INT32_WITHIN(1, 100, encoders.ticks(LEFT));
+    TEST_ASSERT_INT32_WITHIN(1, -100, encoders.ticks(RIGHT));
+
+    // stop and reverse the left wheel, it returns to the start.
+    run(left, 0.0f, right, -1000.0f, 10000, 1000);
+    run(left, -1000.0f, right, -1000.0f, 100000, 1000);
+    TEST_ASSERT_INT32_WITHIN(1, 0, encoders.ticks(LEFT));
+    TEST_ASSERT_INT32_WITHIN(1, -210, encoders.ticks(RIGHT));
+}
+
+void test_braking_keeps_direction_until_stopped(void)
+{
+    encoders.set_direction(LEFT, 1);
+    for (int i = 0; i < 50; i++)
+    {
+        mock_micros += 1000;
+        encoders.mock_edges(LEFT, 5);
+        encoders.update();
+    }
+    TEST_ASSERT_EQUAL_INT32(250, encoders.ticks(LEFT));
+
+    // full reverse brakes the wheel from 5000 ticks/s, edges still come from forward rotation.
+    encoders.set_direction(LEFT, -1);
+    std::int32_t last = encoders.ticks(LEFT);
+    for (int edges = 5; edges > 0; edges--)
+    {
+        for (int i = 0; i < 10; i++)
+        {
+            mock_micros += 1000;
+            encoders.mock_edges(LEFT, edges);
+            encoders.update();
+            TEST_ASSERT_TRUE(encoders.ticks(LEFT) > last);
+            last = encoders.ticks(LEFT);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT32(250 + 150, last);
+
+    // stopped, the reversed command is taken, and the wheel now runs backwards.
+    for (int i = 0; i < RR_ENCODER_VELOCITY_WINDOW; i++)
+    {
+        mock_micros += 1000;
+        encoders.update();
+    }
+    encoders.mock_edges(LEFT, 20);
+    encoders.update();
+    TEST_ASSERT_EQUAL_INT32(250 + 150 - 20, encoders.ticks(LEFT));
+}
+
+void test_direction_change_attributes_earlier_edges(void)
+{
+    encoders.set_direction(LEFT, 1);
+    encoders.mock_edges(LEFT, 50);
+
+    // edges counted before the reversal stay forwards, even though update() has not run.
+    encoders.set_direction(LEFT, -1);
+    encoders.mock_edges(LEFT, 20);
+    encoders.update();
+    TEST_ASSERT_EQUAL_INT32(30, encoders.ticks(LEFT));
+
+    // zero keeps the last direction, a coasting wheel keeps turning.
+    encoders.set_direction(LEFT, 0);
+    encoders.mock_edges(LEFT, 10);
+    encoders.update();
+    TEST_ASSERT_EQUAL_INT32(20, encoders.ticks(LEFT));
+}
+
+void test_hardware_counter_wrap(void)
+{
+    // bring the free running counter to just below wrap, then begin, as after a long run.
+    encoders.mock_edges(LEFT, 0xFFFFFFF0u);
+    encoders.begin();
+    encoders.mock_edges(LEFT, 0x20);
+    encoders.update();
+    TEST_ASSERT_EQUAL_INT32(0x20, encoders.ticks(LEFT));
+}
+
+void test_velocity_estimate_is_timestamped(void)
+{
+    SyntheticTicks left(LEFT), right(RIGHT);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, encoders.velocity(LEFT).ticks_per_s);
+
+    run(left, 2000.0f, right, -500.0f, 50000, 1000);
+    Velocity l = encoders.velocity(LEFT);
+    Velocity r = encoders.velocity(RIGHT);
+
+    // resolution is one tick over the window.
+    const float resolution = 1.0f / ((RR_ENCODER_VELOCITY_WINDOW - 1) * 1e-3f);
+    TEST_ASSERT_FLOAT_WITHIN(resolution, 2000.0f, l.ticks_per_s);
+    TEST_ASSERT_FLOAT_WITHIN(resolution, -500.0f, r.ticks_per_s);
+    TEST_ASSERT_EQUAL_UINT32(mock_micros, l.timestamp_us);
+}
+
+void test_velocity_ignores_fast_updates(void)
+{
+    SyntheticTicks left(LEFT), right(RIGHT);
+    run(left, 1000.0f, right, 1000.0f, 20000, 1000);
+    std::uint32_t stamp = encoders.velocity(LEFT).timestamp_us;
+
+    // updates closer than RR_ENCODER_VELOCITY_MIN_US still count ticks, but do not resample velocity.
+    run(left, 1000.0f, right, 1000.0f, RR_ENCODER_VELOCITY_MIN_US / 2, RR_ENCODER_VELOCITY_MIN_US / 4);
+    TEST_ASSERT_EQUAL_UINT32(stamp, encoders.velocity(LEFT).timestamp_us);
+    TEST_ASSERT_INT32_WITHIN(1, 20, encoders.ticks(LEFT));
+}
+
+void setUp(void) {
+    mock_micros = 0;
+    encoders.begin();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_begin_clears_totals);
+    RUN_TEST(test_synthetic_stream_counts_exactly);
+    RUN_TEST(test_reverse_edges_are_negative);
+    RUN_TEST(test_braking_keeps_direction_until_stopped);
+    RUN_TEST(test_direction_change_attributes_earlier_edges);
+    RUN_TEST(test_hardware_counter_wrap);
+    RUN_TEST(test_velocity_estimate_is_timestamped);
+    RUN_TEST(test_velocity_ignores_fast_updates);
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <rr_filter.hpp>
+#include <rr_median.hpp>
+
+using namespace rr_filter;
+
+typedef FirDecimator<2, 33> Decimator;
+
+// peak output amplitude of a unit sine at freq (fraction of input rate), after settling.
+static float tone_gain(Decimator &dec, float freq)
+{
+    float in[2], out[2];
+    float peak = 0.0f;
+    for (int i = 0; i < 4000; i++)
+    {
+        in[0] = sinf(2.0f * static_cast<float>(M_PI) * freq * static_cast<float>(i));
+        in[1] = 0.0f;
+        if (dec.push(in, out) && i > 400)
+        {
+            peak = fabsf(out[0]) > peak ? fabsf(out[0]) : peak;
+        }
+    }
+    return peak;
+}
+
+void test_design_lowpass_unity_dc_gain(void)
+{
+    float coeffs[17];
+    design_lowpass(17, 0.1f, coeffs);
+    float sum = 0.0f;
+    for (int i = 0; i < 17; i++)
+    {
+        sum += coeffs[i];
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, sum);
+
+    // linear phase, coefficients are symmetric
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, coeffs[0], coeffs[16]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, coeffs[3], coeffs[13]);
+}
+
+void test_decimator_rejects_zero_factor(void)
+{
+    Decimator dec;
+    TEST_ASSERT_FALSE(dec.configure(0));
+    TEST_ASSERT_EQUAL(1, dec.factor());
+}
+
+void test_decimator_pass_through(void)
+{
+    Decimator dec;
+    float in[2] = {1.5f, -2.0f};
+    float out[2];
+    TEST_ASSERT_TRUE(dec.push(in, out));
+    TEST_ASSERT_EQUAL_FLOAT(1.5f, out[0]);
+    TEST_ASSERT_EQUAL_FLOAT(-2.0f, out[1]);
+}
+
+void test_decimator_output_rate(void)
+{
+    Decimator dec;
+    TEST_ASSERT_TRUE(dec.configure(8));
+    TEST_ASSERT_EQUAL(33, dec.taps());
+
+    float in[2] = {1.0f, 1.0f};
+    float out[2];
+    int outputs = 0;
+    for (int i = 0; i < 800; i++)
+    {
+        outputs += dec.push(in, out) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(100, outputs);
+
+    // settled DC is passed with unity gain on every channel
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, out[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, out[1]);
+}
+
+void test_decimator_rejects_aliasing_tone(void)
+{
+    // 800Hz in, 100Hz out, a 10Hz signal passes, 330Hz vibration would alias to 30Hz
+    Decimator dec;
+    dec.configure(8);
+    TEST_ASSERT_TRUE(tone_gain(dec, 10.0f / 800.0f) > 0.9f);
+
+    dec.configure(8);
+    TEST_ASSERT_TRUE(tone_gain(dec, 330.0f / 800.0f) < 0.02f);
+}
+
+// median of the last n of samples[0 .. end), by sorting.
+static float brute_median(const float *samples, size_t end, size_t n)
+{
+    size_t count = end < n ? end : n;
+    float window[16];
+    std::copy(samples + end - count, samples + end, window);
+    std::sort(window, window + count);
+    return count % 2 ? window[count / 2] : 0.5f * (window[count / 2 - 1] + window[count / 2]);
+}
+
+template <size_t N>
+static void check_sliding_median(void)
+{
+    float samples[500];
+    std::uint32_t seed = 12345;
+    SlidingMedian<N> median;
+    for (size_t i = 0; i < 500; i++)
+    {
+        // coarse values, so that ties are common.
+        seed = seed * 1103515245u + 12345u;
+        samples[i] = static_cast<float>((seed >> 16) % 20);
+        median.push(samples[i]);
+        TEST_ASSERT_EQUAL_FLOAT(brute_median(samples, i + 1, N), median.median());
+    }
+    TEST_ASSERT_TRUE(median.full());
+}
+
+void test_sliding_median_matches_sort(void)
+{
+    check_sliding_median<1>();
+    check_sliding_median<2>();
+    check_sliding_median<7>();
+    check_sliding_median<8>();
+}
+
+void test_sliding_median_follows_ramp(void)
+{
+    SlidingMedian<5> median;
+    for (int i = 0; i < 20; i++)
+    {
+        median.push(static_cast<float>(i));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(17.0f, median.median());
+
+    median.reset();
+    TEST_ASSERT_EQUAL(0, median.count());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, median.median());
+}
+
+void test_hampel_replaces_spike_with_median(void)
+{
+    Hampel<7> hampel(3.0f, 0.005f);
+    const float noise[] = {0.100f, 0.102f, 0.099f, 0.101f, 0.100f, 0.098f};
+    for (float x : noise)
+    {
+        TEST_ASSERT_EQUAL_FLOAT(x, hampel.push(x));
+        TEST_ASSERT_FALSE(hampel.outlier());
+    }
+
+    // multipath spike to maximum range.
+    float out = hampel.push(2.0f);
+    TEST_ASSERT_TRUE(hampel.outlier());
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, 0.100f, out);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 6.0f / 7.0f, hampel.confidence());
+
+    // inliers pass unchanged.
+    TEST_ASSERT_EQUAL_FLOAT(0.101f, hampel.push(0.101f));
+}
+
+void test_hampel_follows_persistent_step(void)
+{
+    Hampel<7> hampel(3.0f, 0.005f);
+    for (int i = 0; i < 7; i++)
+    {
+        hampel.push(0.09f);
+    }
+
+    // a wall appearing, rejected until it holds the majority of the window.
+    int rejected = 0;
+    for (int i = 0; i < 7; i++)
+    {
+        hampel.push(0.30f);
+        rejected += hampel.outlier() ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.30f, hampel.value());
+    TEST_ASSERT_LESS_OR_EQUAL(4, rejected);
+    TEST_ASSERT_GREATER_THAN(0, rejected);
+}
+
+void test_hampel_confidence_counts_invalid_samples(void)
+{
+    Hampel<4> hampel(3.0f, 0.005f);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, hampel.confidence());
+    hampel.push(0.2f);
+    hampel.push(0.2f);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, hampel.confidence());
+    hampel.push(0.2f);
+    hampel.push(0.2f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, hampel.confidence());
+
+    // a ping without an echo pushed at maximum range, rejected, and not valid anyway.
+    hampel.push(2.0f, false);
+    TEST_ASSERT_EQUAL_FLOAT(0.75f, hampel.confidence());
+    TEST_ASSERT_EQUAL_FLOAT(0.2f, hampel.value());
+
+    // no echo at all, the median moves to maximum range with no confidence.
+    for (int i = 0; i < 4; i++)
+    {
+        hampel.push(2.0f, false);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, hampel.median());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, hampel.confidence());
+}
+
+void setUp(void) {
+    // Set up code if needed
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_design_lowpass_unity_dc_gain);
+    RUN_TEST(test_decimator_rejects_zero_factor);
+    RUN_TEST(test_decimator_pass_through);
+    RUN_TEST(test_decimator_output_rate);
+    RUN_TEST(test_decimator_rejects_aliasing_tone);
+    RUN_TEST(test_sliding_median_matches_sort);
+    RUN_TEST(test_sliding_median_follows_ramp);
+    RUN_TEST(test_hampel_replaces_spike_with_median);
+    RUN_TEST(test_hampel_follows_persistent_step);
+    RUN_TEST(test_hampel_confidence_counts_invalid_samples);
+    return UNITY_END();
+}
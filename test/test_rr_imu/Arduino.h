@@ -4,22 +4,105 @@
 #ifndef MOCK_ARDUINO_H
 #define MOCK_ARDUINO_H
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 
-// Mock Serial class
+// Mock Serial class, mock_receive() queues bytes for read(), and written bytes are kept for mock_sent()
 class MockSerial {
 public:
+    static constexpr size_t MOCK_RX = 4096;
+    static constexpr size_t MOCK_TX = 16384;
+
     void begin(long baud) { printf("Serial.begin(%ld)\n", baud); }
     void println(const char* str) { printf("%s\n", str); }
     void print(const char* str) { printf("%s", str); }
     operator bool() { return true; }
+
+    int available() { return static_cast<int>(rx_len_ - rx_pos_); }
+    int read() { return rx_pos_ < rx_len_ ? rx_[rx_pos_++] : -1; }
+
+    size_t write(std::uint8_t c) {
+        if (tx_len_ < MOCK_TX) {
+            tx_[tx_len_++] = c;
+        }
+        tx_total_++;
+        return 1;
+    }
+
+    size_t write(const std::uint8_t* buf, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            write(buf[i]);
+        }
+        return len;
+    }
+
+    // queues len bytes to be read, after whatever has not been read yet.
+    bool mock_receive(const std::uint8_t* buf, size_t len) {
+        if (rx_pos_ == rx_len_) {
+            rx_pos_ = rx_len_ = 0;
+        }
+        if (rx_len_ + len > MOCK_RX) {
+            return false;
+        }
+        for (size_t i = 0; i < len; i++) {
+            rx_[rx_len_++] = buf[i];
+        }
+        return true;
+    }
+
+    const std::uint8_t* mock_sent() const { return tx_; }
+    size_t mock_sent_len() const { return tx_len_; }
+
+    // bytes written since the last mock_clear(), including those that did not fit the buffer.
+    size_t mock_sent_total() const { return tx_total_; }
+
+    void mock_clear() {
+        rx_pos_ = rx_len_ = 0;
+        tx_len_ = tx_total_ = 0;
+    }
+
+private:
+    std::uint8_t rx_[MOCK_RX];
+    size_t rx_pos_ = 0;
+    size_t rx_len_ = 0;
+    std::uint8_t tx_[MOCK_TX];
+    size_t tx_len_ = 0;
+    size_t tx_total_ = 0;
 };
 
 extern MockSerial Serial;
 
+// Mock GPIO interrupts, fire() stands in for the hardware edge
+typedef void (*voidFuncPtr)(void);
+
+enum PinStatus { LOW = 0, HIGH = 1, CHANGE, FALLING, RISING };
+enum PinMode { INPUT = 0, OUTPUT, INPUT_PULLUP, INPUT_PULLDOWN };
+
+class MockInterrupt {
+public:
+    unsigned pin = 0;
+    voidFuncPtr isr = nullptr;
+    PinStatus mode = LOW;
+
+    void fire() { if (isr) isr(); }
+};
+
+extern MockInterrupt mock_interrupt;
+
+inline void pinMode(unsigned pin, PinMode mode) { (void)pin; (void)mode; }
+inline void attachInterrupt(unsigned pin, voidFuncPtr isr, PinStatus mode) {
+    mock_interrupt.pin = pin;
+    mock_interrupt.isr = isr;
+    mock_interrupt.mode = mode;
+}
+
 // Arduino timing functions (declared here, implemented in test file)
+inline void noInterrupts() {}
+inline void interrupts() {}
+
 extern unsigned long millis();
+extern unsigned long micros();
 extern void delay(unsigned long ms);
 
 #endif // MOCK_ARDUINO_H
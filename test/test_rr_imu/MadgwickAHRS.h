@@ -16,12 +16,14 @@ public:
     float getRoll() { return mock_roll; }
     float getPitch() { return mock_pitch; }
     float getYaw() { return mock_yaw; }
+    float getYawRadians() { return mock_yaw_radians; }
 
     // Mock control variables
     float sample_freq = 0.0f;
     float mock_roll = 0.0f;
     float mock_pitch = 0.0f;
     float mock_yaw = 0.0f;
+    float mock_yaw_radians = 0.0f;
     float last_gx = 0.0f, last_gy = 0.0f, last_gz = 0.0f;
     float last_ax = 0.0f, last_ay = 0.0f, last_az = 0.0f;
 };
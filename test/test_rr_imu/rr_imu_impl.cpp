@@ -19,19 +19,215 @@
 // SOFTWARE.
 
 #include <rr_imu.hpp>
+#include <rr_zone.hpp>
+
+#ifdef ARDUINO
+#include <Wire.h>
+#endif
 
 namespace mb_operations
 {
+    namespace
+    {
+        // BMI270 sits on the internal I2C bus (Wire1) of the Nano 33 BLE Sense Rev2.
+        constexpr std::uint8_t BMI270_ADDR = 0x68;
+        constexpr std::uint8_t BMI270_ACC_CONF = 0x40;
+        constexpr std::uint8_t BMI270_GYR_CONF = 0x42;
+
+        constexpr std::uint8_t BMI270_DATA_8 = 0x0C;
+        constexpr std::uint8_t BMI270_INT1_IO_CTRL = 0x53;
+        constexpr std::uint8_t BMI270_INT_LATCH = 0x55;
+        constexpr std::uint8_t BMI270_INT_MAP_DATA = 0x58;
+
+        // filter_perf (bit 7) set, bwp (bits 6:4 / 5:4) normal mode.
+        constexpr std::uint8_t BMI270_CONF_PERF_NORMAL = 0xA0;
+
+        // output_en, push-pull, active high
+        constexpr std::uint8_t BMI270_INT1_OUT_PP_HIGH = 0x0A;
+
+        // drdy_int mapped to INT1
+        constexpr std::uint8_t BMI270_DRDY_INT1 = 0x04;
+
+        // ranges configured by Arduino_BMI270_BMM150, +/- 4g, and +/- 2000 dps
+        constexpr float BMI270_ACC_SCALE = 4.0f / 32768.0f;
+        constexpr float BMI270_GYR_SCALE = 2000.0f / 32768.0f;
+
+        constexpr unsigned long BUS_FLUSH_MS = 100;
+
+        inline float to_float(const std::uint8_t *p, float scale)
+        {
+            return static_cast<float>(static_cast<std::int16_t>(p[0] | (p[1] << 8))) * scale;
+        }
+
+        /*
+         * returns BMI270 odr field for rate, or 0 if not supported.
+         */
+        std::uint8_t odr_code(std::uint16_t hz)
+        {
+            switch (hz)
+            {
+            case 100:
+                return 0x08;
+            case 200:
+                return 0x09;
+            case 400:
+                return 0x0A;
+            case 800:
+                return 0x0B;
+            case 1600:
+                return 0x0C;
+            default:
+                return 0;
+            }
+        }
+    }
+
+    volatile std::uint32_t RRImuOpHandler::drdy_count_ = 0;
+
+    void RRImuOpHandler::on_data_ready()
+    {
+        drdy_count_ = drdy_count_ + 1;
+    }
+
     void RRImuOpHandler::init()
     {
-        filter_.begin(100.0f);
-        IMU.begin();
+        if (!IMU.begin())
+        {
+            return;
+        }
+
+        // the library is only needed to load the BMI270 config, after that the sensor bus owns the peripheral.
+#ifdef ARDUINO
+        Wire1.end();
+#endif
+        rr_sensor_bus::SensorBus &bus = rr_sensor_bus::SensorBus::get_instance();
+        bus.begin();
+        std::uint32_t errors = bus.errors();
 
         // allow a small delay for services to become active.
         delay(100);
-        if (IMU.accelerationAvailable() && IMU.gyroscopeAvailable())
+        if (!configure(sensor_odr_hz_, output_hz_))
+        {
+            configure(100, 100);
+        }
+
+        // route data ready to INT1 as a pulse, so that samples are read on demand instead of polled.
+        if (!(write_reg(BMI270_INT1_IO_CTRL, BMI270_INT1_OUT_PP_HIGH) &&
+              write_reg(BMI270_INT_LATCH, 0) &&
+              write_reg(BMI270_INT_MAP_DATA, BMI270_DRDY_INT1)))
+        {
+            return;
+        }
+        if (!bus.flush(BUS_FLUSH_MS) || bus.errors() != errors)
+        {
+            return;
+        }
+        pinMode(RR_IMU_INT_PIN, INPUT);
+        attachInterrupt(RR_IMU_INT_PIN, on_data_ready, RISING);
+
+        drdy_seen_ = drdy_count_;
+        last_sample_ms_ = millis();
+        status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+    }
+
+    bool RRImuOpHandler::write_reg(std::uint8_t reg, std::uint8_t val)
+    {
+        return rr_sensor_bus::SensorBus::get_instance().write(BMI270_ADDR, reg, &val, 1, nullptr, nullptr);
+    }
+
+    bool RRImuOpHandler::write_odr(std::uint16_t sensor_odr_hz)
+    {
+        std::uint8_t code = odr_code(sensor_odr_hz);
+        if (code == 0)
+        {
+            return false;
+        }
+        std::uint8_t conf = static_cast<std::uint8_t>(BMI270_CONF_PERF_NORMAL | code);
+        return write_reg(BMI270_ACC_CONF, conf) && write_reg(BMI270_GYR_CONF, conf);
+    }
+
+    bool RRImuOpHandler::configure(std::uint16_t sensor_odr_hz, std::uint16_t output_hz)
+    {
+        if (odr_code(sensor_odr_hz) == 0 || output_hz == 0 || output_hz > sensor_odr_hz ||
+            sensor_odr_hz % output_hz != 0 || sensor_odr_hz / output_hz > RR_IMU_MAX_DECIMATION)
+        {
+            return false;
+        }
+        if (!write_odr(sensor_odr_hz))
+        {
+            return false;
+        }
+
+        sensor_odr_hz_ = sensor_odr_hz;
+        output_hz_ = output_hz;
+        decimator_.configure(static_cast<std::uint16_t>(sensor_odr_hz / output_hz));
+        filter_.begin(static_cast<float>(output_hz));
+        return true;
+    }
+
+    std::uint16_t RRImuOpHandler::sensor_odr_hz() const
+    {
+        return sensor_odr_hz_;
+    }
+
+    std::uint16_t RRImuOpHandler::output_hz() const
+    {
+        return output_hz_;
+    }
+
+    void RRImuOpHandler::service()
+    {
+        if (read_in_flight_)
+        {
+            return;
+        }
+        std::uint32_t count = drdy_count_;
+        std::uint32_t pending = count - drdy_seen_;
+        if (pending == 0)
+        {
+            return;
+        }
+        drdy_seen_ = count;
+        missed_samples_ += pending - 1;
+
+        read_in_flight_ = rr_sensor_bus::SensorBus::get_instance().read(BMI270_ADDR, BMI270_DATA_8, raw_, sizeof(raw_), on_sample, this);
+    }
+
+    void RRImuOpHandler::on_sample(void *ctx, bool ok)
+    {
+        RRImuOpHandler *self = static_cast<RRImuOpHandler *>(ctx);
+        self->read_in_flight_ = false;
+        if (!ok)
+        {
+            return;
+        }
+
+        self->last_sample_ms_ = millis();
+        if (self->status_ == org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE)
+        {
+            self->status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+        }
+
+        const std::uint8_t *raw = self->raw_;
+        float in[IMU_CHANNELS] = {
+            to_float(&raw[6], BMI270_GYR_SCALE),
+            to_float(&raw[8], BMI270_GYR_SCALE),
+            to_float(&raw[10], BMI270_GYR_SCALE),
+            to_float(&raw[0], BMI270_ACC_SCALE),
+            to_float(&raw[2], BMI270_ACC_SCALE),
+            to_float(&raw[4], BMI270_ACC_SCALE),
+        };
+
+        float out[IMU_CHANNELS];
+        if (self->decimator_.push(in, out))
         {
-            status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY;
+            for (size_t i = 0; i < IMU_CHANNELS; i++)
+            {
+                self->sample_[i] = out[i];
+            }
+            self->filter_.updateIMU(self->sample_[0], self->sample_[1], self->sample_[2],
+                                    self->sample_[3], self->sample_[4], self->sample_[5]);
+            self->yaw_ = self->filter_.getYawRadians();
         }
     }
 
@@ -40,20 +236,53 @@ namespace mb_operations
         return status_;
     }
 
+    std::uint32_t RRImuOpHandler::missed_samples() const
+    {
+        return missed_samples_;
+    }
+
+    bool RRImuOpHandler::yaw_rate(float &rad_s) const
+    {
+        if (status_ != org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_READY ||
+            millis() - last_sample_ms_ > RR_IMU_STALE_MS)
+        {
+            return false;
+        }
+        rad_s = sample_[2] * (rr_math::PI / 180.0f);
+        return true;
+    }
+
+    bool RRImuOpHandler::read_heading(float &yaw, float &rate)
+    {
+        if (!yaw_rate(rate))
+        {
+            return false;
+        }
+        yaw = yaw_;
+        return true;
+    }
+
     void RRImuOpHandler::euler_to_quaternion(float roll, float pitch, float yaw,
                                              float *q_w, float *q_x, float *q_y, float *q_z)
     {
-        float cr = cosf(roll * 0.5f);
-        float sr = sinf(roll * 0.5f);
-        float cp = cosf(pitch * 0.5f);
-        float sp = sinf(pitch * 0.5f);
-        float cy = cosf(yaw * 0.5f);
-        float sy = sinf(yaw * 0.5f);
+        RR_ZONE(rr_zone::ZONE_EULER_TO_QUATERNION);
+        float cr, sr, cp, sp, cy, sy;
+        rr_math::sin_cos(roll * 0.5f, &sr, &cr);
+        rr_math::sin_cos(pitch * 0.5f, &sp, &cp);
+        rr_math::sin_cos(yaw * 0.5f, &sy, &cy);
 
         *q_w = cy * cp * cr + sy * sp * sr;
         *q_x = sy * sp * cr - cy * cp * sr;
         *q_y = cy * sp * cr + sy * cp * sr;
         *q_z = cy * cp * sr - sy * sp * cr;
+
+        // the polynomial kernels are not exact, so keep the result on the unit sphere.
+        rr_math::Quat q = {*q_w, *q_x, *q_y, *q_z};
+        rr_math::normalise(q);
+        *q_w = q.w;
+        *q_x = q.x;
+        *q_y = q.y;
+        *q_z = q.z;
     }
 
     /*
@@ -61,20 +290,12 @@ namespace mb_operations
      */
     void RRImuOpHandler::monitor(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response)
     {
+        RR_ZONE(rr_zone::ZONE_IMU_MONITOR);
         response = org_ryderrobots_ros2_serial_Response_init_zero;
         response.op = rr_ble::rr_op_code_t::MSP_RAW_IMU;
 
-        float gx, gy, gz, ax, ay, az, qx, qy, qz, qw;
-        IMU.readGyroscope(gx, gy, gz);
-        IMU.readAcceleration(ax, ay, az);
-
-        // Rate limit filter updates to match configured sample rate (100Hz)
-        unsigned long current_ms = millis();
-        if (current_ms - last_update_ms_ >= UPDATE_INTERVAL_MS)
-        {
-            filter_.updateIMU(gx, gy, gz, ax, ay, az);
-            last_update_ms_ = current_ms;
-        }
+        // samples are drained, and the filter updated, by service() at the configured rates.
+        float qx, qy, qz, qw;
 
         org_ryderrobots_ros2_serial_MspRawImu payload = org_ryderrobots_ros2_serial_MspRawImu_init_zero;
 
@@ -87,15 +308,15 @@ namespace mb_operations
         payload.has_orientation = true;
 
         // angular velocity
-        payload.angular_velocity.x = gx;
-        payload.angular_velocity.y = gy;
-        payload.angular_velocity.z = gz;
+        payload.angular_velocity.x = sample_[0];
+        payload.angular_velocity.y = sample_[1];
+        payload.angular_velocity.z = sample_[2];
         payload.has_angular_velocity = true;
 
         // linera acceleration.
-        payload.linear_acceleration.x = ax;
-        payload.linear_acceleration.y = ay;
-        payload.linear_acceleration.z = az;
+        payload.linear_acceleration.x = sample_[3];
+        payload.linear_acceleration.y = sample_[4];
+        payload.linear_acceleration.z = sample_[5];
         payload.has_linear_acceleration = true;
         response.data.msp_raw_imu = payload;
         response.which_data = org_ryderrobots_ros2_serial_Response_msp_raw_imu_tag;
@@ -106,8 +327,8 @@ namespace mb_operations
         response = org_ryderrobots_ros2_serial_Response_init_zero;
         response.op = rr_ble::rr_op_code_t::MSP_RAW_IMU;
 
-        // failure condition. set error
-        if (!(IMU.gyroscopeAvailable() && IMU.accelerationAvailable()))
+        // failure condition, data ready interrupts have stopped arriving. set error
+        if (millis() - last_sample_ms_ > RR_IMU_STALE_MS)
         {
             status_ = org_ryderrobots_ros2_serial_Status::org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE;
             org_ryderrobots_ros2_serial_BadRequest bad_request =
@@ -136,4 +357,19 @@ namespace mb_operations
             return;
         }
     }
+
+    void RRImuOpHandler::perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres)
+    {
+        org_ryderrobots_mousebot_ImuState &imu = eres.imu;
+        eres.has_imu = true;
+
+        // rates out of uint16_t range are not supported either, rather than wrapped into ones that are.
+        if (ereq.has_imu_rate && ereq.imu_rate.sensor_odr_hz <= 0xFFFF && ereq.imu_rate.output_hz <= 0xFFFF)
+        {
+            imu.accepted = configure(static_cast<std::uint16_t>(ereq.imu_rate.sensor_odr_hz),
+                                     static_cast<std::uint16_t>(ereq.imu_rate.output_hz));
+        }
+        imu.sensor_odr_hz = sensor_odr_hz_;
+        imu.output_hz = output_hz_;
+    }
 }
\ No newline at end of file
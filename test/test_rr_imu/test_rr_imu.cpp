@@ -64,6 +64,16 @@ public:
         *q_z = cy * cp * sr - sy * sp * cr;
     }
 
+    bool configure(std::uint16_t sensor_odr_hz, std::uint16_t output_hz) {
+        return handler_.configure(sensor_odr_hz, output_hz);
+    }
+
+    void service() { handler_.service(); }
+
+    void perform_ext(const org_ryderrobots_mousebot_ExtRequest &ereq, org_ryderrobots_mousebot_ExtResponse &eres) {
+        handler_.perform_ext(ereq, eres);
+    }
+
     void monitor(const org_ryderrobots_ros2_serial_Request &req, org_ryderrobots_ros2_serial_Response &response) {
         // Call through public perform_op which will route to monitor
         handler_.perform_op(req, response);
@@ -77,6 +87,44 @@ public:
 // Implement mock instances
 MockSerial Serial;
 MockBMI270_BMM150 IMU;
+MockInterrupt mock_interrupt;
+
+// Register level BMI270 on the native sensor bus, serves the data burst from the IMU mock values
+class MockBmi270Registers : public rr_sensor_bus::MockDevice {
+public:
+    int reads = 0;
+    int writes = 0;
+
+    bool read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len) override {
+        if (addr != 0x68 || reg != 0x0C || len != 12) {
+            return false;
+        }
+        reads++;
+        const float acc_lsb = 4.0f / 32768.0f;
+        const float gyr_lsb = 2000.0f / 32768.0f;
+        put(&buf[0], IMU.mock_ax / acc_lsb);
+        put(&buf[2], IMU.mock_ay / acc_lsb);
+        put(&buf[4], IMU.mock_az / acc_lsb);
+        put(&buf[6], IMU.mock_gx / gyr_lsb);
+        put(&buf[8], IMU.mock_gy / gyr_lsb);
+        put(&buf[10], IMU.mock_gz / gyr_lsb);
+        return true;
+    }
+
+    bool write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *buf, size_t len) override {
+        writes++;
+        return addr == 0x68;
+    }
+
+private:
+    static void put(std::uint8_t *p, float v) {
+        std::int16_t raw = static_cast<std::int16_t>(lroundf(v));
+        p[0] = static_cast<std::uint8_t>(raw & 0xff);
+        p[1] = static_cast<std::uint8_t>((raw >> 8) & 0xff);
+    }
+};
+
+MockBmi270Registers mock_bmi270;
 
 // Mock Arduino functions
 unsigned long mock_millis_value = 0;
@@ -92,6 +140,13 @@ bool floatNear(float a, float b, float epsilon = 0.0001f) {
     return fabs(a - b) < epsilon;
 }
 
+// Helper to raise a data ready interrupt and let the handler service it
+void sample(RRImuOpHandlerTestable &handler) {
+    mock_interrupt.fire();
+    handler.service();
+    rr_sensor_bus::SensorBus::get_instance().poll();
+}
+
 // Helper to verify quaternion is normalized
 bool isQuaternionNormalized(float qw, float qx, float qy, float qz, float epsilon = 0.01f) {
     float magnitude = sqrt(qw*qw + qx*qx + qy*qy + qz*qz);
@@ -375,8 +430,8 @@ void test_perform_op_service_unavailable(void) {
     RRImuOpHandlerTestable handler;
     handler.init();
 
-    // Make IMU unavailable
-    IMU.accel_available = false;
+    // data ready interrupts stop arriving
+    mock_millis_value += RR_IMU_STALE_MS + 1;
 
     // Create monitor request
     org_ryderrobots_ros2_serial_Request request = org_ryderrobots_ros2_serial_Request_init_zero;
@@ -393,8 +448,75 @@ void test_perform_op_service_unavailable(void) {
                 response.data.bad_request.etype);
     TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE, handler.status());
 
-    // Restore for other tests
-    IMU.accel_available = true;
+    // recovers once samples arrive again
+    sample(handler);
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Status_READY, handler.status());
+}
+
+void test_data_ready_interrupt_attached(void) {
+    RRImuOpHandlerTestable handler;
+    mock_interrupt = MockInterrupt();
+    handler.init();
+
+    TEST_ASSERT_NOT_NULL(mock_interrupt.isr);
+    TEST_ASSERT_EQUAL(RR_IMU_INT_PIN, mock_interrupt.pin);
+    TEST_ASSERT_EQUAL(RISING, mock_interrupt.mode);
+}
+
+void test_sample_read_waits_for_bus(void) {
+    RRImuOpHandlerTestable handler;
+    handler.init();
+    TEST_ASSERT_TRUE(handler.configure(100, 100));
+
+    org_ryderrobots_ros2_serial_Request request = org_ryderrobots_ros2_serial_Request_init_zero;
+    request.op = rr_ble::rr_op_code_t::MSP_RAW_IMU;
+    request.data.monitor.is_request = true;
+    request.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+    org_ryderrobots_ros2_serial_Response response = org_ryderrobots_ros2_serial_Response_init_zero;
+
+    // service() only queues the burst read, the sample lands when the bus is polled
+    IMU.mock_gx = 0.48828125f;
+    mock_interrupt.fire();
+    handler.service();
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.0f));
+
+    rr_sensor_bus::SensorBus::get_instance().poll();
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.48828125f));
+}
+
+void test_service_reads_once_per_interrupt(void) {
+    RRImuOpHandlerTestable handler;
+    handler.init();
+    TEST_ASSERT_TRUE(handler.configure(100, 100));
+
+    org_ryderrobots_ros2_serial_Request request = org_ryderrobots_ros2_serial_Request_init_zero;
+    request.op = rr_ble::rr_op_code_t::MSP_RAW_IMU;
+    request.data.monitor.is_request = true;
+    request.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+    org_ryderrobots_ros2_serial_Response response = org_ryderrobots_ros2_serial_Response_init_zero;
+
+    mock_bmi270.reads = 0;
+    IMU.mock_gx = 0.48828125f;
+    sample(handler);
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.48828125f));
+
+    // no interrupt, no read, even though the sensor has new data
+    IMU.mock_gx = 0.732421875f;
+    handler.service();
+    rr_sensor_bus::SensorBus::get_instance().poll();
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.48828125f));
+
+    // two interrupts before service, one read and one missed sample
+    mock_interrupt.fire();
+    sample(handler);
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.732421875f));
+    TEST_ASSERT_EQUAL(1, handler.handler_.missed_samples());
+    TEST_ASSERT_EQUAL(2, mock_bmi270.reads);
 }
 
 void test_perform_op_unknown_operation(void) {
@@ -435,6 +557,7 @@ void test_filter_update_rate_limiting(void) {
     request.data.monitor.is_request = true;
     request.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
 
+    sample(handler);
     org_ryderrobots_ros2_serial_Response response1 = org_ryderrobots_ros2_serial_Response_init_zero;
     handler.monitor(request, response1);
 
@@ -447,6 +570,7 @@ void test_filter_update_rate_limiting(void) {
     // Advance time past update interval
     mock_millis_value += 10;
 
+    sample(handler);
     org_ryderrobots_ros2_serial_Response response3 = org_ryderrobots_ros2_serial_Response_init_zero;
     handler.monitor(request, response3);
 
@@ -456,13 +580,131 @@ void test_filter_update_rate_limiting(void) {
     TEST_ASSERT_TRUE(response3.data.msp_raw_imu.has_orientation);
 }
 
+void test_configure_rejects_unsupported_rates(void) {
+    RRImuOpHandlerTestable handler;
+    handler.init();
+
+    TEST_ASSERT_TRUE(handler.configure(800, 100));
+    TEST_ASSERT_TRUE(handler.configure(1600, 200));
+    TEST_ASSERT_TRUE(handler.configure(100, 100));
+
+    // sensor ODR not supported by BMI270
+    TEST_ASSERT_FALSE(handler.configure(300, 100));
+    // output must divide ODR
+    TEST_ASSERT_FALSE(handler.configure(400, 150));
+    // output faster than sensor
+    TEST_ASSERT_FALSE(handler.configure(200, 400));
+    // decimation beyond RR_IMU_MAX_DECIMATION
+    TEST_ASSERT_FALSE(handler.configure(1600, 50));
+    TEST_ASSERT_FALSE(handler.configure(400, 0));
+}
+
+void test_perform_ext_sets_imu_rate(void) {
+    RRImuOpHandlerTestable handler;
+    handler.init();
+
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.has_imu_rate = true;
+    ereq.imu_rate.sensor_odr_hz = 800;
+    ereq.imu_rate.output_hz = 100;
+    handler.perform_ext(ereq, eres);
+    TEST_ASSERT_TRUE(eres.has_imu);
+    TEST_ASSERT_TRUE(eres.imu.accepted);
+    TEST_ASSERT_EQUAL_UINT32(800, eres.imu.sensor_odr_hz);
+    TEST_ASSERT_EQUAL_UINT32(100, eres.imu.output_hz);
+
+    // unsupported rates are rejected and the rates in use kept
+    eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.imu_rate.sensor_odr_hz = 300;
+    handler.perform_ext(ereq, eres);
+    TEST_ASSERT_FALSE(eres.imu.accepted);
+    TEST_ASSERT_EQUAL_UINT32(800, eres.imu.sensor_odr_hz);
+    TEST_ASSERT_EQUAL_UINT32(100, eres.imu.output_hz);
+
+    eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.imu_rate.sensor_odr_hz = 0x10000 + 800;
+    handler.perform_ext(ereq, eres);
+    TEST_ASSERT_FALSE(eres.imu.accepted);
+
+    // without imu_rate the rates are only reported
+    eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.has_imu_rate = false;
+    handler.perform_ext(ereq, eres);
+    TEST_ASSERT_TRUE(eres.has_imu);
+    TEST_ASSERT_FALSE(eres.imu.accepted);
+    TEST_ASSERT_EQUAL_UINT32(800, eres.imu.sensor_odr_hz);
+}
+
+void test_service_decimates_to_output_rate(void) {
+    RRImuOpHandlerTestable handler;
+    handler.init();
+    TEST_ASSERT_TRUE(handler.configure(800, 100));
+
+    // multiples of the sensor LSB, so that values survive the raw register round trip
+    IMU.mock_gx = 0.48828125f;
+    IMU.mock_gy = 0.9765625f;
+    IMU.mock_gz = 1.953125f;
+    IMU.mock_ax = 0.0f;
+    IMU.mock_ay = 0.0f;
+    IMU.mock_az = 1.0f;
+
+    org_ryderrobots_ros2_serial_Request request = org_ryderrobots_ros2_serial_Request_init_zero;
+    request.op = rr_ble::rr_op_code_t::MSP_RAW_IMU;
+    request.data.monitor.is_request = true;
+    request.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+
+    // nothing has been sampled yet, monitor must not read the sensor itself
+    org_ryderrobots_ros2_serial_Response response = org_ryderrobots_ros2_serial_Response_init_zero;
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.0f));
+
+    // one second of sensor samples, the decimated output settles on the input
+    for (int i = 0; i < 800; i++) {
+        sample(handler);
+    }
+    handler.perform_op(request, response);
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.x, 0.48828125f, 0.001f));
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.angular_velocity.z, 1.953125f, 0.001f));
+    TEST_ASSERT_TRUE(floatNear(response.data.msp_raw_imu.linear_acceleration.z, 1.0f, 0.001f));
+}
+
+void test_read_heading_follows_filter_and_goes_stale(void) {
+    RRImuOpHandlerTestable handler;
+    handler.init();
+    TEST_ASSERT_TRUE(handler.configure(800, 100));
+
+    IMU.mock_gx = 0.0f;
+    IMU.mock_gy = 0.0f;
+    IMU.mock_gz = 1.953125f;
+    IMU.mock_ax = 0.0f;
+    IMU.mock_ay = 0.0f;
+    IMU.mock_az = 1.0f;
+
+    for (int i = 0; i < 80; i++) {
+        sample(handler);
+    }
+
+    float yaw = 1.0f;
+    float rate = 0.0f;
+    TEST_ASSERT_TRUE(handler.handler_.read_heading(yaw, rate));
+    TEST_ASSERT_TRUE(floatNear(yaw, 0.0f));
+    TEST_ASSERT_TRUE(floatNear(rate, 1.953125f * 3.14159265f / 180.0f, 0.0001f));
+
+    // no samples for longer than RR_IMU_STALE_MS, the heading must not be used
+    mock_millis_value += RR_IMU_STALE_MS + 1;
+    TEST_ASSERT_FALSE(handler.handler_.read_heading(yaw, rate));
+}
+
 // ============================================================================
 // Test Setup and Loop
 // ============================================================================
 
 // Unity test runner
 void setUp(void) {
-    // Set up code before each test if needed
+    // attach the register model, and drain anything a previous test left queued
+    rr_sensor_bus::SensorBus::get_instance().attach_mock(&mock_bmi270);
+    rr_sensor_bus::SensorBus::get_instance().poll();
 }
 
 void tearDown(void) {
@@ -492,8 +734,15 @@ int main(void) {
     RUN_TEST(test_monitor_function_creates_valid_response);
     RUN_TEST(test_perform_op_with_monitor_request);
     RUN_TEST(test_perform_op_service_unavailable);
+    RUN_TEST(test_data_ready_interrupt_attached);
+    RUN_TEST(test_sample_read_waits_for_bus);
+    RUN_TEST(test_service_reads_once_per_interrupt);
     RUN_TEST(test_perform_op_unknown_operation);
     RUN_TEST(test_filter_update_rate_limiting);
+    RUN_TEST(test_configure_rejects_unsupported_rates);
+    RUN_TEST(test_perform_ext_sets_imu_rate);
+    RUN_TEST(test_service_decimates_to_output_rate);
+    RUN_TEST(test_read_heading_follows_filter_and_goes_stale);
 
     return UNITY_END();
 }
@@ -0,0 +1,242 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <rr_log.hpp>
+#include <rr_log_file.hpp>
+
+using namespace rr_log;
+
+static std::uint8_t buffer[1 << 20];
+
+void test_round_trip(void)
+{
+    BufferSink sink(buffer, sizeof(buffer));
+    Writer writer(sink);
+    TEST_ASSERT_TRUE(writer.begin(250));
+
+    const std::uint8_t frame[] = {0x08, 0x66, 0x1E};
+    const char note[] = "start";
+    TEST_ASSERT_TRUE(writer.append(RT_RX, 0, 1000, frame, sizeof(frame)));
+    TEST_ASSERT_TRUE(writer.append(RT_ECHO, 5, 0x123456789ULL, nullptr, 0));
+    TEST_ASSERT_TRUE(writer.append(RT_NOTE, 0, 0x123456789ULL, note, std::strlen(note)));
+    TEST_ASSERT_EQUAL_UINT64(3, writer.records());
+
+    // records padded to 4 bytes, so every record header is aligned in a mapped file.
+    TEST_ASSERT_EQUAL(HEADER_LEN + 16 + 12 + 20, sink.size());
+    TEST_ASSERT_EQUAL_UINT64(sink.size(), writer.bytes());
+
+    Reader reader(sink.data(), sink.size());
+    TEST_ASSERT_TRUE(reader.valid());
+    TEST_ASSERT_EQUAL_UINT32(250, reader.step_us());
+
+    Record r;
+    TEST_ASSERT_TRUE(reader.next(r));
+    TEST_ASSERT_EQUAL(RT_RX, r.type);
+    TEST_ASSERT_EQUAL_UINT64(1000, r.time_us);
+    TEST_ASSERT_EQUAL(sizeof(frame), r.length);
+    TEST_ASSERT_EQUAL_MEMORY(frame, r.payload, sizeof(frame));
+    TEST_ASSERT_EQUAL(0, (r.payload - sink.data()) % 4);
+
+    TEST_ASSERT_TRUE(reader.next(r));
+    TEST_ASSERT_EQUAL(RT_ECHO, r.type);
+    TEST_ASSERT_EQUAL(5, r.channel);
+    TEST_ASSERT_EQUAL_UINT64(0x123456789ULL, r.time_us);
+    TEST_ASSERT_EQUAL(0, r.length);
+
+    // peek does not move on.
+    Record p;
+    TEST_ASSERT_TRUE(reader.peek(p));
+    TEST_ASSERT_TRUE(reader.next(r));
+    TEST_ASSERT_EQUAL_PTR(p.payload, r.payload);
+    TEST_ASSERT_EQUAL_MEMORY(note, r.payload, 5);
+
+    TEST_ASSERT_FALSE(reader.next(r));
+    TEST_ASSERT_FALSE(reader.truncated());
+
+    reader.rewind();
+    TEST_ASSERT_TRUE(reader.next(r));
+    TEST_ASSERT_EQUAL(RT_RX, r.type);
+}
+
+void test_little_endian_fields(void)
+{
+    std::uint8_t out[4];
+    put_u32(out, 0x11223344);
+    TEST_ASSERT_EQUAL_HEX8(0x44, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, out[3]);
+    TEST_ASSERT_EQUAL_UINT32(0x11223344, get_u32(out));
+
+    BufferSink sink(buffer, sizeof(buffer));
+    Writer writer(sink);
+    writer.begin(0);
+    writer.append(RT_IMU, 2, 0x0102030405060708ULL, nullptr, 0);
+    const std::uint8_t expected[] = {'R', 'R', 'L', 'G', 1, 0, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                     0, 0, RT_IMU, 2, 8, 7, 6, 5, 4, 3, 2, 1};
+    TEST_ASSERT_EQUAL(sizeof(expected), sink.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, sink.data(), sizeof(expected));
+}
+
+void test_cut_short_log_ends_at_last_whole_record(void)
+{
+    BufferSink sink(buffer, sizeof(buffer));
+    Writer writer(sink);
+    writer.begin(0);
+    const std::uint8_t burst[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    writer.append(RT_IMU, 0, 10, burst, sizeof(burst));
+    writer.append(RT_IMU, 0, 20, burst, sizeof(burst));
+
+    // every cut inside the second record reads the first one only.
+    size_t whole = HEADER_LEN + record_len(sizeof(burst));
+    for (size_t cut = whole + 1; cut < sink.size(); cut++)
+    {
+        Reader reader(sink.data(), cut);
+        Record r;
+        TEST_ASSERT_TRUE(reader.next(r));
+        TEST_ASSERT_EQUAL_UINT64(10, r.time_us);
+        TEST_ASSERT_FALSE(reader.next(r));
+        TEST_ASSERT_TRUE(reader.truncated());
+    }
+}
+
+void test_not_a_log(void)
+{
+    const std::uint8_t other[HEADER_LEN] = {'R', 'R', 'L', 'G', 2, 0, 16, 0};
+    Reader newer(other, sizeof(other));
+    TEST_ASSERT_FALSE(newer.valid());
+    Record r;
+    TEST_ASSERT_FALSE(newer.next(r));
+
+    Reader short_header(other, 8);
+    TEST_ASSERT_FALSE(short_header.valid());
+    Reader none(nullptr, 0);
+    TEST_ASSERT_FALSE(none.valid());
+}
+
+void test_full_sink_counts_failures(void)
+{
+    std::uint8_t small[HEADER_LEN + 16];
+    BufferSink sink(small, sizeof(small));
+    Writer writer(sink);
+    TEST_ASSERT_TRUE(writer.begin(0));
+    const std::uint8_t frame[4] = {0};
+    TEST_ASSERT_TRUE(writer.append(RT_TX, 0, 1, frame, sizeof(frame)));
+    TEST_ASSERT_FALSE(writer.append(RT_TX, 0, 2, frame, sizeof(frame)));
+    TEST_ASSERT_FALSE(writer.append(RT_TX, 0, 3, buffer, MAX_PAYLOAD + 1));
+    TEST_ASSERT_EQUAL_UINT64(1, writer.records());
+    TEST_ASSERT_EQUAL_UINT64(2, writer.failed());
+
+    // what was written is still a whole log.
+    Reader reader(sink.data(), sink.size());
+    Record r;
+    TEST_ASSERT_TRUE(reader.next(r));
+    TEST_ASSERT_FALSE(reader.next(r));
+    TEST_ASSERT_FALSE(reader.truncated());
+}
+
+void test_file_round_trip_at_imu_rate(void)
+{
+    // a minute of 400 Hz IMU bursts, with encoder edges at 1 kHz, through a file and back out of a mapping.
+    char path[] = "/tmp/test_rr_log_XXXXXX";
+    int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    std::fclose(fdopen(fd, "w"));
+
+    FileSink file;
+    TEST_ASSERT_TRUE(file.open(path));
+    Writer writer(file);
+    writer.begin(100);
+    std::uint8_t burst[12];
+    std::uint8_t edges[8];
+    std::uint64_t imu = 0;
+    for (std::uint64_t us = 0; us < 60000000; us += 500)
+    {
+        if (us % 2500 == 0)
+        {
+            std::memset(burst, static_cast<int>(imu & 0xFF), sizeof(burst));
+            TEST_ASSERT_TRUE(writer.append(RT_IMU, 0, us, burst, sizeof(burst)));
+            imu++;
+        }
+        if (us % 1000 == 0)
+        {
+            put_u32(edges, 3);
+            put_u32(edges + 4, 4);
+            TEST_ASSERT_TRUE(writer.append(RT_EDGES, 0, us, edges, sizeof(edges)));
+        }
+    }
+    TEST_ASSERT_TRUE(file.close());
+    TEST_ASSERT_EQUAL_UINT64(24000 + 60000, writer.records());
+    TEST_ASSERT_EQUAL_UINT64(0, writer.failed());
+
+    MappedFile mapped;
+    TEST_ASSERT_TRUE(mapped.open(path));
+    TEST_ASSERT_EQUAL_UINT64(writer.bytes(), mapped.size());
+    Reader reader(mapped.data(), mapped.size());
+    TEST_ASSERT_EQUAL_UINT32(100, reader.step_us());
+    Record r;
+    std::uint64_t bursts = 0;
+    std::uint64_t last_us = 0;
+    std::uint32_t left = 0;
+    while (reader.next(r))
+    {
+        TEST_ASSERT_TRUE(r.time_us >= last_us);
+        last_us = r.time_us;
+        if (r.type == RT_IMU)
+        {
+            TEST_ASSERT_EQUAL_HEX8(bursts & 0xFF, r.payload[11]);
+            bursts++;
+        }
+        else if (r.type == RT_EDGES)
+        {
+            left += get_u32(r.payload);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT64(24000, bursts);
+    TEST_ASSERT_EQUAL_UINT32(180000, left);
+    TEST_ASSERT_FALSE(reader.truncated());
+    mapped.close();
+    std::remove(path);
+}
+
+void setUp(void) {
+    // Set up code if needed
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_little_endian_fields);
+    RUN_TEST(test_cut_short_log_ends_at_last_whole_record);
+    RUN_TEST(test_not_a_log);
+    RUN_TEST(test_full_sink_counts_failures);
+    RUN_TEST(test_file_round_trip_at_imu_rate);
+    return UNITY_END();
+}
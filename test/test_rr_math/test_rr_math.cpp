@@ -0,0 +1,203 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+#include <rr_math.hpp>
+
+using namespace rr_math;
+
+// error bounds, measured values are recorded in README.md
+static constexpr double INV_SQRT_REL_BOUND = 5e-6;
+static constexpr double SIN_COS_ABS_BOUND = 4e-6;
+static constexpr double ATAN2_ABS_BOUND = 1.2e-5;
+
+// keeps benchmark loops from being optimised away
+static volatile float sink;
+
+// ============================================================================
+// Error bounds
+// ============================================================================
+
+void test_inv_sqrt_error_bound(void)
+{
+    double worst = 0;
+    for (float x = 1e-6f; x < 1e6f; x *= 1.001f)
+    {
+        double ref = 1.0 / std::sqrt(static_cast<double>(x));
+        double err = std::fabs(inv_sqrt(x) - ref) / ref;
+        worst = err > worst ? err : worst;
+
+        err = std::fabs(portable::inv_sqrt(x) - ref) / ref;
+        worst = err > worst ? err : worst;
+    }
+    printf("inv_sqrt max relative error: %.3g\n", worst);
+    TEST_ASSERT_TRUE(worst < INV_SQRT_REL_BOUND);
+}
+
+void test_inv_sqrt_non_positive(void)
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, inv_sqrt(0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, inv_sqrt(-1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, rr_math::sqrt(-1.0f));
+}
+
+void test_sin_cos_error_bound(void)
+{
+    double worst = 0;
+    for (float a = -20.0f; a < 20.0f; a += 1e-3f)
+    {
+        float s, c;
+        sin_cos(a, &s, &c);
+        double es = std::fabs(s - std::sin(static_cast<double>(a)));
+        double ec = std::fabs(c - std::cos(static_cast<double>(a)));
+        worst = es > worst ? es : worst;
+        worst = ec > worst ? ec : worst;
+    }
+    printf("sin_cos max absolute error: %.3g\n", worst);
+    TEST_ASSERT_TRUE(worst < SIN_COS_ABS_BOUND);
+}
+
+void test_atan2_error_bound(void)
+{
+    double worst = 0;
+    for (float t = -3.14159f; t < 3.14159f; t += 1e-3f)
+    {
+        for (float r = 0.01f; r < 100.0f; r *= 10.0f)
+        {
+            float y = r * std::sin(t);
+            float x = r * std::cos(t);
+            double err = std::fabs(rr_math::atan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x)));
+            worst = err > worst ? err : worst;
+        }
+    }
+    printf("atan2 max absolute error: %.3g\n", worst);
+    TEST_ASSERT_TRUE(worst < ATAN2_ABS_BOUND);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, rr_math::atan2(0.0f, 0.0f));
+}
+
+// ============================================================================
+// Vector and quaternion kernels
+// ============================================================================
+
+void test_normalise_vec3(void)
+{
+    Vec3 v = {3.0f, 0.0f, 4.0f};
+    TEST_ASSERT_TRUE(normalise(v));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.6f, v.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.8f, v.z);
+
+    Vec3 zero = {0.0f, 0.0f, 0.0f};
+    TEST_ASSERT_FALSE(normalise(zero));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, zero.x);
+}
+
+void test_multiply_quaternion(void)
+{
+    // 90 degree rotations about z composed twice is 180 degrees about z
+    float s, c;
+    sin_cos(HALF_PI * 0.5f, &s, &c);
+    Quat q = {c, 0.0f, 0.0f, s};
+    Quat r = multiply(q, q);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, r.w);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, r.z);
+
+    // i * j = k
+    Quat i = {0.0f, 1.0f, 0.0f, 0.0f};
+    Quat j = {0.0f, 0.0f, 1.0f, 0.0f};
+    Quat k = multiply(i, j);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, k.z);
+}
+
+void test_integrate_quaternion(void)
+{
+    // 1 rad/s about z for one second, at 1kHz
+    Quat q = {1.0f, 0.0f, 0.0f, 0.0f};
+    Vec3 w = {0.0f, 0.0f, 1.0f};
+    for (int i = 0; i < 1000; i++)
+    {
+        integrate(q, w, 0.001f);
+    }
+    float yaw = 2.0f * rr_math::atan2(q.z, q.w);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.0f, yaw);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.0f, q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+}
+
+// ============================================================================
+// Benchmark, kernels against libm
+// ============================================================================
+
+template <typename F>
+static double ns_per_op(F fn, int iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        fn(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+void test_benchmark_kernels(void)
+{
+    const int n = 1000000;
+    double kernel, libm;
+
+    kernel = ns_per_op([](int i) { sink = inv_sqrt(1.0f + static_cast<float>(i)); }, n);
+    libm = ns_per_op([](int i) { sink = 1.0f / sqrtf(1.0f + static_cast<float>(i)); }, n);
+    printf("inv_sqrt   kernel %6.2f ns  libm %6.2f ns\n", kernel, libm);
+
+    kernel = ns_per_op([](int i) { float s, c; sin_cos(static_cast<float>(i) * 1e-5f, &s, &c); sink = s + c; }, n);
+    libm = ns_per_op([](int i) { float a = static_cast<float>(i) * 1e-5f; sink = sinf(a) + cosf(a); }, n);
+    printf("sin_cos    kernel %6.2f ns  libm %6.2f ns\n", kernel, libm);
+
+    kernel = ns_per_op([](int i) { sink = rr_math::atan2(static_cast<float>(i & 0xff) - 128.0f, 1.0f + (i >> 8)); }, n);
+    libm = ns_per_op([](int i) { sink = atan2f(static_cast<float>(i & 0xff) - 128.0f, 1.0f + (i >> 8)); }, n);
+    printf("atan2      kernel %6.2f ns  libm %6.2f ns\n", kernel, libm);
+
+    TEST_ASSERT_TRUE(kernel > 0.0);
+}
+
+void setUp(void) {
+    // Set up code if needed
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_inv_sqrt_error_bound);
+    RUN_TEST(test_inv_sqrt_non_positive);
+    RUN_TEST(test_sin_cos_error_bound);
+    RUN_TEST(test_atan2_error_bound);
+    RUN_TEST(test_normalise_vec3);
+    RUN_TEST(test_multiply_quaternion);
+    RUN_TEST(test_integrate_quaternion);
+    RUN_TEST(test_benchmark_kernels);
+    return UNITY_END();
+}
@@ -0,0 +1,755 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <rr_math.hpp>
+#include <rr_maze.hpp>
+#include <rr_plan.hpp>
+
+using namespace rr_maze;
+
+static Solver solver;
+static Planner planner;
+
+static const float CELL = 0.18f;
+
+// ============================================================================
+// Maze generators
+// ============================================================================
+
+static std::uint32_t lcg_state;
+
+static std::uint32_t lcg()
+{
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return lcg_state >> 8;
+}
+
+static void all_walls(MazeMap &maze)
+{
+    maze.clear();
+    for (std::uint8_t y = 0; y < SIZE; y++)
+    {
+        for (std::uint8_t x = 0; x < SIZE; x++)
+        {
+            maze.set(x, y, H_NORTH, true);
+            maze.set(x, y, H_EAST, true);
+        }
+    }
+}
+
+static bool step_to(std::uint8_t x, std::uint8_t y, Heading h, std::uint8_t &nx, std::uint8_t &ny)
+{
+    static const int DX[] = {0, 1, 0, -1};
+    static const int DY[] = {1, 0, -1, 0};
+    int tx = x + DX[h], ty = y + DY[h];
+    if (tx < 0 || ty < 0 || tx >= SIZE || ty >= SIZE)
+    {
+        return false;
+    }
+    nx = static_cast<std::uint8_t>(tx);
+    ny = static_cast<std::uint8_t>(ty);
+    return true;
+}
+
+// recursive backtracker, long winding corridors, then a few walls knocked out to add loops.
+static void random_maze(MazeMap &maze, std::uint32_t seed, int loops)
+{
+    lcg_state = seed;
+    all_walls(maze);
+    static std::uint8_t stack[CELLS];
+    bool visited[CELLS] = {false};
+    int top = 0;
+    stack[top++] = 0;
+    visited[0] = true;
+    while (top > 0)
+    {
+        std::uint8_t c = stack[top - 1];
+        std::uint8_t x = c & 15, y = c >> 4;
+        Heading options[4];
+        int n = 0;
+        for (std::uint8_t h = H_NORTH; h <= H_WEST; h++)
+        {
+            std::uint8_t nx, ny;
+            if (step_to(x, y, static_cast<Heading>(h), nx, ny) && !visited[ny * SIZE + nx])
+            {
+                options[n++] = static_cast<Heading>(h);
+            }
+        }
+        if (n == 0)
+        {
+            top--;
+            continue;
+        }
+        Heading h = options[lcg() % n];
+        std::uint8_t nx = 0, ny = 0;
+        step_to(x, y, h, nx, ny);
+        maze.set(x, y, h, false);
+        visited[ny * SIZE + nx] = true;
+        stack[top++] = static_cast<std::uint8_t>(ny * SIZE + nx);
+    }
+    for (int i = 0; i < loops; i++)
+    {
+        maze.set(lcg() % SIZE, lcg() % (SIZE - 1), H_NORTH, false);
+    }
+}
+
+// rows joined alternately at the east and west ends, one path through every cell.
+static void serpentine(MazeMap &maze)
+{
+    all_walls(maze);
+    for (std::uint8_t y = 0; y < SIZE; y++)
+    {
+        for (std::uint8_t x = 0; x + 1 < SIZE; x++)
+        {
+            maze.set(x, y, H_EAST, false);
+        }
+        if (y + 1 < SIZE)
+        {
+            maze.set((y & 1) ? 0 : SIZE - 1, y, H_NORTH, false);
+        }
+    }
+}
+
+// every side seen, and open.
+static void open_maze(MazeMap &maze)
+{
+    maze.clear();
+    for (std::uint8_t y = 0; y < SIZE; y++)
+    {
+        for (std::uint8_t x = 0; x < SIZE; x++)
+        {
+            maze.set(x, y, H_NORTH, false);
+            maze.set(x, y, H_EAST, false);
+        }
+    }
+}
+
+static Costs slow_diagonals()
+{
+    return {{2.0f, 4.0f, 0.0f}, {0.05f, 4.0f, 0.0f}, {10.0f, 60.0f, 0.0f}, 0.02f};
+}
+
+static Costs fast_diagonals()
+{
+    return {{2.0f, 4.0f, 0.0f}, {2.0f, 4.0f, 0.0f}, {20.0f, 200.0f, 0.0f}, 0.0f};
+}
+
+// drives the plan from the middle of cell (x, y) facing heading, in 1mm steps. Fails if it crosses a side that
+// is not open, or passes a post, and returns the cell it ends in.
+static void drive(const MazeMap &maze, std::uint8_t x, std::uint8_t y, Heading heading, std::uint8_t &end_x, std::uint8_t &end_y)
+{
+    static const float HEADINGS[] = {rr_math::HALF_PI, 0.0f, -rr_math::HALF_PI, rr_math::PI};
+    float px = (x + 0.5f) * CELL, py = (y + 0.5f) * CELL, theta = HEADINGS[heading];
+    int cx = x, cy = y;
+    for (size_t i = 0; i < planner.count(); i++)
+    {
+        const Segment &seg = planner.segment(i);
+        if (seg.kind == S_TURN)
+        {
+            theta += seg.distance;
+            continue;
+        }
+        TEST_ASSERT_TRUE(seg.distance > 0.0f);
+        int steps = static_cast<int>(std::lround(seg.distance / 0.001f));
+        float sx = std::cos(theta) * seg.distance / steps, sy = std::sin(theta) * seg.distance / steps;
+        for (int n = 0; n < steps; n++)
+        {
+            px += sx;
+            py += sy;
+            int nx = static_cast<int>(std::floor(px / CELL)), ny = static_cast<int>(std::floor(py / CELL));
+            if (nx == cx && ny == cy)
+            {
+                continue;
+            }
+            TEST_ASSERT_TRUE(nx == cx || ny == cy);
+            Heading side = nx > cx ? H_EAST : (nx < cx ? H_WEST : (ny > cy ? H_NORTH : H_SOUTH));
+            TEST_ASSERT_TRUE(maze.seen(cx, cy, side));
+            TEST_ASSERT_FALSE(maze.wall(cx, cy, side));
+            cx = nx;
+            cy = ny;
+        }
+    }
+
+    // and it stops in the middle of the cell.
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, (cx + 0.5f) * CELL, px);
+    TEST_ASSERT_FLOAT_WITHIN(0.002f, (cy + 0.5f) * CELL, py);
+    end_x = static_cast<std::uint8_t>(cx);
+    end_y = static_cast<std::uint8_t>(cy);
+}
+
+static size_t count_kind(SegmentKind kind)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < planner.count(); i++)
+    {
+        n += planner.segment(i).kind == kind;
+    }
+    return n;
+}
+
+static void feed(Solver &s, const MazeMap &truth, std::uint8_t x, std::uint8_t y)
+{
+    rr_walls::CellWalls c = truth.cell(x, y);
+    c.seen = 0x0f;
+    s.update(c);
+}
+
+static void assert_matches_flood(const Solver &s)
+{
+    static Solver reference;
+    reference = s;
+    reference.flood();
+    for (std::uint8_t y = 0; y < SIZE; y++)
+    {
+        for (std::uint8_t x = 0; x < SIZE; x++)
+        {
+            if (reference.distance(x, y) != s.distance(x, y))
+            {
+                printf("cell (%u, %u) incremental %u flood %u\n", x, y, s.distance(x, y), reference.distance(x, y));
+            }
+            TEST_ASSERT_EQUAL_UINT16(reference.distance(x, y), s.distance(x, y));
+        }
+    }
+}
+
+// ============================================================================
+// Map
+// ============================================================================
+
+void test_map_shares_walls_between_cells(void)
+{
+    MazeMap maze;
+    TEST_ASSERT_TRUE(maze.set(3, 4, H_NORTH, true));
+    TEST_ASSERT_TRUE(maze.wall(3, 5, H_SOUTH));
+    TEST_ASSERT_TRUE(maze.seen(3, 5, H_SOUTH));
+    TEST_ASSERT_FALSE(maze.set(3, 5, H_SOUTH, true));
+
+    TEST_ASSERT_TRUE(maze.set(3, 4, H_EAST, false));
+    TEST_ASSERT_FALSE(maze.wall(4, 4, H_WEST));
+    TEST_ASSERT_TRUE(maze.seen(4, 4, H_WEST));
+
+    rr_walls::CellWalls c = maze.cell(3, 4);
+    TEST_ASSERT_EQUAL_UINT8(rr_walls::NORTH, c.walls);
+    TEST_ASSERT_EQUAL_UINT8(rr_walls::NORTH | rr_walls::EAST, c.seen);
+}
+
+void test_map_outer_walls_are_fixed(void)
+{
+    MazeMap maze;
+    rr_walls::CellWalls corner = maze.cell(0, 0);
+    TEST_ASSERT_EQUAL_UINT8(rr_walls::SOUTH | rr_walls::WEST, corner.walls);
+    TEST_ASSERT_EQUAL_UINT8(rr_walls::SOUTH | rr_walls::WEST, corner.seen);
+    TEST_ASSERT_FALSE(maze.set(0, 0, H_WEST, false));
+    TEST_ASSERT_FALSE(maze.set(15, 15, H_NORTH, false));
+    TEST_ASSERT_TRUE(maze.wall(15, 15, H_NORTH));
+}
+
+void test_map_packs_edges(void)
+{
+    TEST_ASSERT_EQUAL(136, MazeMap::PACKED);
+    TEST_ASSERT_TRUE(sizeof(MazeMap) <= MazeMap::PACKED);
+
+    MazeMap maze;
+    maze.set(9, 0, H_NORTH, true);
+    std::uint8_t packed[MazeMap::PACKED];
+    maze.pack(packed);
+
+    // h_wall row 0 is the south boundary, row 1 holds the wall north of (9, 0).
+    TEST_ASSERT_EQUAL_UINT8(0xff, packed[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, packed[2]);
+    TEST_ASSERT_EQUAL_UINT8(0x02, packed[3]);
+    // h_seen follows, v_wall after it.
+    TEST_ASSERT_EQUAL_UINT8(0x02, packed[(SIZE + 1) * 2 + 3]);
+    TEST_ASSERT_EQUAL_UINT8(0xff, packed[(SIZE + 1) * 4]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, packed[(SIZE + 1) * 4 + 2]);
+}
+
+// ============================================================================
+// Solver
+// ============================================================================
+
+void test_open_maze_is_manhattan_distance(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0, solver.distance(7, 8));
+    TEST_ASSERT_EQUAL_UINT16(14, solver.distance(0, 0));
+    TEST_ASSERT_EQUAL_UINT16(14, solver.distance(15, 15));
+    TEST_ASSERT_EQUAL_UINT16(6, solver.distance(8, 1));
+    TEST_ASSERT_EQUAL_UINT16(4, solver.distance(3, 7));
+}
+
+void test_next_move(void)
+{
+    // from the start cell facing north, straight and right are equally short.
+    Step step = solver.next(0, 0, H_NORTH);
+    TEST_ASSERT_EQUAL(M_FORWARD, step.move);
+    TEST_ASSERT_EQUAL(H_NORTH, step.heading);
+    TEST_ASSERT_EQUAL_UINT8(0, step.x);
+    TEST_ASSERT_EQUAL_UINT8(1, step.y);
+    TEST_ASSERT_EQUAL_UINT16(13, step.distance);
+
+    rr_walls::CellWalls start = {0, 0, rr_walls::NORTH, rr_walls::NORTH};
+    TEST_ASSERT_TRUE(solver.update(start));
+    step = solver.next(0, 0, H_NORTH);
+    TEST_ASSERT_EQUAL(M_RIGHT, step.move);
+    TEST_ASSERT_EQUAL(H_EAST, step.heading);
+
+    // facing away from the goal, turning around is the last resort.
+    step = solver.next(7, 3, H_SOUTH);
+    TEST_ASSERT_EQUAL(M_BACK, step.move);
+    step = solver.next(3, 7, H_SOUTH);
+    TEST_ASSERT_EQUAL(M_LEFT, step.move);
+
+    step = solver.next(8, 8, H_WEST);
+    TEST_ASSERT_EQUAL(M_NONE, step.move);
+    TEST_ASSERT_EQUAL_UINT16(0, step.distance);
+}
+
+void test_wall_raises_only_affected_cells(void)
+{
+    // a wall along the west of the goal, between columns 6 and 7, rows 7 and 8.
+    rr_walls::CellWalls c = {6, 7, rr_walls::EAST, rr_walls::EAST};
+    solver.update(c);
+    // the row west of it now goes round through row 8, one step longer.
+    TEST_ASSERT_EQUAL_UINT16(7, solver.changed());
+    TEST_ASSERT_EQUAL_UINT16(8, solver.distance(0, 7));
+    c = {6, 8, rr_walls::EAST, rr_walls::EAST};
+    solver.update(c);
+    TEST_ASSERT_EQUAL_UINT16(3, solver.distance(6, 8));
+    TEST_ASSERT_EQUAL_UINT16(3, solver.distance(6, 7));
+    TEST_ASSERT_TRUE(solver.changed() < CELLS / 4);
+    assert_matches_flood(solver);
+
+    // nothing new, nothing changes.
+    TEST_ASSERT_FALSE(solver.update(c));
+}
+
+void test_wall_found_open_lowers_distances(void)
+{
+    rr_walls::CellWalls c = {6, 7, rr_walls::EAST, rr_walls::EAST};
+    solver.update(c);
+    c = {6, 8, rr_walls::EAST, rr_walls::EAST};
+    solver.update(c);
+    c = {6, 8, 0, rr_walls::EAST};
+    TEST_ASSERT_TRUE(solver.update(c));
+    TEST_ASSERT_EQUAL_UINT16(1, solver.distance(6, 8));
+    TEST_ASSERT_EQUAL_UINT16(2, solver.distance(6, 7));
+    assert_matches_flood(solver);
+}
+
+void test_enclosed_cell_is_unreachable(void)
+{
+    rr_walls::CellWalls c = {2, 2, 0x0f, 0x0f};
+    solver.update(c);
+    TEST_ASSERT_EQUAL_UINT16(UNREACHABLE, solver.distance(2, 2));
+    TEST_ASSERT_EQUAL(M_NONE, solver.next(2, 2, H_NORTH).move);
+    TEST_ASSERT_EQUAL_UINT16(UNREACHABLE, solver.next(2, 2, H_NORTH).distance);
+    assert_matches_flood(solver);
+
+    // and reachable again once a side opens.
+    c = {2, 2, 0x0e, 0x0f};
+    solver.update(c);
+    TEST_ASSERT_EQUAL_UINT16(solver.distance(2, 3) + 1, solver.distance(2, 2));
+    assert_matches_flood(solver);
+}
+
+void test_incremental_matches_flood_on_random_mazes(void)
+{
+    static MazeMap truth;
+    for (std::uint32_t seed = 1; seed <= 40; seed++)
+    {
+        random_maze(truth, seed, static_cast<int>(seed % 12));
+        solver.reset();
+
+        // explore in a random order, rechecking every distance after each cell.
+        std::uint8_t order[CELLS];
+        for (std::uint16_t i = 0; i < CELLS; i++)
+        {
+            order[i] = static_cast<std::uint8_t>(i);
+        }
+        for (std::uint16_t i = CELLS - 1; i > 0; i--)
+        {
+            std::uint16_t j = lcg() % (i + 1);
+            std::uint8_t t = order[i];
+            order[i] = order[j];
+            order[j] = t;
+        }
+        for (std::uint16_t i = 0; i < CELLS; i++)
+        {
+            feed(solver, truth, order[i] & 15, order[i] >> 4);
+            assert_matches_flood(solver);
+        }
+
+        // a few misread walls corrected afterwards.
+        for (int i = 0; i < 8; i++)
+        {
+            std::uint8_t x = lcg() % SIZE, y = lcg() % SIZE;
+            rr_walls::CellWalls c = truth.cell(x, y);
+            c.walls ^= rr_walls::EAST;
+            c.seen = 0x0f;
+            solver.update(c);
+            assert_matches_flood(solver);
+            feed(solver, truth, x, y);
+            assert_matches_flood(solver);
+        }
+    }
+}
+
+void test_rejects_bad_goal(void)
+{
+    TEST_ASSERT_FALSE(solver.set_goal({15, 15, 2, 1}));
+    TEST_ASSERT_FALSE(solver.set_goal({0, 0, 0, 1}));
+    TEST_ASSERT_FALSE(solver.set_goal({16, 0, 1, 1}));
+    TEST_ASSERT_EQUAL_UINT8(7, solver.goal().x);
+
+    TEST_ASSERT_TRUE(solver.set_goal({0, 0, 1, 1}));
+    TEST_ASSERT_EQUAL_UINT16(30, solver.distance(15, 15));
+}
+
+// ============================================================================
+// Speed run planner
+// ============================================================================
+
+void test_segment_time(void)
+{
+    rr_control::Limits limits = {1.0f, 2.0f, 0.0f};
+    // reaches 1 m/s after 0.25m, cruises 0.5m, brakes.
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.5f, segment_time(1.0f, limits));
+    // too short to reach v_max.
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f * std::sqrt(0.125f), segment_time(0.25f, limits));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.5f, segment_time(-1.0f, limits));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, segment_time(0.0f, limits));
+
+    limits.jerk = 20.0f;
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.6f, segment_time(1.0f, limits));
+}
+
+void test_plan_straight_run(void)
+{
+    MazeMap maze;
+    for (std::uint8_t y = 0; y < 5; y++)
+    {
+        maze.set(0, y, H_NORTH, false);
+    }
+    TEST_ASSERT_TRUE(planner.plan(maze, {0, 5, 1, 1}, 0, 0, H_NORTH));
+    TEST_ASSERT_EQUAL(1, planner.count());
+    TEST_ASSERT_EQUAL(S_STRAIGHT, planner.segment(0).kind);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 5 * CELL, planner.segment(0).distance);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, segment_time(5 * CELL, planner.costs().straight), planner.predicted_s());
+    TEST_ASSERT_EQUAL_UINT16(5, planner.cells());
+
+    // facing the wrong way, it turns around first.
+    TEST_ASSERT_TRUE(planner.plan(maze, {0, 5, 1, 1}, 0, 0, H_SOUTH));
+    TEST_ASSERT_EQUAL(2, planner.count());
+    TEST_ASSERT_EQUAL(S_TURN, planner.segment(0).kind);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, rr_math::PI, std::fabs(planner.segment(0).distance));
+}
+
+void test_plan_uses_only_seen_sides(void)
+{
+    MazeMap maze;
+    TEST_ASSERT_FALSE(planner.plan(maze, {7, 7, 2, 2}, 0, 0, H_NORTH));
+    TEST_ASSERT_FALSE(planner.found());
+    TEST_ASSERT_EQUAL(0, planner.count());
+
+    // already there.
+    TEST_ASSERT_TRUE(planner.plan(maze, {0, 0, 1, 1}, 0, 0, H_NORTH));
+    TEST_ASSERT_EQUAL(0, planner.count());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, planner.predicted_s());
+}
+
+void test_plan_staircase_diagonal_by_cost(void)
+{
+    // a staircase corridor from (0, 0) north, east, north, east ... to (4, 4).
+    MazeMap maze;
+    all_walls(maze);
+    std::uint8_t x = 0, y = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        Heading h = (i & 1) ? H_EAST : H_NORTH;
+        maze.set(x, y, h, false);
+        (i & 1) ? x++ : y++;
+    }
+    std::uint8_t end_x, end_y;
+
+    TEST_ASSERT_TRUE(planner.configure(fast_diagonals(), CELL));
+    TEST_ASSERT_TRUE(planner.plan(maze, {4, 4, 1, 1}, 0, 0, H_NORTH));
+    TEST_ASSERT_EQUAL(1, count_kind(S_DIAGONAL));
+    TEST_ASSERT_EQUAL(2, count_kind(S_TURN));
+    drive(maze, 0, 0, H_NORTH, end_x, end_y);
+    TEST_ASSERT_EQUAL_UINT8(4, end_x);
+    TEST_ASSERT_EQUAL_UINT8(4, end_y);
+    TEST_ASSERT_EQUAL_UINT16(8, planner.cells());
+    float diagonal = planner.predicted_s();
+
+    // crawling diagonals lose to eight corners.
+    TEST_ASSERT_TRUE(planner.configure(slow_diagonals(), CELL));
+    TEST_ASSERT_TRUE(planner.plan(maze, {4, 4, 1, 1}, 0, 0, H_NORTH));
+    TEST_ASSERT_EQUAL(0, count_kind(S_DIAGONAL));
+    TEST_ASSERT_EQUAL(7, count_kind(S_TURN));
+    drive(maze, 0, 0, H_NORTH, end_x, end_y);
+    TEST_ASSERT_EQUAL_UINT8(4, end_x);
+
+    TEST_ASSERT_TRUE(planner.configure(fast_diagonals(), CELL));
+    planner.plan(maze, {4, 4, 1, 1}, 0, 0, H_NORTH);
+    TEST_ASSERT_EQUAL_FLOAT(diagonal, planner.predicted_s());
+}
+
+void test_plan_prefers_fewer_turns_to_fewer_cells(void)
+{
+    // a short path with four corners, and a long one with one.
+    MazeMap maze;
+    all_walls(maze);
+    maze.set(0, 0, H_EAST, false);
+    maze.set(1, 0, H_NORTH, false);
+    maze.set(1, 1, H_EAST, false);
+    maze.set(2, 1, H_NORTH, false);
+    for (std::uint8_t y = 0; y < 6; y++)
+    {
+        maze.set(0, y, H_NORTH, false);
+    }
+    for (std::uint8_t x = 0; x < 2; x++)
+    {
+        maze.set(x, 6, H_EAST, false);
+    }
+    for (std::uint8_t y = 2; y < 6; y++)
+    {
+        maze.set(2, y, H_NORTH, false);
+    }
+    planner.configure(slow_diagonals(), CELL);
+    TEST_ASSERT_TRUE(planner.plan(maze, {2, 2, 1, 1}, 0, 0, H_NORTH));
+    TEST_ASSERT_EQUAL_UINT16(4, planner.cells());
+
+    // with slow turns the straight way round wins.
+    Costs sluggish = slow_diagonals();
+    sluggish.turn_settle_s = 2.0f;
+    planner.configure(sluggish, CELL);
+    TEST_ASSERT_TRUE(planner.plan(maze, {2, 2, 1, 1}, 0, 0, H_NORTH));
+    TEST_ASSERT_EQUAL_UINT16(12, planner.cells());
+    TEST_ASSERT_EQUAL(2, count_kind(S_TURN));
+}
+
+void test_plan_random_mazes_are_drivable(void)
+{
+    static MazeMap truth;
+    planner.configure(fast_diagonals(), CELL);
+    for (std::uint32_t seed = 200; seed < 230; seed++)
+    {
+        random_maze(truth, seed, 20);
+        TEST_ASSERT_TRUE(planner.plan(truth, {7, 7, 2, 2}, 0, 0, H_NORTH));
+        std::uint8_t end_x, end_y;
+        drive(truth, 0, 0, H_NORTH, end_x, end_y);
+        TEST_ASSERT_TRUE(end_x >= 7 && end_x <= 8 && end_y >= 7 && end_y <= 8);
+        TEST_ASSERT_TRUE(planner.predicted_s() > 0.0f);
+    }
+}
+
+void test_plan_rejects_bad_costs(void)
+{
+    Costs bad = fast_diagonals();
+    bad.diagonal.accel = 0.0f;
+    TEST_ASSERT_FALSE(planner.configure(bad, CELL));
+    bad = fast_diagonals();
+    bad.turn_settle_s = -1.0f;
+    TEST_ASSERT_FALSE(planner.configure(bad, CELL));
+    TEST_ASSERT_FALSE(planner.configure(fast_diagonals(), 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(slow_diagonals().diagonal.v_max, planner.costs().diagonal.v_max);
+}
+
+// ============================================================================
+// Benchmark, worst case updates against a full flood
+// ============================================================================
+
+template <typename F>
+static double us(F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+static const int REPLAYS = 15;
+
+struct Timing
+{
+    double worst_us;
+    double total_us;
+    int updates;
+    std::uint16_t worst_changed;
+};
+
+// each update is replayed from a copy of the solver, and the fastest replay kept, so that the worst case is
+// the update itself rather than the host scheduler.
+static void time_exploration(const MazeMap &truth, const std::uint8_t *order, Timing &t)
+{
+    static Solver before;
+    solver.reset();
+    t = {0.0, 0.0, 0, 0};
+    for (std::uint16_t i = 0; i < CELLS; i++)
+    {
+        std::uint8_t x = order[i] & 15, y = order[i] >> 4;
+        before = solver;
+        double took = 1e9;
+        for (int r = 0; r < REPLAYS; r++)
+        {
+            solver = before;
+            double replay = us([&]() { feed(solver, truth, x, y); });
+            took = replay < took ? replay : took;
+        }
+        t.total_us += took;
+        t.updates++;
+        if (took > t.worst_us)
+        {
+            t.worst_us = took;
+        }
+        if (solver.changed() > t.worst_changed)
+        {
+            t.worst_changed = solver.changed();
+        }
+    }
+}
+
+void test_benchmark_worst_case_updates(void)
+{
+    static MazeMap truth;
+    std::uint8_t order[CELLS];
+    Timing t;
+
+    double flood = 1e9;
+    for (int i = 0; i < 100; i++)
+    {
+        double took = us([]() { solver.flood(); });
+        flood = took < flood ? took : flood;
+    }
+    printf("full flood         %7.2f us\n", flood);
+
+    // serpentine, learned from the goal end outwards: every new wall pushes most of the maze further away.
+    serpentine(truth);
+    solver.set_goal({0, 0, 1, 1});
+    for (std::uint16_t i = 0; i < CELLS; i++)
+    {
+        order[i] = static_cast<std::uint8_t>(i);
+    }
+    time_exploration(truth, order, t);
+    printf("serpentine   worst %7.2f us  mean %6.2f us  worst cells %u\n", t.worst_us, t.total_us / t.updates, t.worst_changed);
+    assert_matches_flood(solver);
+    TEST_ASSERT_EQUAL_UINT16(CELLS - 1, solver.distance(0, SIZE - 1));
+
+    // winding random mazes, explored in a random order, towards the centre goal.
+    solver.set_goal({7, 7, 2, 2});
+    double worst = 0, total = 0;
+    int updates = 0;
+    for (std::uint32_t seed = 100; seed < 120; seed++)
+    {
+        random_maze(truth, seed, 0);
+        for (std::uint16_t i = 0; i < CELLS; i++)
+        {
+            order[i] = static_cast<std::uint8_t>(i);
+        }
+        for (std::uint16_t i = CELLS - 1; i > 0; i--)
+        {
+            std::uint16_t j = lcg() % (i + 1);
+            std::uint8_t s = order[i];
+            order[i] = order[j];
+            order[j] = s;
+        }
+        time_exploration(truth, order, t);
+        worst = t.worst_us > worst ? t.worst_us : worst;
+        total += t.total_us;
+        updates += t.updates;
+    }
+    printf("random       worst %7.2f us  mean %6.2f us\n", worst, total / updates);
+
+    TEST_ASSERT_TRUE(worst > 0.0);
+}
+
+
+void test_benchmark_plan(void)
+{
+    static MazeMap truth;
+    planner.configure(fast_diagonals(), CELL);
+
+    // fully open, every state has the longest runs and staircases to try.
+    open_maze(truth);
+    double open = 1e9;
+    for (int i = 0; i < 20; i++)
+    {
+        double took = us([]() { planner.plan(truth, {7, 7, 2, 2}, 0, 0, H_NORTH); });
+        open = took < open ? took : open;
+    }
+    printf("plan open          %7.2f us  %2u segments  %.3f s\n", open, static_cast<unsigned>(planner.count()), planner.predicted_s());
+
+    double worst = 0;
+    for (std::uint32_t seed = 300; seed < 320; seed++)
+    {
+        random_maze(truth, seed, 30);
+        double took = 1e9;
+        for (int i = 0; i < 5; i++)
+        {
+            double t = us([]() { planner.plan(truth, {7, 7, 2, 2}, 0, 0, H_NORTH); });
+            took = t < took ? t : took;
+        }
+        worst = took > worst ? took : worst;
+    }
+    printf("plan random  worst %7.2f us\n", worst);
+    TEST_ASSERT_TRUE(open > 0.0);
+}
+
+void setUp(void) {
+    solver.set_goal({7, 7, 2, 2});
+    solver.reset();
+    planner.configure(slow_diagonals(), CELL);
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_map_shares_walls_between_cells);
+    RUN_TEST(test_map_outer_walls_are_fixed);
+    RUN_TEST(test_map_packs_edges);
+    RUN_TEST(test_open_maze_is_manhattan_distance);
+    RUN_TEST(test_next_move);
+    RUN_TEST(test_wall_raises_only_affected_cells);
+    RUN_TEST(test_wall_found_open_lowers_distances);
+    RUN_TEST(test_enclosed_cell_is_unreachable);
+    RUN_TEST(test_incremental_matches_flood_on_random_mazes);
+    RUN_TEST(test_rejects_bad_goal);
+    RUN_TEST(test_segment_time);
+    RUN_TEST(test_plan_straight_run);
+    RUN_TEST(test_plan_uses_only_seen_sides);
+    RUN_TEST(test_plan_staircase_diagonal_by_cost);
+    RUN_TEST(test_plan_prefers_fewer_turns_to_fewer_cells);
+    RUN_TEST(test_plan_random_mazes_are_drivable);
+    RUN_TEST(test_plan_rejects_bad_costs);
+    RUN_TEST(test_benchmark_worst_case_updates);
+    RUN_TEST(test_benchmark_plan);
+    return UNITY_END();
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <cstdint>
+#include <rr_memory.hpp>
+
+using namespace rr_memory;
+
+static const size_t WORDS = 64;
+static std::uint32_t region[WORDS];
+static Stack &stack = Stack::get_instance();
+
+void test_paint_and_untouched(void)
+{
+    paint(region, region + WORDS);
+    TEST_ASSERT_EQUAL_UINT32(PAINT, region[0]);
+    TEST_ASSERT_EQUAL_UINT32(PAINT, region[WORDS - 1]);
+    TEST_ASSERT_EQUAL(WORDS * 4, untouched(region, region + WORDS));
+
+    region[40] = 0;
+    TEST_ASSERT_EQUAL(160, untouched(region, region + WORDS));
+    region[0] = 1;
+    TEST_ASSERT_EQUAL(0, untouched(region, region + WORDS));
+}
+
+void test_unpainted_stack_reports_nothing(void)
+{
+    TEST_ASSERT_FALSE(stack.painted());
+    TEST_ASSERT_EQUAL(WORDS * 4, stack.size());
+    TEST_ASSERT_EQUAL(0, stack.high_water());
+    TEST_ASSERT_EQUAL(0, Stack::static_bytes());
+}
+
+void test_high_water_is_deepest_use(void)
+{
+    stack.paint();
+    TEST_ASSERT_TRUE(stack.painted());
+    TEST_ASSERT_EQUAL(0, stack.high_water());
+
+    // the stack grows down from the top, a call chain 16 words deep.
+    for (size_t i = WORDS - 16; i < WORDS; i++)
+    {
+        region[i] = static_cast<std::uint32_t>(i);
+    }
+    TEST_ASSERT_EQUAL(64, stack.high_water());
+
+    // one deeper frame, the paint between it and the top is left where locals were not written.
+    region[10] = 0;
+    TEST_ASSERT_EQUAL((WORDS - 10) * 4, stack.high_water());
+
+    // returning does not lower the mark, only painting again does.
+    stack.paint();
+    TEST_ASSERT_EQUAL(0, stack.high_water());
+}
+
+void test_value_equal_to_paint_is_missed(void)
+{
+    // a word written with the paint value itself is indistinguishable from paint, the mark is a lower bound.
+    stack.paint();
+    region[WORDS - 1] = 7;
+    region[WORDS - 2] = PAINT;
+    TEST_ASSERT_EQUAL(4, stack.high_water());
+}
+
+void setUp(void)
+{
+    stack.mock_stack(region, region + WORDS);
+}
+
+void tearDown(void)
+{
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_paint_and_untouched);
+    RUN_TEST(test_unpainted_stack_reports_nothing);
+    RUN_TEST(test_high_water_is_deepest_use);
+    RUN_TEST(test_value_equal_to_paint_is_missed);
+    return UNITY_END();
+}
@@ -0,0 +1,194 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <rr_metrics.hpp>
+
+using namespace rr_metrics;
+
+static Metrics metrics;
+
+void test_bucket_of_is_log2(void)
+{
+    TEST_ASSERT_EQUAL(0, Metrics::bucket_of(0));
+    TEST_ASSERT_EQUAL(0, Metrics::bucket_of(1));
+    TEST_ASSERT_EQUAL(1, Metrics::bucket_of(2));
+    TEST_ASSERT_EQUAL(1, Metrics::bucket_of(3));
+    TEST_ASSERT_EQUAL(7, Metrics::bucket_of(200));
+    TEST_ASSERT_EQUAL(StageLatency::BUCKETS - 1, Metrics::bucket_of(1 << 11));
+    TEST_ASSERT_EQUAL(StageLatency::BUCKETS - 1, Metrics::bucket_of(0xFFFFFFFF));
+}
+
+void test_ops_are_kept_in_the_order_first_seen(void)
+{
+    metrics.count(150);
+    metrics.count(102);
+    metrics.count(150);
+    metrics.count(102, true);
+    metrics.count(102, true);
+
+    TEST_ASSERT_EQUAL(2, metrics.ops());
+    TEST_ASSERT_EQUAL_INT32(150, metrics.op(0).op);
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.op(0).requests);
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.op(0).publications);
+    TEST_ASSERT_EQUAL_INT32(102, metrics.op(1).op);
+    TEST_ASSERT_EQUAL_UINT32(1, metrics.op(1).requests);
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.op(1).publications);
+}
+
+void test_stages_are_timed_separately(void)
+{
+    metrics.count(151);
+    metrics.record(151, ST_DECODE, 12);
+    metrics.record(151, ST_DISPATCH, 1);
+    metrics.record(151, ST_HANDLER, 300);
+    metrics.record(151, ST_HANDLER, 100);
+    metrics.record(151, ST_ENCODE, 40);
+
+    const OpMetrics &m = metrics.op(0);
+    TEST_ASSERT_EQUAL_UINT32(1, m.stages[ST_DECODE].count);
+    TEST_ASSERT_EQUAL_UINT32(1, m.stages[ST_DECODE].histogram[3]);
+    TEST_ASSERT_EQUAL_UINT32(1, m.stages[ST_DISPATCH].histogram[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, m.stages[ST_ENCODE].histogram[5]);
+
+    const StageLatency &h = m.stages[ST_HANDLER];
+    TEST_ASSERT_EQUAL_UINT32(2, h.count);
+    TEST_ASSERT_EQUAL_UINT32(300, h.max_us);
+    TEST_ASSERT_EQUAL_UINT64(400, h.sum_us);
+    TEST_ASSERT_EQUAL_UINT32(1, h.histogram[6]);
+    TEST_ASSERT_EQUAL_UINT32(1, h.histogram[8]);
+}
+
+void test_errors_by_type_and_op(void)
+{
+    metrics.error(2);
+    metrics.error(4, 157);
+    metrics.error(4, 157);
+    metrics.error(RR_METRICS_ERROR_TYPES + 3, 151);
+
+    TEST_ASSERT_EQUAL_UINT32(1, metrics.errors(0));
+    TEST_ASSERT_EQUAL_UINT32(1, metrics.errors(2));
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.errors(4));
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.errors(RR_METRICS_ERROR_TYPES + 3));
+
+    // an undecodable frame has no op to count against.
+    TEST_ASSERT_EQUAL(2, metrics.ops());
+    TEST_ASSERT_EQUAL_INT32(157, metrics.op(0).op);
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.op(0).errors);
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.op(0).requests);
+    TEST_ASSERT_EQUAL_UINT32(1, metrics.op(1).errors);
+}
+
+void test_full_table_drops_new_ops(void)
+{
+    for (std::int32_t op = 1; op <= RR_METRICS_OPS; op++)
+    {
+        metrics.count(op);
+    }
+    metrics.count(RR_METRICS_OPS + 1);
+    metrics.count(RR_METRICS_OPS + 2, true);
+    metrics.record(RR_METRICS_OPS + 1, ST_HANDLER, 10);
+    metrics.count(1);
+
+    TEST_ASSERT_EQUAL(RR_METRICS_OPS, metrics.ops());
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.dropped());
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.op(0).requests);
+    TEST_ASSERT_EQUAL_INT32(RR_METRICS_OPS, metrics.op(RR_METRICS_OPS - 1).op);
+}
+
+void test_frames_and_bytes(void)
+{
+    metrics.received(10);
+    metrics.received(4);
+    metrics.sent(120);
+
+    TEST_ASSERT_EQUAL_UINT32(14, metrics.rx_bytes());
+    TEST_ASSERT_EQUAL_UINT32(2, metrics.rx_frames());
+    TEST_ASSERT_EQUAL_UINT32(120, metrics.tx_bytes());
+    TEST_ASSERT_EQUAL_UINT32(1, metrics.tx_frames());
+}
+
+void test_reset_clears_metrics(void)
+{
+    metrics.count(150);
+    metrics.record(150, ST_ENCODE, 7);
+    metrics.error(1);
+    metrics.received(5);
+    metrics.sent(5);
+    metrics.reset();
+
+    TEST_ASSERT_EQUAL(0, metrics.ops());
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.errors(1));
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.rx_frames());
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.tx_bytes());
+
+    // the slot is taken afresh, without the old histogram.
+    metrics.count(102);
+    TEST_ASSERT_EQUAL_INT32(102, metrics.op(0).op);
+    TEST_ASSERT_EQUAL_UINT32(0, metrics.op(0).stages[ST_ENCODE].count);
+}
+
+void test_benchmark_request_metrics(void)
+{
+    // what the serial service records for a request, with a handful of ops in the table.
+    const std::int32_t ops[] = {101, 102, 104, 150, 151, 152};
+    const std::uint32_t N = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < N; i++)
+    {
+        std::int32_t op = ops[i % 6];
+        metrics.received(8);
+        metrics.count(op);
+        metrics.record(op, ST_DECODE, i & 15);
+        metrics.record(op, ST_DISPATCH, 1);
+        metrics.record(op, ST_HANDLER, i & 255);
+        metrics.record(op, ST_ENCODE, i & 63);
+        metrics.sent(40);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / N;
+    printf("request metrics   %6.2f ns/request\n", ns);
+    TEST_ASSERT_EQUAL_UINT32(N, metrics.rx_frames());
+}
+
+void setUp(void) {
+    metrics.reset();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_of_is_log2);
+    RUN_TEST(test_ops_are_kept_in_the_order_first_seen);
+    RUN_TEST(test_stages_are_timed_separately);
+    RUN_TEST(test_errors_by_type_and_op);
+    RUN_TEST(test_full_table_drops_new_ops);
+    RUN_TEST(test_frames_and_bytes);
+    RUN_TEST(test_reset_clears_metrics);
+    RUN_TEST(test_benchmark_request_metrics);
+    return UNITY_END();
+}
@@ -0,0 +1,673 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include <cmath>
+
+#include <rr_motor.hpp>
+#include <rr_speed.hpp>
+#include <rr_motion.hpp>
+
+using namespace mb_operations;
+
+static unsigned long mock_millis = 0;
+static unsigned long mock_micros = 0;
+unsigned long millis() { return mock_millis; }
+unsigned long micros() { return mock_micros; }
+void delay(unsigned long ms) { mock_millis += ms; }
+MockSerial Serial;
+MockInterrupt mock_interrupt;
+
+static RRMotorOpHandler motor_hdl;
+static RRMotorOpHandler *motor = &motor_hdl;
+
+/*
+ * two first order wheels driven by the motor handler, speed approaches duty / 800 m/s. Slip turns the body
+ * without the encoders seeing it, only the heading reference does.
+ */
+class SimWheels : public rr_pose::TickSource, public rr_pose::HeadingSource
+{
+public:
+    float speed[2] = {0.0f, 0.0f};
+    double position[2] = {0.0, 0.0};
+    bool available = true;
+    float slip_rad_s = 0.0f;
+    double yaw = 0.0;
+
+    float yaw_rate() const
+    {
+        return (speed[1] - speed[0]) / RR_WHEEL_BASE_M + slip_rad_s;
+    }
+
+    void step(float dt)
+    {
+        float duty[2] = {static_cast<float>(motor->left()), static_cast<float>(motor->right())};
+        for (int i = 0; i < 2; i++)
+        {
+            speed[i] += (duty[i] / 800.0f - speed[i]) * dt / 0.05f;
+            position[i] += speed[i] * dt;
+        }
+        yaw += yaw_rate() * dt;
+    }
+
+    bool read_ticks(std::int32_t &left, std::int32_t &right) override
+    {
+        left = static_cast<std::int32_t>(floor(position[0] / rr_ble::METRES_PER_TICK));
+        right = static_cast<std::int32_t>(floor(position[1] / rr_ble::METRES_PER_TICK));
+        return available;
+    }
+
+    bool read_heading(float &heading, float &rate) override
+    {
+        heading = static_cast<float>(yaw);
+        rate = yaw_rate();
+        return available;
+    }
+};
+
+static SimWheels wheels;
+static RRSpeedOpHandler speed_hdl(motor_hdl);
+static RRSpeedOpHandler *speed = &speed_hdl;
+static RRMotionOpHandler motion_hdl(speed_hdl);
+static RRMotionOpHandler *motion = &motion_hdl;
+
+/*
+ * advances time by one control period, and runs the main loop service.
+ */
+static void run_periods(int n)
+{
+    const float dt = RRSpeedOpHandler::PERIOD_US * 1e-6f;
+    for (int i = 0; i < n; i++)
+    {
+        mock_micros += RRSpeedOpHandler::PERIOD_US;
+        if (mock_micros % 1000 == 0)
+        {
+            mock_millis++;
+        }
+        wheels.step(dt);
+        motor->service();
+        speed->service();
+    }
+}
+
+static const std::uint16_t TOP = RR_MOTOR_PWM_TOP;
+
+static void assert_duty(std::uint16_t l1, std::uint16_t l2, std::uint16_t r1, std::uint16_t r2)
+{
+    rr_motor::Pwm &pwm = rr_motor::Pwm::get_instance();
+    TEST_ASSERT_EQUAL_UINT16(l1, pwm.duty(0));
+    TEST_ASSERT_EQUAL_UINT16(l2, pwm.duty(1));
+    TEST_ASSERT_EQUAL_UINT16(r1, pwm.duty(2));
+    TEST_ASSERT_EQUAL_UINT16(r2, pwm.duty(3));
+}
+
+void test_init_starts_stopped(void)
+{
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Status_READY, motor->status());
+    TEST_ASSERT_EQUAL_UINT16(TOP, rr_motor::Pwm::get_instance().top());
+    assert_duty(0, 0, 0, 0);
+}
+
+void test_command_sets_driver_inputs(void)
+{
+    motor->command(500, -250);
+    assert_duty(TOP / 2, 0, 0, TOP / 4);
+
+    motor->command(-1000, 1000);
+    assert_duty(0, TOP, TOP, 0);
+
+    motor->command(0, 0);
+    assert_duty(0, 0, 0, 0);
+}
+
+void test_command_is_clamped(void)
+{
+    motor->command(1500, -2000);
+    TEST_ASSERT_EQUAL_INT16(RRMotorOpHandler::MAX_COMMAND, motor->left());
+    TEST_ASSERT_EQUAL_INT16(-RRMotorOpHandler::MAX_COMMAND, motor->right());
+    assert_duty(TOP, 0, 0, TOP);
+}
+
+void test_set_raw_rc_applies_command(void)
+{
+    org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+    org_ryderrobots_ros2_serial_Response res = org_ryderrobots_ros2_serial_Response_init_zero;
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+
+    req.op = rr_ble::MSP_SET_RAW_RC;
+    ereq.has_motor_command = true;
+    ereq.motor_command.left = 250;
+    ereq.motor_command.right = 70000;
+    mock_millis = 1234;
+
+    motor->perform_op(req, res);
+    TEST_ASSERT_EQUAL(rr_ble::MSP_SET_RAW_RC, res.op);
+    TEST_ASSERT_NOT_EQUAL(org_ryderrobots_ros2_serial_Response_bad_request_tag, res.which_data);
+
+    motor->perform_ext(ereq, eres);
+    TEST_ASSERT_TRUE(eres.has_motor);
+    TEST_ASSERT_EQUAL_INT32(250, eres.motor.left_command);
+    TEST_ASSERT_EQUAL_INT32(1000, eres.motor.right_command);
+    TEST_ASSERT_EQUAL_INT32(250, eres.motor.left_applied);
+    TEST_ASSERT_EQUAL_INT32(1000, eres.motor.right_applied);
+    TEST_ASSERT_EQUAL_UINT32(1234, eres.motor.command_ms);
+}
+
+void test_motor_monitor_reports_state(void)
+{
+    motor->command(-400, 600);
+
+    org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+    org_ryderrobots_ros2_serial_Response res = org_ryderrobots_ros2_serial_Response_init_zero;
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    req.op = rr_ble::MSP_MOTOR;
+    req.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+    req.data.monitor.is_request = true;
+
+    motor->perform_op(req, res);
+    motor->perform_ext(ereq, eres);
+
+    // a monitor request does not change the command.
+    TEST_ASSERT_EQUAL_INT32(-400, eres.motor.left_command);
+    TEST_ASSERT_EQUAL_INT32(600, eres.motor.right_command);
+    TEST_ASSERT_EQUAL_INT32(-400, eres.motor.left_applied);
+    TEST_ASSERT_EQUAL_INT32(600, eres.motor.right_applied);
+}
+
+void test_motor_monitor_reports_encoders(void)
+{
+    // the wheels are driven the way they are commanded, so reverse edges count down.
+    motor->command(-400, 600);
+    rr_encoder::SyntheticTicks left(rr_encoder::LEFT), right(rr_encoder::RIGHT);
+    for (int i = 0; i < 20; i++)
+    {
+        mock_micros += 1000;
+        left.advance(-1000.0f, 1e-3f);
+        right.advance(3000.0f, 1e-3f);
+        rr_encoder::Encoders::get_instance().update();
+    }
+
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    motor->perform_ext(ereq, eres);
+
+    TEST_ASSERT_EQUAL_INT32(-20, eres.motor.left_ticks);
+    TEST_ASSERT_EQUAL_INT32(60, eres.motor.right_ticks);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -1000.0f * rr_ble::METRES_PER_TICK, eres.motor.left_speed);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 3000.0f * rr_ble::METRES_PER_TICK, eres.motor.right_speed);
+    TEST_ASSERT_EQUAL_UINT32(mock_micros, eres.motor.encoder_us);
+}
+
+void test_unknown_op_is_rejected(void)
+{
+    org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+    org_ryderrobots_ros2_serial_Response res = org_ryderrobots_ros2_serial_Response_init_zero;
+    req.op = rr_ble::MSP_RAW_IMU;
+
+    motor->perform_op(req, res);
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Response_bad_request_tag, res.which_data);
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION, res.data.bad_request.etype);
+}
+
+void test_command_timeout_stops_motors(void)
+{
+    mock_millis = 10000;
+    motor->command(800, 800);
+
+    mock_millis += RR_MOTOR_TIMEOUT_MS;
+    motor->service();
+    TEST_ASSERT_EQUAL_INT16(800, motor->left());
+
+    mock_millis += 1;
+    motor->service();
+    TEST_ASSERT_EQUAL_INT16(0, motor->left());
+    TEST_ASSERT_EQUAL_INT16(0, motor->right());
+    assert_duty(0, 0, 0, 0);
+}
+
+void test_command_to_register_latency(void)
+{
+    rr_motor::Pwm &pwm = rr_motor::Pwm::get_instance();
+    const int N = 100000;
+
+    // every command is visible in the sequence, and restarts it exactly once, within the call.
+    std::uint32_t starts = pwm.starts();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < N; i++)
+    {
+        std::int16_t cmd = static_cast<std::int16_t>((i % 2001) - 1000);
+        motor->command(cmd, static_cast<std::int16_t>(-cmd));
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    TEST_ASSERT_EQUAL_UINT32(starts + N, pwm.starts());
+
+    motor->command(-1000, 1000);
+    assert_duty(0, TOP, TOP, 0);
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+    printf("command to register: %.1f ns\n", ns);
+
+    // generous, the native path is a few stores and must not approach the 1ms control period.
+    TEST_ASSERT_TRUE(ns < 10000.0);
+}
+
+void test_speed_unavailable_without_encoders(void)
+{
+    RRSpeedOpHandler no_encoders(motor_hdl);
+    no_encoders.init();
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Status_NOT_AVAILABLE, no_encoders.status());
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Status_READY, speed->status());
+}
+
+void test_speed_loop_tracks_setpoint(void)
+{
+    speed->set_speed(0.3f, -0.2f);
+    TEST_ASSERT_TRUE(motor->closed_loop());
+
+    // keep the setpoint alive for two seconds.
+    for (int i = 0; i < 4; i++)
+    {
+        run_periods(500);
+        speed->set_speed(0.3f, -0.2f);
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.3f, wheels.speed[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -0.2f, wheels.speed[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.3f, speed->measured(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, -0.2f, speed->measured(1));
+
+    rr_control::LoopTiming t = speed->timing();
+    TEST_ASSERT_EQUAL_UINT32(2000, t.count);
+    TEST_ASSERT_EQUAL_UINT32(RRSpeedOpHandler::PERIOD_US, t.period_min_us);
+    TEST_ASSERT_EQUAL_UINT32(RRSpeedOpHandler::PERIOD_US, t.period_max_us);
+    TEST_ASSERT_EQUAL_UINT32(0, t.overruns);
+}
+
+void test_take_tick_reports_periods_run(void)
+{
+    speed->take_tick();
+    TEST_ASSERT_FALSE(speed->take_tick());
+
+    // the watchdog check in is taken once per main loop, however many periods ran since.
+    run_periods(3);
+    TEST_ASSERT_TRUE(speed->take_tick());
+    TEST_ASSERT_FALSE(speed->take_tick());
+}
+
+void test_raw_command_releases_closed_loop(void)
+{
+    speed->set_speed(0.3f, 0.3f);
+    run_periods(50);
+
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.has_motor_command = true;
+    ereq.motor_command.left = 100;
+    ereq.motor_command.right = 100;
+    motor->perform_ext(ereq, eres);
+
+    run_periods(10);
+    TEST_ASSERT_FALSE(motor->closed_loop());
+    TEST_ASSERT_FALSE(speed->enabled());
+    TEST_ASSERT_EQUAL_INT16(100, motor->left());
+}
+
+void test_setpoint_timeout_releases(void)
+{
+    speed->set_speed(0.3f, 0.3f);
+    run_periods(RR_SPEED_TIMEOUT_MS * 1000 / RRSpeedOpHandler::PERIOD_US);
+    TEST_ASSERT_TRUE(speed->enabled());
+
+    run_periods(2 * 1000 / RRSpeedOpHandler::PERIOD_US);
+    TEST_ASSERT_FALSE(speed->enabled());
+    TEST_ASSERT_FALSE(motor->closed_loop());
+    assert_duty(0, 0, 0, 0);
+}
+
+void test_set_pid_reports_gains_and_timing(void)
+{
+    run_periods(10);
+
+    org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+    org_ryderrobots_ros2_serial_Response res = org_ryderrobots_ros2_serial_Response_init_zero;
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    req.op = rr_ble::MSP_SET_PID;
+    ereq.has_speed_gains = true;
+    ereq.speed_gains.kp = 100.0f;
+    ereq.speed_gains.ki = 200.0f;
+    ereq.speed_gains.kff = 900.0f;
+
+    speed->perform_op(req, res);
+    TEST_ASSERT_NOT_EQUAL(org_ryderrobots_ros2_serial_Response_bad_request_tag, res.which_data);
+    speed->perform_ext(ereq, eres);
+
+    TEST_ASSERT_TRUE(eres.has_speed);
+    TEST_ASSERT_FALSE(eres.speed.enabled);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, eres.speed.gains.kp);
+    TEST_ASSERT_EQUAL_FLOAT(200.0f, eres.speed.gains.ki);
+    TEST_ASSERT_EQUAL_FLOAT(900.0f, eres.speed.gains.kff);
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, speed->gains().kp);
+
+    // statistics restart with new gains.
+    TEST_ASSERT_TRUE(eres.speed.has_timing);
+    TEST_ASSERT_EQUAL_UINT32(0, eres.speed.timing.count);
+
+    run_periods(10);
+    org_ryderrobots_mousebot_ExtRequest monitor = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    speed->perform_ext(monitor, eres);
+    TEST_ASSERT_EQUAL_UINT32(10, eres.speed.timing.count);
+    TEST_ASSERT_EQUAL_UINT32(RRSpeedOpHandler::PERIOD_US, eres.speed.timing.period_mean_us);
+}
+
+void test_retuning_keeps_loop_output(void)
+{
+    // no feed-forward, the integrator carries the output at steady state.
+    rr_control::Gains gains = {RR_SPEED_KP, RR_SPEED_KI, 0.0f, 0.0f, 0.0f};
+    speed->set_gains(gains);
+    for (int i = 0; i < 4; i++)
+    {
+        speed->set_speed(0.3f, 0.3f);
+        run_periods(250);
+    }
+    std::int16_t before = motor->left();
+    TEST_ASSERT_NOT_EQUAL(0, before);
+
+    gains.kp *= 2.0f;
+    speed->set_gains(gains);
+    run_periods(1);
+    TEST_ASSERT_INT_WITHIN(before / 10, before, motor->left());
+
+    rr_control::Gains defaults = {RR_SPEED_KP, RR_SPEED_KI, RR_SPEED_KD, RR_SPEED_KFF, RR_SPEED_KSTATIC};
+    speed->set_gains(defaults);
+}
+
+static org_ryderrobots_mousebot_MotionSegment segment(std::uint32_t id, org_ryderrobots_mousebot_MotionKind kind, float distance,
+                                                      float v_max, float accel, float v_end, float jerk)
+{
+    org_ryderrobots_mousebot_MotionSegment seg = org_ryderrobots_mousebot_MotionSegment_init_zero;
+    seg.id = id;
+    seg.kind = kind;
+    seg.distance = distance;
+    seg.v_max = v_max;
+    seg.accel = accel;
+    seg.v_end = v_end;
+    seg.jerk = jerk;
+    return seg;
+}
+
+/*
+ * runs the control loop until the motion queue is idle, or limit periods pass. The simulated wheels have no
+ * friction, so the static friction offset is left out.
+ */
+static int run_motion(int limit)
+{
+    rr_control::Gains gains = {RR_SPEED_KP, RR_SPEED_KI, RR_SPEED_KD, RR_SPEED_KFF, 0.0f};
+    speed->set_gains(gains);
+
+    int n = 0;
+    while ((motion->active() || motion->queued() > 0) && n < limit)
+    {
+        run_periods(1);
+        n++;
+    }
+    return n;
+}
+
+void test_motion_segments_run_without_host(void)
+{
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.has_motion_segment = true;
+    ereq.motion_segment = segment(7, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.18f, 0.4f, 2.0f, 0.4f, 100.0f);
+    motion->perform_ext(ereq, eres);
+    TEST_ASSERT_TRUE(eres.motion.accepted);
+    TEST_ASSERT_EQUAL_UINT32(1, eres.motion.queued);
+    TEST_ASSERT_TRUE(motion->enqueue(segment(8, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.18f, 0.4f, 2.0f, 0.0f, 100.0f)));
+
+    // longer than the setpoint timeout, with no host traffic at all.
+    int periods = run_motion(5000);
+    TEST_ASSERT_TRUE(periods * RRSpeedOpHandler::PERIOD_US > RR_SPEED_TIMEOUT_MS * 1000UL);
+    TEST_ASSERT_FALSE(motion->active());
+    TEST_ASSERT_TRUE(motion->event_pending());
+
+    // segments are velocity profiles, the wheels end within the speed loop's tracking error of the distance.
+    TEST_ASSERT_FLOAT_WITHIN(0.015f, 0.36f, wheels.position[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.015f, 0.36f, wheels.position[1]);
+
+    org_ryderrobots_mousebot_ExtRequest monitor = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    motion->perform_ext(monitor, eres);
+    TEST_ASSERT_TRUE(eres.motion.event);
+    TEST_ASSERT_EQUAL_UINT32(8, eres.motion.completed_id);
+    TEST_ASSERT_FALSE(motion->event_pending());
+}
+
+void test_motion_turn_drives_wheels_apart(void)
+{
+    const float quarter = 1.5707963f;
+    TEST_ASSERT_TRUE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_TURN, quarter, 10.0f, 50.0f, 0.0f, 0.0f)));
+    run_motion(5000);
+
+    float arc = quarter * RR_WHEEL_BASE_M * 0.5f;
+    TEST_ASSERT_FLOAT_WITHIN(0.003f, -arc, wheels.position[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.003f, arc, wheels.position[1]);
+}
+
+void test_motion_rejects_invalid_segments(void)
+{
+    TEST_ASSERT_FALSE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.0f, 0.4f, 2.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_FALSE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.1f, 0.4f, 0.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_FALSE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.1f, 0.4f, 2.0f, 0.5f, 0.0f)));
+
+    // a turn can not follow a straight that ends moving.
+    TEST_ASSERT_TRUE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.1f, 0.4f, 2.0f, 0.2f, 0.0f)));
+    TEST_ASSERT_FALSE(motion->enqueue(segment(2, org_ryderrobots_mousebot_MotionKind_MK_TURN, 1.0f, 4.0f, 20.0f, 0.0f, 0.0f)));
+
+    for (size_t i = motion->queued(); i < RR_MOTION_QUEUE_LEN - 1; i++)
+    {
+        TEST_ASSERT_TRUE(motion->enqueue(segment(3, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.1f, 0.4f, 2.0f, 0.2f, 0.0f)));
+    }
+    TEST_ASSERT_FALSE(motion->enqueue(segment(4, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.1f, 0.4f, 2.0f, 0.2f, 0.0f)));
+}
+
+void test_motion_abort_brakes_to_rest(void)
+{
+    std::uint32_t before = 0;
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    motion->perform_ext(ereq, eres);
+    before = eres.motion.completed;
+
+    TEST_ASSERT_TRUE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 1.0f, 0.4f, 2.0f, 0.0f, 0.0f)));
+    TEST_ASSERT_TRUE(motion->enqueue(segment(2, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 1.0f, 0.4f, 2.0f, 0.0f, 0.0f)));
+    run_periods(300);
+
+    ereq.motion_abort = true;
+    motion->perform_ext(ereq, eres);
+    int periods = run_motion(5000);
+
+    // 0.2s at 2 m/s^2 from 0.4 m/s.
+    TEST_ASSERT_INT_WITHIN(10, 200, periods);
+    TEST_ASSERT_EQUAL_UINT32(0, motion->queued());
+    TEST_ASSERT_TRUE(wheels.position[0] < 0.3f);
+    TEST_ASSERT_FALSE(motion->event_pending());
+
+    ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    motion->perform_ext(ereq, eres);
+    TEST_ASSERT_EQUAL_UINT32(before, eres.motion.completed);
+}
+
+void test_raw_command_cancels_motion(void)
+{
+    TEST_ASSERT_TRUE(motion->enqueue(segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 1.0f, 0.4f, 2.0f, 0.0f, 0.0f)));
+    run_periods(100);
+    TEST_ASSERT_TRUE(motion->active());
+
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.has_motor_command = true;
+    motor->perform_ext(ereq, eres);
+
+    run_periods(2);
+    TEST_ASSERT_FALSE(motion->active());
+    TEST_ASSERT_FALSE(speed->enabled());
+    TEST_ASSERT_EQUAL_UINT32(0, motion->queued());
+}
+
+void test_slip_turns_without_heading_hold(void)
+{
+    wheels.slip_rad_s = 0.3f;
+    speed->set_speed(0.3f, 0.3f);
+    run_periods(400);
+    TEST_ASSERT_TRUE(wheels.yaw > 0.1);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, speed->heading_correction());
+}
+
+void test_host_heading_hold_corrects_slip(void)
+{
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    ereq.has_heading_hold = true;
+    ereq.heading_hold.enabled = true;
+    ereq.heading_hold.target = 0.0f;
+    ereq.has_wheel_speed = true;
+    ereq.wheel_speed.left = 0.3f;
+    ereq.wheel_speed.right = 0.3f;
+    wheels.slip_rad_s = 0.3f;
+    speed->perform_ext(ereq, eres);
+    run_periods(400);
+
+    // proportional hold leaves the error that turns at the slip rate, slip / kp.
+    TEST_ASSERT_FLOAT_WITHIN(0.3f / RR_HEADING_KP + 0.01f, 0.0f, static_cast<float>(wheels.yaw));
+    TEST_ASSERT_TRUE(speed->heading_correction() < 0.0f);
+
+    org_ryderrobots_mousebot_ExtRequest monitor = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    speed->perform_ext(monitor, eres);
+    TEST_ASSERT_TRUE(eres.speed.heading_hold.enabled);
+    TEST_ASSERT_EQUAL_FLOAT(RR_HEADING_KP, eres.speed.heading_gains.kp);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, static_cast<float>(wheels.yaw), eres.speed.yaw);
+}
+
+void test_heading_correction_is_limited(void)
+{
+    rr_motor::HeadingGains gains = {RR_HEADING_KP, RR_HEADING_KD, 0.02f};
+    speed->set_heading_gains(gains);
+    speed->hold_heading(true, 1.5f);
+    speed->set_speed(0.3f, 0.3f);
+    run_periods(10);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.02f, speed->heading_correction());
+}
+
+void test_invalid_heading_gains_are_rejected(void)
+{
+    rr_motor::HeadingGains gains = {-1.0f, RR_HEADING_KD, RR_HEADING_MAX_CORRECTION};
+    TEST_ASSERT_FALSE(speed->set_heading_gains(gains));
+    gains = {RR_HEADING_KP, NAN, RR_HEADING_MAX_CORRECTION};
+    TEST_ASSERT_FALSE(speed->set_heading_gains(gains));
+    gains = {RR_HEADING_KP, RR_HEADING_KD, INFINITY};
+    TEST_ASSERT_FALSE(speed->set_heading_gains(gains));
+    TEST_ASSERT_EQUAL_FLOAT(RR_HEADING_KP, speed->heading_gains().kp);
+
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    TEST_ASSERT_TRUE(speed->accept_ext(ereq));
+    ereq.has_heading_gains = true;
+    ereq.heading_gains.kp = RR_HEADING_KP;
+    ereq.heading_gains.kd = RR_HEADING_KD;
+    ereq.heading_gains.max_correction = -0.1f;
+    TEST_ASSERT_FALSE(speed->accept_ext(ereq));
+    ereq.heading_gains.max_correction = 0.1f;
+    TEST_ASSERT_TRUE(speed->accept_ext(ereq));
+}
+
+void test_segment_enables_heading_hold(void)
+{
+    wheels.slip_rad_s = 0.3f;
+    org_ryderrobots_mousebot_MotionSegment seg = segment(1, org_ryderrobots_mousebot_MotionKind_MK_STRAIGHT, 0.3f, 0.4f, 2.0f, 0.0f, 0.0f);
+    seg.heading_hold = true;
+    seg.heading = 0.0f;
+    TEST_ASSERT_TRUE(motion->enqueue(seg));
+    run_motion(5000);
+    TEST_ASSERT_FLOAT_WITHIN(0.3f / RR_HEADING_KP + 0.01f, 0.0f, static_cast<float>(wheels.yaw));
+
+    // the host setting applies again once the queue is idle.
+    run_periods(2);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, speed->heading_correction());
+}
+
+void setUp(void) {
+    mock_millis = 0;
+    mock_micros = 0;
+    motor->init();
+    motor->set_closed_loop(false);
+    wheels = SimWheels();
+    speed->set_tick_source(&wheels);
+    speed->set_heading_source(&wheels);
+    speed->hold_heading(false, 0.0f);
+    speed->init();
+    speed->release();
+    rr_control::Gains defaults = {RR_SPEED_KP, RR_SPEED_KI, RR_SPEED_KD, RR_SPEED_KFF, RR_SPEED_KSTATIC};
+    speed->set_gains(defaults);
+    rr_motor::HeadingGains heading_defaults = {RR_HEADING_KP, RR_HEADING_KD, RR_HEADING_MAX_CORRECTION};
+    speed->set_heading_gains(heading_defaults);
+    motion->init();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_init_starts_stopped);
+    RUN_TEST(test_command_sets_driver_inputs);
+    RUN_TEST(test_command_is_clamped);
+    RUN_TEST(test_set_raw_rc_applies_command);
+    RUN_TEST(test_motor_monitor_reports_state);
+    RUN_TEST(test_motor_monitor_reports_encoders);
+    RUN_TEST(test_unknown_op_is_rejected);
+    RUN_TEST(test_command_timeout_stops_motors);
+    RUN_TEST(test_command_to_register_latency);
+    RUN_TEST(test_speed_unavailable_without_encoders);
+    RUN_TEST(test_speed_loop_tracks_setpoint);
+    RUN_TEST(test_take_tick_reports_periods_run);
+    RUN_TEST(test_raw_command_releases_closed_loop);
+    RUN_TEST(test_setpoint_timeout_releases);
+    RUN_TEST(test_set_pid_reports_gains_and_timing);
+    RUN_TEST(test_retuning_keeps_loop_output);
+    RUN_TEST(test_motion_segments_run_without_host);
+    RUN_TEST(test_motion_turn_drives_wheels_apart);
+    RUN_TEST(test_motion_rejects_invalid_segments);
+    RUN_TEST(test_motion_abort_brakes_to_rest);
+    RUN_TEST(test_raw_command_cancels_motion);
+    RUN_TEST(test_slip_turns_without_heading_hold);
+    RUN_TEST(test_host_heading_hold_corrects_slip);
+    RUN_TEST(test_heading_correction_is_limited);
+    RUN_TEST(test_invalid_heading_gains_are_rejected);
+    RUN_TEST(test_segment_enables_heading_hold);
+    return UNITY_END();
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <cmath>
+
+#include <rr_pose.hpp>
+
+using namespace rr_pose;
+
+static const float DT = 0.005f;
+static const float WHEEL_BASE = 0.074f;
+static const float METRES_PER_TICK = static_cast<float>(M_PI) * 0.032f / 1440.0f;
+
+static PoseEstimator estimator;
+
+static Measurement step(bool has_ticks, std::int32_t left, std::int32_t right, bool has_yaw_rate, float yaw_rate)
+{
+    Measurement m = {DT, has_ticks, left, right, has_yaw_rate, yaw_rate};
+    return m;
+}
+
+static void run(const Measurement &m, int steps)
+{
+    for (int i = 0; i < steps; i++)
+    {
+        estimator.update(m);
+    }
+}
+
+void test_configure_rejects_invalid(void)
+{
+    PoseEstimator e;
+    Config bad_base = {0.0f, METRES_PER_TICK, 0.98f, 1.0f};
+    Config bad_tick = {WHEEL_BASE, -1.0f, 0.98f, 1.0f};
+    Config bad_weight = {WHEEL_BASE, METRES_PER_TICK, 1.5f, 1.0f};
+    TEST_ASSERT_FALSE(e.configure(bad_base));
+    TEST_ASSERT_FALSE(e.configure(bad_tick));
+    TEST_ASSERT_FALSE(e.configure(bad_weight));
+
+    // an unconfigured estimator does not move
+    e.update(step(true, 10, 10, true, 1.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, e.pose().x);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, e.pose().heading);
+}
+
+void test_straight_line_from_encoders(void)
+{
+    run(step(true, 10, 10, false, 0.0f), 100);
+
+    const Pose &p = estimator.pose();
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1000.0f * METRES_PER_TICK, p.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, p.y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, p.heading);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 10.0f * METRES_PER_TICK / DT, p.v);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, p.v, p.vx);
+}
+
+void test_turn_in_place_from_gyro(void)
+{
+    // a quarter turn in one second
+    run(step(false, 0, 0, true, static_cast<float>(M_PI) / 2.0f), 200);
+
+    const Pose &p = estimator.pose();
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, static_cast<float>(M_PI) / 2.0f, p.heading);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, static_cast<float>(M_PI) / 2.0f, p.omega);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, p.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, p.y);
+}
+
+void test_arc_fuses_consistent_sources(void)
+{
+    // outer wheel 12 ticks, inner 8 ticks per step, gyro agrees with the encoders.
+    float dl = 8.0f * METRES_PER_TICK;
+    float dr = 12.0f * METRES_PER_TICK;
+    float omega = (dr - dl) / WHEEL_BASE / DT;
+    float radius = 0.5f * (dl + dr) / (dr - dl) * WHEEL_BASE;
+
+    // run for a quarter circle
+    int steps = static_cast<int>(lroundf(static_cast<float>(M_PI) / 2.0f / (omega * DT)));
+    run(step(true, 8, 12, true, omega), steps);
+
+    float heading = omega * DT * static_cast<float>(steps);
+    const Pose &p = estimator.pose();
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, heading, p.heading);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, radius * sinf(heading), p.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, radius * (1.0f - cosf(heading)), p.y);
+}
+
+void test_encoders_remove_gyro_bias(void)
+{
+    // ten seconds driving straight with a 0.05 rad/s gyroscope bias, gyro alone would drift 0.5 rad.
+    run(step(true, 10, 10, true, 0.05f), 2000);
+
+    // steady state error is bias * dt / (1 - gyro_weight)
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.0f, estimator.pose().heading);
+}
+
+void test_wheel_slip_is_ignored(void)
+{
+    // right wheel spins, the robot does not rotate.
+    run(step(true, 0, 20, true, 0.0f), 200);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, estimator.pose().heading);
+
+    // once traction returns the estimate does not jump to the slipped encoder heading.
+    run(step(true, 10, 10, true, 0.0f), 200);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, estimator.pose().heading);
+}
+
+void test_reset_wraps_heading(void)
+{
+    run(step(true, 10, 10, false, 0.0f), 10);
+    estimator.reset(0.09f, 0.27f, 3.0f * static_cast<float>(M_PI) / 2.0f);
+
+    const Pose &p = estimator.pose();
+    TEST_ASSERT_EQUAL_FLOAT(0.09f, p.x);
+    TEST_ASSERT_EQUAL_FLOAT(0.27f, p.y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -static_cast<float>(M_PI) / 2.0f, p.heading);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, p.v);
+}
+
+void setUp(void) {
+    Config config = {WHEEL_BASE, METRES_PER_TICK, 0.98f, 1.0f};
+    estimator.configure(config);
+    estimator.reset(0.0f, 0.0f, 0.0f);
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_configure_rejects_invalid);
+    RUN_TEST(test_straight_line_from_encoders);
+    RUN_TEST(test_turn_in_place_from_gyro);
+    RUN_TEST(test_arc_fuses_consistent_sources);
+    RUN_TEST(test_encoders_remove_gyro_bias);
+    RUN_TEST(test_wheel_slip_is_ignored);
+    RUN_TEST(test_reset_wraps_heading);
+    return UNITY_END();
+}
@@ -0,0 +1,287 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <rr_range.hpp>
+
+using namespace mb_operations;
+using rr_range::EchoCapture;
+
+MockSerial Serial;
+MockInterrupt mock_interrupt;
+
+static unsigned long mock_micros = 0;
+unsigned long micros() { return mock_micros; }
+unsigned long millis() { return mock_micros / 1000; }
+void delay(unsigned long ms) { mock_micros += ms * 1000; }
+
+static EchoCapture &capture = EchoCapture::get_instance();
+static RRRangeOpHandler handler;
+
+static const std::uint8_t ECHO_PINS[] = {RR_RANGE_0_ECHO_PIN, RR_RANGE_1_ECHO_PIN, RR_RANGE_2_ECHO_PIN};
+
+/*
+ * echo width (us) of a target at metres.
+ */
+static std::uint32_t width_of(float metres)
+{
+    return static_cast<std::uint32_t>(metres * 2.0f / RR_RANGE_SPEED_OF_SOUND * 1e6f + 0.5f);
+}
+
+/*
+ * services the handler every step_us for us microseconds, as the main loop would.
+ */
+static void run(unsigned long us, unsigned long step_us = 1000)
+{
+    for (unsigned long t = 0; t < us; t += step_us)
+    {
+        mock_micros += step_us;
+        handler.service();
+    }
+}
+
+void test_init_pings_first_sensor_only(void)
+{
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Status_READY, handler.status());
+    TEST_ASSERT_EQUAL_UINT32(1, capture.mock_triggers());
+    TEST_ASSERT_EQUAL_UINT8(RR_RANGE_0_ECHO_PIN, capture.mock_triggered());
+    for (size_t i = 0; i < handler.sensors(); i++)
+    {
+        TEST_ASSERT_FALSE(handler.reading(i).valid);
+    }
+}
+
+void test_echo_is_converted_to_distance(void)
+{
+    std::uint32_t width = width_of(0.2f);
+    capture.mock_echo(RR_RANGE_0_ECHO_PIN, 450, 450 + width);
+    run(5000);
+
+    const rr_range::Reading &r = handler.reading(0);
+    TEST_ASSERT_TRUE(r.valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.2f, r.distance);
+    TEST_ASSERT_EQUAL_UINT32(width, r.echo_us);
+    // timed by the capture, not by when the main loop noticed it.
+    TEST_ASSERT_EQUAL_UINT32(450 + width, r.timestamp_us);
+}
+
+void test_sensors_are_pinged_in_round_robin(void)
+{
+    std::uint32_t triggered_at[3] = {0, 0, 0};
+    triggered_at[0] = 0;
+    for (size_t i = 1; i < 3; i++)
+    {
+        std::uint32_t before = capture.mock_triggers();
+        while (capture.mock_triggers() == before)
+        {
+            run(100, 100);
+        }
+        TEST_ASSERT_EQUAL_UINT8(ECHO_PINS[i], capture.mock_triggered());
+        triggered_at[i] = static_cast<std::uint32_t>(mock_micros);
+        // the next ping waits out the whole slot, even with nothing to hear.
+        TEST_ASSERT_UINT32_WITHIN(100, RR_RANGE_SLOT_US, triggered_at[i] - triggered_at[i - 1]);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, handler.cycles());
+    run(RR_RANGE_SLOT_US, 100);
+    TEST_ASSERT_EQUAL_UINT32(1, handler.cycles());
+    TEST_ASSERT_EQUAL_UINT8(RR_RANGE_0_ECHO_PIN, capture.mock_triggered());
+}
+
+void test_missing_echo_times_out(void)
+{
+    run(RR_RANGE_TIMEOUT_US - 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, handler.timeouts());
+
+    run(1000);
+    const rr_range::Reading &r = handler.reading(0);
+    TEST_ASSERT_FALSE(r.valid);
+    TEST_ASSERT_EQUAL_UINT32(1, handler.timeouts());
+    TEST_ASSERT_EQUAL_UINT32(RR_RANGE_TIMEOUT_US, r.timestamp_us);
+}
+
+void test_echo_ending_after_timeout_is_rejected(void)
+{
+    // HC-SR04 style no echo, the line stays high for ~38ms. the main loop only comes back after it ended.
+    capture.mock_echo(RR_RANGE_0_ECHO_PIN, 450, 38000);
+    run(40000, 40000);
+
+    TEST_ASSERT_FALSE(handler.reading(0).valid);
+    TEST_ASSERT_EQUAL_UINT32(1, handler.timeouts());
+}
+
+void test_echo_beyond_max_range_is_invalid(void)
+{
+    capture.mock_echo(RR_RANGE_0_ECHO_PIN, 450, 450 + width_of(RR_RANGE_MAX_M + 0.5f));
+    run(RR_RANGE_TIMEOUT_US);
+
+    const rr_range::Reading &r = handler.reading(0);
+    TEST_ASSERT_FALSE(r.valid);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, r.distance);
+    TEST_ASSERT_EQUAL_UINT32(0, handler.timeouts());
+}
+
+void test_busy_sensor_is_skipped(void)
+{
+    capture.mock_busy(RR_RANGE_1_ECHO_PIN, true);
+    run(RR_RANGE_SLOT_US);
+
+    TEST_ASSERT_EQUAL_UINT8(RR_RANGE_2_ECHO_PIN, capture.mock_triggered());
+    TEST_ASSERT_EQUAL_UINT32(2, capture.mock_triggers());
+    capture.mock_busy(RR_RANGE_1_ECHO_PIN, false);
+}
+
+void test_skipped_sensor_reading_goes_stale(void)
+{
+    capture.mock_echo(RR_RANGE_1_ECHO_PIN, 450, 450 + width_of(0.2f));
+    run(2 * RR_RANGE_SLOT_US);
+    TEST_ASSERT_TRUE(handler.reading(1).valid);
+    std::uint32_t timestamp = handler.reading(1).timestamp_us;
+
+    capture.mock_busy(RR_RANGE_1_ECHO_PIN, true);
+    run(2 * RR_RANGE_SLOT_US);
+    const rr_range::Reading &r = handler.reading(1);
+    TEST_ASSERT_FALSE(r.valid);
+    TEST_ASSERT_FALSE(r.filtered_valid);
+    // aged from when it was measured.
+    TEST_ASSERT_EQUAL_UINT32(timestamp, r.timestamp_us);
+    capture.mock_busy(RR_RANGE_1_ECHO_PIN, false);
+}
+
+void test_all_busy_counts_no_cycles(void)
+{
+    for (size_t i = 0; i < sizeof(ECHO_PINS); i++)
+    {
+        capture.mock_busy(ECHO_PINS[i], true);
+    }
+    handler.init();
+    std::uint32_t triggers = capture.mock_triggers();
+
+    run(4 * RR_RANGE_SLOT_US);
+    TEST_ASSERT_EQUAL_UINT32(0, handler.cycles());
+    TEST_ASSERT_EQUAL_UINT32(triggers, capture.mock_triggers());
+
+    for (size_t i = 0; i < sizeof(ECHO_PINS); i++)
+    {
+        capture.mock_busy(ECHO_PINS[i], false);
+    }
+    run(RR_RANGE_SLOT_US);
+    TEST_ASSERT_EQUAL_UINT32(triggers + 1, capture.mock_triggers());
+}
+
+void test_dropout_is_filtered(void)
+{
+    const std::uint32_t round = RR_RANGE_SLOT_US * RR_RANGE_SENSORS;
+    capture.mock_echo(RR_RANGE_0_ECHO_PIN, 450, 450 + width_of(0.2f));
+    run(5 * round);
+    TEST_ASSERT_TRUE(handler.reading(0).filtered_valid);
+    TEST_ASSERT_FALSE(handler.reading(0).outlier);
+
+    // one ping without an echo, the raw reading drops out, the filtered one holds.
+    capture.mock_echo(RR_RANGE_0_ECHO_PIN, 0, 0);
+    run(round);
+    const rr_range::Reading &r = handler.reading(0);
+    TEST_ASSERT_FALSE(r.valid);
+    TEST_ASSERT_TRUE(r.outlier);
+    TEST_ASSERT_TRUE(r.filtered_valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.2f, r.filtered);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 5.0f / RR_RANGE_FILTER_WINDOW, r.confidence);
+
+    // the wall is gone for good, the filter follows once most of its window agrees.
+    run(RR_RANGE_FILTER_WINDOW * round);
+    TEST_ASSERT_FALSE(handler.reading(0).filtered_valid);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, handler.reading(0).confidence);
+}
+
+void test_monitor_serves_cache_without_pinging(void)
+{
+    capture.mock_echo(RR_RANGE_0_ECHO_PIN, 450, 450 + width_of(0.1f));
+    run(5000);
+    std::uint32_t triggers = capture.mock_triggers();
+
+    org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+    req.op = rr_ble::MSP_RAW_SENSORS;
+    req.which_data = org_ryderrobots_ros2_serial_Request_monitor_tag;
+    req.data.monitor.is_request = true;
+    org_ryderrobots_ros2_serial_Response res;
+    handler.perform_op(req, res);
+    TEST_ASSERT_EQUAL_INT32(rr_ble::MSP_RAW_SENSORS, res.op);
+    TEST_ASSERT_NOT_EQUAL(org_ryderrobots_ros2_serial_Response_bad_request_tag, res.which_data);
+
+    mock_micros += 3000;
+    org_ryderrobots_mousebot_ExtRequest ereq = org_ryderrobots_mousebot_ExtRequest_init_zero;
+    org_ryderrobots_mousebot_ExtResponse eres = org_ryderrobots_mousebot_ExtResponse_init_zero;
+    handler.perform_ext(ereq, eres);
+
+    TEST_ASSERT_EQUAL_UINT32(triggers, capture.mock_triggers());
+    TEST_ASSERT_TRUE(eres.has_range);
+    TEST_ASSERT_EQUAL(RR_RANGE_SENSORS, eres.range.readings_count);
+    TEST_ASSERT_TRUE(eres.range.readings[0].valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.1f, eres.range.readings[0].distance);
+    TEST_ASSERT_TRUE(eres.range.readings[0].filtered_valid);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.1f, eres.range.readings[0].filtered);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f / RR_RANGE_FILTER_WINDOW, eres.range.readings[0].confidence);
+    TEST_ASSERT_UINT32_WITHIN(1, 7, eres.range.readings[0].age_ms);
+    TEST_ASSERT_FALSE(eres.range.readings[1].valid);
+    TEST_ASSERT_EQUAL_UINT32(0, eres.range.readings[1].age_ms);
+}
+
+void test_perform_op_rejects_other_ops(void)
+{
+    org_ryderrobots_ros2_serial_Request req = org_ryderrobots_ros2_serial_Request_init_zero;
+    req.op = rr_ble::MSP_RAW_IMU;
+    org_ryderrobots_ros2_serial_Response res;
+    handler.perform_op(req, res);
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_Response_bad_request_tag, res.which_data);
+    TEST_ASSERT_EQUAL(org_ryderrobots_ros2_serial_ErrorType_ET_UNKNOWN_OPERATION, res.data.bad_request.etype);
+}
+
+void setUp(void) {
+    mock_micros = 0;
+    for (size_t i = 0; i < sizeof(ECHO_PINS); i++)
+    {
+        capture.mock_echo(ECHO_PINS[i], 0, 0);
+    }
+    handler.init();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_init_pings_first_sensor_only);
+    RUN_TEST(test_echo_is_converted_to_distance);
+    RUN_TEST(test_sensors_are_pinged_in_round_robin);
+    RUN_TEST(test_missing_echo_times_out);
+    RUN_TEST(test_echo_ending_after_timeout_is_rejected);
+    RUN_TEST(test_echo_beyond_max_range_is_invalid);
+    RUN_TEST(test_busy_sensor_is_skipped);
+    RUN_TEST(test_skipped_sensor_reading_goes_stale);
+    RUN_TEST(test_all_busy_counts_no_cycles);
+    RUN_TEST(test_dropout_is_filtered);
+    RUN_TEST(test_monitor_serves_cache_without_pinging);
+    RUN_TEST(test_perform_op_rejects_other_ops);
+    return UNITY_END();
+}
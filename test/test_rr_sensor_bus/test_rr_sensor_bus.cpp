@@ -0,0 +1,158 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <unity.h>
+
+#include <cstring>
+
+#include "Arduino.h"
+#include <rr_sensor_bus.hpp>
+
+using namespace rr_sensor_bus;
+
+// Mock Arduino functions
+unsigned long mock_millis_value = 0;
+unsigned long millis() { return mock_millis_value; }
+void delay(unsigned long ms) { mock_millis_value += ms; }
+
+// 256 byte register file per address, that NACKs anything other than 0x68
+class MockRegisters : public MockDevice {
+public:
+    std::uint8_t regs[256];
+    int transfers = 0;
+
+    bool read(std::uint8_t addr, std::uint8_t reg, std::uint8_t *buf, size_t len) override {
+        transfers++;
+        if (addr != 0x68) {
+            return false;
+        }
+        std::memcpy(buf, &regs[reg], len);
+        return true;
+    }
+
+    bool write(std::uint8_t addr, std::uint8_t reg, const std::uint8_t *buf, size_t len) override {
+        transfers++;
+        if (addr != 0x68) {
+            return false;
+        }
+        std::memcpy(&regs[reg], buf, len);
+        return true;
+    }
+};
+
+MockRegisters mock_dev;
+
+struct Completion {
+    int calls = 0;
+    bool ok = false;
+    int order = 0;
+};
+
+static int completion_seq = 0;
+
+static void on_complete(void *ctx, bool ok) {
+    Completion *c = static_cast<Completion *>(ctx);
+    c->calls++;
+    c->ok = ok;
+    c->order = ++completion_seq;
+}
+
+void test_read_completes_on_poll(void) {
+    SensorBus &bus = SensorBus::get_instance();
+    mock_dev.regs[0x0C] = 0x34;
+    mock_dev.regs[0x0D] = 0x12;
+
+    std::uint8_t buf[2] = {0, 0};
+    Completion c;
+    TEST_ASSERT_TRUE(bus.read(0x68, 0x0C, buf, sizeof(buf), on_complete, &c));
+    TEST_ASSERT_FALSE(bus.idle());
+
+    // nothing happens until the scheduler polls
+    TEST_ASSERT_EQUAL(0, c.calls);
+    TEST_ASSERT_EQUAL(0, buf[0]);
+
+    bus.poll();
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_TRUE(c.ok);
+    TEST_ASSERT_EQUAL(0x34, buf[0]);
+    TEST_ASSERT_EQUAL(0x12, buf[1]);
+    TEST_ASSERT_TRUE(bus.idle());
+}
+
+void test_transfers_complete_in_order(void) {
+    SensorBus &bus = SensorBus::get_instance();
+    std::uint8_t val = 0xA5;
+    std::uint8_t buf = 0;
+    Completion w, r;
+
+    TEST_ASSERT_TRUE(bus.write(0x68, 0x40, &val, 1, on_complete, &w));
+    TEST_ASSERT_TRUE(bus.read(0x68, 0x40, &buf, 1, on_complete, &r));
+    bus.poll();
+
+    TEST_ASSERT_TRUE(w.order < r.order);
+    TEST_ASSERT_EQUAL(0xA5, buf);
+}
+
+void test_nack_counts_error(void) {
+    SensorBus &bus = SensorBus::get_instance();
+    std::uint32_t errors = bus.errors();
+    std::uint8_t buf[1];
+    Completion c;
+
+    TEST_ASSERT_TRUE(bus.read(0x29, 0x00, buf, 1, on_complete, &c));
+    bus.poll();
+    TEST_ASSERT_EQUAL(1, c.calls);
+    TEST_ASSERT_FALSE(c.ok);
+    TEST_ASSERT_EQUAL(errors + 1, bus.errors());
+}
+
+void test_queue_full_and_invalid_transfers(void) {
+    SensorBus &bus = SensorBus::get_instance();
+    std::uint8_t buf[1];
+    std::uint8_t data[SensorBus::MAX_WRITE + 1] = {0};
+
+    TEST_ASSERT_FALSE(bus.read(0x68, 0x00, buf, 0, nullptr, nullptr));
+    TEST_ASSERT_FALSE(bus.write(0x68, 0x00, data, sizeof(data), nullptr, nullptr));
+
+    for (size_t i = 0; i < SensorBus::QUEUE_LEN; i++) {
+        TEST_ASSERT_TRUE(bus.read(0x68, 0x00, buf, 1, nullptr, nullptr));
+    }
+    TEST_ASSERT_FALSE(bus.read(0x68, 0x00, buf, 1, nullptr, nullptr));
+    TEST_ASSERT_TRUE(bus.flush(10));
+    TEST_ASSERT_TRUE(bus.idle());
+}
+
+void setUp(void) {
+    SensorBus::get_instance().attach_mock(&mock_dev);
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_read_completes_on_poll);
+    RUN_TEST(test_transfers_complete_in_order);
+    RUN_TEST(test_nack_counts_error);
+    RUN_TEST(test_queue_full_and_invalid_transfers);
+    return UNITY_END();
+}
@@ -0,0 +1,487 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <cmath>
+#include <cstdint>
+#include <rr_math.hpp>
+#include <rr_sim_clock.hpp>
+#include <rr_sim_imu.hpp>
+#include <rr_sim_random.hpp>
+#include <rr_sim_robot.hpp>
+#include <rr_sim_sensors.hpp>
+#include <rr_sim_wdt.hpp>
+#include <rr_sim_world.hpp>
+
+using namespace rr_sim;
+
+static const float CELL = RR_MAZE_CELL_M;
+static const float FACE = 0.5f * RR_MAZE_WALL_M;
+static const Noise PERFECT = {0.0f, 0.0f, 0.0f, 0.0f};
+
+// two by two cells, the start cell closed to the north.
+static const char *TWO_CELLS =
+    "+---+---+\n"
+    "|       |\n"
+    "+---+   +\n"
+    "|       |\n"
+    "+---+---+\n";
+
+// drives both wheels for us of physics steps.
+static void drive(Robot &robot, const World &world, float left, float right, std::uint32_t us)
+{
+    const float d[2] = {left, right};
+    for (std::uint32_t t = 0; t < us; t += RR_SIM_PHYSICS_US)
+    {
+        robot.step(d, RR_SIM_PHYSICS_US, world);
+    }
+}
+
+void test_stepped_clock_moves_by_step_and_sleep(void)
+{
+    Clock clock;
+    clock.start_stepped(250);
+    TEST_ASSERT_EQUAL(Clock::STEPPED, clock.mode());
+    TEST_ASSERT_EQUAL_UINT64(0, clock.now_us());
+
+    clock.step();
+    clock.step();
+    TEST_ASSERT_EQUAL_UINT64(500, clock.now_us());
+
+    // delay() passes time without a loop iteration.
+    clock.sleep(10000);
+    TEST_ASSERT_EQUAL_UINT64(10500, clock.now_us());
+}
+
+void test_realtime_clock_follows_host(void)
+{
+    Clock clock;
+    clock.start_realtime();
+    std::uint64_t start = clock.now_us();
+
+    // step() is only a marker in real time.
+    clock.step();
+    clock.sleep(2000);
+    std::uint64_t elapsed = clock.now_us() - start;
+    TEST_ASSERT_TRUE(elapsed >= 2000);
+    TEST_ASSERT_TRUE(elapsed < 1000000);
+}
+
+void test_imu_registers_read_back(void)
+{
+    Bmi270 imu;
+    std::uint8_t conf[] = {0xA8};
+    TEST_ASSERT_TRUE(imu.write(Bmi270::ADDR, Bmi270::REG_ACC_CONF, conf, 1));
+
+    std::uint8_t out = 0;
+    TEST_ASSERT_TRUE(imu.read(Bmi270::ADDR, Bmi270::REG_ACC_CONF, &out, 1));
+    TEST_ASSERT_EQUAL_HEX8(0xA8, out);
+
+    // not acknowledged at any other address, or past the register file.
+    TEST_ASSERT_FALSE(imu.write(0x69, Bmi270::REG_ACC_CONF, conf, 1));
+    TEST_ASSERT_FALSE(imu.read(Bmi270::ADDR, 0x7F, &out, 2));
+}
+
+void test_imu_burst_serves_motion(void)
+{
+    Bmi270 imu;
+    std::uint8_t raw[Bmi270::DATA_LEN];
+    TEST_ASSERT_TRUE(imu.read(Bmi270::ADDR, Bmi270::REG_DATA_8, raw, sizeof(raw)));
+
+    // at rest, 1g on z at +/- 4g is 8192 LSB.
+    TEST_ASSERT_EQUAL_HEX8(0x00, raw[4]);
+    TEST_ASSERT_EQUAL_HEX8(0x20, raw[5]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, raw[11]);
+
+    const float gyro[3] = {0.0f, 0.0f, -90.0f};
+    const float accel[3] = {0.5f, 0.0f, 1.0f};
+    imu.set_motion(gyro, accel);
+    TEST_ASSERT_TRUE(imu.read(Bmi270::ADDR, Bmi270::REG_DATA_8, raw, sizeof(raw)));
+    std::int16_t ax = static_cast<std::int16_t>(raw[0] | (raw[1] << 8));
+    std::int16_t gz = static_cast<std::int16_t>(raw[10] | (raw[11] << 8));
+    TEST_ASSERT_EQUAL_INT16(4096, ax);
+    TEST_ASSERT_EQUAL_INT16(Bmi270::encode(-90.0f, Bmi270::GYR_LSB_PER_DPS), gz);
+    TEST_ASSERT_EQUAL_UINT32(2, imu.bursts());
+}
+
+void test_imu_data_replays_burst(void)
+{
+    Bmi270 imu;
+    const float gyro[3] = {12.5f, -3.0f, 250.0f};
+    const float accel[3] = {-0.25f, 0.125f, 0.98f};
+    imu.set_motion(gyro, accel);
+    std::uint8_t recorded[Bmi270::DATA_LEN];
+    imu.data(recorded);
+
+    Bmi270 replayed;
+    replayed.set_data(recorded);
+    std::uint8_t raw[Bmi270::DATA_LEN];
+    TEST_ASSERT_TRUE(replayed.read(Bmi270::ADDR, Bmi270::REG_DATA_8, raw, sizeof(raw)));
+    TEST_ASSERT_EQUAL_MEMORY(recorded, raw, sizeof(raw));
+}
+
+void test_imu_encode_clamps(void)
+{
+    TEST_ASSERT_EQUAL_INT16(32767, Bmi270::encode(5.0f, Bmi270::ACC_LSB_PER_G));
+    TEST_ASSERT_EQUAL_INT16(-32768, Bmi270::encode(-3000.0f, Bmi270::GYR_LSB_PER_DPS));
+    TEST_ASSERT_EQUAL_INT16(16, Bmi270::encode(1.0f, Bmi270::GYR_LSB_PER_DPS));
+}
+
+void test_imu_data_ready_follows_odr(void)
+{
+    Bmi270 imu;
+
+    // nothing until the output data rate is written.
+    TEST_ASSERT_EQUAL_UINT32(0, imu.period_us());
+    TEST_ASSERT_EQUAL_UINT32(0, imu.data_ready(1000000));
+
+    // 400 Hz.
+    std::uint8_t conf[] = {0xAA};
+    imu.write(Bmi270::ADDR, Bmi270::REG_ACC_CONF, conf, 1);
+    TEST_ASSERT_EQUAL_UINT32(2500, imu.period_us());
+    TEST_ASSERT_EQUAL_UINT32(0, imu.data_ready(0));
+    TEST_ASSERT_EQUAL_UINT32(0, imu.data_ready(2499));
+    TEST_ASSERT_EQUAL_UINT32(1, imu.data_ready(2500));
+    TEST_ASSERT_EQUAL_UINT32(0, imu.data_ready(4999));
+
+    // a late check sees every pulse it missed.
+    TEST_ASSERT_EQUAL_UINT32(4, imu.data_ready(12600));
+    TEST_ASSERT_EQUAL_UINT32(1, imu.data_ready(15000));
+
+    // 12.5 Hz.
+    conf[0] = 0xA5;
+    imu.write(Bmi270::ADDR, Bmi270::REG_ACC_CONF, conf, 1);
+    TEST_ASSERT_EQUAL_UINT32(80000, imu.period_us());
+    TEST_ASSERT_EQUAL_UINT32(0, imu.data_ready(20000));
+    TEST_ASSERT_EQUAL_UINT32(1, imu.data_ready(100000));
+}
+
+void test_watchdog_reloads_on_rounds(void)
+{
+    Watchdog wdt;
+
+    // not running until started.
+    TEST_ASSERT_TRUE(wdt.check(0, 100000000));
+    TEST_ASSERT_FALSE(wdt.running());
+
+    wdt.start(5000, 0, 0);
+    TEST_ASSERT_TRUE(wdt.check(1, 4000000));
+    TEST_ASSERT_TRUE(wdt.check(1, 9000000));
+    TEST_ASSERT_EQUAL_UINT64(5000000, wdt.since_reload_us(9000000));
+
+    // loop statistics cleared, the count restarts.
+    TEST_ASSERT_TRUE(wdt.check(0, 9500000));
+    TEST_ASSERT_FALSE(wdt.expired());
+}
+
+void test_watchdog_expires_without_rounds(void)
+{
+    Watchdog wdt;
+    wdt.start(5000, 7, 1000);
+    TEST_ASSERT_TRUE(wdt.check(7, 5001000));
+    TEST_ASSERT_FALSE(wdt.check(7, 5001001));
+    TEST_ASSERT_TRUE(wdt.expired());
+
+    // once expired a round is too late.
+    TEST_ASSERT_FALSE(wdt.check(8, 5002000));
+}
+
+void test_rng_is_repeatable(void)
+{
+    Rng a(42);
+    Rng b(42);
+    Rng c(43);
+    bool differs = false;
+    for (int i = 0; i < 100; i++)
+    {
+        std::uint32_t v = a.next();
+        TEST_ASSERT_EQUAL_UINT32(v, b.next());
+        differs = differs || v != c.next();
+    }
+    TEST_ASSERT_TRUE(differs);
+
+    // first draws of a fixed seed, so a change to the generator shows up as a change to every recorded run.
+    Rng d(0);
+    Rng e(0);
+    TEST_ASSERT_EQUAL_UINT32(e.next(), d.next());
+    TEST_ASSERT_TRUE(d.below(7) < 7);
+}
+
+void test_rng_gaussian_statistics(void)
+{
+    Rng rng(7);
+    const int N = 20000;
+    double sum = 0.0;
+    double squares = 0.0;
+    for (int i = 0; i < N; i++)
+    {
+        double g = rng.gaussian();
+        sum += g;
+        squares += g * g;
+    }
+    double mean = sum / N;
+    double sd = std::sqrt(squares / N - mean * mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, 0.0f, static_cast<float>(mean));
+    TEST_ASSERT_FLOAT_WITHIN(0.03f, 1.0f, static_cast<float>(sd));
+}
+
+void test_world_cast_open_maze(void)
+{
+    World world;
+    float mid = 0.5f * CELL;
+
+    // the outer walls, west and south of the start cell.
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, mid - FACE, world.cast(mid, mid, rr_math::PI, 5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, mid - FACE, world.cast(mid, mid, -rr_math::HALF_PI, 5.0f));
+
+    // up the middle of the first column, between the posts, to the north wall.
+    float north = rr_maze::SIZE * CELL - FACE - mid;
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, north, world.cast(mid, mid, rr_math::HALF_PI, 5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, world.cast(mid, mid, rr_math::HALF_PI, 1.0f));
+
+    // along a grid line the posts are in the way, at the first corner.
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, CELL - FACE - mid, world.cast(mid, CELL, 0.0f, 5.0f));
+
+    // nothing seen from outside.
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, world.cast(-0.1f, mid, 0.0f, 5.0f));
+}
+
+void test_world_load_text_maze(void)
+{
+    World world;
+    TEST_ASSERT_TRUE(world.load(TWO_CELLS));
+    const rr_maze::MazeMap &walls = world.walls();
+    TEST_ASSERT_TRUE(walls.wall(0, 0, rr_maze::H_NORTH));
+    TEST_ASSERT_FALSE(walls.wall(0, 0, rr_maze::H_EAST));
+    TEST_ASSERT_FALSE(walls.wall(1, 0, rr_maze::H_NORTH));
+    TEST_ASSERT_TRUE(walls.wall(1, 0, rr_maze::H_EAST));
+
+    float mid = 0.5f * CELL;
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, mid - FACE, world.cast(mid, mid, rr_math::HALF_PI, 5.0f));
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.0f * CELL - FACE - mid, world.cast(mid, mid, 0.0f, 5.0f));
+
+    // a line of the wrong width, or too few lines, leaves the maze as it was.
+    TEST_ASSERT_FALSE(world.load("+--+\n|  |\n+--+\n"));
+    TEST_ASSERT_FALSE(world.load("+---+\n"));
+    TEST_ASSERT_TRUE(world.walls().wall(0, 0, rr_maze::H_NORTH));
+}
+
+void test_world_generate_is_perfect_maze(void)
+{
+    World a;
+    World b;
+    a.generate(3, 0);
+    b.generate(3, 0);
+
+    // a spanning tree of the cells, opening CELLS - 1 walls, the same for the same seed.
+    int open = 0;
+    for (std::uint8_t y = 0; y < rr_maze::SIZE; y++)
+    {
+        for (std::uint8_t x = 0; x < rr_maze::SIZE; x++)
+        {
+            for (std::uint8_t h = rr_maze::H_NORTH; h <= rr_maze::H_EAST; h++)
+            {
+                bool wall = a.walls().wall(x, y, static_cast<rr_maze::Heading>(h));
+                TEST_ASSERT_EQUAL(wall, b.walls().wall(x, y, static_cast<rr_maze::Heading>(h)));
+                open += wall ? 0 : 1;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(rr_maze::CELLS - 1, open);
+}
+
+void test_robot_drives_straight(void)
+{
+    World world;
+    Robot robot;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, rr_math::HALF_PI, robot.truth().heading);
+
+    drive(robot, world, 0.5f, 0.5f, 1000000);
+    const Truth &t = robot.truth();
+    float speed = 0.5f * RR_SIM_WHEEL_MAX_MPS;
+
+    // up to speed after a few time constants, having lost tau * speed to the lag.
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, speed, t.v);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, t.omega);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f * CELL, t.x);
+    TEST_ASSERT_FLOAT_WITHIN(2e-3f, 0.5f * CELL + speed * (1.0f - RR_SIM_MOTOR_TAU_S), t.y);
+    TEST_ASSERT_EQUAL_UINT64(1000000, t.time_us);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, t.y - 0.5f * CELL, static_cast<float>(t.odometer_m[LEFT]));
+    TEST_ASSERT_EQUAL_UINT32(0, robot.collisions());
+}
+
+void test_robot_turns_in_place(void)
+{
+    World world;
+    Robot robot;
+    drive(robot, world, -0.25f, 0.25f, 500000);
+    const Truth &t = robot.truth();
+
+    float omega = 2.0f * 0.25f * RR_SIM_WHEEL_MAX_MPS / RR_WHEEL_BASE_M;
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, omega, t.omega);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f * CELL, t.x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f * CELL, t.y);
+    float turned = omega * (0.5f - RR_SIM_MOTOR_TAU_S);
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, rr_math::wrap_pi(rr_math::HALF_PI + turned), t.heading);
+
+    // in a turn the wheels still turn through distance.
+    TEST_ASSERT_TRUE(t.odometer_m[LEFT] > 0.0);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, static_cast<float>(t.odometer_m[LEFT]), static_cast<float>(t.odometer_m[RIGHT]));
+}
+
+void test_robot_stops_at_wall(void)
+{
+    World world;
+    TEST_ASSERT_TRUE(world.load(TWO_CELLS));
+    Robot robot;
+    drive(robot, world, 1.0f, 1.0f, 1000000);
+    const Truth &t = robot.truth();
+
+    // the body came to rest against the wall north of the start cell, and stays there.
+    TEST_ASSERT_EQUAL_UINT32(1, robot.collisions());
+    TEST_ASSERT_TRUE(robot.contact());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, CELL - FACE - RR_SIM_BODY_RADIUS_M, t.y);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, t.v);
+
+    // backing away frees it.
+    drive(robot, world, -0.5f, -0.5f, 200000);
+    TEST_ASSERT_FALSE(robot.contact());
+    TEST_ASSERT_EQUAL_UINT32(1, robot.collisions());
+}
+
+void test_sensors_follow_truth(void)
+{
+    World world;
+    Robot robot;
+    Sensors sensors(1, PERFECT);
+    drive(robot, world, 0.25f, 0.5f, 300000);
+    const Truth &t = robot.truth();
+
+    float gyro[3];
+    float accel[3];
+    sensors.imu(t, gyro, accel);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, t.omega * 57.2957795f, gyro[2]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, gyro[0]);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, accel[2]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, t.v * t.omega / 9.80665f, accel[1]);
+
+    // every edge once, whenever the counter is read.
+    std::uint32_t edges = sensors.edges(t, RIGHT);
+    double per_edge = 3.14159265358979 * RR_WHEEL_DIAMETER_M / RR_ENCODER_TICKS_PER_REV;
+    TEST_ASSERT_EQUAL_UINT32(static_cast<std::uint32_t>(t.odometer_m[RIGHT] / per_edge), edges);
+    TEST_ASSERT_EQUAL_UINT32(0, sensors.edges(t, RIGHT));
+
+    // facing west from the middle of the start cell, the sensor face 0.04 m ahead of the centre.
+    Robot west;
+    west.place(0.5f * CELL, 0.5f * CELL, rr_math::PI);
+    const RangeMount front = {0.0f, 0.04f};
+    float d = 0.0f;
+    TEST_ASSERT_TRUE(sensors.range(world, west.truth(), front, 2.0f, d));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f * CELL - FACE - 0.04f, d);
+
+    // out of range is no echo.
+    const RangeMount left = {-rr_math::HALF_PI, 0.03f};
+    TEST_ASSERT_FALSE(sensors.range(world, west.truth(), left, 2.0f, d));
+}
+
+void test_sensor_noise_is_seeded(void)
+{
+    Robot robot;
+    Sensors a(5);
+    Sensors b(5);
+    Sensors c(6);
+    float ga[3], aa[3], gb[3], ab[3], gc[3], ac[3];
+
+    // the same bias, and noise, for the same seed, around the bias for a robot at rest.
+    double sum = 0.0;
+    double squares = 0.0;
+    const int N = 4000;
+    for (int i = 0; i < N; i++)
+    {
+        a.imu(robot.truth(), ga, aa);
+        b.imu(robot.truth(), gb, ab);
+        c.imu(robot.truth(), gc, ac);
+        TEST_ASSERT_EQUAL_FLOAT(ga[2], gb[2]);
+        TEST_ASSERT_EQUAL_FLOAT(aa[0], ab[0]);
+        double e = ga[2] - a.gyro_bias_dps()[2];
+        sum += e;
+        squares += e * e;
+    }
+    TEST_ASSERT_TRUE(a.gyro_bias_dps()[2] != c.gyro_bias_dps()[2]);
+    double sd = std::sqrt(squares / N - (sum / N) * (sum / N));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * RR_SIM_GYRO_NOISE_DPS, RR_SIM_GYRO_NOISE_DPS, static_cast<float>(sd));
+
+    // range readings draw from their own stream, so they do not shift the IMU's.
+    World world;
+    Sensors d(5);
+    float dist;
+    d.range(world, robot.truth(), {rr_math::PI, 0.03f}, 2.0f, dist);
+    Sensors e(5);
+    d.imu(robot.truth(), ga, aa);
+    e.imu(robot.truth(), gb, ab);
+    TEST_ASSERT_EQUAL_FLOAT(gb[2], ga[2]);
+}
+
+void test_sensor_echo_timing(void)
+{
+    std::uint32_t rise;
+    std::uint32_t fall;
+
+    // 0.343 m and back at 343 m/s is 2 ms.
+    Sensors::echo(0.343f, 343.0f, rise, fall);
+    TEST_ASSERT_EQUAL_UINT32(RR_SIM_ECHO_DELAY_US, rise);
+    TEST_ASSERT_EQUAL_UINT32(RR_SIM_ECHO_DELAY_US + 2000, fall);
+}
+
+void setUp(void) {
+    // Set up code if needed
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_stepped_clock_moves_by_step_and_sleep);
+    RUN_TEST(test_realtime_clock_follows_host);
+    RUN_TEST(test_imu_registers_read_back);
+    RUN_TEST(test_imu_burst_serves_motion);
+    RUN_TEST(test_imu_data_replays_burst);
+    RUN_TEST(test_imu_encode_clamps);
+    RUN_TEST(test_imu_data_ready_follows_odr);
+    RUN_TEST(test_watchdog_reloads_on_rounds);
+    RUN_TEST(test_watchdog_expires_without_rounds);
+    RUN_TEST(test_rng_is_repeatable);
+    RUN_TEST(test_rng_gaussian_statistics);
+    RUN_TEST(test_world_cast_open_maze);
+    RUN_TEST(test_world_load_text_maze);
+    RUN_TEST(test_world_generate_is_perfect_maze);
+    RUN_TEST(test_robot_drives_straight);
+    RUN_TEST(test_robot_turns_in_place);
+    RUN_TEST(test_robot_stops_at_wall);
+    RUN_TEST(test_sensors_follow_truth);
+    RUN_TEST(test_sensor_noise_is_seeded);
+    RUN_TEST(test_sensor_echo_timing);
+    return UNITY_END();
+}
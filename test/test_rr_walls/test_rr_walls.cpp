@@ -0,0 +1,278 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <cmath>
+#include <rr_math.hpp>
+#include <rr_walls.hpp>
+
+using namespace rr_walls;
+
+static const float CELL = 0.18f;
+static const float FACE = 0.006f;
+static const float OFFSET = 0.03f;
+static const float MARGIN = 0.005f;
+
+static const Mount LEFT = {rr_math::HALF_PI, OFFSET, true};
+static const Mount FRONT = {0.0f, OFFSET, false};
+static const Mount RIGHT = {-rr_math::HALF_PI, OFFSET, true};
+
+static WallDetector detector;
+
+static rr_pose::Pose pose_at(float x, float y, float heading)
+{
+    return {x, y, heading, 0.0f, 0.0f, 0.0f, 0.0f};
+}
+
+// echo from a surface at metres from the robot centre, seen by a sensor at OFFSET.
+static Observation echo_at(float metres)
+{
+    return {true, metres - OFFSET, 1.0f};
+}
+
+static const Observation NO_ECHO = {false, 0.0f, 0.0f};
+
+void test_cell_sides_are_classified(void)
+{
+    // middle of the start cell, facing north.
+    rr_pose::Pose p = pose_at(0.09f, 0.09f, rr_math::HALF_PI);
+    CellWalls left;
+    TEST_ASSERT_FALSE(detector.update(p, left));
+    TEST_ASSERT_TRUE(detector.in_cell());
+
+    detector.observe(p, LEFT, echo_at(0.09f - FACE));
+    detector.observe(p, RIGHT, echo_at(0.09f + CELL - FACE));
+    detector.observe(p, FRONT, NO_ECHO);
+
+    const CellWalls &c = detector.current();
+    TEST_ASSERT_EQUAL_UINT8(0, c.x);
+    TEST_ASSERT_EQUAL_UINT8(0, c.y);
+    TEST_ASSERT_EQUAL_UINT8(WEST, c.walls);
+    TEST_ASSERT_EQUAL_UINT8(WEST | EAST | NORTH, c.seen);
+}
+
+void test_sides_follow_heading(void)
+{
+    // cell (2, 3) facing west, the left sensor looks south, the right one north.
+    rr_pose::Pose p = pose_at(2.5f * CELL, 3.5f * CELL, rr_math::PI);
+    CellWalls left;
+    detector.update(p, left);
+
+    detector.observe(p, LEFT, echo_at(0.09f - FACE));
+    detector.observe(p, RIGHT, echo_at(0.09f - FACE));
+    detector.observe(p, FRONT, echo_at(0.09f - FACE));
+
+    const CellWalls &c = detector.current();
+    TEST_ASSERT_EQUAL_UINT8(2, c.x);
+    TEST_ASSERT_EQUAL_UINT8(3, c.y);
+    TEST_ASSERT_EQUAL_UINT8(SOUTH | NORTH | WEST, c.walls);
+}
+
+void test_hysteresis_holds_between_thresholds(void)
+{
+    rr_pose::Pose p = pose_at(0.09f, 0.09f, rr_math::HALF_PI);
+    CellWalls left;
+    detector.update(p, left);
+    const float face = 0.09f - FACE;
+
+    // readings inside the band do not classify an unseen side.
+    detector.observe(p, FRONT, echo_at(face + 0.035f));
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().seen);
+
+    detector.observe(p, FRONT, echo_at(face + 0.01f));
+    TEST_ASSERT_EQUAL_UINT8(NORTH, detector.current().walls);
+
+    // a wall stays a wall until a reading passes off_m.
+    detector.observe(p, FRONT, echo_at(face + 0.045f));
+    TEST_ASSERT_EQUAL_UINT8(NORTH, detector.current().walls);
+    detector.observe(p, FRONT, echo_at(face + 0.06f));
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().walls);
+
+    // and open stays open until a reading is within on_m.
+    detector.observe(p, FRONT, echo_at(face + 0.025f));
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().walls);
+    TEST_ASSERT_EQUAL_UINT8(NORTH, detector.current().seen);
+}
+
+void test_crossing_reports_cell_left(void)
+{
+    CellWalls left;
+    rr_pose::Pose p = pose_at(0.09f, 0.09f, rr_math::HALF_PI);
+    detector.update(p, left);
+    detector.observe(p, LEFT, echo_at(0.09f - FACE));
+    detector.observe(p, RIGHT, echo_at(0.09f - FACE));
+
+    // still in the cell, or not past it by the margin.
+    p = pose_at(0.09f, 0.179f, rr_math::HALF_PI);
+    TEST_ASSERT_FALSE(detector.update(p, left));
+    p = pose_at(0.09f, CELL + MARGIN - 0.001f, rr_math::HALF_PI);
+    TEST_ASSERT_FALSE(detector.update(p, left));
+
+    p = pose_at(0.09f, CELL + MARGIN + 0.001f, rr_math::HALF_PI);
+    TEST_ASSERT_TRUE(detector.update(p, left));
+    TEST_ASSERT_EQUAL_UINT8(0, left.x);
+    TEST_ASSERT_EQUAL_UINT8(0, left.y);
+    TEST_ASSERT_EQUAL_UINT8(WEST | EAST, left.walls);
+    TEST_ASSERT_EQUAL_UINT8(WEST | EAST, left.seen);
+
+    // the new cell starts unseen.
+    TEST_ASSERT_EQUAL_UINT8(1, detector.current().y);
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().seen);
+}
+
+void test_boundary_noise_emits_one_cell(void)
+{
+    CellWalls left;
+    rr_pose::Pose p = pose_at(0.09f, 0.09f, rr_math::HALF_PI);
+    detector.update(p, left);
+
+    // pose noise either side of the boundary, within the margin.
+    int crossed = 0;
+    for (int i = 0; i < 20; i++)
+    {
+        p = pose_at(0.09f, CELL + ((i % 2 == 0) ? 0.003f : -0.003f), rr_math::HALF_PI);
+        crossed += detector.update(p, left) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(0, crossed);
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().y);
+
+    p = pose_at(0.09f, CELL + 0.02f, rr_math::HALF_PI);
+    TEST_ASSERT_TRUE(detector.update(p, left));
+    TEST_ASSERT_EQUAL_UINT8(0, left.y);
+
+    // and once in the next cell, noise on the same boundary does not go back.
+    for (int i = 0; i < 20; i++)
+    {
+        p = pose_at(0.09f, CELL + ((i % 2 == 0) ? 0.003f : -0.003f), rr_math::HALF_PI);
+        crossed += detector.update(p, left) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(0, crossed);
+    TEST_ASSERT_EQUAL_UINT8(1, detector.current().y);
+}
+
+void test_side_sensors_only_observe_mid_cell(void)
+{
+    CellWalls left;
+    // near the northern edge of the cell, the side sensor would see the post.
+    rr_pose::Pose p = pose_at(0.09f, 0.16f, rr_math::HALF_PI);
+    detector.update(p, left);
+    detector.observe(p, LEFT, echo_at(0.09f - FACE));
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().seen);
+
+    // the front sensor still observes there.
+    detector.observe(p, FRONT, echo_at(0.02f - FACE));
+    TEST_ASSERT_EQUAL_UINT8(NORTH, detector.current().walls);
+}
+
+void test_skewed_beams(void)
+{
+    CellWalls left;
+    // 10 degrees off north, the slant range to the front wall is longer than the distance.
+    float skew = 10.0f * rr_math::PI / 180.0f;
+    rr_pose::Pose p = pose_at(0.09f, 0.09f, rr_math::HALF_PI + skew);
+    detector.update(p, left);
+    detector.observe(p, FRONT, echo_at((0.09f - FACE) / std::cos(skew)));
+    TEST_ASSERT_EQUAL_UINT8(NORTH, detector.current().walls);
+
+    // too far off any axis to tell which side it hit.
+    p = pose_at(0.09f, 0.09f, rr_math::HALF_PI + 0.6f);
+    detector.observe(p, RIGHT, echo_at(0.05f));
+    TEST_ASSERT_EQUAL_UINT8(NORTH, detector.current().seen);
+}
+
+void test_low_confidence_echo_is_ignored(void)
+{
+    CellWalls left;
+    rr_pose::Pose p = pose_at(0.09f, 0.09f, 0.0f);
+    detector.update(p, left);
+    detector.observe(p, FRONT, {true, 0.05f, 0.3f});
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().seen);
+    detector.observe(p, FRONT, {true, 0.05f, 0.6f});
+    TEST_ASSERT_EQUAL_UINT8(EAST, detector.current().walls);
+}
+
+void test_outside_maze(void)
+{
+    CellWalls left;
+    rr_pose::Pose p = pose_at(-0.05f, 0.09f, 0.0f);
+    TEST_ASSERT_FALSE(detector.update(p, left));
+    TEST_ASSERT_FALSE(detector.in_cell());
+    detector.observe(p, FRONT, echo_at(0.05f));
+    TEST_ASSERT_EQUAL_UINT8(0, detector.current().seen);
+
+    p = pose_at(0.01f, 0.09f, 0.0f);
+    TEST_ASSERT_FALSE(detector.update(p, left));
+    TEST_ASSERT_TRUE(detector.in_cell());
+
+    // leaving the maze still reports the last cell.
+    p = pose_at(16 * CELL + 0.01f, 0.09f, 0.0f);
+    detector.update(p, left);
+    p = pose_at(15.5f * CELL, 0.09f, 0.0f);
+    detector.update(p, left);
+    p = pose_at(16 * CELL + 0.01f, 0.09f, 0.0f);
+    TEST_ASSERT_TRUE(detector.update(p, left));
+    TEST_ASSERT_EQUAL_UINT8(15, left.x);
+    TEST_ASSERT_FALSE(detector.in_cell());
+}
+
+void test_rejects_bad_thresholds(void)
+{
+    TEST_ASSERT_FALSE(detector.set_thresholds({0.05f, 0.02f, 0.5f}));
+    TEST_ASSERT_FALSE(detector.set_thresholds({0.02f, 0.05f, 1.5f}));
+    TEST_ASSERT_FALSE(detector.set_thresholds({-0.01f, 0.05f, 0.5f}));
+    TEST_ASSERT_EQUAL_FLOAT(0.02f, detector.thresholds().on_m);
+
+    TEST_ASSERT_TRUE(detector.set_thresholds({0.01f, 0.08f, 0.2f}));
+    TEST_ASSERT_EQUAL_FLOAT(0.08f, detector.thresholds().off_m);
+
+    Maze maze = {0.18f, 0.2f, 16};
+    TEST_ASSERT_FALSE(detector.configure(maze, 0.35f, 0.05f, 0.005f));
+    maze.wall_m = 0.012f;
+    TEST_ASSERT_FALSE(detector.configure(maze, 0.35f, 0.05f, 0.1f));
+    TEST_ASSERT_FALSE(detector.configure(maze, 0.35f, 0.05f, -0.001f));
+}
+
+void setUp(void) {
+    Maze maze = {CELL, 2.0f * FACE, 16};
+    detector.configure(maze, 0.35f, 0.05f, MARGIN);
+    detector.set_thresholds({0.02f, 0.05f, 0.5f});
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cell_sides_are_classified);
+    RUN_TEST(test_sides_follow_heading);
+    RUN_TEST(test_hysteresis_holds_between_thresholds);
+    RUN_TEST(test_crossing_reports_cell_left);
+    RUN_TEST(test_boundary_noise_emits_one_cell);
+    RUN_TEST(test_side_sensors_only_observe_mid_cell);
+    RUN_TEST(test_skewed_beams);
+    RUN_TEST(test_low_confidence_echo_is_ignored);
+    RUN_TEST(test_outside_maze);
+    RUN_TEST(test_rejects_bad_thresholds);
+    return UNITY_END();
+}
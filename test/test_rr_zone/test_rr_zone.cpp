@@ -0,0 +1,193 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+// zones are compiled in for these tests, as they are in a profiling build.
+#define RR_ZONE_PROFILE 1
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <rr_zone.hpp>
+
+using namespace rr_zone;
+
+static Profiler &profiler = Profiler::get_instance();
+
+static volatile float sink;
+
+static void work(int n)
+{
+    float x = 0.0f;
+    for (int i = 0; i < n; i++)
+    {
+        x += static_cast<float>(i) * 0.5f;
+    }
+    sink = x;
+}
+
+void test_record_aggregates(void)
+{
+    profiler.record(ZONE_DECODE, 100, 130);
+    profiler.record(ZONE_DECODE, 200, 210);
+    profiler.record(ZONE_DECODE, 300, 350);
+
+    const ZoneStats &z = profiler.zone(ZONE_DECODE);
+    TEST_ASSERT_EQUAL_UINT32(3, z.count);
+    TEST_ASSERT_EQUAL_UINT32(10, z.min_ticks);
+    TEST_ASSERT_EQUAL_UINT32(50, z.max_ticks);
+    TEST_ASSERT_EQUAL_UINT64(90, z.sum_ticks);
+    TEST_ASSERT_EQUAL_UINT32(0, profiler.zone(ZONE_ENCODE).count);
+}
+
+void test_record_across_counter_wrap(void)
+{
+    // a 32 bit cycle counter that wrapped while the zone ran.
+    profiler.record(ZONE_LOOP, 0xFFFFFFF0u, 0x10u);
+    TEST_ASSERT_EQUAL_UINT32(0x20, profiler.zone(ZONE_LOOP).max_ticks);
+}
+
+void test_scopes_nest(void)
+{
+    {
+        RR_ZONE(ZONE_SERIAL);
+        work(1000);
+        {
+            RR_ZONE(ZONE_DECODE);
+            work(1000);
+        }
+        {
+            RR_ZONE(ZONE_ENCODE);
+            work(1000);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1, profiler.zone(ZONE_SERIAL).count);
+    TEST_ASSERT_EQUAL_UINT32(1, profiler.zone(ZONE_DECODE).count);
+    TEST_ASSERT_EQUAL_UINT32(1, profiler.zone(ZONE_ENCODE).count);
+    TEST_ASSERT_TRUE(profiler.zone(ZONE_SERIAL).max_ticks >=
+                     profiler.zone(ZONE_DECODE).max_ticks + profiler.zone(ZONE_ENCODE).max_ticks);
+
+    // events are kept as zones are left, the enclosing zone last.
+    TEST_ASSERT_EQUAL(3, profiler.events());
+    TEST_ASSERT_EQUAL(ZONE_DECODE, profiler.event(0).zone);
+    TEST_ASSERT_EQUAL(ZONE_ENCODE, profiler.event(1).zone);
+    TEST_ASSERT_EQUAL(ZONE_SERIAL, profiler.event(2).zone);
+    TEST_ASSERT_TRUE(profiler.event(2).start <= profiler.event(0).start);
+    TEST_ASSERT_TRUE(profiler.event(0).start + profiler.event(0).ticks <= profiler.event(1).start);
+}
+
+void test_conversions_and_names(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(1000, Profiler::ticks_per_us());
+    TEST_ASSERT_EQUAL_UINT32(1500, Profiler::to_ns(1500));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, Profiler::to_ns(1ull << 40));
+    TEST_ASSERT_EQUAL_STRING("loop", Profiler::zone_name(ZONE_LOOP));
+    TEST_ASSERT_EQUAL_STRING("euler_to_quaternion", Profiler::zone_name(ZONE_EULER_TO_QUATERNION));
+    TEST_ASSERT_EQUAL_STRING("unknown", Profiler::zone_name(ZONES));
+}
+
+void test_events_stop_when_full(void)
+{
+    for (std::uint32_t i = 0; i < RR_ZONE_EVENTS + 10; i++)
+    {
+        profiler.record(ZONE_IMU, i, i + 1);
+    }
+    TEST_ASSERT_EQUAL(RR_ZONE_EVENTS, profiler.events());
+    TEST_ASSERT_EQUAL_UINT32(10, profiler.events_dropped());
+    TEST_ASSERT_EQUAL_UINT32(RR_ZONE_EVENTS + 10, profiler.zone(ZONE_IMU).count);
+}
+
+void test_chrome_trace(void)
+{
+    profiler.record(ZONE_LOOP, 5000, 9000);
+    profiler.record(ZONE_POSE, 6000, 6500);
+
+    std::FILE *f = std::tmpfile();
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_TRUE(profiler.write_chrome_trace(f));
+
+    static char json[1024];
+    std::rewind(f);
+    size_t n = std::fread(json, 1, sizeof(json) - 1, f);
+    json[n] = '\0';
+    std::fclose(f);
+
+    TEST_ASSERT_NOT_NULL(std::strstr(json, "\"traceEvents\":["));
+    TEST_ASSERT_NOT_NULL(std::strstr(json, "{\"name\":\"loop\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":0.000,\"dur\":4.000}"));
+    TEST_ASSERT_NOT_NULL(std::strstr(json, "{\"name\":\"pose\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":1.000,\"dur\":0.500}"));
+
+    int depth = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        depth += json[i] == '{' || json[i] == '[';
+        depth -= json[i] == '}' || json[i] == ']';
+        TEST_ASSERT_TRUE(depth >= 0);
+    }
+    TEST_ASSERT_EQUAL(0, depth);
+    TEST_ASSERT_FALSE(profiler.write_chrome_trace(nullptr));
+}
+
+void test_reset_clears_zones(void)
+{
+    profiler.record(ZONE_MAZE, 0, 10);
+    profiler.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, profiler.zone(ZONE_MAZE).count);
+    TEST_ASSERT_EQUAL(0, profiler.events());
+    profiler.record(ZONE_MAZE, 0, 10);
+    TEST_ASSERT_EQUAL_UINT32(10, profiler.zone(ZONE_MAZE).min_ticks);
+}
+
+void test_benchmark_zone(void)
+{
+    const std::uint32_t N = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < N; i++)
+    {
+        RR_ZONE(ZONE_LOOP);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / N;
+    printf("zone enter, leave %6.2f ns/zone, two steady_clock reads\n", ns);
+    TEST_ASSERT_EQUAL_UINT32(N, profiler.zone(ZONE_LOOP).count);
+}
+
+void setUp(void) {
+    profiler.reset();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_record_aggregates);
+    RUN_TEST(test_record_across_counter_wrap);
+    RUN_TEST(test_scopes_nest);
+    RUN_TEST(test_conversions_and_names);
+    RUN_TEST(test_events_stop_when_full);
+    RUN_TEST(test_chrome_trace);
+    RUN_TEST(test_reset_clears_zones);
+    RUN_TEST(test_benchmark_zone);
+    return UNITY_END();
+}
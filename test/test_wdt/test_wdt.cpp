@@ -0,0 +1,300 @@
+// Copyright (c) 2025 Ryder Robots
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <wdt_supervisor.hpp>
+#include <wdt_trace.hpp>
+
+using namespace wdt;
+
+static Supervisor sv;
+
+// stands in for the .noinit section, it keeps its contents across the "resets" below.
+static Retained retained;
+
+/*
+ * one main loop iteration from now_us: sensors, control and serial take the given times.
+ */
+static std::uint32_t iterate(std::uint32_t now_us, std::uint32_t sensors_us, std::uint32_t control_us, std::uint32_t serial_us, std::int32_t op = 0)
+{
+    sv.begin(now_us);
+    now_us += sensors_us;
+    sv.check_in(TASK_SENSORS, now_us);
+    now_us += control_us;
+    sv.check_in(TASK_CONTROL, now_us);
+    if (op != 0)
+    {
+        sv.note(op);
+    }
+    now_us += serial_us;
+    sv.check_in(TASK_SERIAL, now_us);
+    sv.end(now_us, now_us / 1000);
+    return now_us;
+}
+
+void test_bucket_of_is_log2(void)
+{
+    TEST_ASSERT_EQUAL(0, Supervisor::bucket_of(0));
+    TEST_ASSERT_EQUAL(0, Supervisor::bucket_of(1));
+    TEST_ASSERT_EQUAL(1, Supervisor::bucket_of(2));
+    TEST_ASSERT_EQUAL(1, Supervisor::bucket_of(3));
+    TEST_ASSERT_EQUAL(9, Supervisor::bucket_of(1000));
+    TEST_ASSERT_EQUAL(10, Supervisor::bucket_of(1024));
+    TEST_ASSERT_EQUAL(Supervisor::BUCKETS - 1, Supervisor::bucket_of(UINT32_MAX));
+}
+
+void test_round_completes_when_every_task_checks_in(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(Supervisor::ALL_TASKS, sv.pending());
+    sv.begin(0);
+    TEST_ASSERT_FALSE(sv.check_in(TASK_SENSORS, 10));
+    TEST_ASSERT_FALSE(sv.check_in(TASK_SENSORS, 20));
+    TEST_ASSERT_FALSE(sv.check_in(TASK_CONTROL, 30));
+    TEST_ASSERT_EQUAL_UINT8(1 << TASK_SERIAL, sv.pending());
+    TEST_ASSERT_EQUAL_UINT32(0, sv.rounds());
+
+    TEST_ASSERT_TRUE(sv.check_in(TASK_SERIAL, 40));
+    TEST_ASSERT_EQUAL_UINT8(Supervisor::ALL_TASKS, sv.pending());
+    TEST_ASSERT_EQUAL_UINT32(1, sv.rounds());
+    TEST_ASSERT_EQUAL_UINT32(2, sv.task(TASK_SENSORS).check_ins);
+
+    TEST_ASSERT_FALSE(sv.check_in(TASKS, 50));
+}
+
+void test_loop_period_and_histogram(void)
+{
+    std::uint32_t now = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        std::uint32_t start = now;
+        iterate(now, 100, 50, 50);
+        now = start + 1000;
+    }
+    // one slow iteration, 20ms.
+    std::uint32_t start = now;
+    iterate(now, 100, 50, 19000);
+    now = start + 20000;
+    iterate(now, 100, 50, 50);
+
+    const rr_control::LoopTiming &t = sv.timing();
+    TEST_ASSERT_EQUAL_UINT32(102, t.count);
+    TEST_ASSERT_EQUAL_UINT32(1000, t.period_min_us);
+    TEST_ASSERT_EQUAL_UINT32(20000, t.period_max_us);
+    TEST_ASSERT_EQUAL_UINT32(200, t.exec_min_us);
+    TEST_ASSERT_EQUAL_UINT32(19150, t.exec_max_us);
+
+    TEST_ASSERT_EQUAL_UINT32(100, sv.bucket(Supervisor::bucket_of(1000)));
+    TEST_ASSERT_EQUAL_UINT32(1, sv.bucket(Supervisor::bucket_of(20000)));
+    std::uint32_t total = 0;
+    for (size_t b = 0; b < Supervisor::BUCKETS; b++)
+    {
+        total += sv.bucket(b);
+    }
+    TEST_ASSERT_EQUAL_UINT32(101, total);
+}
+
+void test_task_spans_and_gaps(void)
+{
+    std::uint32_t now = iterate(0, 300, 40, 10);
+    now = iterate(now + 1000, 100, 900, 10);
+    iterate(now + 5000, 100, 40, 10);
+
+    TEST_ASSERT_EQUAL_UINT32(300, sv.task(TASK_SENSORS).max_span_us);
+    TEST_ASSERT_EQUAL_UINT32(900, sv.task(TASK_CONTROL).max_span_us);
+    TEST_ASSERT_EQUAL_UINT32(10, sv.task(TASK_SERIAL).max_span_us);
+
+    // serial checked in at 350, 2360, and 7510.
+    TEST_ASSERT_EQUAL_UINT32(5150, sv.task(TASK_SERIAL).max_gap_us);
+}
+
+void test_offenders_keep_the_slowest_with_their_cause(void)
+{
+    std::uint32_t now = 0;
+    const std::uint32_t serial[] = {10, 4000, 20, 30, 2500, 40, 8000, 50, 3000, 60};
+    for (size_t i = 0; i < sizeof(serial) / sizeof(serial[0]); i++)
+    {
+        now = iterate(now + 1000, 100, 50, serial[i], static_cast<std::int32_t>(150 + i));
+    }
+    // a slow control step, without a request.
+    now = iterate(now + 1000, 100, 3500, 10);
+
+    TEST_ASSERT_EQUAL(WDT_OFFENDERS, sv.offenders());
+    TEST_ASSERT_EQUAL_UINT32(8150, sv.offender(0).exec_us);
+    TEST_ASSERT_EQUAL_INT32(156, sv.offender(0).op);
+    TEST_ASSERT_EQUAL(TASK_SERIAL, sv.offender(0).task);
+    TEST_ASSERT_EQUAL_UINT32(8000, sv.offender(0).task_us);
+
+    TEST_ASSERT_EQUAL_UINT32(4150, sv.offender(1).exec_us);
+    TEST_ASSERT_EQUAL_UINT32(3610, sv.offender(2).exec_us);
+    TEST_ASSERT_EQUAL(TASK_CONTROL, sv.offender(2).task);
+    TEST_ASSERT_EQUAL_INT32(0, sv.offender(2).op);
+    TEST_ASSERT_EQUAL_UINT32(3150, sv.offender(3).exec_us);
+    for (size_t i = 1; i < sv.offenders(); i++)
+    {
+        TEST_ASSERT_TRUE(sv.offender(i - 1).exec_us >= sv.offender(i).exec_us);
+    }
+}
+
+void test_counters_wrap(void)
+{
+    std::uint32_t now = UINT32_MAX - 1500;
+    iterate(now, 100, 100, 100);
+    iterate(now + 1000, 100, 100, 100);
+    iterate(now + 2000, 100, 100, 100);
+
+    TEST_ASSERT_EQUAL_UINT32(1000, sv.timing().period_max_us);
+    TEST_ASSERT_EQUAL_UINT32(300, sv.offender(0).exec_us);
+    TEST_ASSERT_EQUAL_UINT32(1000, sv.task(TASK_SERIAL).max_gap_us);
+}
+
+void test_reset_clears_statistics(void)
+{
+    iterate(0, 100, 100, 5000);
+    iterate(6000, 100, 100, 100);
+    sv.reset();
+
+    TEST_ASSERT_EQUAL_UINT32(0, sv.timing().count);
+    TEST_ASSERT_EQUAL(0, sv.offenders());
+    TEST_ASSERT_EQUAL_UINT32(0, sv.task(TASK_SERIAL).check_ins);
+    TEST_ASSERT_EQUAL_UINT32(0, sv.rounds());
+
+    // the first iteration after a reset has no period.
+    iterate(10000, 100, 100, 100);
+    TEST_ASSERT_EQUAL_UINT32(0, sv.bucket(Supervisor::bucket_of(4000)));
+    TEST_ASSERT_EQUAL_UINT32(0, sv.task(TASK_SERIAL).max_gap_us);
+}
+
+// ============================================================================
+// Post-mortem trace
+// ============================================================================
+
+void test_trace_garbage_is_not_trusted(void)
+{
+    std::memset(&retained, 0xa5, sizeof(retained));
+    Trace trace(retained);
+    trace.boot(0);
+    TEST_ASSERT_FALSE(trace.previous_valid());
+    TEST_ASSERT_EQUAL(0, trace.previous_count());
+    TEST_ASSERT_EQUAL_UINT32(1, trace.boots());
+    TEST_ASSERT_EQUAL_UINT32(0, trace.recorded());
+}
+
+void test_trace_survives_reset(void)
+{
+    std::memset(&retained, 0, sizeof(retained));
+    {
+        Trace trace(retained);
+        trace.boot(0);
+        trace.record(TE_LOOP, 0, TASK_SENSORS, 1000, 250);
+        trace.record(TE_REQUEST, 153, TASK_SERIAL, 1900, 120);
+        trace.set_pending((1 << TASK_SERIAL));
+    }
+
+    // the watchdog fires, RESETREAS.DOG is bit 1.
+    Trace trace(retained);
+    trace.boot(0x2);
+    TEST_ASSERT_TRUE(trace.previous_valid());
+    TEST_ASSERT_EQUAL_UINT32(0x2, trace.reset_reason());
+    TEST_ASSERT_EQUAL_UINT32(2, trace.boots());
+    TEST_ASSERT_EQUAL(2, trace.previous_count());
+    TEST_ASSERT_EQUAL_UINT32(2, trace.previous_recorded());
+    TEST_ASSERT_EQUAL_UINT32(1 << TASK_SERIAL, trace.previous_pending());
+
+    TEST_ASSERT_EQUAL(TE_LOOP, trace.previous(0).kind);
+    TEST_ASSERT_EQUAL_UINT32(250, trace.previous(0).loop_us);
+    TEST_ASSERT_EQUAL(TE_REQUEST, trace.previous(1).kind);
+    TEST_ASSERT_EQUAL_INT16(153, trace.previous(1).op);
+    TEST_ASSERT_EQUAL_UINT32(1900, trace.previous(1).at_us);
+
+    // the new boot starts an empty ring.
+    TEST_ASSERT_EQUAL_UINT32(0, trace.recorded());
+    Trace again(retained);
+    again.boot(0x4);
+    TEST_ASSERT_TRUE(again.previous_valid());
+    TEST_ASSERT_EQUAL(0, again.previous_count());
+    TEST_ASSERT_EQUAL_UINT32(3, again.boots());
+}
+
+void test_trace_keeps_the_latest_events(void)
+{
+    std::memset(&retained, 0, sizeof(retained));
+    {
+        Trace trace(retained);
+        trace.boot(0);
+        for (std::uint32_t i = 0; i < WDT_TRACE_EVENTS * 2 + 5; i++)
+        {
+            trace.record(TE_LOOP, static_cast<std::int32_t>(i), TASK_CONTROL, i * 1000, i);
+        }
+    }
+    Trace trace(retained);
+    trace.boot(0x2);
+    TEST_ASSERT_EQUAL(WDT_TRACE_EVENTS, trace.previous_count());
+    TEST_ASSERT_EQUAL_UINT32(WDT_TRACE_EVENTS * 2 + 5, trace.previous_recorded());
+    for (size_t i = 0; i < trace.previous_count(); i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(WDT_TRACE_EVENTS + 5 + i, trace.previous(i).loop_us);
+    }
+}
+
+void test_benchmark_trace_record(void)
+{
+    std::memset(&retained, 0, sizeof(retained));
+    Trace trace(retained);
+    trace.boot(0);
+    const std::uint32_t N = 1000000;
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint32_t i = 0; i < N; i++)
+    {
+        trace.record(TE_LOOP, 150, TASK_SERIAL, i, i & 1023);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / N;
+    printf("trace record      %6.2f ns/event\n", ns);
+    TEST_ASSERT_EQUAL_UINT32(N, trace.recorded());
+}
+
+void setUp(void) {
+    sv.reset();
+}
+
+void tearDown(void) {
+    // Clean up code if needed
+}
+
+int main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_of_is_log2);
+    RUN_TEST(test_round_completes_when_every_task_checks_in);
+    RUN_TEST(test_loop_period_and_histogram);
+    RUN_TEST(test_task_spans_and_gaps);
+    RUN_TEST(test_offenders_keep_the_slowest_with_their_cause);
+    RUN_TEST(test_counters_wrap);
+    RUN_TEST(test_reset_clears_statistics);
+    RUN_TEST(test_trace_garbage_is_not_trusted);
+    RUN_TEST(test_trace_survives_reset);
+    RUN_TEST(test_trace_keeps_the_latest_events);
+    RUN_TEST(test_benchmark_trace_record);
+    return UNITY_END();
+}
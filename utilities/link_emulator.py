@@ -0,0 +1,409 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Ryder Robots
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+"""
+Mousebot Link Emulator - Impaired serial link for bench testing
+
+Sits between a host client and the board, or the simulator (sim/README.md), and passes bytes both ways through a
+model of the link, so that field problems can be reproduced, and measured, on a bench:
+
+    client -> pseudo terminal (--link) -> [emulator] -> --device (board, or simulator terminal)
+
+Each direction is cut into chunks of up to --chunk bytes, as a USB full speed endpoint delivers them. Chunks then
+queue for the wire at --bps, and arrive --latency-ms later, give or take --jitter-ms drawn from --jitter. Faults,
+in the directions given by --faults, drop or corrupt single bytes, and hold chunks back so the next overtakes them.
+The random source is seeded, so the same traffic meets the same faults.
+
+Counters, per direction, show what the framing made of it: frames (TERM_CHAR) in and out, and frames that met a
+fault. When the generated protobuf modules are available, frames delivered are also unstuffed and decoded, and bad request
+responses counted by error type.
+
+Usage:
+    # Simulator behind a 115200 bps UART, clients open /tmp/mousebot-link instead of /tmp/mousebot
+    ./link_emulator.py --device /tmp/mousebot --link /tmp/mousebot-link --bps 115200
+
+    # 2ms +/- 1ms latency, 8 byte chunks, 1 in 10000 bytes lost towards the board, statistics as JSON on exit
+    ./link_emulator.py --device /dev/ttyACM0 --link /tmp/mousebot-link --latency-ms 2 --jitter-ms 1 \\
+        --chunk 8 --loss 1e-4 --faults to-device --stats link.json
+"""
+
+import sys
+import os
+import json
+import heapq
+import random
+import select
+import signal
+import time
+import tty
+import argparse
+from pathlib import Path
+
+# Add proto directory to path for imports
+SCRIPT_DIR = Path(__file__).parent
+PROTO_DIR = SCRIPT_DIR.parent / "proto"
+sys.path.insert(0, str(PROTO_DIR))
+
+# decoding is optional, the link itself does not need it.
+try:
+    import rr_serial_pb2 as pb
+except ImportError:
+    pb = None
+
+
+TERM_CHAR = 0x1E  # Record separator character
+ESC_CHAR = 0x1B  # TERM_CHAR and ESC_CHAR inside a frame are sent as ESC_CHAR, byte ^ ESC_XOR
+ESC_XOR = 0x20
+USB_CHUNK = 64  # USB full speed bulk endpoint
+BITS_PER_BYTE = 10  # 8N1, a start and a stop bit
+READ_LEN = 4096
+
+
+class Impairments:
+    """Model of one direction of the link"""
+
+    def __init__(self, bps=0, chunk=USB_CHUNK, latency_ms=0.0, jitter_ms=0.0, jitter='uniform', loss=0.0,
+                 corrupt=0.0, reorder=0.0, reorder_ms=1.0, faults=True):
+        self.bps = bps
+        self.chunk = chunk
+        self.latency_s = latency_ms / 1000.0
+        self.jitter_s = jitter_ms / 1000.0
+        self.jitter = jitter
+        self.loss = loss if faults else 0.0
+        self.corrupt = corrupt if faults else 0.0
+        self.reorder = reorder if faults else 0.0
+        self.reorder_s = reorder_ms / 1000.0
+
+    def delay(self, rng):
+        """Latency of one chunk, never negative"""
+        if self.jitter_s <= 0.0:
+            return self.latency_s
+        if self.jitter == 'normal':
+            jitter = rng.gauss(0.0, self.jitter_s)
+        elif self.jitter == 'exponential':
+            jitter = rng.expovariate(1.0 / self.jitter_s)
+        else:
+            jitter = rng.uniform(-self.jitter_s, self.jitter_s)
+        return max(0.0, self.latency_s + jitter)
+
+
+class Direction:
+    """Bytes from src_fd, through the impairments, to dst_fd"""
+
+    def __init__(self, name, src_fd, dst_fd, impairments, rng, decode=None):
+        self.name = name
+        self.src_fd = src_fd
+        self.dst_fd = dst_fd
+        self.imp = impairments
+        self.rng = rng
+        self.decode = decode
+        self.queue = []
+        self.seq = 0
+        self.link_free = 0.0
+        self.in_order = 0.0
+        self.backlog = bytearray()
+        self.frame_damaged = False
+        self.out_frame = bytearray()
+        self.counters = {
+            'bytes_in': 0,
+            'bytes_out': 0,
+            'chunks': 0,
+            'bytes_dropped': 0,
+            'bytes_corrupted': 0,
+            'chunks_reordered': 0,
+            'frames_in': 0,
+            'frames_out': 0,
+            'frames_damaged': 0,
+            'max_delay_ms': 0.0,
+            'frames_decoded': 0,
+            'frames_undecodable': 0,
+            'bad_requests': {},
+        }
+
+    def ingest(self, data, now):
+        """Queues data, read at now, for delivery"""
+        c = self.counters
+        c['bytes_in'] += len(data)
+        for start in range(0, len(data), self.imp.chunk):
+            chunk = self.damage(data[start:start + self.imp.chunk])
+            c['chunks'] += 1
+
+            # serialised behind the chunks before it, then delayed.
+            if self.imp.bps > 0:
+                self.link_free = max(now, self.link_free) + len(chunk) * BITS_PER_BYTE / self.imp.bps
+            else:
+                self.link_free = now
+            due = self.link_free + self.imp.delay(self.rng)
+            if self.imp.reorder > 0.0 and self.rng.random() < self.imp.reorder:
+                # held back, and not holding back those after it.
+                due += self.imp.reorder_s
+                c['chunks_reordered'] += 1
+            else:
+                due = max(due, self.in_order)
+                self.in_order = due
+            c['max_delay_ms'] = max(c['max_delay_ms'], (due - now) * 1000.0)
+            heapq.heappush(self.queue, (due, self.seq, chunk))
+            self.seq += 1
+
+    def damage(self, chunk):
+        """Drops and corrupts bytes of chunk, and counts the frames sent into the link that met a fault"""
+        c = self.counters
+        out = bytearray()
+        for b in chunk:
+            term = b == TERM_CHAR
+            if self.imp.loss > 0.0 and self.rng.random() < self.imp.loss:
+                c['bytes_dropped'] += 1
+                self.frame_damaged = True
+            else:
+                if self.imp.corrupt > 0.0 and self.rng.random() < self.imp.corrupt:
+                    c['bytes_corrupted'] += 1
+                    self.frame_damaged = True
+                    b ^= 1 << self.rng.randrange(8)
+                out.append(b)
+            if term:
+                self.end_frame()
+        return bytes(out)
+
+    def end_frame(self):
+        self.counters['frames_in'] += 1
+        if self.frame_damaged:
+            self.counters['frames_damaged'] += 1
+        self.frame_damaged = False
+
+    def next_due(self):
+        return self.queue[0][0] if self.queue else None
+
+    def deliver(self, now):
+        """Writes the chunks that are due, keeping what the destination can not take yet"""
+        while self.queue and self.queue[0][0] <= now:
+            _, _, chunk = heapq.heappop(self.queue)
+            self.backlog += chunk
+            self.frames(chunk)
+        if self.backlog:
+            try:
+                n = os.write(self.dst_fd, self.backlog)
+            except BlockingIOError:
+                n = 0
+            self.counters['bytes_out'] += n
+            del self.backlog[:n]
+
+    def frames(self, chunk):
+        """Counts, and decodes, the frames delivered"""
+        c = self.counters
+        for b in chunk:
+            if b != TERM_CHAR:
+                self.out_frame.append(b)
+                continue
+            c['frames_out'] += 1
+            if self.decode is not None:
+                self.decode(self, bytes(self.out_frame))
+            self.out_frame.clear()
+
+
+def unstuff(frame):
+    """Undoes the byte stuffing of a frame; raises ValueError on a bad escape"""
+    out = bytearray()
+    it = iter(frame)
+    for b in it:
+        if b == ESC_CHAR:
+            b = next(it, None)
+            if b is None or (b ^ ESC_XOR) not in (TERM_CHAR, ESC_CHAR):
+                raise ValueError("bad escape in frame")
+            b ^= ESC_XOR
+        out.append(b)
+    return bytes(out)
+
+
+def decode_request(direction, frame):
+    """Counts the frames the board would be able to decode"""
+    try:
+        pb.Request().ParseFromString(unstuff(frame))
+        direction.counters['frames_decoded'] += 1
+    except Exception:
+        direction.counters['frames_undecodable'] += 1
+
+
+def decode_response(direction, frame):
+    """Counts the responses a client would be able to decode, and bad requests by error type"""
+    c = direction.counters
+    try:
+        response = pb.Response()
+        response.ParseFromString(unstuff(frame))
+        c['frames_decoded'] += 1
+    except Exception:
+        c['frames_undecodable'] += 1
+        return
+    if response.WhichOneof('data') == 'bad_request':
+        etype = pb.ErrorType.Name(response.bad_request.etype)
+        c['bad_requests'][etype] = c['bad_requests'].get(etype, 0) + 1
+
+
+def open_device(path):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    if os.isatty(fd):
+        tty.setraw(fd)
+    return fd
+
+
+def open_link(path):
+    """Pseudo terminal for the client, kept open on both sides so that clients can come and go"""
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    os.set_blocking(master, False)
+    port = os.ttyname(slave)
+    if path:
+        if os.path.lexists(path):
+            os.unlink(path)
+        os.symlink(port, path)
+    return master, slave, port
+
+
+def print_counters(directions, elapsed):
+    for d in directions:
+        c = d.counters
+        line = (f"{elapsed:8.1f}s {d.name:9s} bytes {c['bytes_in']}/{c['bytes_out']}  frames {c['frames_in']}/"
+                f"{c['frames_out']}  damaged {c['frames_damaged']}  dropped {c['bytes_dropped']}  corrupted "
+                f"{c['bytes_corrupted']}  reordered {c['chunks_reordered']}  max delay {c['max_delay_ms']:.1f}ms")
+        if d.decode is not None:
+            line += f"  undecodable {c['frames_undecodable']}"
+            if c['bad_requests']:
+                line += "  " + " ".join(f"{k}={v}" for k, v in sorted(c['bad_requests'].items()))
+        print(line, file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Mousebot Link Emulator - impaired serial link between a client and the board",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  %(prog)s --device /tmp/mousebot --link /tmp/mousebot-link --bps 115200
+  %(prog)s --device /dev/ttyACM0 --link /tmp/mousebot-link --latency-ms 2 --jitter-ms 1 --corrupt 1e-4
+        """
+    )
+    parser.add_argument('--device', '-d', required=True,
+                        help='Board serial port, or simulator terminal')
+    parser.add_argument('--link', '-l',
+                        help='Symbolic link to the terminal clients open (default: print its path)')
+    parser.add_argument('--bps', type=int, default=0,
+                        help=f'Line rate in bits/s, {BITS_PER_BYTE} bits a byte (default: 0, unlimited)')
+    parser.add_argument('--chunk', type=int, default=USB_CHUNK,
+                        help=f'Largest chunk delivered at once, in bytes (default: {USB_CHUNK})')
+    parser.add_argument('--latency-ms', type=float, default=0.0,
+                        help='Latency of each chunk in ms (default: 0)')
+    parser.add_argument('--jitter-ms', type=float, default=0.0,
+                        help='Jitter added to the latency in ms, its scale depends on --jitter (default: 0)')
+    parser.add_argument('--jitter', choices=['uniform', 'normal', 'exponential'], default='uniform',
+                        help='uniform +/- jitter, normal with jitter as deviation, or exponential with jitter as '
+                             'mean (default: uniform)')
+    parser.add_argument('--loss', type=float, default=0.0,
+                        help='Probability that a byte is lost (default: 0)')
+    parser.add_argument('--corrupt', type=float, default=0.0,
+                        help='Probability that a byte has a bit flipped (default: 0)')
+    parser.add_argument('--reorder', type=float, default=0.0,
+                        help='Probability that a chunk is held back, and overtaken (default: 0)')
+    parser.add_argument('--reorder-ms', type=float, default=1.0,
+                        help='How long a chunk is held back in ms (default: 1)')
+    parser.add_argument('--faults', choices=['both', 'to-device', 'to-client'], default='both',
+                        help='Directions that lose, corrupt and reorder (default: both)')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='Random seed (default: 1)')
+    parser.add_argument('--report', type=float, default=0.0,
+                        help='Print the counters every this many seconds (default: 0, on exit only)')
+    parser.add_argument('--stats',
+                        help='Write the counters, and configuration, to this file as JSON on exit')
+    args = parser.parse_args()
+
+    try:
+        device_fd = open_device(args.device)
+    except OSError as e:
+        print(f"ERROR: Could not open {args.device}: {e}")
+        return 1
+    master, slave, port = open_link(args.link)
+
+    # each direction draws from its own source, so that one's traffic does not change the other's faults.
+    directions = []
+    for i, (name, src, dst, faults, decode) in enumerate((
+            ('to-device', master, device_fd, args.faults in ('both', 'to-device'), decode_request),
+            ('to-client', device_fd, master, args.faults in ('both', 'to-client'), decode_response))):
+        imp = Impairments(args.bps, max(1, args.chunk), args.latency_ms, args.jitter_ms, args.jitter, args.loss,
+                          args.corrupt, args.reorder, args.reorder_ms, faults)
+        rng = random.Random(args.seed * 2 + i)
+        directions.append(Direction(name, src, dst, imp, rng, decode if pb is not None else None))
+
+    print(f"Clients connect to {args.link or port}, passing to {args.device}"
+          f"{'' if pb is not None else ', frames are not decoded (no rr_serial_pb2)'}", file=sys.stderr)
+
+    stopping = []
+    signal.signal(signal.SIGTERM, lambda signum, frame: stopping.append(signum))
+    start = time.monotonic()
+    next_report = start + args.report if args.report > 0 else None
+    try:
+        while not stopping:
+            now = time.monotonic()
+            due = [t for t in (d.next_due() for d in directions) if t is not None]
+            if next_report is not None:
+                due.append(next_report)
+            timeout = max(0.0, min(due) - now) if due else 0.5
+            writers = [d.dst_fd for d in directions if d.backlog]
+            readable, _, _ = select.select([master, device_fd], writers, [], timeout)
+
+            now = time.monotonic()
+            for d in directions:
+                if d.src_fd in readable:
+                    try:
+                        data = os.read(d.src_fd, READ_LEN)
+                    except BlockingIOError:
+                        data = b''
+                    except OSError:
+                        # the board went away, as on a reset.
+                        print(f"ERROR: {args.device} closed", file=sys.stderr)
+                        stopping.append(0)
+                        break
+                    if data:
+                        d.ingest(data, now)
+                d.deliver(now)
+
+            if next_report is not None and now >= next_report:
+                print_counters(directions, now - start)
+                next_report += args.report
+    except KeyboardInterrupt:
+        pass
+    finally:
+        elapsed = time.monotonic() - start
+        print_counters(directions, elapsed)
+        if args.stats:
+            with open(args.stats, 'w') as f:
+                json.dump({
+                    'elapsed_s': elapsed,
+                    'config': {k: v for k, v in vars(args).items() if k not in ('stats', 'report')},
+                    'directions': {d.name: d.counters for d in directions},
+                }, f, indent=2)
+        if args.link and os.path.islink(args.link):
+            os.unlink(args.link)
+        os.close(slave)
+        os.close(master)
+        os.close(device_fd)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Ryder Robots
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""
+Mousebot Log Recorder - Records the serial link of the board, or the simulator, to a log
+
+Passes bytes both ways between a pseudo terminal, which the client opens, and the board, and appends each chunk to
+a log (rr_log.py) as it goes, bytes to the board as rx and bytes from it as tx, as the firmware sees them:
+
+    client -> pseudo terminal (--link) -> [recorder] -> --device (board, or simulator terminal)
+                                              |
+                                            --log
+
+Times are in us since the recorder started, on the host's monotonic clock, so the log is a real time one. Its rx
+records replay into the simulator with mousebot_sim --replay, and what the firmware answers there can be compared
+with the tx recorded here with rr_log.py diff --type tx --bytes-only.
+
+Usage:
+    # record a session with the board, clients open /tmp/mousebot-rec instead of /dev/ttyACM0
+    ./log_recorder.py --device /dev/ttyACM0 --link /tmp/mousebot-rec --log session.log
+"""
+
+import sys
+import os
+import select
+import signal
+import time
+import argparse
+
+from link_emulator import open_device, open_link
+from rr_log import Writer, RT_RX, RT_TX
+
+READ_LEN = 4096
+LOG_BUFFER = 1 << 18  # a full rate IMU stream is a few kB/s, so this is written a few times a minute
+
+
+def forward(fd, data):
+    """Writes all of data, waiting on fd when it is full, so that nothing recorded goes missing on the way"""
+    view = memoryview(data)
+    while view:
+        try:
+            n = os.write(fd, view)
+            view = view[n:]
+        except BlockingIOError:
+            select.select([], [fd], [], 0.1)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Mousebot Log Recorder - records the serial link between a client and the board",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  %(prog)s --device /dev/ttyACM0 --link /tmp/mousebot-rec --log session.log
+  %(prog)s --device /tmp/mousebot --link /tmp/mousebot-rec --log sim.log --channel 1
+        """
+    )
+    parser.add_argument('--device', '-d', required=True,
+                        help='Board serial port, or simulator terminal')
+    parser.add_argument('--link', '-l',
+                        help='Symbolic link to the terminal clients open (default: print its path)')
+    parser.add_argument('--log', required=True,
+                        help='Log to write')
+    parser.add_argument('--channel', type=int, default=0,
+                        help='Channel of the records, to tell links apart in merged logs (default: 0)')
+    args = parser.parse_args()
+
+    try:
+        device_fd = open_device(args.device)
+        log_file = open(args.log, 'wb', buffering=LOG_BUFFER)
+    except OSError as e:
+        print(f"ERROR: {e}")
+        return 1
+    master, slave, port = open_link(args.link)
+    log = Writer(log_file)
+    print(f"Clients connect to {args.link or port}, passing to {args.device}, recording to {args.log}",
+          file=sys.stderr)
+
+    stopping = []
+    signal.signal(signal.SIGTERM, lambda signum, frame: stopping.append(signum))
+    start = time.monotonic_ns()
+    counts = {RT_RX: 0, RT_TX: 0}
+    try:
+        while not stopping:
+            readable, _, _ = select.select([master, device_fd], [], [], 0.5)
+            for src, dst, rtype in ((master, device_fd, RT_RX), (device_fd, master, RT_TX)):
+                if src not in readable:
+                    continue
+                try:
+                    data = os.read(src, READ_LEN)
+                except BlockingIOError:
+                    continue
+                except OSError:
+                    print(f"ERROR: {args.device} closed", file=sys.stderr)
+                    stopping.append(0)
+                    break
+                if data:
+                    log.append(rtype, args.channel, (time.monotonic_ns() - start) // 1000, data)
+                    counts[rtype] += len(data)
+                    forward(dst, data)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        log_file.close()
+        print(f"{log.records} records, rx {counts[RT_RX]} bytes, tx {counts[RT_TX]} bytes", file=sys.stderr)
+        if args.link and os.path.islink(args.link):
+            os.unlink(args.link)
+        os.close(slave)
+        os.close(master)
+        os.close(device_fd)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Ryder Robots
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""
+Mousebot Memory Report - Static RAM and flash by module, message sizes, and a guard against heap allocation
+
+Run by PlatformIO around the firmware link (extra_scripts in platformio.ini), or by hand on a build directory:
+
+    ./memory_report.py ../.pio/build/nano33ble --nm arm-none-eabi-nm
+
+Before the link, the object files built from src/ and lib/ are checked for references to malloc, calloc, realloc
+or operator new, and the build fails, naming the object and the function, if there are any: the firmware only
+uses memory it reserved statically, RRBuffer and the handlers' own members, so that it cannot run out at run time.
+The Arduino core and mbed below it are not checked, they allocate for themselves at boot.
+
+After the link, the statics of each module are summed from the symbols of its object files, RAM as data and bss,
+flash as text, rodata and data, before unused sections are dropped, so each is an upper bound. The sizes of the
+request path's messages are read from the rr_sizeof_* symbols lib/rr_memory/src/rr_memory_op.cpp defines; each
+request handled has a Request, ExtRequest, Response and ExtResponse on the stack at once. MSP_MEMORY reports the
+same sizes at run time, with the stack's high water mark.
+"""
+
+import sys
+import os
+import subprocess
+import argparse
+
+# allocation only, operator delete is referenced by every virtual destructor whether anything is allocated or not.
+HEAP_SYMBOLS = ('malloc', 'calloc', 'realloc', 'strdup', '_malloc_r', '_calloc_r', '_realloc_r', '_strdup_r')
+HEAP_PREFIXES = ('_Znw', '_Zna')  # operator new, and new[]
+SIZEOF_PREFIX = 'rr_sizeof_'
+RAM_TYPES = 'bBdD'
+FLASH_TYPES = 'tTrRdD'
+
+
+def firmware_objects(build_dir, lib_dir):
+    """Object files built from src/, and from each library in lib_dir, by module"""
+    libs = set(os.listdir(lib_dir)) if os.path.isdir(lib_dir) else set()
+    modules = {}
+    for root, _, files in os.walk(build_dir):
+        rel = os.path.relpath(root, build_dir).split(os.sep)
+        if rel[0] == 'src':
+            module = 'src'
+        elif rel[0].startswith('lib') and len(rel) > 1 and rel[1] in libs:
+            module = rel[1]
+        else:
+            continue
+        for name in files:
+            if name.endswith('.o'):
+                modules.setdefault(module, []).append(os.path.join(root, name))
+    return modules
+
+
+def symbols(nm, path):
+    """(size, type, name) of each symbol of an object file, size 0 for undefined ones"""
+    out = subprocess.run([nm, '-S', path], check=True, capture_output=True, text=True).stdout
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4:
+            yield int(fields[1], 16), fields[2], fields[3]
+        elif len(fields) == 3:
+            # an absolute symbol's value is what it holds, the sizes are stored that way.
+            yield int(fields[0], 16), fields[1], fields[2]
+        elif len(fields) == 2:
+            yield 0, fields[0], fields[1]
+
+
+def heap_references(nm, modules):
+    found = []
+    for module, objects in sorted(modules.items()):
+        for path in objects:
+            for _, stype, name in symbols(nm, path):
+                if stype == 'U' and (name in HEAP_SYMBOLS or name.startswith(HEAP_PREFIXES)):
+                    found.append((module, os.path.basename(path), name))
+    return found
+
+
+def summarise(nm, modules):
+    """RAM and flash of each module, and the message sizes"""
+    rows = []
+    sizes = {}
+    for module, objects in sorted(modules.items()):
+        ram = flash = 0
+        for path in objects:
+            for size, stype, name in symbols(nm, path):
+                if stype == 'A' and name.startswith(SIZEOF_PREFIX):
+                    sizes[name[len(SIZEOF_PREFIX):]] = size
+                    continue
+                if stype in RAM_TYPES:
+                    ram += size
+                if stype in FLASH_TYPES:
+                    flash += size
+        rows.append((module, ram, flash))
+    return rows, sizes
+
+
+def print_report(rows, sizes):
+    print("Static memory by module (bytes, before unused sections are dropped):")
+    print(f"  {'module':20s} {'RAM':>8s} {'flash':>8s}")
+    for module, ram, flash in sorted(rows, key=lambda r: -r[1]):
+        print(f"  {module:20s} {ram:>8d} {flash:>8d}")
+    print(f"  {'total':20s} {sum(r[1] for r in rows):>8d} {sum(r[2] for r in rows):>8d}")
+    if sizes:
+        print("Message sizes (bytes):")
+        for name, size in sorted(sizes.items(), key=lambda s: -s[1]):
+            print(f"  {name:20s} {size:>8d}")
+
+
+def print_heap_references(found):
+    print("ERROR: the firmware must not allocate from the heap, found:")
+    for module, obj, name in found:
+        print(f"  {module}/{obj}: {name}")
+
+
+def scons(env):
+    """Hooks the guard before, and the report after, the firmware link"""
+    nm = env.subst('$CC').replace('gcc', 'nm')
+    lib_dir = env.subst('$PROJECT_DIR/lib')
+    elf = '$BUILD_DIR/${PROGNAME}.elf'
+
+    def guard(target, source, env):
+        found = heap_references(nm, firmware_objects(env.subst('$BUILD_DIR'), lib_dir))
+        if found:
+            print_heap_references(found)
+            env.Exit(1)
+
+    def report(target, source, env):
+        print_report(*summarise(nm, firmware_objects(env.subst('$BUILD_DIR'), lib_dir)))
+
+    env.AddPreAction(elf, guard)
+    env.AddPostAction(elf, report)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Mousebot Memory Report - static memory by module, message sizes, and heap allocations",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  %(prog)s ../.pio/build/nano33ble --nm arm-none-eabi-nm
+  %(prog)s ../.pio/build/native
+        """
+    )
+    parser.add_argument('build_dir',
+                        help='PlatformIO build directory of an environment')
+    parser.add_argument('--nm', default='nm',
+                        help='nm of the toolchain that built it (default: nm)')
+    parser.add_argument('--lib-dir', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'lib'),
+                        help='Project library directory (default: ../lib)')
+    args = parser.parse_args()
+
+    modules = firmware_objects(args.build_dir, args.lib_dir)
+    if not modules:
+        print(f"ERROR: no object files of src/ or lib/ under {args.build_dir}")
+        return 1
+    print_report(*summarise(args.nm, modules))
+    found = heap_references(args.nm, modules)
+    if found:
+        print_heap_references(found)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
+else:
+    # run by PlatformIO as an extra script
+    Import('env')  # noqa: F821
+    scons(env)  # noqa: F821
@@ -79,9 +79,36 @@ class OpCodes:
 
 
 TERM_CHAR = 0x1E  # Record separator character
+ESC_CHAR = 0x1B  # TERM_CHAR and ESC_CHAR inside a frame are sent as ESC_CHAR, byte ^ ESC_XOR
+ESC_XOR = 0x20
 RESPONSE_TIMEOUT = 2.0  # Timeout for receiving response in seconds
 
 
+def stuff(data):
+    """Byte stuff a frame so it holds no TERM_CHAR; the terminator is not appended"""
+    out = bytearray()
+    for b in data:
+        if b in (TERM_CHAR, ESC_CHAR):
+            out += bytes([ESC_CHAR, b ^ ESC_XOR])
+        else:
+            out.append(b)
+    return bytes(out)
+
+
+def unstuff(data):
+    """Undo stuff() on a frame read up to its TERM_CHAR; raises ValueError on a bad escape"""
+    out = bytearray()
+    it = iter(data)
+    for b in it:
+        if b == ESC_CHAR:
+            b = next(it, None)
+            if b is None or (b ^ ESC_XOR) not in (TERM_CHAR, ESC_CHAR):
+                raise ValueError("bad escape in frame")
+            b ^= ESC_XOR
+        out.append(b)
+    return bytes(out)
+
+
 class MousebotROS2Client(Node):
     """ROS2 topic-based communication client for Arduino mousebot"""
 
@@ -141,9 +168,9 @@ class MousebotROS2Client(Node):
             # Serialize request
             data = request.SerializeToString()
 
-            # Create UInt8MultiArray message with data + terminator
+            # Create UInt8MultiArray message with the stuffed data + terminator
             msg = UInt8MultiArray()
-            msg.data = list(data) + [TERM_CHAR]
+            msg.data = list(stuff(data)) + [TERM_CHAR]
 
             # Publish to /serial_write topic
             self.publisher.publish(msg)
@@ -187,7 +214,7 @@ class MousebotROS2Client(Node):
         try:
             # Deserialize response
             response = pb.Response()
-            response.ParseFromString(bytes(self.response_data))
+            response.ParseFromString(unstuff(self.response_data))
             return response
         except Exception as e:
             self.get_logger().error(f'Error decoding response: {e}')
@@ -38,8 +38,69 @@ Usage:
     # Request feature list
     ./mousebot_serial_client.py --port /dev/ttyACM0 --operation features
 
+    # Drive motors at 30% forwards, then monitor them
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --motor 300 300
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation motor
+
+    # Closed loop wheel speeds in m/s, and controller gains
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --speed 0.3 0.3
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --gains 300 3000 0 800 40
+
+    # Drive straight holding the current heading reference, and a 0.18m move that holds heading 0
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --speed 0.3 0.3 --heading-hold 0
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --move 1 0.18 0.5 2 0 0 --heading-hold 0
+
+    # Latest range sensor readings, at 10 Hz
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation range --rate 10
+
+    # Walls of the maze cell being observed, and wall hysteresis thresholds
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation walls --rate 5
+
+    # Main loop timing and watchdog check ins, then clear them
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation status
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation status --loop-reset
+
+    # What the previous boot was doing before it was reset, and the events after the 16th
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation trace
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation trace --trace-from 16
+
+    # Request counts, stage latencies and errors of the serial service, from the 3rd operation, then clear them
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation metrics
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation metrics --metrics-from 2 --metrics-reset
+
+    # Time spent in each profiling zone, firmware built with -D RR_ZONE_PROFILE=1, then clear them
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation profile --profile-reset
+
+    # Stack high water mark, static RAM, and the size of the request and response messages
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation memory
+
+    # Sample the IMU at 800 Hz, fused at 100 Hz
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation imu --imu-rate 800 100
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --wall-thresholds 0.02 0.05 0.5
+
+    # Next move towards the goal, the flood fill distances, and the map changes after change 10
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation maze-move
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation maze-dist
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation maze-map --maze-since 10
+
+    # Plan the speed run over the explored maze, and the segments after the 16th of it
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation maze-plan
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation maze-plan --plan-from 17
+
+    # Plan with slower diagonals: straight, diagonal and turn v_max accel jerk, then the turn settle time
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation maze-plan --plan-costs 2 4 0 1 4 0 10 60 0 0.02
+
+    # Clear the maze map, and solve for a single goal cell
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --maze-reset --maze-goal 7 7 1 1
+
+    # Stream the pose estimate every 20ms
+    ./mousebot_serial_client.py --port /dev/ttyACM0 --operation pose --subscribe 20
+
     # Raw command
     ./mousebot_serial_client.py --port /dev/ttyACM0 --op-code 102
+
+    # Round trip times, and requests/s, of 1000 MSP_RAW_IMU requests sent one at a time, to the simulator
+    ./mousebot_serial_client.py --port /tmp/mousebot --op-code 102 --round-trips 1000
 """
 
 import sys
@@ -65,22 +126,75 @@ except ImportError:
     print("  protoc --python_out=. rr_serial.proto")
     sys.exit(1)
 
+try:
+    import rr_mousebot_pb2 as mb
+except ImportError:
+    print("ERROR: Could not import rr_mousebot_pb2")
+    print("Generate protobuf files first:")
+    print("  cd proto/")
+    print("  protoc --python_out=. rr_mousebot.proto")
+    sys.exit(1)
+
 
 # Constants from rr_ble.hpp
 class OpCodes:
     """MSP Operation Codes"""
+    MSP_STATUS = 101
     MSP_RAW_IMU = 102
     MSP_MOTOR = 104
     MSP_RAW_SENSORS = 105
+    MSP_PID = 112
+    MSP_POSE = 150
+    MSP_MOTION = 151
+    MSP_WALLS = 152
+    MSP_MAZE_MOVE = 153
+    MSP_MAZE_DIST = 154
+    MSP_MAZE_MAP = 155
+    MSP_MAZE_PLAN = 156
+    MSP_TRACE = 157
+    MSP_METRICS = 158
+    MSP_PROFILE = 159
+    MSP_MEMORY = 160
+    MSP_SET_PID = 202
+    MSP_SET_WHEEL_SPEED = 250
+    MSP_SET_MOTION = 251
+    MSP_SET_MAZE = 252
     MSP_SET_RAW_RC = 200
     BAD_REQUEST = 400
 
 
 TERM_CHAR = 0x1E  # Record separator character
+ESC_CHAR = 0x1B  # TERM_CHAR and ESC_CHAR inside a frame are sent as ESC_CHAR, byte ^ ESC_XOR
+ESC_XOR = 0x20
 BAUD_RATE = 115200
 TIMEOUT = 2.0  # Serial timeout in seconds
 
 
+def stuff(data):
+    """Byte stuff a frame so it holds no TERM_CHAR; the terminator is not appended"""
+    out = bytearray()
+    for b in data:
+        if b in (TERM_CHAR, ESC_CHAR):
+            out += bytes([ESC_CHAR, b ^ ESC_XOR])
+        else:
+            out.append(b)
+    return bytes(out)
+
+
+def unstuff(data):
+    """Undo stuff() on a frame read up to its TERM_CHAR; raises ValueError on a bad escape"""
+    out = bytearray()
+    it = iter(data)
+    for b in it:
+        if b == ESC_CHAR:
+            b = next(it, None)
+            if b is None or (b ^ ESC_XOR) not in (TERM_CHAR, ESC_CHAR):
+                raise ValueError("bad escape in frame")
+            b ^= ESC_XOR
+        out.append(b)
+    return bytes(out)
+
+
 class MousebotClient:
     """Serial communication client for Arduino mousebot"""
 
@@ -97,6 +211,8 @@ class MousebotClient:
         self.baudrate = baudrate
         self.timeout = timeout
         self.ser = None
+        # mousebot extension fields of the last response, see proto/rr_mousebot.proto
+        self.ext = None
 
     def connect(self):
         """Open serial connection"""
@@ -123,12 +239,13 @@ class MousebotClient:
             self.ser.close()
             print("Disconnected")
 
-    def send_request(self, request):
+    def send_request(self, request, ext=None):
         """
         Send protobuf request to mousebot
 
         Args:
             request: Request protobuf message
+            ext: optional ExtRequest, encoded in the same frame after request
 
         Returns:
             bool: True if sent successfully
@@ -140,9 +257,11 @@ class MousebotClient:
         try:
             # Serialize request
             data = request.SerializeToString()
+            if ext is not None:
+                data += ext.SerializeToString()
 
-            # Send data + terminator
-            self.ser.write(data)
+            # Send the stuffed data + terminator
+            self.ser.write(stuff(data))
             self.ser.write(bytes([TERM_CHAR]))
             self.ser.flush()
 
@@ -187,8 +306,11 @@ class MousebotClient:
                 return None
 
             # Deserialize response
+            data = unstuff(data)
             response = pb.Response()
             response.ParseFromString(bytes(data))
+            self.ext = mb.ExtResponse()
+            self.ext.ParseFromString(bytes(data))
 
             return response
 
@@ -196,18 +318,24 @@ class MousebotClient:
             print(f"ERROR receiving response: {e}")
             return None
 
-    def request_imu(self):
+    def request_imu(self, rate=None):
         """
         Request IMU data (MSP_RAW_IMU)
 
+        Args:
+            rate: optional (sensor ODR, output rate) in Hz to change the sampling to
+
         Returns:
-            Response message or None
+            Response message or None, the rates in use are in self.ext.imu
         """
         request = pb.Request()
         request.op = OpCodes.MSP_RAW_IMU
         request.monitor.is_request = True
+        ext = mb.ExtRequest()
+        if rate is not None:
+            ext.imu_rate.sensor_odr_hz, ext.imu_rate.output_hz = rate
 
-        if self.send_request(request):
+        if self.send_request(request, ext):
             return self.receive_response()
         return None
 
@@ -228,6 +356,307 @@ class MousebotClient:
             return self.receive_response()
         return None
 
+    def request_pose(self, subscribe_ms=None):
+        """
+        Request pose estimate (MSP_POSE)
+
+        Args:
+            subscribe_ms: if set, the firmware publishes the pose every subscribe_ms,
+                          0 cancels the subscription
+
+        Returns:
+            Response message or None, pose is in self.ext.pose
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_POSE
+        request.monitor.is_request = True
+
+        ext = None
+        if subscribe_ms is not None:
+            ext = mb.ExtRequest()
+            ext.subscribe.period_ms = subscribe_ms
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_range(self):
+        """
+        Request the latest range sensor readings (MSP_RAW_SENSORS)
+
+        Returns:
+            Response message or None, readings are in self.ext.range
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_RAW_SENSORS
+        request.monitor.is_request = True
+
+        if self.send_request(request):
+            return self.receive_response()
+        return None
+
+    def request_status(self, reset=False):
+        """
+        Request main loop timing and watchdog check ins (MSP_STATUS)
+
+        Args:
+            reset: clear the statistics after they are returned
+
+        Returns:
+            Response message or None, loop state is in self.ext.loop
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_STATUS
+        request.monitor.is_request = True
+        ext = None
+        if reset:
+            ext = mb.ExtRequest()
+            ext.loop_reset = True
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_trace(self, first=0):
+        """
+        Request the trace left by the previous boot (MSP_TRACE)
+
+        Args:
+            first: index of the first event returned
+
+        Returns:
+            Response message or None, the trace is in self.ext.trace
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_TRACE
+        request.monitor.is_request = True
+        ext = mb.ExtRequest()
+        ext.trace_from = first
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_metrics(self, first=0, reset=False):
+        """
+        Request serial service metrics (MSP_METRICS)
+
+        Args:
+            first: index of the first operation returned
+            reset: clear the metrics after they are returned
+
+        Returns:
+            Response message or None, the metrics are in self.ext.metrics
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_METRICS
+        request.monitor.is_request = True
+        ext = mb.ExtRequest()
+        ext.metrics_from = first
+        ext.metrics_reset = reset
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_profile(self, reset=False):
+        """
+        Request profiling zone timings (MSP_PROFILE)
+
+        Args:
+            reset: clear the zones after they are returned
+
+        Returns:
+            Response message or None, the zones are in self.ext.profile
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_PROFILE
+        request.monitor.is_request = True
+        ext = mb.ExtRequest()
+        ext.profile_reset = reset
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_memory(self):
+        """
+        Request memory use (MSP_MEMORY)
+
+        Returns:
+            Response message or None, the figures are in self.ext.memory
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_MEMORY
+        request.monitor.is_request = True
+
+        if self.send_request(request, mb.ExtRequest()):
+            return self.receive_response()
+        return None
+
+    def request_walls(self, thresholds=None):
+        """
+        Request the next maze cell left, or the cell being observed (MSP_WALLS)
+
+        Args:
+            thresholds: optional (on_m, off_m, min_confidence) wall hysteresis
+
+        Returns:
+            Response message or None, walls are in self.ext.walls
+        """
+        request = pb.Request()
+        request.op = OpCodes.MSP_WALLS
+        request.monitor.is_request = True
+        ext = None
+        if thresholds is not None:
+            ext = mb.ExtRequest()
+            t = ext.wall_thresholds
+            t.on_m, t.off_m, t.min_confidence = thresholds
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_maze(self, op=OpCodes.MSP_MAZE_MOVE, since=0, goal=None, reset=False, costs=None, plan_from=0):
+        """
+        Query the on-device maze (MSP_MAZE_MOVE, MSP_MAZE_DIST, MSP_MAZE_MAP, MSP_MAZE_PLAN), or set it
+        (MSP_SET_MAZE)
+
+        Args:
+            op: query operation, ignored when goal or reset are given
+            since: MSP_MAZE_MAP returns map changes after this sequence number
+            goal: optional (x, y, width, height) goal rectangle, cells
+            reset: clear the map
+            costs: optional speed run cost model, straight, diagonal and turn (v_max, accel, jerk), then the
+                turn settle time in s, 10 values
+            plan_from: MSP_MAZE_PLAN replans when 0, otherwise returns the cached plan from this segment id
+
+        Returns:
+            Response message or None, maze state is in self.ext.maze, and the plan in self.ext.plan
+        """
+        request = pb.Request()
+        ext = mb.ExtRequest()
+        if goal is not None or reset:
+            request.op = OpCodes.MSP_SET_MAZE
+            if goal is not None:
+                g = ext.maze_goal
+                g.x, g.y, g.width, g.height = goal
+            ext.maze_reset = reset
+        else:
+            request.op = op
+            request.monitor.is_request = True
+            ext.maze_since = since
+            ext.plan_from = plan_from
+        if costs is not None:
+            c = ext.plan_costs
+            for limits, values in ((c.straight, costs[0:3]), (c.diagonal, costs[3:6]), (c.turn, costs[6:9])):
+                limits.v_max, limits.accel, limits.jerk = values
+            c.turn_settle_s = costs[9]
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_motor(self, command=None):
+        """
+        Set motors (MSP_SET_RAW_RC), or monitor them (MSP_MOTOR)
+
+        Args:
+            command: optional (left, right) duty per mille, -1000 .. 1000
+
+        Returns:
+            Response message or None, motor state is in self.ext.motor
+        """
+        request = pb.Request()
+        ext = None
+        if command is None:
+            request.op = OpCodes.MSP_MOTOR
+            request.monitor.is_request = True
+        else:
+            request.op = OpCodes.MSP_SET_RAW_RC
+            ext = mb.ExtRequest()
+            ext.motor_command.left = command[0]
+            ext.motor_command.right = command[1]
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_speed(self, setpoint=None, gains=None, heading=None, heading_gains=None):
+        """
+        Set wheel speeds (MSP_SET_WHEEL_SPEED), gains (MSP_SET_PID), or monitor the controller (MSP_PID)
+
+        Args:
+            setpoint: optional (left, right) m/s
+            gains: optional (kp, ki, kd, kff, kstatic)
+            heading: optional heading hold target in rad, False releases the hold
+            heading_gains: optional (kp, kd, max_correction)
+
+        Returns:
+            Response message or None, controller state is in self.ext.speed
+        """
+        request = pb.Request()
+        ext = mb.ExtRequest()
+        if setpoint is not None:
+            request.op = OpCodes.MSP_SET_WHEEL_SPEED
+            ext.wheel_speed.left = setpoint[0]
+            ext.wheel_speed.right = setpoint[1]
+        elif gains is not None or heading is not None or heading_gains is not None:
+            request.op = OpCodes.MSP_SET_PID
+        else:
+            request.op = OpCodes.MSP_PID
+            request.monitor.is_request = True
+
+        if gains is not None:
+            g = ext.speed_gains
+            g.kp, g.ki, g.kd, g.kff, g.kstatic = gains
+        if heading is not None:
+            ext.heading_hold.enabled = heading is not False
+            ext.heading_hold.target = 0.0 if heading is False else heading
+        if heading_gains is not None:
+            h = ext.heading_gains
+            h.kp, h.kd, h.max_correction = heading_gains
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
+    def request_motion(self, segment=None, turn=False, abort=False, heading=None):
+        """
+        Queue a motion segment or abort (MSP_SET_MOTION), or monitor the queue (MSP_MOTION)
+
+        Args:
+            segment: optional (id, distance, v_max, accel, v_end, jerk), m or rad
+            turn: the segment is an in place turn
+            abort: brake to rest, and drop queued segments
+            heading: optional heading in rad held by a straight segment
+
+        Returns:
+            Response message or None, queue state is in self.ext.motion
+        """
+        request = pb.Request()
+        ext = None
+        if segment is None and not abort:
+            request.op = OpCodes.MSP_MOTION
+            request.monitor.is_request = True
+        else:
+            request.op = OpCodes.MSP_SET_MOTION
+            ext = mb.ExtRequest()
+            if abort:
+                ext.motion_abort = True
+            else:
+                m = ext.motion_segment
+                m.id = int(segment[0])
+                m.kind = mb.MK_TURN if turn else mb.MK_STRAIGHT
+                m.distance, m.v_max, m.accel, m.v_end, m.jerk = segment[1:]
+                if heading is not None:
+                    m.heading_hold = True
+                    m.heading = heading
+
+        if self.send_request(request, ext):
+            return self.receive_response()
+        return None
+
     def send_raw_opcode(self, op_code):
         """
         Send raw operation code with monitor request
@@ -246,8 +675,336 @@ class MousebotClient:
             return self.receive_response()
         return None
 
+    def measure_round_trips(self, op_code, count):
+        """
+        Send monitor requests for op_code one at a time, each after the previous response
+
+        Args:
+            op_code: Integer operation code
+            count: Number of requests
+
+        Returns:
+            list of round trip times in seconds, of the requests answered, and the total time
+        """
+        times = []
+        start = time.perf_counter()
+        for _ in range(count):
+            sent = time.perf_counter()
+            if self.send_raw_opcode(op_code) is not None:
+                times.append(time.perf_counter() - sent)
+        return times, time.perf_counter() - start
+
+
+def print_round_trips(times, count, elapsed):
+    if not times:
+        print(f"0/{count} answered")
+        return
+    times = sorted(times)
+
+    def percentile(p):
+        return times[min(len(times) - 1, int(p * len(times)))] * 1e6
+
+    print(f"{len(times)}/{count} answered in {elapsed:.3f} s, {len(times) / elapsed:.1f} requests/s")
+    print(f"Round trip us: min {times[0] * 1e6:.0f}  p50 {percentile(0.5):.0f}  p90 {percentile(0.9):.0f}  "
+          f"p99 {percentile(0.99):.0f}  max {times[-1] * 1e6:.0f}")
+
+
+def print_pose(ext):
+    """Pretty print pose extension"""
+    if not ext or not ext.HasField('pose'):
+        return
+
+    p = ext.pose
+    print("\nPose:")
+    print(f"  x: {p.x:+.4f} m  y: {p.y:+.4f} m  heading: {p.heading:+.4f} rad")
+    print(f"  v: {p.v:+.4f} m/s  omega: {p.omega:+.4f} rad/s")
+    print(f"  vx: {p.vx:+.4f} m/s  vy: {p.vy:+.4f} m/s  t: {p.timestamp_ms} ms")
+
+
+def print_motor(ext):
+    """Pretty print motor extension"""
+    if not ext or not ext.HasField('motor'):
+        return
+
+    m = ext.motor
+    print("\nMotors (per mille):")
+    print(f"  command: left {m.left_command:+5d}  right {m.right_command:+5d}")
+    print(f"  applied: left {m.left_applied:+5d}  right {m.right_applied:+5d}  at {m.command_ms} ms")
+    print(f"  ticks:   left {m.left_ticks:+d}  right {m.right_ticks:+d}")
+    print(f"  speed:   left {m.left_speed:+.3f}  right {m.right_speed:+.3f} m/s  at {m.encoder_us} us")
+
+
+def print_speed(ext):
+    """Pretty print wheel speed controller extension"""
+    if not ext or not ext.HasField('speed'):
+        return
+
+    s = ext.speed
+    print(f"\nWheel Speed ({'closed loop' if s.enabled else 'released'}):")
+    print(f"  setpoint: left {s.setpoint.left:+.3f}  right {s.setpoint.right:+.3f} m/s")
+    print(f"  measured: left {s.measured.left:+.3f}  right {s.measured.right:+.3f} m/s")
+    print(f"  output:   left {s.left_output:+5d}  right {s.right_output:+5d}")
+    g = s.gains
+    print(f"  gains: kp {g.kp} ki {g.ki} kd {g.kd} kff {g.kff} kstatic {g.kstatic}")
+    h = s.heading_hold
+    hg = s.heading_gains
+    print(f"  heading: {'hold ' + format(h.target, '+.4f') if h.enabled else 'free'}  yaw {s.yaw:+.4f} rad  "
+          f"correction {s.heading_correction:+.3f} m/s")
+    print(f"  heading gains: kp {hg.kp} kd {hg.kd} max {hg.max_correction}")
+    t = s.timing
+    print(f"  loop: {t.count} periods, period {t.period_min_us}/{t.period_mean_us}/{t.period_max_us} us, "
+          f"exec {t.exec_min_us}/{t.exec_mean_us}/{t.exec_max_us} us, {t.overruns} overruns")
+
+
+def print_range(ext):
+    """Pretty print range sensor extension"""
+    if not ext or not ext.HasField('range'):
+        return
+
+    r = ext.range
+    print(f"\nRange ({r.cycles} rounds, {r.timeouts} without echo):")
+    for s in r.readings:
+        distance = f"{s.distance:.3f} m" if s.valid else "no echo"
+        filtered = f"{s.filtered:.3f} m" if s.filtered_valid else "no echo"
+        print(f"  sensor {s.sensor}: raw {distance:>9}{' (rejected)' if s.outlier else ''}  "
+              f"filtered {filtered:>9}  confidence {s.confidence:.2f}  echo {s.echo_us} us  age {s.age_ms} ms")
+
+
+WDT_TASKS = ("serial", "sensors", "control")
+
 
-def print_imu_response(response):
+def print_loop(ext):
+    """Pretty print main loop timing extension"""
+    if not ext or not ext.HasField('loop'):
+        return
+
+    lp = ext.loop
+    t = lp.timing
+    print("\nMain loop:")
+    print(f"  iterations {t.count}  overruns {t.overruns}  watchdog {lp.timeout_ms} ms, {lp.rounds} rounds")
+    print(f"  period us  min {t.period_min_us}  mean {t.period_mean_us}  max {t.period_max_us}")
+    print(f"  run us     min {t.exec_min_us}  mean {t.exec_mean_us}  max {t.exec_max_us}")
+    for b, n in enumerate(lp.histogram):
+        if n:
+            print(f"  {1 << b:>8d} us+ {n}")
+    for i, task in enumerate(lp.tasks):
+        name = WDT_TASKS[i] if i < len(WDT_TASKS) else str(i)
+        waiting = ", waiting" if lp.pending & (1 << i) else ""
+        print(f"  {name:8s} check ins {task.check_ins}  longest {task.max_span_us} us  "
+              f"largest gap {task.max_gap_us} us{waiting}")
+    for o in lp.offenders:
+        name = WDT_TASKS[o.task] if o.task < len(WDT_TASKS) else str(o.task)
+        print(f"  slow: {o.exec_us} us at {o.at_ms} ms, op {o.op}, {name} {o.task_us} us")
+    if lp.accepted:
+        print("  statistics cleared")
+
+
+RESET_REASONS = ((0, "reset pin"), (1, "watchdog"), (2, "soft reset"), (3, "CPU lockup"), (16, "wake from OFF"),
+                 (17, "LPCOMP"), (18, "debug interface"), (19, "NFC"), (20, "VBUS"))
+TRACE_KINDS = {1: "loop", 2: "request", 3: "publish"}
+
+
+def print_trace(ext):
+    """Pretty print post-mortem trace extension"""
+    if not ext or not ext.HasField('trace'):
+        return
+
+    t = ext.trace
+    reasons = [name for bit, name in RESET_REASONS if t.reset_reason & (1 << bit)] or ["power on"]
+    print("\nPrevious boot:")
+    print(f"  reset by {', '.join(reasons)} (RESETREAS 0x{t.reset_reason:08x}), boot {t.boots}")
+    if not t.valid:
+        print("  no trace retained")
+        return
+    pending = [WDT_TASKS[i] for i in range(len(WDT_TASKS)) if t.pending & (1 << i)]
+    print(f"  {t.recorded} events recorded, last {t.total} held, pending: {', '.join(pending) or 'none'}")
+    for e in t.events:
+        task = WDT_TASKS[e.task] if e.task < len(WDT_TASKS) else str(e.task)
+        print(f"  {e.at_us:>10d} us  {TRACE_KINDS.get(e.kind, e.kind):8s} op {e.op:4d}  {task:8s} {e.loop_us} us")
+    if t.more:
+        print(f"  more follow, --trace-from {t.first + len(t.events)}")
+
+
+METRICS_STAGES = ("decode", "dispatch", "handler", "encode")
+
+
+def print_metrics(ext):
+    """Pretty print serial service metrics extension"""
+    if not ext or not ext.HasField('metrics'):
+        return
+
+    m = ext.metrics
+    print("\nSerial metrics:")
+    print(f"  rx {m.rx_frames} frames, {m.rx_bytes} bytes  tx {m.tx_frames} frames, {m.tx_bytes} bytes")
+    for etype, n in enumerate(m.errors):
+        if n:
+            name = pb.ErrorType.Name(etype) if etype in pb.ErrorType.values() else str(etype)
+            print(f"  {name}: {n}")
+    for o in m.ops:
+        print(f"  op {o.op:4d}  requests {o.requests}  publications {o.publications}  errors {o.errors}")
+        for i, st in enumerate(o.stages):
+            if not st.count:
+                continue
+            name = METRICS_STAGES[i] if i < len(METRICS_STAGES) else str(i)
+            buckets = "  ".join(f"{1 << b}+:{n}" for b, n in enumerate(st.histogram) if n)
+            print(f"    {name:8s} mean {st.mean_us} us  max {st.max_us} us  [{buckets}]")
+    if m.dropped:
+        print(f"  {m.dropped} requests of operations beyond the table")
+    if m.more:
+        print(f"  more follow, --metrics-from {m.first + len(m.ops)} of {m.total}")
+    if m.accepted:
+        print("  metrics cleared")
+
+
+PROFILE_ZONES = ("loop", "sensors", "control", "serial", "decode", "encode", "bus", "imu", "pose", "range", "walls",
+                 "maze", "imu_monitor", "euler_to_quaternion", "read", "dispatch", "handler", "write")
+
+
+def print_profile(ext):
+    """Pretty print profiling zone extension"""
+    if not ext or not ext.HasField('profile'):
+        return
+
+    p = ext.profile
+    print(f"\nProfiling zones ({p.ticks_per_us} ticks/us):")
+    if not p.enabled:
+        print("  not compiled in, build with -D RR_ZONE_PROFILE=1")
+    for z in p.zones:
+        name = PROFILE_ZONES[z.zone] if z.zone < len(PROFILE_ZONES) else str(z.zone)
+        print(f"  {name:20s} {z.count:>8d}x  min {z.min_ns:>8d} ns  mean {z.mean_ns:>8d} ns  max {z.max_ns:>8d} ns  "
+              f"total {z.total_us} us")
+    if p.accepted:
+        print("  zones cleared")
+
+
+def print_memory(ext):
+    """Pretty print memory extension"""
+    if not ext or not ext.HasField('memory'):
+        return
+
+    m = ext.memory
+    print("\nMemory (bytes):")
+    if m.painted:
+        print(f"  stack        {m.stack_used:>7d} of {m.stack_size} used at most, {m.stack_size - m.stack_used} "
+              f"never touched")
+    else:
+        print("  stack        not painted")
+    print(f"  static       {m.static_bytes:>7d}")
+    print(f"  RRBuffer     {m.buffer_size:>7d}")
+    print(f"  Request      {m.request_size:>7d}   ExtRequest  {m.ext_request_size:>7d}")
+    print(f"  Response     {m.response_size:>7d}   ExtResponse {m.ext_response_size:>7d}")
+
+
+def print_imu_rate(ext):
+    """Pretty print IMU rate extension"""
+    if not ext or not ext.HasField('imu'):
+        return
+
+    r = ext.imu
+    print(f"\nIMU rates: sensor {r.sensor_odr_hz} Hz, output {r.output_hz} Hz{', accepted' if r.accepted else ''}")
+
+
+def print_walls(ext):
+    """Pretty print maze wall extension"""
+    if not ext or not ext.HasField('walls'):
+        return
+
+    w = ext.walls
+    title = "Walls (cell left)" if w.event else "Walls"
+    print(f"\n{title}:")
+    if w.accepted:
+        print("  thresholds accepted")
+    if w.in_maze:
+        c = w.cell
+        sides = ''.join(n if c.walls & b else ('.' if c.seen & b else '?')
+                        for n, b in (('N', 1), ('E', 2), ('S', 4), ('W', 8)))
+        print(f"  cell ({c.x}, {c.y}): {sides}")
+    else:
+        print("  outside the maze")
+    t = w.thresholds
+    print(f"  queued: {w.queued}  dropped: {w.dropped}  "
+          f"thresholds on {t.on_m:.3f} m off {t.off_m:.3f} m confidence {t.min_confidence:.2f}")
+
+
+MAZE_HEADINGS = "NESW"
+MAZE_MOVES = {0: "none", 1: "forward", 2: "right", 3: "back", 4: "left"}
+
+
+def print_maze(ext):
+    """Pretty print maze extension"""
+    if not ext or not ext.HasField('maze'):
+        return
+
+    m = ext.maze
+    print("\nMaze:")
+    if m.accepted:
+        print("  accepted")
+    g = m.goal
+    print(f"  goal ({g.x}, {g.y}) {g.width}x{g.height}  updates {m.updates}  last {m.update_us} us "
+          f"({m.changed} cells)  slowest {m.max_update_us} us")
+    if m.HasField('step'):
+        s = m.step
+        if not s.in_maze:
+            print("  outside the maze")
+        else:
+            print(f"  at ({s.x}, {s.y}) facing {MAZE_HEADINGS[s.heading]}: {MAZE_MOVES.get(s.move, s.move)} to "
+                  f"({s.next_x}, {s.next_y}) facing {MAZE_HEADINGS[s.next_heading]}, {s.distance} cells to go")
+    if len(m.distances) > 0:
+        size = int(len(m.distances) ** 0.5)
+        for y in reversed(range(size)):
+            row = m.distances[y * size:(y + 1) * size]
+            print("  " + " ".join(" --" if d == 255 else f"{d:3d}" for d in row))
+    if m.resync:
+        print(f"  resync, whole map ({len(m.map)} bytes) at change {m.seq}")
+    elif m.deltas:
+        for c in m.deltas:
+            sides = ''.join(n if c.walls & b else ('.' if c.seen & b else '?')
+                            for n, b in (('N', 1), ('E', 2), ('S', 4), ('W', 8)))
+            print(f"  cell ({c.x}, {c.y}): {sides}")
+        print(f"  up to change {m.seq}{', more follow' if m.more else ''}")
+
+
+def print_plan(ext):
+    """Pretty print speed run plan extension"""
+    if not ext or not ext.HasField('plan'):
+        return
+
+    p = ext.plan
+    print("\nPlan:")
+    if p.accepted:
+        print("  costs accepted")
+    c = p.costs
+    for name, limits in (('straight', c.straight), ('diagonal', c.diagonal), ('turn', c.turn)):
+        print(f"  {name:8s} v_max {limits.v_max:.3f}  accel {limits.accel:.3f}  jerk {limits.jerk:.3f}")
+    print(f"  turn settle {c.turn_settle_s:.3f} s")
+    if not p.found:
+        print("  no run along seen open sides reaches the goal")
+        return
+    print(f"  {p.total} segments over {p.cells} cells: {p.straights} straights, {p.diagonals} diagonals, "
+          f"{p.turns} turns, predicted {p.predicted_s:.3f} s, planned in {p.plan_us} us")
+    for s in p.segments:
+        unit = "rad" if s.kind == 1 else "m"
+        print(f"  {s.id:3d} {'turn' if s.kind == 1 else 'straight':8s} {s.distance:+.3f} {unit}  v_max {s.v_max:.3f}")
+    if p.more:
+        print(f"  more follow, --plan-from {p.first + len(p.segments) + 1}")
+
+
+def print_motion(ext):
+    """Pretty print motion queue extension"""
+    if not ext or not ext.HasField('motion'):
+        return
+
+    m = ext.motion
+    title = "Motion (segment completed)" if m.event else "Motion"
+    print(f"\n{title}:")
+    if m.accepted:
+        print("  segment queued")
+    print(f"  queued: {m.queued}  active: {m.active_id if m.active else '-'}  "
+          f"progress {m.progress:.3f}  velocity {m.velocity:+.3f}")
+    print(f"  completed: {m.completed} (last id {m.completed_id})")
+
+
+def print_imu_response(response, ext=None):
     """Pretty print IMU response data"""
     if not response:
         print("No response received")
@@ -297,6 +1054,21 @@ def print_imu_response(response):
             print(f"  y: {la.y:+.6f}")
             print(f"  z: {la.z:+.6f}")
 
+    print_imu_rate(ext)
+    print_pose(ext)
+    print_motor(ext)
+    print_speed(ext)
+    print_motion(ext)
+    print_range(ext)
+    print_walls(ext)
+    print_loop(ext)
+    print_trace(ext)
+    print_metrics(ext)
+    print_profile(ext)
+    print_memory(ext)
+    print_maze(ext)
+    print_plan(ext)
+
     print(f"{'='*60}\n")
 
 
@@ -327,8 +1099,10 @@ Examples:
 
     parser.add_argument(
         '--operation', '-o',
-        choices=['imu', 'features'],
-        help='Predefined operation (imu, features)'
+        choices=['imu', 'features', 'pose', 'motor', 'pid', 'motion', 'range', 'walls', 'maze-move', 'maze-dist',
+                 'maze-map', 'maze-plan', 'status', 'trace', 'metrics', 'profile', 'memory'],
+        help='Predefined operation (imu, features, pose, motor, pid, motion, range, walls, maze-move, maze-dist, '
+             'maze-map, maze-plan, status, trace, metrics, profile, memory)'
     )
 
     parser.add_argument(
@@ -343,6 +1117,168 @@ Examples:
         help='Continuous monitoring rate in Hz (e.g., 10 for 10Hz)'
     )
 
+    parser.add_argument(
+        '--motor', '-m',
+        type=int,
+        nargs=2,
+        metavar=('LEFT', 'RIGHT'),
+        help='Set motor duty, per mille (-1000 .. 1000)'
+    )
+
+    parser.add_argument(
+        '--imu-rate',
+        type=int,
+        nargs=2,
+        metavar=('ODR', 'OUTPUT'),
+        help='With --operation imu, set the sensor ODR (100, 200, 400, 800, 1600) and the fused output rate, Hz'
+    )
+
+    parser.add_argument(
+        '--speed',
+        type=float,
+        nargs=2,
+        metavar=('LEFT', 'RIGHT'),
+        help='Set closed loop wheel speeds, m/s'
+    )
+
+    parser.add_argument(
+        '--gains',
+        type=float,
+        nargs=5,
+        metavar=('KP', 'KI', 'KD', 'KFF', 'KSTATIC'),
+        help='Set wheel speed controller gains'
+    )
+
+    parser.add_argument(
+        '--heading-hold',
+        type=float,
+        metavar='TARGET',
+        help='Hold this heading (rad) while driving, with --move applies to that straight segment'
+    )
+
+    parser.add_argument(
+        '--heading-off',
+        action='store_true',
+        help='Release the host heading hold'
+    )
+
+    parser.add_argument(
+        '--heading-gains',
+        type=float,
+        nargs=3,
+        metavar=('KP', 'KD', 'MAX'),
+        help='Set heading hold gains, MAX is the wheel speed correction limit in m/s'
+    )
+
+    parser.add_argument(
+        '--move',
+        type=float,
+        nargs=6,
+        metavar=('ID', 'DISTANCE', 'VMAX', 'ACCEL', 'VEND', 'JERK'),
+        help='Queue a motion segment, m (or rad with --turn), jerk 0 for trapezoidal'
+    )
+
+    parser.add_argument(
+        '--turn',
+        action='store_true',
+        help='The --move segment is an in place turn, positive counter clockwise'
+    )
+
+    parser.add_argument(
+        '--abort',
+        action='store_true',
+        help='Brake to rest, and drop queued motion segments'
+    )
+
+    parser.add_argument(
+        '--wall-thresholds',
+        type=float,
+        nargs=3,
+        metavar=('ON', 'OFF', 'CONFIDENCE'),
+        help='Set wall hysteresis, m past the expected wall face, and the smallest filter confidence used'
+    )
+
+    parser.add_argument(
+        '--maze-since',
+        type=int,
+        default=0,
+        help='With --operation maze-map, return map changes after this sequence number'
+    )
+
+    parser.add_argument(
+        '--plan-costs',
+        type=float,
+        nargs=10,
+        metavar=('SV', 'SA', 'SJ', 'DV', 'DA', 'DJ', 'TV', 'TA', 'TJ', 'SETTLE'),
+        help='Set the speed run cost model: straight, diagonal and turn v_max, accel and jerk, m or rad, then the '
+             'turn settle time in s'
+    )
+
+    parser.add_argument(
+        '--plan-from',
+        type=int,
+        default=0,
+        help='With --operation maze-plan, page the cached plan from this segment id instead of replanning'
+    )
+
+    parser.add_argument(
+        '--maze-goal',
+        type=int,
+        nargs=4,
+        metavar=('X', 'Y', 'WIDTH', 'HEIGHT'),
+        help='Set the maze goal rectangle, cells'
+    )
+
+    parser.add_argument(
+        '--loop-reset',
+        action='store_true',
+        help='With --operation status, clear the main loop statistics after they are returned'
+    )
+
+    parser.add_argument(
+        '--trace-from',
+        type=int,
+        default=0,
+        help='With --operation trace, return events from this index'
+    )
+
+    parser.add_argument(
+        '--metrics-from',
+        type=int,
+        default=0,
+        help='With --operation metrics, return operations from this index'
+    )
+
+    parser.add_argument(
+        '--metrics-reset',
+        action='store_true',
+        help='With --operation metrics, clear the metrics after they are returned'
+    )
+
+    parser.add_argument(
+        '--profile-reset',
+        action='store_true',
+        help='With --operation profile, clear the profiling zones after they are returned'
+    )
+
+    parser.add_argument(
+        '--maze-reset',
+        action='store_true',
+        help='Clear the on-device maze map'
+    )
+
+    parser.add_argument(
+        '--subscribe', '-s',
+        type=int,
+        help='Subscribe to the pose stream with this period in ms, and print frames as they arrive'
+    )
+
+    parser.add_argument(
+        '--round-trips',
+        type=int,
+        help='Send this many --op-code requests (default MSP_STATUS), one at a time, and report round trip times'
+    )
+
     parser.add_argument(
         '--timeout', '-t',
         type=float,
@@ -353,8 +1289,21 @@ Examples:
     args = parser.parse_args()
 
     # Validate arguments
-    if not args.operation and args.op_code is None:
-        parser.error("Must specify either --operation or --op-code")
+    if (not args.operation and args.op_code is None and args.motor is None and
+            args.speed is None and args.gains is None and args.move is None and not args.abort and
+            args.heading_hold is None and not args.heading_off and args.heading_gains is None and
+            args.wall_thresholds is None and args.maze_goal is None and not args.maze_reset and
+            args.round_trips is None):
+        parser.error("Must specify either --operation, --op-code, --motor, --speed, --gains, --heading-hold, "
+                     "--heading-off, --heading-gains, --move, --abort, --wall-thresholds, --maze-goal, "
+                     "--maze-reset, or --round-trips")
+
+    maze_ops = {
+        'maze-move': OpCodes.MSP_MAZE_MOVE,
+        'maze-dist': OpCodes.MSP_MAZE_DIST,
+        'maze-map': OpCodes.MSP_MAZE_MAP,
+        'maze-plan': OpCodes.MSP_MAZE_PLAN,
+    }
 
     # Create client and connect
     client = MousebotClient(
@@ -367,7 +1316,21 @@ Examples:
         return 1
 
     try:
-        if args.rate:
+        if args.round_trips:
+            op_code = args.op_code if args.op_code is not None else OpCodes.MSP_STATUS
+            times, elapsed = client.measure_round_trips(op_code, args.round_trips)
+            print_round_trips(times, args.round_trips, elapsed)
+        elif args.subscribe is not None and args.operation == 'pose':
+            # Stream mode, frames arrive without being requested
+            response = client.request_pose(args.subscribe)
+            print(f"Subscribed every {args.subscribe} ms (Press Ctrl+C to stop)\n")
+            try:
+                while response is not None:
+                    print_imu_response(response, client.ext)
+                    response = client.receive_response()
+            finally:
+                client.request_pose(0)
+        elif args.rate:
             # Continuous mode
             interval = 1.0 / args.rate
             print(f"Monitoring at {args.rate} Hz (Press Ctrl+C to stop)\n")
@@ -378,6 +1341,25 @@ Examples:
                 if args.operation == 'imu':
                     response = client.request_imu()
                     print_imu_response(response)
+                elif args.operation == 'pose':
+                    response = client.request_pose()
+                    print_imu_response(response, client.ext)
+                elif args.operation == 'motion':
+                    response = client.request_motion()
+                    print_imu_response(response, client.ext)
+                elif args.operation == 'range':
+                    response = client.request_range()
+                    print_imu_response(response, client.ext)
+                elif args.operation == 'status':
+                    response = client.request_status(args.loop_reset)
+                    print_imu_response(response, client.ext)
+                elif args.operation == 'walls':
+                    response = client.request_walls()
+                    print_imu_response(response, client.ext)
+                elif args.operation in maze_ops:
+                    response = client.request_maze(maze_ops[args.operation], args.maze_since,
+                                                   costs=args.plan_costs, plan_from=args.plan_from)
+                    print_imu_response(response, client.ext)
                 elif args.op_code is not None:
                     response = client.send_raw_opcode(args.op_code)
                     print_imu_response(response)
@@ -388,9 +1370,60 @@ Examples:
                 time.sleep(sleep_time)
         else:
             # Single request mode
-            if args.operation == 'imu':
-                response = client.request_imu()
-                print_imu_response(response)
+            if args.move is not None or args.abort:
+                response = client.request_motion(args.move, args.turn, args.abort, args.heading_hold)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'motion':
+                response = client.request_motion()
+                print_imu_response(response, client.ext)
+            elif (args.speed is not None or args.gains is not None or args.heading_hold is not None or
+                  args.heading_off or args.heading_gains is not None):
+                heading = False if args.heading_off else args.heading_hold
+                response = client.request_speed(args.speed, args.gains, heading, args.heading_gains)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'pid':
+                response = client.request_speed()
+                print_imu_response(response, client.ext)
+            elif args.motor is not None:
+                response = client.request_motor(args.motor)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'motor':
+                response = client.request_motor()
+                print_imu_response(response, client.ext)
+            elif args.operation == 'imu':
+                response = client.request_imu(args.imu_rate)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'pose':
+                response = client.request_pose()
+                print_imu_response(response, client.ext)
+            elif args.operation == 'range':
+                response = client.request_range()
+                print_imu_response(response, client.ext)
+            elif args.operation == 'status':
+                response = client.request_status(args.loop_reset)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'trace':
+                response = client.request_trace(args.trace_from)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'metrics':
+                response = client.request_metrics(args.metrics_from, args.metrics_reset)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'profile':
+                response = client.request_profile(args.profile_reset)
+                print_imu_response(response, client.ext)
+            elif args.operation == 'memory':
+                response = client.request_memory()
+                print_imu_response(response, client.ext)
+            elif args.maze_goal is not None or args.maze_reset:
+                response = client.request_maze(goal=args.maze_goal, reset=args.maze_reset)
+                print_imu_response(response, client.ext)
+            elif args.operation in maze_ops:
+                response = client.request_maze(maze_ops[args.operation], args.maze_since,
+                                               costs=args.plan_costs, plan_from=args.plan_from)
+                print_imu_response(response, client.ext)
+            elif args.wall_thresholds is not None or args.operation == 'walls':
+                response = client.request_walls(args.wall_thresholds)
+                print_imu_response(response, client.ext)
             elif args.operation == 'features':
                 response = client.request_features()
                 print_imu_response(response)
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025 Ryder Robots
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+
+"""
+Mousebot Log - Reads and writes the record and replay log (lib/rr_log/include/rr_log.hpp)
+
+A log is a 16 byte header, then records appended one after another, each a u16 payload length, u8 type, u8 channel,
+u64 time in us, then the payload padded to 4 bytes, all little endian. The simulator writes them with --record, and
+replays them with --replay (sim/README.md), log_recorder.py writes them from the serial link of a board.
+
+Usage:
+    # every record, payloads in hex
+    ./rr_log.py dump run.log
+
+    # records, bytes and rate by type
+    ./rr_log.py stats run.log
+
+    # does a replay answer as the recording did, compared on what the firmware wrote
+    ./rr_log.py diff run.log replay.log --type tx
+"""
+
+import sys
+import os
+import mmap
+import struct
+import argparse
+
+MAGIC = b'RRLG'
+VERSION = 1
+HEADER = struct.Struct('<4sHHII')
+RECORD = struct.Struct('<HBBQ')
+
+RT_RX = 1
+RT_TX = 2
+RT_IMU = 3
+RT_EDGES = 4
+RT_ECHO = 5
+RT_NOTE = 6
+TYPES = {RT_RX: 'rx', RT_TX: 'tx', RT_IMU: 'imu', RT_EDGES: 'edges', RT_ECHO: 'echo', RT_NOTE: 'note'}
+
+
+def record_len(payload_len):
+    return (RECORD.size + payload_len + 3) & ~3
+
+
+class Writer:
+    """Appends records to a file, the header first"""
+
+    def __init__(self, f, step_us=0):
+        self.f = f
+        self.records = 0
+        f.write(HEADER.pack(MAGIC, VERSION, HEADER.size, step_us, 0))
+
+    def append(self, rtype, channel, time_us, payload=b''):
+        pad = record_len(len(payload)) - RECORD.size - len(payload)
+        self.f.write(RECORD.pack(len(payload), rtype, channel, time_us) + bytes(payload) + b'\0' * pad)
+        self.records += 1
+
+
+class Reader:
+    """Records of a log, mapped into memory rather than read, so that a long log costs nothing to open"""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) if f.seek(0, 2) else b''
+        if len(self.data) < HEADER.size:
+            raise ValueError(f"{path} is not a log")
+        magic, version, header_len, self.step_us, _ = HEADER.unpack_from(self.data)
+        if magic != MAGIC or version != VERSION or header_len < HEADER.size:
+            raise ValueError(f"{path} is not a log")
+        self.header_len = header_len
+        self.truncated = False
+
+    def __iter__(self):
+        """(time_us, type, channel, payload) of each record, until one is cut short"""
+        offset = self.header_len
+        size = len(self.data)
+        while offset + RECORD.size <= size:
+            length, rtype, channel, time_us = RECORD.unpack_from(self.data, offset)
+            end = offset + record_len(length)
+            if end > size:
+                break
+            yield time_us, rtype, channel, bytes(self.data[offset + RECORD.size:offset + RECORD.size + length])
+            offset = end
+        self.truncated = offset != size
+
+
+def parse_types(text):
+    names = {v: k for k, v in TYPES.items()}
+    try:
+        return {names[t] for t in text.split(',')} if text else set(TYPES)
+    except KeyError as e:
+        raise argparse.ArgumentTypeError(f"unknown type {e}, one of {','.join(names)}")
+
+
+def describe(rtype, channel, payload):
+    if rtype == RT_EDGES and len(payload) == 8:
+        return 'left %d right %d' % struct.unpack('<II', payload)
+    if rtype == RT_ECHO and len(payload) == 8:
+        return 'pin %d rise %d fall %d us' % ((channel,) + struct.unpack('<II', payload))
+    if rtype == RT_IMU and len(payload) == 12:
+        return 'accel %d %d %d gyro %d %d %d' % struct.unpack('<6h', payload)
+    if rtype == RT_NOTE:
+        return payload.decode('utf-8', 'replace')
+    return payload.hex()
+
+
+def dump(args):
+    log = Reader(args.log)
+    print(f"step {log.step_us} us" if log.step_us else "real time")
+    for time_us, rtype, channel, payload in log:
+        if rtype in args.type:
+            print(f"{time_us:12d} {TYPES.get(rtype, rtype):>5} {describe(rtype, channel, payload)}")
+    if log.truncated:
+        print("log ends in a record cut short")
+    return 0
+
+
+def stats(args):
+    log = Reader(args.log)
+    counts = {}
+    first = last = None
+    for time_us, rtype, channel, payload in log:
+        c = counts.setdefault(rtype, [0, 0])
+        c[0] += 1
+        c[1] += len(payload)
+        first = time_us if first is None else first
+        last = time_us
+    span_s = (last - first) / 1e6 if first is not None and last > first else 0.0
+    print(f"{'step %d us' % log.step_us if log.step_us else 'real time'}, {span_s:.3f} s, "
+          f"{len(log.data)} bytes{', cut short' if log.truncated else ''}")
+    for rtype, (records, nbytes) in sorted(counts.items()):
+        rate = f"{records / span_s:10.1f}/s" if span_s > 0 else ''
+        print(f"{TYPES.get(rtype, rtype):>5} {records:9d} records {nbytes:10d} bytes {rate}")
+    return 0
+
+
+def diff(args):
+    """Compares records of the types given, by time, channel and payload; the byte streams of rx and tx are compared
+    joined up, as the same bytes can be read, or written, in different chunks"""
+    a = [r for r in Reader(args.a) if r[1] in args.type]
+    b = [r for r in Reader(args.b) if r[1] in args.type]
+    for rtype in (RT_RX, RT_TX):
+        if rtype in args.type:
+            sa = b''.join(r[3] for r in a if r[1] == rtype)
+            sb = b''.join(r[3] for r in b if r[1] == rtype)
+            if sa != sb:
+                at = next((i for i, (x, y) in enumerate(zip(sa, sb)) if x != y), min(len(sa), len(sb)))
+                print(f"{TYPES[rtype]} differs at byte {at} of {len(sa)} / {len(sb)}")
+                return 1
+    if args.bytes_only:
+        print(f"same bytes, {len(a)} / {len(b)} records")
+        return 0
+    for i, (ra, rb) in enumerate(zip(a, b)):
+        if ra != rb:
+            print(f"record {i} differs:")
+            for name, r in (('a', ra), ('b', rb)):
+                print(f"  {name} {r[0]:12d} {TYPES.get(r[1], r[1]):>5} {describe(r[1], r[2], r[3])}")
+            return 1
+    if len(a) != len(b):
+        print(f"{len(a)} records against {len(b)}")
+        return 1
+    print(f"same, {len(a)} records")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Mousebot Log - dump, summarise, or compare record and replay logs",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  %(prog)s dump run.log --type rx,tx
+  %(prog)s diff run.log replay.log --type tx
+        """
+    )
+    sub = parser.add_subparsers(dest='command', required=True)
+    p = sub.add_parser('dump', help='Print records')
+    p.add_argument('log')
+    p.add_argument('--type', type=parse_types, default=set(TYPES),
+                   help='Comma separated types to print (default: all)')
+    p.set_defaults(run=dump)
+    p = sub.add_parser('stats', help='Records, bytes and rate by type')
+    p.add_argument('log')
+    p.set_defaults(run=stats)
+    p = sub.add_parser('diff', help='Compare two logs, exit 1 if they differ')
+    p.add_argument('a')
+    p.add_argument('b')
+    p.add_argument('--type', type=parse_types, default=set(TYPES),
+                   help='Comma separated types to compare (default: all)')
+    p.add_argument('--bytes-only', action='store_true',
+                   help='Compare only the rx and tx byte streams, not when, or in what chunks, they went')
+    p.set_defaults(run=diff)
+    args = parser.parse_args()
+    try:
+        return args.run(args)
+    except BrokenPipeError:
+        # output piped into head, and the rest not wanted.
+        os.dup2(os.open(os.devnull, os.O_WRONLY), sys.stdout.fileno())
+        return 0
+    except (OSError, ValueError) as e:
+        print(f"ERROR: {e}")
+        return 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -26,11 +26,11 @@ fi
 
 # Generate Python protobuf files
 cd "$PROTO_DIR"
-protoc --python_out=. rr_serial.proto
+protoc --python_out=. rr_serial.proto rr_mousebot.proto
 
-if [ -f "rr_serial_pb2.py" ]; then
-    echo "✓ Generated rr_serial_pb2.py successfully"
-    ls -lh rr_serial_pb2.py
+if [ -f "rr_serial_pb2.py" ] && [ -f "rr_mousebot_pb2.py" ]; then
+    echo "✓ Generated rr_serial_pb2.py and rr_mousebot_pb2.py successfully"
+    ls -lh rr_serial_pb2.py rr_mousebot_pb2.py
 else
     echo "ERROR: Failed to generate protobuf files"
     exit 1
@@ -32,6 +32,8 @@ except ImportError:
     print("Run: ./setup_proto.sh")
     sys.exit(1)
 
+from mousebot_serial_client import TERM_CHAR, stuff, unstuff
+
 
 def test_connection(port="/dev/ttyACM0"):
     """Test basic serial connection and single IMU request"""
@@ -58,8 +60,8 @@ def test_connection(port="/dev/ttyACM0"):
 
         # Send request
         data = request.SerializeToString()
-        ser.write(data)
-        ser.write(bytes([0x1E]))  # Terminator
+        ser.write(stuff(data))
+        ser.write(bytes([TERM_CHAR]))  # Terminator
         ser.flush()
         print(f"✓ Sent IMU request ({len(data)} bytes)")
 
@@ -74,7 +76,7 @@ def test_connection(port="/dev/ttyACM0"):
 
             if ser.in_waiting > 0:
                 byte = ser.read(1)
-                if byte[0] == 0x1E:
+                if byte[0] == TERM_CHAR:
                     break
                 response_data.append(byte[0])
 
@@ -82,7 +84,7 @@ def test_connection(port="/dev/ttyACM0"):
 
         # Parse response
         response = pb.Response()
-        response.ParseFromString(bytes(response_data))
+        response.ParseFromString(unstuff(response_data))
 
         print(f"✓ Parsed protobuf response")
         print(f"  Op Code: {response.op}")